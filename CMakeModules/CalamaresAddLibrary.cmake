@@ -52,8 +52,20 @@ function(calamares_add_library)
     include_directories(${CMAKE_CURRENT_LIST_DIR})
     include_directories(${CMAKE_CURRENT_BINARY_DIR})
 
-    # add resources from current dir
-    if(LIBRARY_RESOURCES)
+    # add resources from current dir; with the Qt Quick Compiler, the
+    # QML files in them are compiled ahead-of-time instead of on startup.
+    # The .qml sources are retained in the resources, since
+    # searchQmlFile() looks for them by name.
+    if(LIBRARY_RESOURCES AND BUILD_QMLCACHE)
+        set(QTQUICK_COMPILER_RETAINED_RESOURCES)
+        foreach(_resource ${LIBRARY_RESOURCES})
+            get_filename_component(_resource_path ${_resource} ABSOLUTE)
+            list(APPEND QTQUICK_COMPILER_RETAINED_RESOURCES ${_resource} ${_resource_path})
+        endforeach()
+        qtquick_compiler_add_resources(_compiled_resources ${LIBRARY_RESOURCES})
+        list(APPEND LIBRARY_SOURCES ${_compiled_resources})
+        set(LIBRARY_RESOURCES)
+    elseif(LIBRARY_RESOURCES)
         list(APPEND LIBRARY_SOURCES ${LIBRARY_RESOURCES})
     endif()
 
@@ -17,6 +17,18 @@
 #   [RESOURCES FILE]
 #   SOURCES <FILE..>
 #   )
+#
+# calamares_add_benchmark(
+#   <NAME>
+#   [GUI]
+#   SOURCES <FILE..>
+#   )
+#
+# Benchmarks are QtTest executables that use QBENCHMARK. They are
+# not built by default and are not run by ctest. Build the target
+# *calamares-benchmarks* to build and run all of them; each one
+# writes its results (as QtTest XML) to benchmarks/<NAME>.xml
+# in the build directory.
 
 include( CMakeParseArguments )
 include( CalamaresAutomoc )
@@ -53,3 +65,40 @@ function( calamares_add_test )
         endif()
     endif()
 endfunction()
+
+function( calamares_add_benchmark )
+    set( NAME ${ARGV0} )
+    set( options GUI )
+    set( oneValueArgs NAME )
+    set( multiValueArgs SOURCES LIBRARIES DEFINITIONS )
+    cmake_parse_arguments( BENCHMARK "${options}" "${oneValueArgs}" "${multiValueArgs}" ${ARGN} )
+    set( BENCHMARK_NAME ${NAME} )
+
+    if( ECM_FOUND AND BUILD_TESTING )
+        add_executable( ${BENCHMARK_NAME} EXCLUDE_FROM_ALL ${BENCHMARK_SOURCES} )
+        target_link_libraries( ${BENCHMARK_NAME}
+            Calamares::calamares
+            ${BENCHMARK_LIBRARIES}
+            Qt5::Core
+            Qt5::Test
+            )
+        calamares_automoc( ${BENCHMARK_NAME} )
+        target_compile_definitions( ${BENCHMARK_NAME} PRIVATE -DBUILD_AS_TEST="${CMAKE_CURRENT_SOURCE_DIR}" ${BENCHMARK_DEFINITIONS} )
+        if( BENCHMARK_GUI )
+            target_link_libraries( ${BENCHMARK_NAME} Calamares::calamaresui Qt5::Gui )
+        endif()
+
+        if( NOT TARGET calamares-benchmarks )
+            add_custom_target( calamares-benchmarks )
+        endif()
+        set( _results_dir ${CMAKE_BINARY_DIR}/benchmarks )
+        add_custom_target( ${BENCHMARK_NAME}-run
+            COMMAND ${CMAKE_COMMAND} -E make_directory ${_results_dir}
+            COMMAND ${BENCHMARK_NAME} -o ${_results_dir}/${BENCHMARK_NAME}.xml,xml -o -,txt
+            DEPENDS ${BENCHMARK_NAME}
+            COMMENT "Running benchmark ${BENCHMARK_NAME}"
+            VERBATIM
+            )
+        add_dependencies( calamares-benchmarks ${BENCHMARK_NAME}-run )
+    endif()
+endfunction()
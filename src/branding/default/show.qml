@@ -33,6 +33,8 @@ Presentation
         Image {
             id: background
             source: "squid.png"
+            // Decode in the background, the disk is busy installing
+            asynchronous: true
             width: 200; height: 200
             fillMode: Image.PreserveAspectFit
             anchors.centerIn: parent
@@ -22,6 +22,7 @@
 #include "utils/CalamaresUtilsGui.h"
 #include "utils/CalamaresUtilsSystem.h"
 #include "utils/Dirs.h"
+#include "utils/ImageRegistry.h"
 #include "utils/Logger.h"
 #ifdef WITH_QML
 #include "utils/Qml.h"
@@ -83,6 +84,12 @@ CalamaresApplication::init()
     setQuitOnLastWindowClosed( false );
     setWindowIcon( QIcon( Calamares::Branding::instance()->imagePath( Calamares::Branding::ProductIcon ) ) );
 
+    // Rasterize the commonly-used images while modules are loading;
+    // the product logo is shown at 80x80 in the sidebar.
+    CalamaresUtils::prewarmDefaultPixmaps( CalamaresUtils::defaultIconSize() );
+    ImageRegistry::instance()->prewarm(
+        { Calamares::Branding::instance()->imagePath( Calamares::Branding::ProductLogo ) }, QSize( 80, 80 ) );
+
     cDebug() << Logger::SubEntry << "STARTUP: initSettings, initQmlPath, initBranding done";
 
     initModuleManager();  //also shows main window
@@ -112,6 +119,14 @@ CalamaresApplication::mainWindow()
 }
 
 
+void
+CalamaresApplication::setCheckpoint( const QString& filename, bool resume )
+{
+    m_checkpointFile = filename;
+    m_resume = resume;
+}
+
+
 static QStringList
 brandingFileCandidates( bool assumeBuilddir, const QString& brandingFilename )
 {
@@ -295,6 +310,10 @@ void
 CalamaresApplication::initJobQueue()
 {
     Calamares::JobQueue* jobQueue = new Calamares::JobQueue( this );
+    if ( !m_checkpointFile.isEmpty() )
+    {
+        jobQueue->setCheckpoint( m_checkpointFile, m_resume );
+    }
     new CalamaresUtils::System( Calamares::Settings::instance()->doChroot(), this );
     Calamares::Branding::instance()->setGlobals( jobQueue->globalStorage() );
 }
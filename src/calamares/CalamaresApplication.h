@@ -45,6 +45,12 @@ public:
      */
     CalamaresWindow* mainWindow();
 
+    /** @brief Keep a checkpoint of the exec phase in @p filename
+     *
+     * Call this before init(); see JobQueue::setCheckpoint().
+     */
+    void setCheckpoint( const QString& filename, bool resume );
+
 private slots:
     void initView();
     void initViewSteps();
@@ -58,6 +64,8 @@ private:
     void initJobQueue();
 
     CalamaresWindow* m_mainwindow;
+    QString m_checkpointFile;
+    bool m_resume = false;
     Calamares::ModuleManager* m_moduleManager;
 };
 
@@ -19,6 +19,7 @@
 #include "VariantModel.h"
 #include "modulesystem/Module.h"
 #include "modulesystem/ModuleManager.h"
+#include "utils/ImageRegistry.h"
 #include "utils/Logger.h"
 #include "utils/Paste.h"
 #include "utils/Retranslator.h"
@@ -214,6 +215,12 @@ DebugWindow::DebugWindow()
         }
     } );
 
+    connect( m_ui->imageCacheButton, &QPushButton::clicked, []() {
+        const auto s = ImageRegistry::instance()->statistics();
+        cDebug() << "Image cache hits" << s.hits << "misses" << s.misses;
+        cDebug() << Logger::SubEntry << s.count << "images using" << s.costKiB << "KiB of" << s.budgetKiB << "KiB";
+    } );
+
     // Send Log button only if it would be useful
     m_ui->sendLogButton->setVisible( CalamaresUtils::Paste::isEnabled() );
     connect( m_ui->sendLogButton, &QPushButton::clicked, [this]() { CalamaresUtils::Paste::doLogUploadUI( this ); } );
@@ -12,6 +12,7 @@
 #include "CalamaresApplication.h"
 
 #include "Settings.h"
+#include "utils/ConfigCache.h"
 #include "utils/Dirs.h"
 #include "utils/Logger.h"
 #include "utils/Retranslator.h"
@@ -78,6 +79,12 @@ handle_args( CalamaresApplication& a )
     QCommandLineOption configOption(
         QStringList { "c", "config" }, "Configuration directory to use, for testing purposes.", "config" );
     QCommandLineOption xdgOption( QStringList { "X", "xdg-config" }, "Use XDG_{CONFIG,DATA}_DIRS as well." );
+    QCommandLineOption checkpointOption(
+        QStringLiteral( "checkpoint" ), "Keep a checkpoint of the installation in this file.", "file" );
+    QCommandLineOption resumeOption( QStringLiteral( "resume" ), "Resume the installation from the checkpoint." );
+    QCommandLineOption cacheOption( QStringLiteral( "config-cache" ),
+                                    "Use of the configuration cache: off, use (the default) or verify.",
+                                    "mode" );
 
     QCommandLineParser parser;
     parser.setApplicationDescription( "Distribution-independent installer framework" );
@@ -89,6 +96,9 @@ handle_args( CalamaresApplication& a )
     parser.addOption( configOption );
     parser.addOption( xdgOption );
     parser.addOption( debugTxOption );
+    parser.addOption( checkpointOption );
+    parser.addOption( resumeOption );
+    parser.addOption( cacheOption );
 
     parser.process( a );
 
@@ -102,6 +112,14 @@ handle_args( CalamaresApplication& a )
         CalamaresUtils::setXdgDirs();
     }
     CalamaresUtils::setAllowLocalTranslation( parser.isSet( debugOption ) || parser.isSet( debugTxOption ) );
+    if ( parser.isSet( checkpointOption ) )
+    {
+        a.setCheckpoint( parser.value( checkpointOption ), parser.isSet( resumeOption ) );
+    }
+    if ( parser.isSet( cacheOption ) && !CalamaresUtils::ConfigCache::setMode( parser.value( cacheOption ) ) )
+    {
+        cWarning() << "Unknown configuration-cache mode" << parser.value( cacheOption );
+    }
 
     return parser.isSet( debugOption );
 }
@@ -0,0 +1,266 @@
+/* === This file is part of Calamares - <https://calamares.io> ===
+ *
+ *   SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *   SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ *   Calamares is Free Software: see the License-Identifier above.
+ *
+ */
+
+#include "CalamaresConfig.h"
+#include "GlobalStorage.h"
+#include "JobQueue.h"
+#include "locale/TimeZone.h"
+#include "utils/CalamaresUtilsSystem.h"
+#include "utils/CommandList.h"
+#include "utils/Logger.h"
+#include "utils/Runner.h"
+#include "utils/Yaml.h"
+
+#ifdef WITH_PYTHON
+#include "PythonHelper.h"
+#endif
+
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QtTest/QtTest>
+
+/** @brief Benchmarks for (what we think are) hot paths in libcalamares
+ *
+ * Run these through the *calamares-benchmarks* target, which
+ * keeps the results in a machine-readable form.
+ */
+class LibCalamaresBenchmarks : public QObject
+{
+    Q_OBJECT
+public:
+    LibCalamaresBenchmarks() {}
+    ~LibCalamaresBenchmarks() override {}
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void benchGSInsert_data();
+    void benchGSInsert();
+    void benchGSValue();
+    void benchGSData();
+
+    void benchYamlToVariant();
+    void benchSaveYaml();
+
+    void benchLogger();
+
+    void benchRunnerSpawn();
+    void benchCommandListSpawn();
+
+    void benchZonesFindByName();
+    void benchZonesFindByLocation();
+
+#ifdef WITH_PYTHON
+    void benchVariantToPyObject();
+#endif
+
+private:
+    QTemporaryDir m_tempDir;
+};
+
+/// @brief A GS-like map of @p count keys, with nested lists and maps
+static QVariantMap
+sampleMap( int count )
+{
+    QVariantMap m;
+    for ( int i = 0; i < count; ++i )
+    {
+        const QString key = QStringLiteral( "key%1" ).arg( i );
+        switch ( i % 4 )
+        {
+        case 0:
+            m.insert( key, i );
+            break;
+        case 1:
+            m.insert( key, QStringLiteral( "value %1" ).arg( i ) );
+            break;
+        case 2:
+            m.insert( key, QVariantList { i, QStringLiteral( "two" ), true } );
+            break;
+        default:
+            m.insert( key, QVariantMap { { "device", QStringLiteral( "/dev/sda%1" ).arg( i ) }, { "fs", "ext4" } } );
+        }
+    }
+    return m;
+}
+
+void
+LibCalamaresBenchmarks::initTestCase()
+{
+    // Keep the benchmark log out of the user's real log
+    QStandardPaths::setTestModeEnabled( true );
+    Logger::setupLogLevel( Logger::LOGERROR );
+    QVERIFY( m_tempDir.isValid() );
+
+    (void)new Calamares::JobQueue( this );
+    (void)new CalamaresUtils::System( false, this );
+}
+
+void
+LibCalamaresBenchmarks::benchGSInsert_data()
+{
+    QTest::addColumn< int >( "count" );
+    QTest::newRow( "10" ) << 10;
+    QTest::newRow( "1000" ) << 1000;
+}
+
+void
+LibCalamaresBenchmarks::benchGSInsert()
+{
+    QFETCH( int, count );
+    const QVariantMap m = sampleMap( count );
+    QBENCHMARK
+    {
+        Calamares::GlobalStorage gs;
+        for ( auto it = m.cbegin(); it != m.cend(); ++it )
+        {
+            gs.insert( it.key(), it.value() );
+        }
+    }
+}
+
+void
+LibCalamaresBenchmarks::benchGSValue()
+{
+    Calamares::GlobalStorage gs;
+    const QVariantMap m = sampleMap( 1000 );
+    for ( auto it = m.cbegin(); it != m.cend(); ++it )
+    {
+        gs.insert( it.key(), it.value() );
+    }
+    QBENCHMARK
+    {
+        for ( auto it = m.cbegin(); it != m.cend(); ++it )
+        {
+            (void)gs.value( it.key() );
+        }
+    }
+}
+
+void
+LibCalamaresBenchmarks::benchGSData()
+{
+    Calamares::GlobalStorage gs;
+    const QVariantMap m = sampleMap( 1000 );
+    for ( auto it = m.cbegin(); it != m.cend(); ++it )
+    {
+        gs.insert( it.key(), it.value() );
+    }
+    QBENCHMARK
+    {
+        (void)gs.data().count();
+    }
+}
+
+void
+LibCalamaresBenchmarks::benchYamlToVariant()
+{
+    const QString filename = m_tempDir.filePath( "to-variant.yaml" );
+    QVERIFY( CalamaresUtils::saveYaml( filename, sampleMap( 1000 ) ) );
+    QFile f( filename );
+    QVERIFY( f.open( QIODevice::ReadOnly ) );
+    const YAML::Node doc = YAML::Load( f.readAll().constData() );
+    QBENCHMARK
+    {
+        (void)CalamaresUtils::yamlToVariant( doc );
+    }
+}
+
+void
+LibCalamaresBenchmarks::benchSaveYaml()
+{
+    const QString filename = m_tempDir.filePath( "save.yaml" );
+    const QVariantMap m = sampleMap( 1000 );
+    QBENCHMARK
+    {
+        QVERIFY( CalamaresUtils::saveYaml( filename, m ) );
+    }
+}
+
+void
+LibCalamaresBenchmarks::benchLogger()
+{
+    Logger::setupLogfile();
+    Logger::setupLogLevel( Logger::LOGVERBOSE );
+    const QVariantMap m = sampleMap( 4 );
+    QBENCHMARK
+    {
+        for ( int i = 0; i < 1000; ++i )
+        {
+            cDebug() << "Benchmark line" << i << m;
+        }
+    }
+    Logger::setupLogLevel( Logger::LOGERROR );
+}
+
+void
+LibCalamaresBenchmarks::benchRunnerSpawn()
+{
+    QBENCHMARK
+    {
+        auto r = Calamares::Utils::Runner( { "true" } ).run();
+        QCOMPARE( r.getExitCode(), 0 );
+    }
+}
+
+void
+LibCalamaresBenchmarks::benchCommandListSpawn()
+{
+    CalamaresUtils::CommandList commands( QVariantList { "true", "true", "true", "true" }, false );
+    QCOMPARE( commands.count(), 4 );
+    QBENCHMARK
+    {
+        QVERIFY( bool( commands.run() ) );
+    }
+}
+
+void
+LibCalamaresBenchmarks::benchZonesFindByName()
+{
+    const CalamaresUtils::Locale::ZonesModel zones;
+    QBENCHMARK
+    {
+        QVERIFY( zones.find( "Europe", "Amsterdam" ) );
+        QVERIFY( zones.find( "America", "New_York" ) );
+        QVERIFY( !zones.find( "Europe", "Nowhere" ) );
+    }
+}
+
+void
+LibCalamaresBenchmarks::benchZonesFindByLocation()
+{
+    const CalamaresUtils::Locale::ZonesModel zones;
+    QBENCHMARK
+    {
+        QVERIFY( zones.find( 52.37, 4.90 ) );
+        QVERIFY( zones.find( -33.87, 151.21 ) );
+    }
+}
+
+#ifdef WITH_PYTHON
+void
+LibCalamaresBenchmarks::benchVariantToPyObject()
+{
+    if ( !Py_IsInitialized() )
+    {
+        Py_Initialize();
+    }
+    const QVariant v = sampleMap( 1000 );
+    QBENCHMARK
+    {
+        (void)CalamaresPython::variantToPyObject( v );
+    }
+}
+#endif
+
+QTEST_GUILESS_MAIN( LibCalamaresBenchmarks )
+
+#include "utils/moc-warnings.h"
+
+#include "Benchmarks.moc"
@@ -18,6 +18,7 @@
 #include <QFile>
 #include <QJsonDocument>
 #include <QMutexLocker>
+#include <QSaveFile>
 
 using namespace CalamaresUtils::Units;
 
@@ -115,15 +116,15 @@ bool
 GlobalStorage::saveJson( const QString& filename ) const
 {
     ReadLock l( this );
-    QFile f( filename );
-    if ( !f.open( QFile::WriteOnly ) )
+    QSaveFile f( filename );
+    // The permissions apply to the temporary file, so the contents
+    // are never readable by others, not even briefly.
+    if ( !f.open( QFile::WriteOnly ) || !f.setPermissions( QFile::ReadOwner | QFile::WriteOwner ) )
     {
         return false;
     }
 
-    f.write( QJsonDocument::fromVariant( m ).toJson() );
-    f.close();
-    return true;
+    return f.write( QJsonDocument::fromVariant( m ).toJson() ) >= 0 && f.commit();
 }
 
 bool
@@ -86,7 +86,7 @@ public:
      * No tidying, sanitization, or censoring is done -- for instance,
      * the user module sets a slightly-obscured password in global storage,
      * and this JSON file will contain that password in-the-only-slightly-
-     * obscured form.
+     * obscured form. The file is created readable only by its owner.
      */
     bool saveJson( const QString& filename ) const;
 
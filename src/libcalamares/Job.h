@@ -136,6 +136,16 @@ public:
     bool isEmergency() const { return m_emergency; }
     void setEmergency( bool e ) { m_emergency = e; }
 
+    /** @brief Does the job run again when resuming from a checkpoint?
+     *
+     * When the JobQueue resumes an installation, jobs that completed
+     * before are skipped, except for jobs like this one that set up
+     * state outside of GlobalStorage and the target system -- for
+     * instance, mounting the target system.
+     */
+    bool isRerunOnResume() const { return m_rerunOnResume; }
+    void setRerunOnResume( bool r ) { m_rerunOnResume = r; }
+
 signals:
     /** @brief Signals that the job has made progress
      *
@@ -146,6 +156,7 @@ signals:
 
 private:
     bool m_emergency = false;
+    bool m_rerunOnResume = false;
 };
 
 using job_ptr = QSharedPointer< Job >;
@@ -15,8 +15,13 @@
 #include "Job.h"
 #include "utils/Logger.h"
 
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QMutex>
 #include <QMutexLocker>
+#include <QSaveFile>
 #include <QThread>
 
 #include <memory>
@@ -24,6 +29,13 @@
 namespace Calamares
 {
 
+/// @brief Where the GlobalStorage snapshot goes, for checkpoint @p filename
+static QString
+checkpointGlobalsFile( const QString& filename )
+{
+    return filename + QStringLiteral( "-globals" );
+}
+
 struct WeightedJob
 {
     /** @brief Cumulative weight **before** this job starts
@@ -42,6 +54,7 @@ struct WeightedJob
     qreal weight = 0.0;
 
     job_ptr job;
+    QString source;  ///< Where the job came from (e.g. module instance key)
 };
 using WeightedJobList = QList< WeightedJob >;
 
@@ -81,7 +94,7 @@ public:
         }
     }
 
-    void enqueue( int moduleWeight, const JobList& jobs )
+    void enqueue( int moduleWeight, const JobList& jobs, const QString& source )
     {
         QMutexLocker qlock( &m_enqueMutex );
 
@@ -100,7 +113,7 @@ public:
         for ( const auto& j : jobs )
         {
             qreal jobContribution = ( j->getJobWeight() / totalJobWeight ) * moduleWeight;
-            m_queuedJobs->append( WeightedJob { cumulative, jobContribution, j } );
+            m_queuedJobs->append( WeightedJob { cumulative, jobContribution, j, source } );
             cumulative += jobContribution;
         }
     }
@@ -120,6 +133,11 @@ public:
             {
                 cDebug() << o << "Skipping non-emergency job" << jobitem.job->prettyName();
             }
+            else if ( m_jobIndex < m_resumeIndex && !jobitem.job->isRerunOnResume() )
+            {
+                cDebug() << o << "Skipping job completed before checkpoint" << jobitem.job->prettyName();
+                emitProgress( 1.0 );
+            }
             else
             {
                 cDebug() << o << "Starting" << ( failureEncountered ? "EMERGENCY JOB" : "job" )
@@ -140,6 +158,10 @@ public:
                 emitProgress( 1.0 );  // 100% for *this job*
             }
             m_jobIndex++;
+            if ( !failureEncountered && m_jobIndex > m_resumeIndex )
+            {
+                saveCheckpoint();
+            }
         }
         if ( failureEncountered )
         {
@@ -151,9 +173,30 @@ public:
             emitProgress( 1.0 );
         }
         m_runningJobs->clear();
+        m_resumeIndex = 0;
         QMetaObject::invokeMethod( m_queue, "finish", Qt::QueuedConnection );
     }
 
+    void setCheckpointFile( const QString& filename ) { m_checkpointFile = filename; }
+    QString checkpointFile() const { return m_checkpointFile; }
+    /// @brief Skip the first @p index jobs (unless they re-run on resume)
+    void setResumeIndex( int index ) { m_resumeIndex = index; }
+
+    /** @brief The sources of the jobs that are about to run
+     *
+     * Call this only after finalize() and before the thread starts.
+     */
+    QStringList runningSources() const
+    {
+        QStringList l;
+        l.reserve( m_runningJobs->count() );
+        for ( const auto& j : *m_runningJobs )
+        {
+            l << j.source;
+        }
+        return l;
+    }
+
     /** @brief The names of the queued (not running!) jobs.
      */
     QStringList queuedJobs() const
@@ -169,6 +212,41 @@ public:
     }
 
 private:
+    /* This is called **only** from run(), after job number m_jobIndex
+     * is done. GlobalStorage is written first, so that the checkpoint
+     * never claims more progress than the snapshot reflects.
+     */
+    void saveCheckpoint() const
+    {
+        if ( m_checkpointFile.isEmpty() )
+        {
+            return;
+        }
+
+        const QString globalsFile = checkpointGlobalsFile( m_checkpointFile );
+        if ( !m_queue->globalStorage()->saveJson( globalsFile ) )
+        {
+            cWarning() << "Could not save checkpoint globals to" << globalsFile;
+            return;
+        }
+
+        QJsonArray jobs;
+        for ( const auto& j : *m_runningJobs )
+        {
+            jobs.append( QJsonObject { { "source", j.source }, { "name", j.job->prettyName() } } );
+        }
+        QJsonObject checkpoint { { "completed", m_jobIndex }, { "jobs", jobs } };
+
+        // Private from the start: the permissions apply to the temporary file
+        QSaveFile f( m_checkpointFile );
+        if ( !f.open( QIODevice::WriteOnly ) || !f.setPermissions( QFile::ReadOwner | QFile::WriteOwner )
+             || f.write( QJsonDocument( checkpoint ).toJson() ) < 0 || !f.commit() )
+        {
+            cWarning() << "Could not save checkpoint to" << m_checkpointFile;
+            return;
+        }
+    }
+
     /* This is called **only** from run(), while m_runMutex is
      * already locked, so we can use the m_runningJobs member safely.
      */
@@ -213,7 +291,9 @@ private:
 
     JobQueue* m_queue;
     int m_jobIndex = 0;  ///< Index into m_runningJobs
+    int m_resumeIndex = 0;  ///< Jobs before this one were completed before a checkpoint
     qreal m_overallQueueWeight = 0.0;  ///< cumulation when **all** the jobs are done
+    QString m_checkpointFile;
 };
 
 JobThread::~JobThread() {}
@@ -264,19 +344,72 @@ JobQueue::start()
 {
     Q_ASSERT( !m_thread->isRunning() );
     m_thread->finalize();
+    m_thread->setResumeIndex( m_resume ? loadCheckpoint() : 0 );
+    m_resume = false;  // Only the first run resumes
     m_finished = false;
     m_thread->start();
 }
 
 
 void
-JobQueue::enqueue( int moduleWeight, const JobList& jobs )
+JobQueue::enqueue( int moduleWeight, const JobList& jobs, const QString& source )
 {
     Q_ASSERT( !m_thread->isRunning() );
-    m_thread->enqueue( moduleWeight, jobs );
+    m_thread->enqueue( moduleWeight, jobs, source );
     emit queueChanged( m_thread->queuedJobs() );
 }
 
+void
+JobQueue::setCheckpoint( const QString& filename, bool resume )
+{
+    Q_ASSERT( !m_thread->isRunning() );
+    m_thread->setCheckpointFile( filename );
+    m_resume = resume && !filename.isEmpty();
+}
+
+int
+JobQueue::loadCheckpoint()
+{
+    const QString filename = m_thread->checkpointFile();
+    QFile f( filename );
+    if ( !f.open( QIODevice::ReadOnly ) )
+    {
+        cWarning() << "No checkpoint to resume from in" << filename;
+        return 0;
+    }
+
+    QJsonParseError e;
+    const QJsonDocument d = QJsonDocument::fromJson( f.readAll(), &e );
+    if ( !d.isObject() )
+    {
+        cWarning() << "Checkpoint" << filename << "is not suitable JSON" << e.errorString();
+        return 0;
+    }
+
+    const QJsonObject checkpoint = d.object();
+    const QJsonArray jobs = checkpoint.value( "jobs" ).toArray();
+    const QStringList sources = m_thread->runningSources();
+    const int completed = checkpoint.value( "completed" ).toInt();
+    bool same = jobs.count() == sources.count() && completed > 0 && completed <= sources.count();
+    for ( int i = 0; same && i < jobs.count(); ++i )
+    {
+        same = jobs.at( i ).toObject().value( "source" ).toString() == sources.at( i );
+    }
+    if ( !same )
+    {
+        cWarning() << "Checkpoint" << filename << "does not match the queued jobs, not resuming.";
+        return 0;
+    }
+
+    if ( !m_storage->loadJson( checkpointGlobalsFile( filename ) ) )
+    {
+        cWarning() << "Could not restore checkpoint globals, not resuming.";
+        return 0;
+    }
+    cDebug() << "Resuming from checkpoint" << filename << "after" << completed << "of" << sources.count() << "jobs";
+    return completed;
+}
+
 void
 JobQueue::finish()
 {
@@ -49,9 +49,29 @@ public:
     /** @brief Queues up jobs from a single module source
      *
      * The total weight of the jobs is spread out to fill the weight
-     * of the module.
+     * of the module. The @p source (e.g. the module instance key)
+     * identifies where the jobs come from in a checkpoint.
      */
-    void enqueue( int moduleWeight, const JobList& jobs );
+    void enqueue( int moduleWeight, const JobList& jobs, const QString& source = QString() );
+    /** @brief Keeps a checkpoint of the queue's progress in @p filename
+     *
+     * After each job that completes successfully, the queue writes
+     * a snapshot of GlobalStorage (see GlobalStorage::saveJson(), the
+     * snapshot goes to @p filename with "-globals" added to the name)
+     * and then the number of completed jobs and their sources to
+     * the JSON file @p filename. Both files are readable by the owner only,
+     * since GlobalStorage may contain (obscured) passwords.
+     *
+     * If @p resume is @c true, then start() reads the checkpoint first.
+     * If the queued jobs come from the same sources as those in the
+     * checkpoint, GlobalStorage is restored from the snapshot and the
+     * completed jobs are skipped -- except those that must re-run
+     * (see Job::isRerunOnResume()), like mounting the target system.
+     *
+     * Call this before start(); an empty @p filename switches
+     * checkpoints off.
+     */
+    void setCheckpoint( const QString& filename, bool resume = false );
     /** @brief Starts all the jobs that are enqueued.
      *
      * After this, isRunning() returns @c true until
@@ -103,9 +123,13 @@ public slots:
 private:
     static JobQueue* s_instance;
 
+    /// @brief Restores from the checkpoint, returns the number of jobs to skip
+    int loadCheckpoint();
+
     JobThread* m_thread;
     GlobalStorage* m_storage;
     bool m_finished = true;  ///< Initially, not running
+    bool m_resume = false;
 };
 
 }  // namespace Calamares
@@ -29,6 +29,7 @@ namespace bp = boost::python;
 #endif
 
 BOOST_PYTHON_FUNCTION_OVERLOADS( mount_overloads, CalamaresPython::mount, 2, 4 );
+BOOST_PYTHON_FUNCTION_OVERLOADS( create_swapfile_overloads, CalamaresPython::create_swapfile, 2, 3 );
 BOOST_PYTHON_FUNCTION_OVERLOADS( target_env_call_str_overloads, CalamaresPython::target_env_call, 1, 3 );
 BOOST_PYTHON_FUNCTION_OVERLOADS( target_env_call_list_overloads, CalamaresPython::target_env_call, 1, 3 );
 BOOST_PYTHON_FUNCTION_OVERLOADS( check_target_env_call_str_overloads, CalamaresPython::check_target_env_call, 1, 3 );
@@ -115,6 +116,14 @@ BOOST_PYTHON_MODULE( libcalamares )
                               "-1 = QProcess crash\n"
                               "-2 = QProcess cannot start\n"
                               "-3 = bad arguments" ) );
+    bp::def( "create_swapfile",
+             &CalamaresPython::create_swapfile,
+             create_swapfile_overloads( bp::args( "path", "size", "callback" ),
+                                        "Creates a swapfile of @p size bytes at @p path, ready for swapon.\n"
+                                        "Space is preallocated where possible; on btrfs, copy-on-write "
+                                        "and compression are switched off for the file. The optional "
+                                        "callback is called with the fraction done (at most once per "
+                                        "percent). Returns True on success." ) );
 
     // .. Process functions
     bp::def(
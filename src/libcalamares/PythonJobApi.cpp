@@ -14,6 +14,7 @@
 #include "JobQueue.h"
 #include "PythonHelper.h"
 #include "partition/Mount.h"
+#include "partition/Swap.h"
 #include "utils/CalamaresUtilsSystem.h"
 #include "utils/Logger.h"
 #include "utils/RAII.h"
@@ -60,13 +61,39 @@ bp_list_to_qstringlist( const bp::list& args )
     return list;
 }
 
+/** @brief Releases the Python GIL for as long as this object exists
+ *
+ * Other Python threads can run in the meantime, so nothing may use
+ * Python until the object is destroyed. The thread state is restored
+ * on destruction, so also when the code in between throws.
+ */
+class ReleasedPythonLock
+{
+public:
+    ReleasedPythonLock()
+        : m_threadState( PyEval_SaveThread() )
+    {
+    }
+    ~ReleasedPythonLock() { PyEval_RestoreThread( m_threadState ); }
+
+    ReleasedPythonLock( const ReleasedPythonLock& ) = delete;
+    ReleasedPythonLock& operator=( const ReleasedPythonLock& ) = delete;
+
+private:
+    PyThreadState* m_threadState;
+};
+
 static inline CalamaresUtils::ProcessResult
 target_env_command( const QStringList& args, const std::string& input, int timeout )
 {
+    const QString stdInput = QString::fromStdString( input );
+    // Nothing below uses Python, so other Python threads (e.g. running
+    // commands of their own) can go on while the command runs.
+    ReleasedPythonLock unlocked;
     // Since Python doesn't give us the type system for distinguishing
     // seconds from other integral types, massage to seconds here.
     return CalamaresUtils::System::instance()->targetEnvCommand(
-        args, QString(), QString::fromStdString( input ), std::chrono::seconds( timeout ) );
+        args, QString(), stdInput, std::chrono::seconds( timeout ) );
 }
 
 namespace CalamaresPython
@@ -84,6 +111,17 @@ mount( const std::string& device_path,
                                              QString::fromStdString( options ) );
 }
 
+bool
+create_swapfile( const std::string& path, long long size, const boost::python::object& callback )
+{
+    std::function< void( double ) > progress;
+    if ( !callback.is_none() )
+    {
+        progress = [ &callback ]( double fraction ) { callback( fraction ); };
+    }
+    return CalamaresUtils::Partition::createSwapFile( QString::fromStdString( path ), size, progress );
+}
+
 int
 target_env_call( const std::string& command, const std::string& input, int timeout )
 {
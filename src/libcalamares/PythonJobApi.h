@@ -28,6 +28,10 @@ int mount( const std::string& device_path,
            const std::string& filesystem_name = std::string(),
            const std::string& options = std::string() );
 
+bool create_swapfile( const std::string& path,
+                      long long size,
+                      const boost::python::object& callback = boost::python::object() );
+
 int target_env_call( const std::string& command, const std::string& input = std::string(), int timeout = 0 );
 
 int target_env_call( const boost::python::list& args, const std::string& input = std::string(), int timeout = 0 );
@@ -0,0 +1,92 @@
+/* === This file is part of Calamares - <https://calamares.io> ===
+ *
+ *   SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *   SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ *   Calamares is Free Software: see the License-Identifier above.
+ *
+ */
+
+#include "JobQueue.h"
+#include "PythonHelper.h"
+#include "PythonJob.h"
+#include "utils/CalamaresUtilsSystem.h"
+#include "utils/Logger.h"
+
+#include <QTemporaryDir>
+#include <QtTest/QtTest>
+
+// Defined by BOOST_PYTHON_MODULE in PythonJob.cpp
+extern "C" PyObject* PyInit_libcalamares();
+
+class PythonTests : public QObject
+{
+    Q_OBJECT
+public:
+    PythonTests() {}
+    ~PythonTests() override {}
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void testCommandsOverlap();
+};
+
+void
+PythonTests::initTestCase()
+{
+    Logger::setupLogLevel( Logger::LOGDEBUG );
+    // Wherever the test runs, the module is there
+    if ( !Py_IsInitialized() )
+    {
+        QCOMPARE( PyImport_AppendInittab( "libcalamares", &PyInit_libcalamares ), 0 );
+    }
+}
+
+void
+PythonTests::testCommandsOverlap()
+{
+    Calamares::JobQueue queue;
+    CalamaresUtils::System system( false );  // Commands run on the host
+
+    QTemporaryDir dir;
+    QVERIFY( dir.isValid() );
+    {
+        QFile f( dir.filePath( "main.py" ) );
+        QVERIFY( f.open( QIODevice::WriteOnly ) );
+        f.write( R"(
+import threading
+import time
+import libcalamares
+
+def run():
+    spans = []
+    def command():
+        start = time.monotonic()
+        libcalamares.utils.target_env_call(["sleep", "1"])
+        spans.append((start, time.monotonic()))
+    threads = [threading.Thread(target=command) for _ in range(2)]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    if len(spans) != 2:
+        return ("Commands failed", str(spans))
+    (s1, e1), (s2, e2) = spans
+    # With the GIL held, the second command starts after the first ends
+    if max(s1, s2) >= min(e1, e2):
+        return ("Commands did not overlap", str(spans))
+    return None
+)" );
+    }
+
+    Calamares::PythonJob job( QStringLiteral( "main.py" ), dir.path() );
+    const auto result = job.exec();
+    QVERIFY2( bool( result ), qPrintable( result.message() + ' ' + result.details() ) );
+}
+
+QTEST_GUILESS_MAIN( PythonTests )
+
+#include "utils/moc-warnings.h"
+
+#include "PythonTests.moc"
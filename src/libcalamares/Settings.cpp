@@ -14,6 +14,7 @@
 #include "Settings.h"
 
 #include "CalamaresConfig.h"
+#include "utils/ConfigCache.h"
 #include "utils/Dirs.h"
 #include "utils/Logger.h"
 #include "utils/Yaml.h"
@@ -111,8 +112,16 @@ Settings::instance()
     return s_instance;
 }
 
+/** @brief Interprets the module-search entries @p rawPaths into @p output
+ *
+ * Every directory that is looked at is added to @p considered,
+ * since the result depends on which of them exist.
+ */
 static void
-interpretModulesSearch( const bool debugMode, const QStringList& rawPaths, QStringList& output )
+interpretModulesSearch( const bool debugMode,
+                        const QStringList& rawPaths,
+                        QStringList& output,
+                        QStringList& considered )
 {
     for ( const auto& path : rawPaths )
     {
@@ -125,6 +134,7 @@ interpretModulesSearch( const bool debugMode, const QStringList& rawPaths, QStri
             {
                 QString buildDirModules
                     = QDir::current().absolutePath() + QDir::separator() + "src" + QDir::separator() + "modules";
+                considered.append( buildDirModules );
                 if ( QDir( buildDirModules ).exists() )
                 {
                     output.append( buildDirModules );
@@ -134,10 +144,12 @@ interpretModulesSearch( const bool debugMode, const QStringList& rawPaths, QStri
             // Install path is set in CalamaresAddPlugin.cmake
             output.append( CalamaresUtils::systemLibDir().absolutePath() + QDir::separator() + "calamares"
                            + QDir::separator() + "modules" );
+            considered.append( output.last() );
         }
         else
         {
             QDir d( path );
+            considered.append( d.absolutePath() );
             if ( d.exists() && d.isReadable() )
             {
                 output.append( d.absolutePath() );
@@ -150,6 +162,45 @@ interpretModulesSearch( const bool debugMode, const QStringList& rawPaths, QStri
     }
 }
 
+/** @brief Where the configuration files of @p instances are looked up
+ *
+ * This follows moduleConfigurationCandidates() in Module.cpp, but lists
+ * the directories rather than the files, so that a configuration file
+ * appearing in one of them is noticed as well.
+ */
+static QStringList
+instanceConfigurationPaths( const bool debugMode, const Settings::InstanceDescriptionList& instances )
+{
+    QStringList paths;
+    if ( CalamaresUtils::isAppDataDirOverridden() )
+    {
+        paths << CalamaresUtils::appDataDir().absoluteFilePath( QStringLiteral( "modules" ) );
+        return paths;
+    }
+
+    if ( debugMode )
+    {
+        paths << QDir().absoluteFilePath( QStringLiteral( "src/modules" ) );
+        for ( const auto& d : instances )
+        {
+            if ( d.configFileName().contains( '/' ) )
+            {
+                paths << QDir().absoluteFilePath( d.configFileName() );
+            }
+        }
+    }
+    if ( CalamaresUtils::haveExtraDirs() )
+    {
+        for ( const auto& s : CalamaresUtils::extraConfigDirs() )
+        {
+            paths << ( s + QStringLiteral( "modules" ) );
+        }
+    }
+    paths << QStringLiteral( "/etc/calamares/modules" );
+    paths << CalamaresUtils::appDataDir().absoluteFilePath( QStringLiteral( "modules" ) );
+    return paths;
+}
+
 static void
 interpretInstances( const YAML::Node& node, Settings::InstanceDescriptionList& customInstances )
 {
@@ -255,15 +306,39 @@ Settings::Settings( const QString& settingsFilePath, bool debugMode )
     , m_disableCancel( false )
     , m_disableCancelDuringExec( false )
 {
+    using CalamaresUtils::ConfigCache;
+
     cDebug() << "Using Calamares settings file at" << settingsFilePath;
-    QFile file( settingsFilePath );
-    if ( file.exists() && file.open( QFile::ReadOnly | QFile::Text ) )
+    // The module search path depends on debug mode and the current directory,
+    // and on the directories that exist; those are stored with the cache.
+    ConfigCache cache(
+        QStringLiteral( "settings" ), { settingsFilePath }, QVariantList { debugMode, QDir::currentPath() } );
+    QVariantMap cached;
+    const bool haveCache = cache.load( cached );
+    if ( haveCache && ConfigCache::mode() == ConfigCache::Mode::Use && setCacheData( cached ) )
     {
-        setConfiguration( file.readAll(), file.fileName() );
+        cDebug() << Logger::SubEntry << "Using cached settings" << cache.filePath();
     }
     else
     {
-        cWarning() << "Cannot read settings file" << file.fileName();
+        QFile file( settingsFilePath );
+        if ( file.exists() && file.open( QFile::ReadOnly | QFile::Text ) )
+        {
+            setConfiguration( file.readAll(), file.fileName() );
+            if ( isValid() )
+            {
+                const auto fresh = cacheData();
+                if ( haveCache && ConfigCache::mode() == ConfigCache::Mode::Verify )
+                {
+                    cache.verify( cached, fresh );
+                }
+                cache.store( fresh, m_cacheDependencies );
+            }
+        }
+        else
+        {
+            cWarning() << "Cannot read settings file" << file.fileName();
+        }
     }
 
     s_instance = this;
@@ -319,8 +394,10 @@ Settings::setConfiguration( const QByteArray& ba, const QString& explainName )
         YAML::Node config = YAML::Load( ba.constData() );
         Q_ASSERT( config.IsMap() );
 
-        interpretModulesSearch(
-            debugMode(), CalamaresUtils::yamlToStringList( config[ "modules-search" ] ), m_modulesSearchPaths );
+        interpretModulesSearch( debugMode(),
+                                CalamaresUtils::yamlToStringList( config[ "modules-search" ] ),
+                                m_modulesSearchPaths,
+                                m_cacheDependencies );
         interpretInstances( config[ "instances" ], m_moduleInstances );
         interpretSequence( config[ "sequence" ], m_modulesSequence );
 
@@ -334,6 +411,7 @@ Settings::setConfiguration( const QByteArray& ba, const QString& explainName )
         m_quitAtEnd = requireBool( config, "quit-at-end", false );
 
         reconcileInstancesAndSequence();
+        m_cacheDependencies << instanceConfigurationPaths( debugMode(), m_moduleInstances );
     }
     catch ( YAML::Exception& e )
     {
@@ -341,6 +419,108 @@ Settings::setConfiguration( const QByteArray& ba, const QString& explainName )
     }
 }
 
+QVariantMap
+Settings::cacheData() const
+{
+    QVariantList instances;
+    for ( const auto& d : m_moduleInstances )
+    {
+        QVariantMap m { { QStringLiteral( "module" ), d.key().module() },
+                        { QStringLiteral( "id" ), d.key().id() },
+                        { QStringLiteral( "config" ), d.configFileName() } };
+        if ( d.explicitWeight() )
+        {
+            m.insert( QStringLiteral( "weight" ), d.weight() );
+        }
+        instances.append( m );
+    }
+
+    QVariantList sequence;
+    for ( const auto& step : m_modulesSequence )
+    {
+        QStringList roster;
+        for ( const auto& instanceKey : step.second )
+        {
+            roster.append( instanceKey.toString() );
+        }
+        sequence.append( QVariantMap { { QStringLiteral( "show" ), step.first == ModuleSystem::Action::Show },
+                                       { QStringLiteral( "modules" ), roster } } );
+    }
+
+    return QVariantMap { { QStringLiteral( "modules-search" ), m_modulesSearchPaths },
+                         { QStringLiteral( "instances" ), instances },
+                         { QStringLiteral( "sequence" ), sequence },
+                         { QStringLiteral( "branding" ), m_brandingComponentName },
+                         { QStringLiteral( "prompt-install" ), m_promptInstall },
+                         { QStringLiteral( "do-chroot" ), m_doChroot },
+                         { QStringLiteral( "oem-setup" ), m_isSetupMode },
+                         { QStringLiteral( "disable-cancel" ), m_disableCancel },
+                         { QStringLiteral( "disable-cancel-during-exec" ), m_disableCancelDuringExec },
+                         { QStringLiteral( "hide-back-and-next-during-exec" ), m_hideBackAndNextDuringExec },
+                         { QStringLiteral( "quit-at-end" ), m_quitAtEnd } };
+}
+
+bool
+Settings::setCacheData( const QVariantMap& data )
+{
+    static const char* const flags[] = { "prompt-install",
+                                         "do-chroot",
+                                         "oem-setup",
+                                         "disable-cancel",
+                                         "disable-cancel-during-exec",
+                                         "hide-back-and-next-during-exec",
+                                         "quit-at-end" };
+    for ( const char* flag : flags )
+    {
+        if ( !data.contains( flag ) )
+        {
+            return false;
+        }
+    }
+
+    InstanceDescriptionList instances;
+    for ( const auto& v : data.value( "instances" ).toList() )
+    {
+        instances.append( InstanceDescription::fromSettings( v.toMap() ) );
+        if ( !instances.last().isValid() )
+        {
+            return false;
+        }
+    }
+
+    ModuleSequence sequence;
+    for ( const auto& v : data.value( "sequence" ).toList() )
+    {
+        const auto step = v.toMap();
+        ModuleSystem::InstanceKeyList roster;
+        for ( const auto& s : step.value( "modules" ).toStringList() )
+        {
+            roster.append( ModuleSystem::InstanceKey::fromString( s ) );
+        }
+        const auto action = step.value( "show" ).toBool() ? ModuleSystem::Action::Show : ModuleSystem::Action::Exec;
+        sequence.append( qMakePair( action, roster ) );
+    }
+
+    const QString branding = data.value( "branding" ).toString();
+    if ( branding.isEmpty() || sequence.isEmpty() )
+    {
+        return false;
+    }
+
+    m_modulesSearchPaths = data.value( "modules-search" ).toStringList();
+    m_moduleInstances = instances;
+    m_modulesSequence = sequence;
+    m_brandingComponentName = branding;
+    m_promptInstall = data.value( "prompt-install" ).toBool();
+    m_doChroot = data.value( "do-chroot" ).toBool();
+    m_isSetupMode = data.value( "oem-setup" ).toBool();
+    m_disableCancel = data.value( "disable-cancel" ).toBool();
+    m_disableCancelDuringExec = data.value( "disable-cancel-during-exec" ).toBool();
+    m_hideBackAndNextDuringExec = data.value( "hide-back-and-next-during-exec" ).toBool();
+    m_quitAtEnd = data.value( "quit-at-end" ).toBool();
+    return true;
+}
+
 QStringList
 Settings::modulesSearchPaths() const
 {
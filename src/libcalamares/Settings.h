@@ -20,6 +20,7 @@
 
 #include <QObject>
 #include <QStringList>
+#include <QVariantMap>
 
 
 namespace Calamares
@@ -178,6 +179,22 @@ public:
 private:
     static Settings* s_instance;
 
+    /// @brief The interpreted settings, for the cache
+    QVariantMap cacheData() const;
+    /** @brief Restore the settings from @p data made by cacheData()
+     *
+     * Returns @c false (and changes nothing) if the data is incomplete.
+     */
+    bool setCacheData( const QVariantMap& data );
+
+    /** @brief Directories (and files) the interpreted settings depend on
+     *
+     * These are the module-search directories that were looked at, whether
+     * they exist or not, and the places that instance configuration files
+     * are looked up. Only filled in when the settings file is parsed.
+     */
+    QStringList m_cacheDependencies;
+
     QStringList m_modulesSearchPaths;
 
     InstanceDescriptionList m_moduleInstances;
@@ -13,10 +13,12 @@
 #include "JobQueue.h"
 #include "Settings.h"
 #include "modulesystem/InstanceKey.h"
+#include "utils/ConfigCache.h"
 #include "utils/Logger.h"
 
 #include <QObject>
 #include <QSignalSpy>
+#include <QTemporaryDir>
 #include <QtTest/QtTest>
 
 class TestLibCalamares : public QObject
@@ -36,8 +38,10 @@ private Q_SLOTS:
     void testInstanceDescription();
 
     void testSettings();
+    void testSettingsCache();
 
     void testJobQueue();
+    void testJobQueueCheckpoint();
 };
 
 void
@@ -86,6 +90,7 @@ TestLibCalamares::testGSLoadSave()
     QCOMPARE( gs.count(), 3 );
 
     QVERIFY( gs.saveJson( jsonfilename ) );
+    QCOMPARE( QFile::permissions( jsonfilename ) & ( QFile::ReadOther | QFile::ReadGroup ), QFile::Permissions() );
     Calamares::GlobalStorage gs2;
     QCOMPARE( gs2.count(), 0 );
     QVERIFY( gs2.loadJson( jsonfilename ) );
@@ -510,6 +515,128 @@ DummyJob::exec()
 }
 
 
+void
+TestLibCalamares::testSettingsCache()
+{
+    using CalamaresUtils::ConfigCache;
+
+    QStandardPaths::setTestModeEnabled( true );
+    QTemporaryDir dir;
+    QVERIFY( dir.isValid() );
+    const QString path = dir.filePath( "settings.conf" );
+    {
+        QFile f( path );
+        QVERIFY( f.open( QIODevice::WriteOnly ) );
+        f.write( R"(---
+modules-search: [ local ]
+branding: default
+instances:
+    - module: welcome
+      id: hi
+      weight: 75
+sequence:
+    - show:
+        - welcome@hi
+        - summary
+    - exec:
+        - welcome@hi
+prompt-install: true
+)" );
+    }
+
+    const QString cacheFile = ConfigCache( QStringLiteral( "settings" ), {} ).filePath();
+    QFile::remove( cacheFile );
+    const int mismatches = ConfigCache::mismatchCount();
+
+    // Self-check: the second time, the cache is compared with the parsed settings
+    ConfigCache::setMode( ConfigCache::Mode::Verify );
+    {
+        Calamares::Settings s( path, true );
+        QVERIFY( s.isValid() );
+        QVERIFY( QFile::exists( cacheFile ) );
+    }
+    {
+        Calamares::Settings s( path, true );
+        QVERIFY( s.isValid() );
+        QCOMPARE( ConfigCache::mismatchCount(), mismatches );
+    }
+
+    // From the cache
+    ConfigCache::setMode( ConfigCache::Mode::Use );
+    {
+        Calamares::Settings s( path, true );
+        QVERIFY( s.isValid() );
+        QCOMPARE( s.brandingComponentName(), QStringLiteral( "default" ) );
+        QCOMPARE( s.moduleInstances().count(), 2 );
+        QCOMPARE( s.moduleInstances().first().weight(), 75 );
+        QCOMPARE( s.moduleInstances().last().configFileName(), QStringLiteral( "summary.conf" ) );
+        QCOMPARE( s.modulesSequence().count(), 2 );
+        QVERIFY( s.modulesSequence().first().first == Calamares::ModuleSystem::Action::Show );
+        QCOMPARE( s.modulesSequence().first().second.count(), 2 );
+        QVERIFY( s.modulesSequence().last().first == Calamares::ModuleSystem::Action::Exec );
+        QVERIFY( s.showPromptBeforeExecution() );
+        QVERIFY( !s.quitAtEnd() );
+        QVERIFY( !s.modulesSearchPaths().isEmpty() );
+    }
+
+    // Changed settings are parsed again
+    {
+        QFile f( path );
+        QVERIFY( f.open( QIODevice::Append ) );
+        f.write( "quit-at-end: true\n" );
+    }
+    {
+        Calamares::Settings s( path, true );
+        QVERIFY( s.quitAtEnd() );
+        QCOMPARE( s.moduleInstances().count(), 2 );
+    }
+
+    // The cache depends on debug-mode as well
+    {
+        Calamares::Settings s( path, false );
+        QVERIFY( s.quitAtEnd() );
+        QVERIFY( !s.debugMode() );
+    }
+    {
+        Calamares::Settings s( path, false );
+        QVERIFY( s.quitAtEnd() );
+        QCOMPARE( s.moduleInstances().count(), 2 );
+    }
+
+    // The module-search paths depend on which directories exist
+    const QString extraModules = dir.filePath( "modules" );
+    {
+        QFile f( path );
+        QVERIFY( f.open( QIODevice::WriteOnly | QIODevice::Truncate ) );
+        f.write( QStringLiteral( "---\nmodules-search: [ local, %1 ]\nbranding: default\n"
+                                 "sequence:\n    - show:\n        - welcome\n" )
+                     .arg( extraModules )
+                     .toUtf8() );
+    }
+    {
+        Calamares::Settings s( path, false );
+        QVERIFY( s.isValid() );
+        QVERIFY( !s.modulesSearchPaths().contains( extraModules ) );
+    }
+    QVERIFY( QDir( dir.path() ).mkdir( "modules" ) );
+    {
+        Calamares::Settings s( path, false );
+        QVERIFY( s.isValid() );
+        QVERIFY( s.modulesSearchPaths().contains( extraModules ) );
+    }
+
+    // The mode can be set by name (from the command-line)
+    QVERIFY( ConfigCache::setMode( QStringLiteral( "verify" ) ) );
+    QVERIFY( ConfigCache::mode() == ConfigCache::Mode::Verify );
+    QVERIFY( !ConfigCache::setMode( QStringLiteral( "sometimes" ) ) );
+    QVERIFY( ConfigCache::mode() == ConfigCache::Mode::Verify );
+    QVERIFY( ConfigCache::setMode( QStringLiteral( "Off" ) ) );
+    QVERIFY( ConfigCache::mode() == ConfigCache::Mode::Off );
+    ConfigCache::setMode( ConfigCache::Mode::Use );
+
+    QFile::remove( cacheFile );
+}
+
 void
 TestLibCalamares::testJobQueue()
 {
@@ -629,6 +756,65 @@ TestLibCalamares::testJobQueue()
     }
 }
 
+void
+TestLibCalamares::testJobQueueCheckpoint()
+{
+    QTemporaryDir tempRoot( QDir::tempPath() + QStringLiteral( "/test-job-XXXXXX" ) );
+    QVERIFY( tempRoot.isValid() );
+    const QString checkpoint = tempRoot.filePath( "checkpoint.json" );
+
+    // Run one job, with a checkpoint
+    {
+        Calamares::JobQueue q;
+        q.setCheckpoint( checkpoint );
+        q.globalStorage()->insert( "derp", 17 );
+        q.enqueue( 8, Calamares::JobList() << Calamares::job_ptr( new DummyJob( this ) ), "dummy@one" );
+
+        QEventLoop loop;
+        connect( &q, &Calamares::JobQueue::finished, &loop, &QEventLoop::quit );
+        QTimer::singleShot( MAX_TEST_DURATION, &loop, &QEventLoop::quit );
+        q.start();
+        loop.exec();
+        QVERIFY( !q.isRunning() );
+    }
+    QVERIFY( QFile::exists( checkpoint ) );
+    QCOMPARE( QFile::permissions( checkpoint ) & ( QFile::ReadOther | QFile::ReadGroup ), QFile::Permissions() );
+
+    // Same jobs: skips the job and restores GS
+    {
+        Calamares::JobQueue q;
+        q.setCheckpoint( checkpoint, true );
+        q.enqueue( 8, Calamares::JobList() << Calamares::job_ptr( new DummyJob( this ) ), "dummy@one" );
+        QSignalSpy spy_progress( &q, &Calamares::JobQueue::progress );
+
+        QEventLoop loop;
+        connect( &q, &Calamares::JobQueue::finished, &loop, &QEventLoop::quit );
+        QTimer::singleShot( MAX_TEST_DURATION, &loop, &QEventLoop::quit );
+        q.start();
+        loop.exec();
+        QVERIFY( q.globalStorage()->contains( "derp" ) );
+        QCOMPARE( q.globalStorage()->value( "derp" ).toInt(), 17 );
+        // 100% for the skipped job, 100% at queue end
+        QCOMPARE( spy_progress.count(), 2 );
+    }
+
+    // Different jobs: the checkpoint does not apply
+    {
+        Calamares::JobQueue q;
+        q.setCheckpoint( checkpoint, true );
+        q.enqueue( 8, Calamares::JobList() << Calamares::job_ptr( new DummyJob( this ) ), "dummy@two" );
+        QSignalSpy spy_progress( &q, &Calamares::JobQueue::progress );
+
+        QEventLoop loop;
+        connect( &q, &Calamares::JobQueue::finished, &loop, &QEventLoop::quit );
+        QTimer::singleShot( MAX_TEST_DURATION, &loop, &QEventLoop::quit );
+        q.start();
+        loop.exec();
+        QVERIFY( !q.globalStorage()->contains( "derp" ) );
+        QCOMPARE( spy_progress.count(), 5 );  // The job ran, see testJobQueue()
+    }
+}
+
 
 QTEST_GUILESS_MAIN( TestLibCalamares )
 
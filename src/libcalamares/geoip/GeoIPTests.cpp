@@ -18,8 +18,16 @@
 
 #include "network/Manager.h"
 
+#include <QElapsedTimer>
+#include <QSemaphore>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QThread>
+#include <QUrlQuery>
 #include <QtTest/QtTest>
 
+#include <atomic>
+
 QTEST_GUILESS_MAIN( GeoIPTests )
 
 using namespace CalamaresUtils::GeoIP;
@@ -31,6 +39,8 @@ GeoIPTests::~GeoIPTests() {}
 void
 GeoIPTests::initTestCase()
 {
+    // Lookups happen in other threads; the manager should live in this one
+    (void)CalamaresUtils::Network::Manager::instance();
 }
 
 static const char json_data_attribute[] = "{\"time_zone\":\"Europe/Amsterdam\"}";
@@ -264,3 +274,241 @@ GeoIPTests::testFixed()
         QCOMPARE( f.processReply( QByteArray( "derp" ) ), tz );
     }
 }
+
+/** @brief A local stand-in for GeoIP services
+ *
+ * Serves canned data on localhost: /json, /xml and /bad (which is
+ * no GeoIP data at all). A query like ?delay=500 delays the reply by
+ * that many milliseconds; other query items are ignored, so they can
+ * be used to make URLs distinct. The server has a thread of its own,
+ * since the lookups block the test's thread.
+ */
+class HttpStandIn : public QThread
+{
+public:
+    HttpStandIn()
+    {
+        start();
+        m_ready.acquire();
+    }
+    ~HttpStandIn() override
+    {
+        quit();
+        wait();
+    }
+
+    QString url( const QString& path, int delay = 0, const QString& tag = QString() ) const
+    {
+        return QStringLiteral( "http://127.0.0.1:%1/%2?delay=%3&tag=%4" )
+            .arg( m_port )
+            .arg( path )
+            .arg( delay )
+            .arg( tag );
+    }
+    /// @brief How many requests have been served
+    int requests() const { return m_requests; }
+
+protected:
+    void run() override
+    {
+        QTcpServer server;
+        server.listen( QHostAddress::LocalHost );
+        m_port = server.serverPort();
+        QObject::connect( &server, &QTcpServer::newConnection, &server, [ &server, this ]() {
+            while ( auto* socket = server.nextPendingConnection() )
+            {
+                QObject::connect( socket, &QTcpSocket::readyRead, socket, [ socket, this ]() { serve( socket ); } );
+                QObject::connect( socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater );
+            }
+        } );
+        m_ready.release();
+        exec();
+    }
+
+private:
+    void serve( QTcpSocket* socket )
+    {
+        const QByteArray request = socket->property( "request" ).toByteArray() + socket->readAll();
+        socket->setProperty( "request", request );
+        if ( !request.contains( "\r\n\r\n" ) )
+        {
+            return;
+        }
+
+        // GET /path?query HTTP/1.1
+        const QUrl url( QStringLiteral( "http://localhost" ) + QString::fromLatin1( request.split( ' ' ).value( 1 ) ) );
+        const int delay = QUrlQuery( url ).queryItemValue( QStringLiteral( "delay" ) ).toInt();
+        QByteArray body;
+        if ( url.path() == QStringLiteral( "/json" ) )
+        {
+            body = json_data_attribute;
+        }
+        else if ( url.path() == QStringLiteral( "/xml" ) )
+        {
+            body = xml_data_ubiquity;
+        }
+        else
+        {
+            body = "<html><body>Nothing to see here</body></html>";
+        }
+        m_requests++;
+
+        QTimer::singleShot( delay, socket, [ socket, body ]() {
+            socket->write( "HTTP/1.1 200 OK\r\nConnection: close\r\nContent-Length: "
+                           + QByteArray::number( body.length() ) + "\r\n\r\n" + body );
+            socket->disconnectFromHost();
+        } );
+    }
+
+    QSemaphore m_ready;
+    quint16 m_port = 0;
+    std::atomic< int > m_requests { 0 };
+};
+
+void
+GeoIPTests::testConfiguration()
+{
+    QVariantMap provider { { "style", "xml" }, { "url", "http://example.com/xml" }, { "selector", "" } };
+    QVariantMap bogus { { "style", "smoke-signals" }, { "url", "http://example.com/" }, { "selector", "" } };
+    QVariantMap map { { "style", "json" },
+                      { "url", "http://example.com/json" },
+                      { "selector", "tz" },
+                      { "timeout", 5 },
+                      { "providers", QVariantList { provider, bogus } } };
+
+    Handler h( map );
+    QVERIFY( h.isValid() );
+    QVERIFY( h.type() == Handler::Type::JSON );
+    QCOMPARE( h.url(), QStringLiteral( "http://example.com/json" ) );
+    QCOMPARE( h.selector(), QStringLiteral( "tz" ) );
+    QCOMPARE( h.timeout(), std::chrono::milliseconds( 5000 ) );
+#ifdef QT_XML_LIB
+    QCOMPARE( h.providers().count(), 2 );
+    QVERIFY( h.providers().last().type == Handler::Type::XML );
+#else
+    QCOMPARE( h.providers().count(), 1 );
+#endif
+
+    // A bogus first provider doesn't stop the others
+    map.insert( "style", "none" );
+    map.remove( "timeout" );
+    Handler h2( map );
+#ifdef QT_XML_LIB
+    QVERIFY( h2.isValid() );
+    QCOMPARE( h2.url(), QStringLiteral( "http://example.com/xml" ) );
+#endif
+    QCOMPARE( h2.timeout(), std::chrono::milliseconds( 10000 ) );
+
+    QVERIFY( !Handler( QVariantMap() ).isValid() );
+}
+
+void
+GeoIPTests::testProviders()
+{
+    HttpStandIn server;
+    Handler::clearCache();
+
+    // The first valid answer wins, even if a bad one comes sooner
+    Handler h( "json", server.url( "bad" ), QString() );
+    QVERIFY( !h.get().isValid() );
+
+    QVariantMap slow { { "style", "json" }, { "url", server.url( "json", 3000 ) }, { "selector", "" } };
+    QVariantMap quick { { "style", "json" }, { "url", server.url( "json", 100 ) }, { "selector", "" } };
+    QVariantMap map { { "style", "json" },
+                      { "url", server.url( "bad" ) },
+                      { "selector", "" },
+                      { "providers", QVariantList { slow, quick } } };
+    Handler many( map );
+    QCOMPARE( many.providers().count(), 3 );
+
+    QElapsedTimer timer;
+    timer.start();
+    const auto tz = many.get();
+    QCOMPARE( tz, RegionZonePair( QStringLiteral( "Europe" ), QStringLiteral( "Amsterdam" ) ) );
+    QVERIFY( timer.elapsed() < 2000 );
+
+#ifdef QT_XML_LIB
+    // Different styles, too
+    QVariantMap xml { { "style", "xml" }, { "url", server.url( "xml" ) }, { "selector", "" } };
+    QVariantMap mixed { { "style", "json" },
+                        { "url", server.url( "json", 2000, "mixed" ) },
+                        { "selector", "" },
+                        { "providers", QVariantList { xml } } };
+    timer.restart();
+    QCOMPARE( Handler( mixed ).get(), RegionZonePair( QStringLiteral( "Europe" ), QStringLiteral( "Amsterdam" ) ) );
+    QVERIFY( timer.elapsed() < 1500 );
+#endif
+}
+
+void
+GeoIPTests::testCache()
+{
+    HttpStandIn server;
+    Handler::clearCache();
+
+    Handler h( "json", server.url( "json" ), QString() );
+    QVERIFY( h.get().isValid() );
+    QCOMPARE( server.requests(), 1 );
+    QVERIFY( h.get().isValid() );
+    QCOMPARE( server.requests(), 1 );
+
+    // Another handler, and the raw data, come from the same reply
+    Handler other( "json", server.url( "json" ), QString() );
+    QCOMPARE( other.query().result(), h.get() );
+    QCOMPARE( other.getRaw(), QStringLiteral( "Europe/Amsterdam" ) );
+    QCOMPARE( server.requests(), 1 );
+
+    // A different URL is a different reply
+    QVERIFY( Handler( "json", server.url( "json", 0, "other" ), QString() ).get().isValid() );
+    QCOMPARE( server.requests(), 2 );
+
+    Handler::clearCache();
+    QVERIFY( h.get().isValid() );
+    QCOMPARE( server.requests(), 3 );
+
+    // Whatever the service said is cached, even if it isn't useful
+    Handler bad( "json", server.url( "nothing" ), QString() );
+    QVERIFY( !bad.get().isValid() );
+    QVERIFY( !bad.get().isValid() );
+    QCOMPARE( server.requests(), 4 );
+
+    // Failed requests are not cached
+    Handler unreachable( "json", QStringLiteral( "http://127.0.0.1:1/json" ), QString() );
+    unreachable.setTimeout( std::chrono::milliseconds( 2000 ) );
+    QVERIFY( !unreachable.get().isValid() );
+}
+
+void
+GeoIPTests::testConcurrentLookups()
+{
+    HttpStandIn server;
+    Handler::clearCache();
+
+    // Two modules asking at the same time share the request
+    Handler locale( "json", server.url( "json", 500 ), QString() );
+    Handler welcome( "json", server.url( "json", 500 ), QString() );
+    auto zone = locale.query();
+    auto raw = welcome.queryRaw();
+    QCOMPARE( zone.result(), RegionZonePair( QStringLiteral( "Europe" ), QStringLiteral( "Amsterdam" ) ) );
+    QCOMPARE( raw.result(), QStringLiteral( "Europe/Amsterdam" ) );
+    QCOMPARE( server.requests(), 1 );
+}
+
+void
+GeoIPTests::testDeadline()
+{
+    HttpStandIn server;
+    Handler::clearCache();
+
+    Handler h( "json", server.url( "json", 3000 ), QString() );
+    h.setTimeout( std::chrono::milliseconds( 300 ) );
+
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY( !h.get().isValid() );
+    QVERIFY( timer.elapsed() < 2000 );
+
+    timer.restart();
+    QVERIFY( !h.query().result().isValid() );
+    QVERIFY( timer.elapsed() < 2000 );
+}
@@ -32,6 +32,12 @@ private Q_SLOTS:
     void testSplitTZ();
 
     void testGet();
+
+    void testConfiguration();
+    void testProviders();
+    void testCache();
+    void testConcurrentLookups();
+    void testDeadline();
 };
 
 #endif
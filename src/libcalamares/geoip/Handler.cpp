@@ -21,6 +21,14 @@
 #include "utils/NamedEnum.h"
 #include "utils/Variant.h"
 
+#include <QDeadlineTimer>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QThreadPool>
+#include <QWaitCondition>
+
 #include <memory>
 
 static const NamedEnumTable< CalamaresUtils::GeoIP::Handler::Type >&
@@ -42,46 +50,171 @@ handlerTypes()
     return names;
 }
 
+/** @brief The replies from GeoIP services in this process
+ *
+ * Replies are kept for a while so that modules asking the same service
+ * (and repeated lookups) don't cause new network requests. While one
+ * thread is fetching a URL, others that want the same URL wait for it.
+ */
+struct ReplyCache
+{
+    struct Reply
+    {
+        QByteArray data;
+        QElapsedTimer age;
+    };
+
+    QMutex mutex;
+    QWaitCondition fetched;
+    QHash< QString, Reply > replies;
+    QSet< QString > inFlight;
+};
+
+static ReplyCache&
+replyCache()
+{
+    static ReplyCache cache;
+    return cache;
+}
+
+/// @brief Threads for the lookups, so they don't wait for the global pool
+static QThreadPool*
+lookupPool()
+{
+    static QThreadPool* pool = []() {
+        auto* p = new QThreadPool;
+        p->setMaxThreadCount( 8 );
+        return p;
+    }();
+    return pool;
+}
+
+static constexpr const std::chrono::minutes cacheLifetime( 10 );
+static constexpr const std::chrono::seconds defaultTimeout( 10 );
+
+/// @brief Milliseconds left until @p deadline, for QWaitCondition
+static unsigned long
+remaining( const QDeadlineTimer& deadline )
+{
+    return static_cast< unsigned long >( qMax( qint64( 0 ), deadline.remainingTime() ) );
+}
+
+static QByteArray
+fetch( const QString& url, const QDeadlineTimer& deadline )
+{
+    auto& cache = replyCache();
+    QMutexLocker lock( &cache.mutex );
+    while ( cache.inFlight.contains( url ) )
+    {
+        if ( deadline.hasExpired() || !cache.fetched.wait( &cache.mutex, remaining( deadline ) ) )
+        {
+            return QByteArray();
+        }
+    }
+
+    const auto it = cache.replies.constFind( url );
+    if ( it != cache.replies.constEnd()
+         && it->age.elapsed() < std::chrono::duration_cast< std::chrono::milliseconds >( cacheLifetime ).count() )
+    {
+        return it->data;
+    }
+
+    cache.inFlight.insert( url );
+    lock.unlock();
+
+    using namespace CalamaresUtils::Network;
+    const auto timeout = std::chrono::milliseconds( qMax( qint64( 1 ), deadline.remainingTime() ) );
+    const QByteArray data = Manager::instance().synchronousGet( url, { RequestOptions::FakeUserAgent, timeout } );
+
+    lock.relock();
+    cache.inFlight.remove( url );
+    if ( !data.isEmpty() )
+    {
+        ReplyCache::Reply reply { data, QElapsedTimer() };
+        reply.age.start();
+        cache.replies.insert( url, reply );
+    }
+    cache.fetched.wakeAll();
+    return data;
+}
+
 namespace CalamaresUtils
 {
 namespace GeoIP
 {
 
 Handler::Handler()
-    : m_type( Type::None )
+    : m_timeout( defaultTimeout )
 {
 }
 
 Handler::Handler( const QString& implementation, const QString& url, const QString& selector )
-    : m_type( Type::None )
-    , m_url( url )
-    , m_selector( selector )
+    : m_timeout( defaultTimeout )
+{
+    addProvider( implementation, url, selector );
+}
+
+Handler::Handler( const QVariantMap& configuration )
+    : m_timeout( defaultTimeout )
+{
+    addProvider( CalamaresUtils::getString( configuration, "style" ),
+                 CalamaresUtils::getString( configuration, "url" ),
+                 CalamaresUtils::getString( configuration, "selector" ) );
+    const auto providers = configuration.value( "providers" ).toList();
+    for ( const auto& v : providers )
+    {
+        const auto provider = v.toMap();
+        addProvider( CalamaresUtils::getString( provider, "style" ),
+                     CalamaresUtils::getString( provider, "url" ),
+                     CalamaresUtils::getString( provider, "selector" ) );
+    }
+
+    const auto timeout = CalamaresUtils::getInteger( configuration, "timeout", 0 );
+    if ( timeout > 0 )
+    {
+        m_timeout = std::chrono::seconds( timeout );
+    }
+}
+
+Handler::~Handler() {}
+
+void
+Handler::addProvider( const QString& implementation, const QString& url, const QString& selector )
 {
     bool ok = false;
-    m_type = handlerTypes().find( implementation, ok );
+    Type type = handlerTypes().find( implementation, ok );
     if ( !ok )
     {
         cWarning() << "GeoIP style" << implementation << "is not recognized.";
+        return;
     }
-    else if ( m_type == Type::None )
+    else if ( type == Type::None )
     {
         cWarning() << "GeoIP style *none* does not do anything.";
+        return;
     }
-    else if ( m_type == Type::Fixed && Calamares::Settings::instance()
+    else if ( type == Type::Fixed && Calamares::Settings::instance()
               && !Calamares::Settings::instance()->debugMode() )
     {
         cWarning() << "GeoIP style *fixed* is not recommended for production.";
     }
 #if !defined( QT_XML_LIB )
-    else if ( m_type == Type::XML )
+    else if ( type == Type::XML )
     {
-        m_type = Type::None;
         cWarning() << "GeoIP style *xml* is not supported in this version of Calamares.";
+        return;
     }
 #endif
+    m_providers.append( Provider { type, url, selector } );
 }
 
-Handler::~Handler() {}
+void
+Handler::clearCache()
+{
+    auto& cache = replyCache();
+    QMutexLocker lock( &cache.mutex );
+    cache.replies.clear();
+}
 
 static std::unique_ptr< Interface >
 create_interface( Handler::Type t, const QString& selector )
@@ -105,31 +238,88 @@ create_interface( Handler::Type t, const QString& selector )
 }
 
 static RegionZonePair
-do_query( Handler::Type type, const QString& url, const QString& selector )
+do_query( const Handler::Provider& provider, const QDeadlineTimer& deadline )
 {
-    const auto interface = create_interface( type, selector );
+    const auto interface = create_interface( provider.type, provider.selector );
     if ( !interface )
     {
         return RegionZonePair();
     }
 
-    using namespace CalamaresUtils::Network;
-    return interface->processReply(
-        CalamaresUtils::Network::Manager::instance().synchronousGet( url, { RequestOptions::FakeUserAgent } ) );
+    return interface->processReply( fetch( provider.url, deadline ) );
 }
 
 static QString
-do_raw_query( Handler::Type type, const QString& url, const QString& selector )
+do_raw_query( const Handler::Provider& provider, const QDeadlineTimer& deadline )
 {
-    const auto interface = create_interface( type, selector );
+    const auto interface = create_interface( provider.type, provider.selector );
     if ( !interface )
     {
         return QString();
     }
 
-    using namespace CalamaresUtils::Network;
-    return interface->rawReply(
-        CalamaresUtils::Network::Manager::instance().synchronousGet( url, { RequestOptions::FakeUserAgent } ) );
+    return interface->rawReply( fetch( provider.url, deadline ) );
+}
+
+static inline bool
+isUsable( const RegionZonePair& r )
+{
+    return r.isValid();
+}
+
+static inline bool
+isUsable( const QString& s )
+{
+    return !s.isEmpty();
+}
+
+/** @brief Ask all the @p providers at once, and return the first usable answer
+ *
+ * Returns a default-constructed (unusable) result if none of the providers
+ * gives a usable answer before the @p timeout. Providers that are still
+ * busy then finish in the background (their replies are still cached).
+ */
+template < typename T >
+static T
+ask_providers( const QVector< Handler::Provider >& providers,
+               std::chrono::milliseconds timeout,
+               T ( *ask )( const Handler::Provider&, const QDeadlineTimer& ) )
+{
+    struct Race
+    {
+        QMutex mutex;
+        QWaitCondition answered;
+        T result;
+        int outstanding = 0;
+    };
+
+    const QDeadlineTimer deadline( timeout.count() );
+    auto race = std::make_shared< Race >();
+    race->outstanding = providers.count();
+    for ( const auto& provider : providers )
+    {
+        QtConcurrent::run( lookupPool(), [race, provider, deadline, ask]() {
+            const T r = ask( provider, deadline );
+            QMutexLocker lock( &race->mutex );
+            race->outstanding--;
+            if ( isUsable( r ) && !isUsable( race->result ) )
+            {
+                race->result = r;
+            }
+            race->answered.wakeAll();
+        } );
+    }
+
+    QMutexLocker lock( &race->mutex );
+    while ( !isUsable( race->result ) && race->outstanding > 0 )
+    {
+        if ( deadline.hasExpired() || !race->answered.wait( &race->mutex, remaining( deadline ) ) )
+        {
+            cWarning() << "GeoIP lookup did not finish within" << timeout.count() << "ms.";
+            break;
+        }
+    }
+    return race->result;
 }
 
 RegionZonePair
@@ -139,18 +329,17 @@ Handler::get() const
     {
         return RegionZonePair();
     }
-    return do_query( m_type, m_url, m_selector );
+    return ask_providers( m_providers, m_timeout, do_query );
 }
 
 
 QFuture< RegionZonePair >
 Handler::query() const
 {
-    Handler::Type type = m_type;
-    QString url = m_url;
-    QString selector = m_selector;
+    const auto providers = m_providers;
+    const auto timeout = m_timeout;
 
-    return QtConcurrent::run( [=] { return do_query( type, url, selector ); } );
+    return QtConcurrent::run( [=] { return ask_providers( providers, timeout, do_query ); } );
 }
 
 QString
@@ -160,18 +349,17 @@ Handler::getRaw() const
     {
         return QString();
     }
-    return do_raw_query( m_type, m_url, m_selector );
+    return ask_providers( m_providers, m_timeout, do_raw_query );
 }
 
 
 QFuture< QString >
 Handler::queryRaw() const
 {
-    Handler::Type type = m_type;
-    QString url = m_url;
-    QString selector = m_selector;
+    const auto providers = m_providers;
+    const auto timeout = m_timeout;
 
-    return QtConcurrent::run( [=] { return do_raw_query( type, url, selector ); } );
+    return QtConcurrent::run( [=] { return ask_providers( providers, timeout, do_raw_query ); } );
 }
 
 }  // namespace GeoIP
@@ -14,8 +14,11 @@
 
 #include <QString>
 #include <QVariantMap>
+#include <QVector>
 #include <QtConcurrent/QtConcurrentRun>
 
+#include <chrono>
+
 namespace CalamaresUtils
 {
 namespace GeoIP
@@ -28,6 +31,16 @@ namespace GeoIP
  * synchronous API and will return an invalid zone pair on
  * error or if the configuration is not understood. For an
  * async API, use query().
+ *
+ * A handler may have more than one provider (GeoIP service). They
+ * are all asked at the same time, and the first valid answer wins.
+ * The whole lookup is bounded by timeout(); when that runs out,
+ * the result is invalid and the caller should use its own default.
+ *
+ * Replies are cached for the whole process (for a few minutes), and
+ * concurrent lookups of the same URL share one request, so
+ * modules asking the same service (e.g. *welcome* and *locale*)
+ * cause only one network request.
  */
 class DLLEXPORT Handler
 {
@@ -40,6 +53,14 @@ public:
         Fixed  // Returns selector string verbatim
     };
 
+    /// @brief One GeoIP service
+    struct Provider
+    {
+        Type type;
+        QString url;
+        QString selector;
+    };
+
     /** @brief An unconfigured handler; this always returns errors. */
     Handler();
     /** @brief A handler for a specific GeoIP source.
@@ -49,6 +70,14 @@ public:
      * is used to select something from the data returned by the @url.
      */
     Handler( const QString& implementation, const QString& url, const QString& selector );
+    /** @brief A handler configured from a *geoip* map
+     *
+     * The map has keys *style*, *url* and *selector* for one provider,
+     * and optionally *providers*, a list of maps with those same keys
+     * for more providers. *timeout* is the deadline for the whole
+     * lookup, in seconds.
+     */
+    explicit Handler( const QVariantMap& configuration );
 
     ~Handler();
 
@@ -56,7 +85,7 @@ public:
      *
      * If the Handler is valid, then do the actual fetching and interpretation
      * of data and return the result. An invalid Handler will return an
-     * invalid (empty) result.
+     * invalid (empty) result, as does a lookup that takes too long.
      */
     RegionZonePair get() const;
     /// @brief Like get, but don't interpret the contents
@@ -70,15 +99,26 @@ public:
     /// @brief Like query, but don't interpret the contents
     QFuture< QString > queryRaw() const;
 
-    bool isValid() const { return m_type != Type::None; }
-    Type type() const { return m_type; }
-    QString url() const { return m_url; }
-    QString selector() const { return m_selector; }
+    bool isValid() const { return !m_providers.isEmpty(); }
+    /// @brief The type of the first provider
+    Type type() const { return isValid() ? m_providers.first().type : Type::None; }
+    /// @brief The URL of the first provider
+    QString url() const { return isValid() ? m_providers.first().url : QString(); }
+    /// @brief The selector of the first provider
+    QString selector() const { return isValid() ? m_providers.first().selector : QString(); }
+    QVector< Provider > providers() const { return m_providers; }
+
+    std::chrono::milliseconds timeout() const { return m_timeout; }
+    void setTimeout( std::chrono::milliseconds timeout ) { m_timeout = timeout; }
+
+    /// @brief Forget all the cached replies (e.g. for testing)
+    static void clearCache();
 
 private:
-    Type m_type;
-    const QString m_url;
-    const QString m_selector;
+    void addProvider( const QString& implementation, const QString& url, const QString& selector );
+
+    QVector< Provider > m_providers;
+    std::chrono::milliseconds m_timeout;
 };
 
 }  // namespace GeoIP
@@ -40,6 +40,9 @@ private Q_SLOTS:
     void testEsperanto();
     void testInterlingue();
 
+    // Switching languages
+    void testLanguageSwitch();
+
     // TimeZone testing
     void testRegions();
     void testSimpleZones();
@@ -274,6 +277,50 @@ LocaleTests::testTranslatableConfigContext()
 }
 
 
+void
+LocaleTests::testLanguageSwitch()
+{
+    // The calamares-i18n QRC is linked in, so these are the shipped catalogues
+    QVERIFY( QFile::exists( ":/lang/calamares_nl.qm" ) );
+
+    const QStringList languages = QString( CALAMARES_TRANSLATION_LANGUAGES ).split( ';' );
+    QVERIFY( languages.count() > 1 );
+    CalamaresUtils::installModuleTranslator( QStringLiteral( "tz_" ) );
+
+    // Twice around: the first time catalogues are looked up, then they are known
+    for ( int round = 0; round < 2; ++round )
+    {
+        QElapsedTimer timer;
+        qint64 slowest = 0;
+        QString slowestName;
+        timer.start();
+        for ( const auto& name : languages )
+        {
+            QElapsedTimer switchTimer;
+            switchTimer.start();
+            CalamaresUtils::installTranslator( { name }, QString() );
+            const auto elapsed = switchTimer.nsecsElapsed();
+            if ( elapsed > slowest )
+            {
+                slowest = elapsed;
+                slowestName = name;
+            }
+            QCOMPARE( CalamaresUtils::translatorLocaleName().name, name );
+        }
+        cDebug() << "Round" << round << languages.count() << "languages in" << timer.elapsed() << "ms, slowest"
+                 << slowestName << ( slowest / 1000 ) << "us";
+        // Very loose: a language switch is a lookup in mapped memory
+        QVERIFY( slowest < 250 * 1000 * 1000 );
+    }
+
+    // The timezone names follow the language
+    CalamaresUtils::installTranslator( { QStringLiteral( "nl" ) }, QString() );
+    QCOMPARE( QObject::tr( "Europe", "tz_regions" ), QStringLiteral( "Europa" ) );
+    CalamaresUtils::installTranslator( { QStringLiteral( "en" ) }, QString() );
+    QCOMPARE( QObject::tr( "Europe", "tz_regions" ), QStringLiteral( "Europe" ) );
+}
+
+
 void
 LocaleTests::testRegions()
 {
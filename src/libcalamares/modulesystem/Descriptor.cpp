@@ -85,11 +85,14 @@ Descriptor::fromDescriptorData( const QVariantMap& moduleDesc )
     }
 
     d.m_isEmergeny = CalamaresUtils::getBool( moduleDesc, "emergency", false );
+    d.m_isRerunOnResume = CalamaresUtils::getBool( moduleDesc, "rerunOnResume", false );
     d.m_hasConfig = !CalamaresUtils::getBool( moduleDesc, "noconfig", false );  // Inverted logic during load
     d.m_requiredModules = CalamaresUtils::getStringList( moduleDesc, "requiredModules" );
     d.m_weight = int( CalamaresUtils::getInteger( moduleDesc, "weight", -1 ) );
 
-    QStringList consumedKeys { "type", "interface", "name", "emergency", "noconfig", "requiredModules", "weight" };
+    QStringList consumedKeys {
+        "type", "interface", "name", "emergency", "noconfig", "requiredModules", "rerunOnResume", "weight"
+    };
 
     switch ( d.interface() )
     {
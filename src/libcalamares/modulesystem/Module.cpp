@@ -44,6 +44,7 @@ Module::initFrom( const Calamares::ModuleSystem::Descriptor& moduleDescriptor, c
     {
         m_maybe_emergency = true;
     }
+    m_rerunOnResume = moduleDescriptor.isRerunOnResume();
 }
 
 static QStringList
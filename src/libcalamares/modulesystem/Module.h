@@ -84,6 +84,13 @@ public:
      */
     bool isEmergency() const { return m_emergency; }
 
+    /**
+     * @brief Do the jobs of this module run again when resuming?
+     *
+     * See Job::isRerunOnResume(); this is set in the module.desc.
+     */
+    bool isRerunOnResume() const { return m_rerunOnResume; }
+
     /**
      * @brief isLoaded reports on the loaded status of a module.
      * @return true if the module's loading phase has finished, otherwise false.
@@ -151,6 +158,7 @@ protected:
     bool m_loaded = false;
     bool m_emergency = false;  // Based on module and local config
     bool m_maybe_emergency = false;  // Based on the module.desc
+    bool m_rerunOnResume = false;  // Based on the module.desc
 
 private:
     void loadConfigurationFile( const QString& configFileName );  //throws YAML::Exception
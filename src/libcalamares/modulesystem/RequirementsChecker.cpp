@@ -17,6 +17,7 @@
 
 #include <QFuture>
 #include <QFutureWatcher>
+#include <QMutexLocker>
 #include <QTimer>
 #include <QtConcurrent/QtConcurrent>
 
@@ -29,8 +30,6 @@ RequirementsChecker::RequirementsChecker( QVector< Module* > modules, Requiremen
     : QObject( parent )
     , m_modules( std::move( modules ) )
     , m_model( model )
-    , m_progressTimer( nullptr )
-    , m_progressTimeouts( 0 )
 {
     m_watchers.reserve( m_modules.count() );
     connect( this, &RequirementsChecker::requirementsProgress, model, &RequirementsModel::setProgressMessage );
@@ -41,9 +40,7 @@ RequirementsChecker::~RequirementsChecker() {}
 void
 RequirementsChecker::run()
 {
-    m_progressTimer = new QTimer( this );
-    connect( m_progressTimer, &QTimer::timeout, this, &RequirementsChecker::reportProgress );
-    m_progressTimer->start( 1200 );  // msec
+    m_elapsed.start();
 
     for ( const auto& module : m_modules )
     {
@@ -63,17 +60,18 @@ RequirementsChecker::finished()
     static QMutex finishedMutex;
     QMutexLocker lock( &finishedMutex );
 
-    if ( m_progressTimer && std::all_of( m_watchers.cbegin(), m_watchers.cend(), []( const Watcher* w ) {
-             return w && w->isFinished();
-         } ) )
+    if ( m_done )
+    {
+        return;
+    }
+    // Each module that completes updates the progress message; there's
+    // no need to poll for it.
+    reportProgress();
+    if ( std::all_of(
+             m_watchers.cbegin(), m_watchers.cend(), []( const Watcher* w ) { return w && w->isFinished(); } ) )
     {
         cDebug() << "All requirements have been checked.";
-        if ( m_progressTimer )
-        {
-            m_progressTimer->stop();
-            delete m_progressTimer;
-            m_progressTimer = nullptr;
-        }
+        m_done = true;
 
         m_model->describe();
         m_model->changeRequirementsList();
@@ -97,8 +95,6 @@ RequirementsChecker::addCheckedRequirements( Module* m )
 void
 RequirementsChecker::reportProgress()
 {
-    m_progressTimeouts++;
-
     QStringList remainingNames;
     auto remaining = std::count_if( m_watchers.cbegin(), m_watchers.cend(), [&]( const Watcher* w ) {
         if ( w && !w->isFinished() )
@@ -111,9 +107,8 @@ RequirementsChecker::reportProgress()
     if ( remaining > 0 )
     {
         cDebug() << "Remaining modules:" << remaining << Logger::DebugList( remainingNames );
-        unsigned int posInterval = ( m_progressTimer->interval() < 0 ) ? 1000 : uint( m_progressTimer->interval() );
         QString waiting = tr( "Waiting for %n module(s).", "", remaining );
-        QString elapsed = tr( "(%n second(s))", "", m_progressTimeouts * posInterval / 1000 );
+        QString elapsed = tr( "(%n second(s))", "", int( m_elapsed.elapsed() / 1000 ) );
         emit requirementsProgress( waiting + QString( " " ) + elapsed );
     }
     else
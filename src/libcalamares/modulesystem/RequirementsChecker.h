@@ -12,9 +12,9 @@
 
 #include "modulesystem/Requirement.h"
 
+#include <QElapsedTimer>
 #include <QFutureWatcher>
 #include <QObject>
-#include <QTimer>
 #include <QVector>
 
 namespace Calamares
@@ -46,7 +46,7 @@ public Q_SLOTS:
     /// @brief Called when all requirements have been checked
     void finished();
 
-    /// @brief Called periodically while requirements are being checked
+    /// @brief Called each time a module's requirements have been checked
     void reportProgress();
 
 signals:
@@ -63,8 +63,8 @@ private:
 
     RequirementsModel* m_model;
 
-    QTimer* m_progressTimer;
-    unsigned m_progressTimeouts;
+    QElapsedTimer m_elapsed;
+    bool m_done = false;
 };
 
 }  // namespace Calamares
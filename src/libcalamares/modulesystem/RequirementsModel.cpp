@@ -38,6 +38,22 @@ RequirementsModel::changeRequirementsList()
     emit satisfiedMandatoryChanged( m_satisfiedMandatory );
 }
 
+void
+RequirementsModel::updateRequirement( const Calamares::RequirementEntry& entry )
+{
+    QMutexLocker l( &m_addLock );
+    for ( int row = 0; row < m_requirements.count(); ++row )
+    {
+        if ( m_requirements.at( row ).name == entry.name )
+        {
+            m_requirements[ row ] = entry;
+            emit dataChanged( index( row ), index( row ) );
+            changeRequirementsList();
+            return;
+        }
+    }
+}
+
 int
 RequirementsModel::rowCount( const QModelIndex& ) const
 {
@@ -69,6 +69,14 @@ public:
     ///@brief Debugging tool, describe the checking-state
     void describe() const;
 
+    /** @brief Replace the requirement with the same name as @p entry
+     *
+     * This is used when a single requirement is checked again after
+     * the initial checks are done. Entries that are not already in
+     * the model are ignored.
+     */
+    void updateRequirement( const Calamares::RequirementEntry& entry );
+
 signals:
     void satisfiedRequirementsChanged( bool value );
     void satisfiedMandatoryChanged( bool value );
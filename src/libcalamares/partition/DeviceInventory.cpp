@@ -0,0 +1,297 @@
+/* === This file is part of Calamares - <https://calamares.io> ===
+ *
+ *   SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *   SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ *   Calamares is Free Software: see the License-Identifier above.
+ *
+ */
+
+#include "DeviceInventory.h"
+
+#include "utils/CalamaresUtilsSystem.h"
+#include "utils/Logger.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QThread>
+
+#include <algorithm>
+
+/// @brief sysfs always counts sizes in 512-byte sectors
+static constexpr const qint64 sysfsSectorSize = 512;
+
+/// @brief Contents of @p file in @p dir, trimmed; empty if it can't be read
+static QString
+readSysfsFile( const QDir& dir, const QString& file )
+{
+    QFile f( dir.filePath( file ) );
+    if ( !f.open( QIODevice::ReadOnly ) )
+    {
+        return QString();
+    }
+    return QString::fromUtf8( f.readAll() ).trimmed();
+}
+
+/** @brief The device node for a block device, from its uevent
+ *
+ * Kernel names can contain a '!' where the device node has a '/'
+ * (e.g. cciss!c0d0 is /dev/cciss/c0d0); the uevent has the real name.
+ */
+static QString
+devicePath( const QDir& dir, const QString& name )
+{
+    const auto lines = readSysfsFile( dir, QStringLiteral( "uevent" ) ).split( '\n' );
+    for ( const auto& line : lines )
+    {
+        if ( line.startsWith( QStringLiteral( "DEVNAME=" ) ) )
+        {
+            return QStringLiteral( "/dev/" ) + line.mid( 8 );
+        }
+    }
+    return QStringLiteral( "/dev/" ) + QString( name ).replace( '!', '/' );
+}
+
+/** @brief Reads the block devices from @p sysClassBlock
+ *
+ * This is normally /sys/class/block, which has one symlink per
+ * block device, to its directory in the device tree. Partitions
+ * live inside the directory of their disk.
+ */
+STATICTEST CalamaresUtils::Partition::BlockDeviceList
+scanSysfs( const QString& sysClassBlock )
+{
+    CalamaresUtils::Partition::BlockDeviceList devices;
+
+    const auto entries = QDir( sysClassBlock ).entryInfoList( QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name );
+    devices.reserve( entries.count() );
+    for ( const auto& entry : entries )
+    {
+        const QDir dir( entry.canonicalFilePath() );
+
+        CalamaresUtils::Partition::BlockDevice d;
+        d.name = entry.fileName();
+        d.path = devicePath( dir, d.name );
+        d.size = readSysfsFile( dir, QStringLiteral( "size" ) ).toLongLong() * sysfsSectorSize;
+        d.readOnly = readSysfsFile( dir, QStringLiteral( "ro" ) ) == QStringLiteral( "1" );
+        d.partitionNumber = readSysfsFile( dir, QStringLiteral( "partition" ) ).toInt();
+        d.isPartition = d.partitionNumber > 0;
+        if ( d.isPartition )
+        {
+            const QDir parentDir( QFileInfo( dir.absolutePath() ).absolutePath() );
+            d.parent = parentDir.dirName();
+            d.removable = readSysfsFile( parentDir, QStringLiteral( "removable" ) ) == QStringLiteral( "1" );
+        }
+        else
+        {
+            d.removable = readSysfsFile( dir, QStringLiteral( "removable" ) ) == QStringLiteral( "1" );
+        }
+        devices.append( d );
+    }
+    return devices;
+}
+
+/// @brief Undo the shell-style escaping of `blkid -o export`
+static QString
+unescapeBlkid( const QString& value )
+{
+    QString s;
+    s.reserve( value.length() );
+    for ( int i = 0; i < value.length(); ++i )
+    {
+        if ( value.at( i ) == '\\' && i + 1 < value.length() )
+        {
+            ++i;
+        }
+        s.append( value.at( i ) );
+    }
+    return s;
+}
+
+/** @brief Fills in the filesystem information in @p devices
+ *
+ * The @p output is what `blkid -o export` prints: blocks of KEY=value
+ * lines, one block per device, separated by an empty line.
+ * Devices are matched by their device node.
+ */
+STATICTEST void
+applyBlkid( CalamaresUtils::Partition::BlockDeviceList& devices, const QString& output )
+{
+    CalamaresUtils::Partition::BlockDevice* current = nullptr;
+    const auto lines = output.split( '\n' );
+    for ( const auto& line : lines )
+    {
+        const int eq = line.indexOf( '=' );
+        if ( eq < 1 )
+        {
+            current = nullptr;
+            continue;
+        }
+        const QString key = line.left( eq );
+        const QString value = unescapeBlkid( line.mid( eq + 1 ) );
+        if ( key == QStringLiteral( "DEVNAME" ) )
+        {
+            auto it = std::find_if(
+                devices.begin(), devices.end(), [ &value ]( const auto& d ) { return d.path == value; } );
+            current = it == devices.end() ? nullptr : &( *it );
+        }
+        else if ( !current )
+        {
+            continue;
+        }
+        else if ( key == QStringLiteral( "TYPE" ) )
+        {
+            current->fsType = value;
+        }
+        else if ( key == QStringLiteral( "UUID" ) )
+        {
+            current->uuid = value;
+        }
+        else if ( key == QStringLiteral( "PARTUUID" ) )
+        {
+            current->partUuid = value;
+        }
+        else if ( key == QStringLiteral( "LABEL" ) )
+        {
+            current->label = value;
+        }
+    }
+}
+
+/// @brief Scans the system: sysfs for the devices, then one blkid for all of them
+static CalamaresUtils::Partition::BlockDeviceList
+scanSystem()
+{
+    auto devices = scanSysfs( QStringLiteral( "/sys/class/block" ) );
+    if ( devices.isEmpty() )
+    {
+        cWarning() << "No block devices found in sysfs.";
+        return devices;
+    }
+
+    // Skip the blkid cache file, it may be stale
+    QStringList command { "blkid", "-c", "/dev/null", "-o", "export" };
+    for ( const auto& d : qAsConst( devices ) )
+    {
+        command.append( d.path );
+    }
+    // blkid exits with 2 if *some* device has nothing to report, but the output is fine
+    const auto r = CalamaresUtils::System::runCommand( command, std::chrono::seconds( 30 ) );
+    applyBlkid( devices, r.getOutput() );
+
+    cDebug() << "Block device inventory has" << devices.count() << "devices.";
+    return devices;
+}
+
+namespace CalamaresUtils
+{
+namespace Partition
+{
+
+bool
+BlockDevice::isDisk() const
+{
+    static const char* const notDisks[] = { "loop", "ram", "zram", "fd", "sr", "dm-" };
+    if ( isPartition )
+    {
+        return false;
+    }
+    return std::none_of( std::begin( notDisks ), std::end( notDisks ), [ this ]( const char* prefix ) {
+        return name.startsWith( QLatin1String( prefix ) );
+    } );
+}
+
+DeviceInventory*
+DeviceInventory::instance()
+{
+    static DeviceInventory* s_instance = new DeviceInventory();
+    return s_instance;
+}
+
+DeviceInventory::DeviceInventory()
+    : QObject( nullptr )
+{
+    // udev creates and removes the device nodes, and the /dev/disk/by-* links
+    // change when filesystems are created.
+    QStringList watched;
+    for ( const auto& dir : { "/dev", "/dev/disk/by-uuid", "/dev/disk/by-partuuid", "/dev/disk/by-label" } )
+    {
+        if ( QFileInfo( dir ).isDir() )
+        {
+            watched.append( dir );
+        }
+    }
+    m_watcher = new QFileSystemWatcher( watched, this );
+    connect( m_watcher, &QFileSystemWatcher::directoryChanged, this, &DeviceInventory::invalidate );
+
+    // The watcher needs an event loop; the instance may be created from a job thread
+    if ( QCoreApplication::instance() && thread() != QCoreApplication::instance()->thread() )
+    {
+        moveToThread( QCoreApplication::instance()->thread() );
+    }
+}
+
+BlockDeviceList
+DeviceInventory::devices()
+{
+    QMutexLocker lock( &m_mutex );
+    if ( !m_valid )
+    {
+        m_devices = scanSystem();
+        m_valid = true;
+    }
+    return m_devices;
+}
+
+BlockDeviceList
+DeviceInventory::disks()
+{
+    BlockDeviceList l = devices();
+    l.erase( std::remove_if( l.begin(), l.end(), []( const BlockDevice& d ) { return !d.isDisk(); } ), l.end() );
+    return l;
+}
+
+BlockDeviceList
+DeviceInventory::partitions( const QString& disk )
+{
+    const BlockDevice parent = device( disk );
+    BlockDeviceList l = devices();
+    l.erase( std::remove_if( l.begin(),
+                             l.end(),
+                             [ &parent ]( const BlockDevice& d ) { return !d.isPartition || d.parent != parent.name; } ),
+             l.end() );
+    std::sort( l.begin(), l.end(), []( const BlockDevice& a, const BlockDevice& b ) {
+        return a.partitionNumber < b.partitionNumber;
+    } );
+    return parent.isValid() ? l : BlockDeviceList();
+}
+
+BlockDevice
+DeviceInventory::device( const QString& nameOrPath )
+{
+    const auto l = devices();
+    auto it = std::find_if( l.cbegin(), l.cend(), [ &nameOrPath ]( const BlockDevice& d ) {
+        return d.name == nameOrPath || d.path == nameOrPath;
+    } );
+    return it == l.cend() ? BlockDevice() : *it;
+}
+
+void
+DeviceInventory::invalidate()
+{
+    {
+        QMutexLocker lock( &m_mutex );
+        if ( !m_valid )
+        {
+            return;
+        }
+        m_valid = false;
+    }
+    emit changed();
+}
+
+}  // namespace Partition
+}  // namespace CalamaresUtils
@@ -0,0 +1,118 @@
+/* === This file is part of Calamares - <https://calamares.io> ===
+ *
+ *   SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *   SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ *   Calamares is Free Software: see the License-Identifier above.
+ *
+ */
+
+/*
+ * A shared inventory of the block devices in the system.
+ */
+#ifndef PARTITION_DEVICEINVENTORY_H
+#define PARTITION_DEVICEINVENTORY_H
+
+#include "DllMacro.h"
+
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QVector>
+
+class QFileSystemWatcher;
+
+namespace CalamaresUtils
+{
+namespace Partition
+{
+
+/** @brief What the system knows about one block device
+ *
+ * The first part comes from sysfs, the second part from blkid.
+ * Fields that are not known are empty (or zero, or false).
+ */
+struct DLLEXPORT BlockDevice
+{
+    QString name;  ///< Kernel name, e.g. "sda" or "nvme0n1p2"
+    QString path;  ///< Device node, e.g. "/dev/sda"
+    QString parent;  ///< For partitions, the kernel name of the disk
+    int partitionNumber = 0;  ///< For partitions, the number in the partition table
+    qint64 size = 0;  ///< In bytes
+    bool isPartition = false;
+    bool readOnly = false;
+    bool removable = false;
+
+    QString fsType;  ///< e.g. "ext4", "swap", "crypto_LUKS", "iso9660"
+    QString uuid;  ///< Filesystem UUID, or the LUKS UUID for a LUKS container
+    QString partUuid;  ///< GPT (or MBR-derived) partition UUID
+    QString label;  ///< Filesystem label
+
+    bool isValid() const { return !name.isEmpty(); }
+    /** @brief Is this a whole disk that could hold an installation?
+     *
+     * That excludes partitions, and devices that are never install
+     * targets: loop, ram, zram, floppy, optical and device-mapper devices.
+     */
+    bool isDisk() const;
+    /** @brief Is this a device-mapper device?
+     *
+     * Those are LVM logical volumes and opened LUKS containers (and
+     * other mappings); they can hold a filesystem just like a partition.
+     */
+    bool isVolume() const { return name.startsWith( QLatin1String( "dm-" ) ); }
+};
+
+using BlockDeviceList = QVector< BlockDevice >;
+
+/** @brief Shared inventory of block devices
+ *
+ * The devices are scanned once (from sysfs, with one blkid run for
+ * the filesystem information) and the results are kept until
+ * something changes. Changes are noticed through the device nodes
+ * and the /dev/disk links that udev maintains; code that changes
+ * the disks itself (e.g. the partitioning jobs) should call
+ * invalidate() when it is done, so that the next query re-scans.
+ *
+ * All the query methods are thread-safe.
+ */
+class DLLEXPORT DeviceInventory : public QObject
+{
+    Q_OBJECT
+
+public:
+    static DeviceInventory* instance();
+
+    ///@brief All the block devices, disks and partitions
+    BlockDeviceList devices();
+    ///@brief Whole disks only, see BlockDevice::isDisk()
+    BlockDeviceList disks();
+    ///@brief Partitions on the disk with kernel name or path @p disk, by number
+    BlockDeviceList partitions( const QString& disk );
+    /** @brief Look up one device by kernel name or device path
+     *
+     * Returns an invalid BlockDevice if there is no such device.
+     */
+    BlockDevice device( const QString& nameOrPath );
+
+public Q_SLOTS:
+    ///@brief Forget the cached results; the next query re-scans
+    void invalidate();
+
+signals:
+    ///@brief The inventory has been invalidated
+    void changed();
+
+private:
+    DeviceInventory();
+
+    QMutex m_mutex;
+    BlockDeviceList m_devices;
+    bool m_valid = false;
+    QFileSystemWatcher* m_watcher = nullptr;
+};
+
+}  // namespace Partition
+}  // namespace CalamaresUtils
+
+#endif
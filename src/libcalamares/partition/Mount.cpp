@@ -11,14 +11,279 @@
 
 #include "Mount.h"
 
+#include "partition/DeviceInventory.h"
 #include "partition/Sync.h"
 #include "utils/CalamaresUtilsSystem.h"
 #include "utils/Logger.h"
 #include "utils/String.h"
 
 #include <QDir>
+#include <QFileInfo>
 #include <QTemporaryDir>
 
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <sys/mount.h>
+
+/// @brief Exit code of mount(8) and umount(8) for "mount failure"
+static constexpr const int mountFailure = 32;
+
+/** @brief Translates mount(8)-style @p options for mount(2)
+ *
+ * The flags that mount(2) knows are collected in @p flags, the rest
+ * of the options are passed to the filesystem in @p data. Options that
+ * only mean something to mount(8) or fstab (e.g. noauto, x-*) are dropped.
+ *
+ * Returns @c false if the options need mount(8) itself (e.g. loop),
+ * or are command-line options other than --bind and --rbind.
+ */
+STATICTEST bool
+parseMountOptions( const QString& options, unsigned long& flags, QString& data )
+{
+    struct Flag
+    {
+        const char* name;
+        unsigned long set;
+        unsigned long clear;
+    };
+    static const Flag knownFlags[] = {
+        { "ro", MS_RDONLY, 0 },
+        { "rw", 0, MS_RDONLY },
+        { "nosuid", MS_NOSUID, 0 },
+        { "suid", 0, MS_NOSUID },
+        { "nodev", MS_NODEV, 0 },
+        { "dev", 0, MS_NODEV },
+        { "noexec", MS_NOEXEC, 0 },
+        { "exec", 0, MS_NOEXEC },
+        { "sync", MS_SYNCHRONOUS, 0 },
+        { "async", 0, MS_SYNCHRONOUS },
+        { "dirsync", MS_DIRSYNC, 0 },
+        { "noatime", MS_NOATIME, 0 },
+        { "atime", 0, MS_NOATIME },
+        { "nodiratime", MS_NODIRATIME, 0 },
+        { "diratime", 0, MS_NODIRATIME },
+        { "relatime", MS_RELATIME, 0 },
+        { "norelatime", 0, MS_RELATIME },
+        { "strictatime", MS_STRICTATIME, 0 },
+        { "mand", MS_MANDLOCK, 0 },
+        { "nomand", 0, MS_MANDLOCK },
+        { "silent", MS_SILENT, 0 },
+        { "loud", 0, MS_SILENT },
+        { "remount", MS_REMOUNT, 0 },
+        { "bind", MS_BIND, 0 },
+        { "rbind", MS_BIND | MS_REC, 0 },
+    };
+    static const QStringList ignored { "defaults", "auto", "noauto", "nofail", "_netdev" };
+    static const QStringList needMount { "loop", "user", "nouser", "users", "owner", "group" };
+    static const QStringList needMountPrefixes {
+        "loop=", "offset=", "sizelimit=", "encryption=", "helper=", "uhelper="
+    };
+
+    flags = 0;
+    data.clear();
+
+    if ( options.startsWith( '-' ) )
+    {
+        if ( options == QStringLiteral( "--bind" ) )
+        {
+            flags = MS_BIND;
+            return true;
+        }
+        if ( options == QStringLiteral( "--rbind" ) )
+        {
+            flags = MS_BIND | MS_REC;
+            return true;
+        }
+        return false;
+    }
+
+    QStringList fsOptions;
+    const auto parts = options.split( ',', SplitSkipEmptyParts );
+    for ( const auto& o : parts )
+    {
+        if ( needMount.contains( o )
+             || std::any_of( needMountPrefixes.cbegin(),
+                             needMountPrefixes.cend(),
+                             [ &o ]( const QString& prefix ) { return o.startsWith( prefix ); } ) )
+        {
+            return false;
+        }
+        if ( ignored.contains( o ) || o.startsWith( QStringLiteral( "x-" ) )
+             || o.startsWith( QStringLiteral( "comment=" ) ) )
+        {
+            continue;
+        }
+        auto it = std::find_if( std::begin( knownFlags ), std::end( knownFlags ), [ &o ]( const Flag& f ) {
+            return o == QLatin1String( f.name );
+        } );
+        if ( it != std::end( knownFlags ) )
+        {
+            flags = ( flags & ~it->clear ) | it->set;
+        }
+        else
+        {
+            fsOptions.append( o );
+        }
+    }
+    data = fsOptions.join( ',' );
+    return true;
+}
+
+/** @brief Does a mount with @p flags need a second, read-only remount?
+ *
+ * The kernel ignores MS_RDONLY when creating a bind mount, so "bind,ro"
+ * gives a writable mount; it takes a remount of the bind to make it
+ * read-only (that's what mount(8) does as well, when it does it at all).
+ */
+STATICTEST bool
+isReadOnlyBind( unsigned long flags )
+{
+    return ( flags & MS_BIND ) && ( flags & MS_RDONLY ) && !( flags & MS_REMOUNT );
+}
+
+/// @brief Does mount(8) use a helper program (e.g. mount.ntfs-3g) for @p fsType?
+static bool
+hasMountHelper( const QString& fsType )
+{
+    for ( const auto& dir : { "/sbin/", "/usr/sbin/", "/bin/", "/usr/bin/" } )
+    {
+        if ( QFileInfo( QLatin1String( dir ) + QStringLiteral( "mount." ) + fsType ).isExecutable() )
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/// @brief Runs mount(8), for what mount(2) can't do on its own
+static int
+runMount( const QString& devicePath, const QString& mountPoint, const QString& filesystemName, const QString& options )
+{
+    QStringList args = { "mount" };
+
+    if ( !filesystemName.isEmpty() )
+    {
+        args << "-t" << filesystemName;
+    }
+    if ( !options.isEmpty() )
+    {
+        if ( options.startsWith( '-' ) )
+        {
+            args << options;
+        }
+        else
+        {
+            args << "-o" << options;
+        }
+    }
+    if ( !devicePath.isEmpty() )
+    {
+        args << devicePath;
+    }
+    args << mountPoint;
+
+    auto r = CalamaresUtils::System::runCommand( args, std::chrono::seconds( 10 ) );
+    return r.getExitCode();
+}
+
+/** @brief Calls mount(2); returns 0 on success, or an errno value
+ *
+ * Like mount(8), a write-protected device is mounted read-only instead.
+ */
+static int
+nativeMount( const QString& devicePath,
+             const QString& mountPoint,
+             const QString& fsType,
+             unsigned long flags,
+             const QString& data )
+{
+    const QByteArray source = QFile::encodeName( devicePath );
+    const QByteArray target = QFile::encodeName( mountPoint );
+    const QByteArray type = fsType.toUtf8();
+    const QByteArray fsData = data.toUtf8();
+    auto doMount = [ & ]( unsigned long f ) {
+        return ::mount( source.constData(),
+                        target.constData(),
+                        type.isEmpty() ? nullptr : type.constData(),
+                        f,
+                        fsData.isEmpty() ? nullptr : fsData.constData() );
+    };
+
+    if ( doMount( flags ) == 0 )
+    {
+        return 0;
+    }
+    const bool readOnlyRetry
+        = ( errno == EROFS || errno == EACCES ) && !( flags & ( MS_RDONLY | MS_BIND | MS_REMOUNT ) );
+    if ( readOnlyRetry && doMount( flags | MS_RDONLY ) == 0 )
+    {
+        cDebug() << "Device" << devicePath << "is write-protected, mounted read-only.";
+        return 0;
+    }
+    return errno;
+}
+
+/** @brief Translates umount(8)-style @p options to umount2(2) flags
+ *
+ * Sets @p recursive for -R. Returns @c false for options that
+ * are not understood.
+ */
+STATICTEST bool
+parseUnmountOptions( const QStringList& options, int& flags, bool& recursive )
+{
+    flags = 0;
+    recursive = false;
+    for ( const auto& o : options )
+    {
+        if ( o == QStringLiteral( "--lazy" ) )
+        {
+            flags |= MNT_DETACH;
+        }
+        else if ( o == QStringLiteral( "--force" ) )
+        {
+            flags |= MNT_FORCE;
+        }
+        else if ( o == QStringLiteral( "--recursive" ) )
+        {
+            recursive = true;
+        }
+        else if ( o == QStringLiteral( "--verbose" ) )
+        {
+            // Nothing to be verbose about
+        }
+        else if ( o.startsWith( '-' ) && !o.startsWith( QStringLiteral( "--" ) ) )
+        {
+            // Bundled short options, e.g. -lv
+            for ( const auto c : o.mid( 1 ) )
+            {
+                switch ( c.toLatin1() )
+                {
+                case 'l':
+                    flags |= MNT_DETACH;
+                    break;
+                case 'f':
+                    flags |= MNT_FORCE;
+                    break;
+                case 'R':
+                    recursive = true;
+                    break;
+                case 'v':
+                    break;
+                default:
+                    return false;
+                }
+            }
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 namespace CalamaresUtils
 {
 namespace Partition
@@ -52,37 +317,95 @@ mount( const QString& devicePath, const QString& mountPoint, const QString& file
         }
     }
 
-    QStringList args = { "mount" };
-
-    if ( !filesystemName.isEmpty() )
+    unsigned long flags = 0;
+    QString data;
+    QString fsType = filesystemName;
+    bool guessed = false;
+    bool native = parseMountOptions( options, flags, data );
+    const bool readOnlyBind = native && isReadOnlyBind( flags );
+    if ( native && !( flags & ( MS_BIND | MS_REMOUNT ) ) )
     {
-        args << "-t" << filesystemName;
+        if ( fsType.isEmpty() )
+        {
+            guessed = true;
+            // mount(8) would ask blkid; the inventory already did. Files need
+            // a loop device, which is also something mount(8) does.
+            fsType = DeviceInventory::instance()->device( QFileInfo( devicePath ).canonicalFilePath() ).fsType;
+        }
+        native = !fsType.isEmpty() && !hasMountHelper( fsType );
     }
-    if ( !options.isEmpty() )
+
+    if ( native )
     {
-        if ( options.startsWith( '-' ) )
+        const int error = nativeMount( devicePath, mountPoint, fsType, flags, data );
+        if ( error == 0 )
         {
-            args << options;
+            return 0;
         }
-        else
+        if ( error != ENODEV && !guessed )
         {
-            args << "-o" << options;
+            cWarning() << "Could not mount" << devicePath << "on" << mountPoint << std::strerror( error );
+            return mountFailure;
         }
+        // The kernel doesn't know the type by that name, or the inventory
+        // was out of date (e.g. the device was just formatted); mount(8)
+        // may do better.
+        cDebug() << "Native mount of" << devicePath << "failed," << std::strerror( error ) << "trying mount(8).";
     }
-    args << devicePath << mountPoint;
-
-    auto r = CalamaresUtils::System::runCommand( args, std::chrono::seconds( 10 ) );
-    sync();
-    return r.getExitCode();
+    const int r = runMount( devicePath, mountPoint, filesystemName, options );
+    if ( r == 0 && readOnlyBind )
+    {
+        const int remount = runMount( QString(), mountPoint, QString(), QStringLiteral( "remount,bind,ro" ) );
+        if ( remount != 0 )
+        {
+            // Don't leave a writable mount where a read-only one was asked for
+            cWarning() << "Could not make bind-mount" << mountPoint << "read-only.";
+            unmount( mountPoint, { "--lazy" } );
+            return remount;
+        }
+    }
+    return r;
 }
 
 int
 unmount( const QString& path, const QStringList& options )
 {
-    auto r
-        = CalamaresUtils::System::runCommand( QStringList { "umount" } << options << path, std::chrono::seconds( 10 ) );
-    sync();
-    return r.getExitCode();
+    int flags = 0;
+    bool recursive = false;
+    if ( !QFileInfo( path ).isDir() || !parseUnmountOptions( options, flags, recursive ) )
+    {
+        // A device rather than a mount point, or unusual options
+        auto r = CalamaresUtils::System::runCommand( QStringList { "umount" } << options << path,
+                                                     std::chrono::seconds( 10 ) );
+        return r.getExitCode();
+    }
+
+    QStringList targets;
+    if ( recursive )
+    {
+        const QString prefix = path.endsWith( '/' ) ? path : path + '/';
+        auto mounts = MtabInfo::fromMtabFilteredByPrefix( prefix, QStringLiteral( "/proc/self/mounts" ) );
+        // Submounts first
+        std::sort( mounts.begin(), mounts.end(), MtabInfo::mountPointOrder );
+        for ( const auto& m : qAsConst( mounts ) )
+        {
+            targets.append( m.mountPoint );
+        }
+    }
+    targets.append( path );
+
+    for ( const auto& target : qAsConst( targets ) )
+    {
+        // A detached filesystem is written out whenever it is no longer busy,
+        // so write out this one (and no other) now.
+        syncFilesystem( target );
+        if ( ::umount2( QFile::encodeName( target ).constData(), flags ) != 0 )
+        {
+            cWarning() << "Could not unmount" << target << std::strerror( errno );
+            return mountFailure;
+        }
+    }
+    return 0;
 }
 
 struct TemporaryMount::Private
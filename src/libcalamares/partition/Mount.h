@@ -26,14 +26,24 @@ namespace Partition
 {
 
 /**
- * Runs the mount utility with the specified parameters.
+ * Mounts @p devicePath on @p mountPoint.
+ *
+ * This calls mount(2) directly when it can. The mount utility is used
+ * instead for what only it knows how to do: loop-mounting files,
+ * filesystem helpers (e.g. mount.ntfs-3g), filesystems whose type
+ * is not known, and options like "loop" or "user". Neither way waits
+ * for udev or syncs any disks: call sync() or settle() if needed.
+ *
  * @param devicePath the path of the partition to mount.
  * @param mountPoint the full path of the target mount point.
  * @param filesystemName the name of the filesystem (optional).
  * @param options any additional options as passed to mount -o (optional).
  *          If @p options starts with a dash (-) then it is passed unchanged
  *          and no -o option is added; this is used in handling --bind mounts.
- * @returns the program's exit code, or:
+ *          A bind-mount with "ro" (e.g. "bind,ro") is remounted read-only
+ *          afterwards, since the kernel ignores "ro" when binding.
+ * @returns 0 on success, 32 (like the mount utility) if mount(2) fails,
+ *          the program's exit code if the mount utility is used, or:
  *             Crashed = QProcess crash
  *             FailedToStart = QProcess cannot start
  *             NoWorkingDirectory = bad arguments
@@ -45,9 +55,14 @@ DLLEXPORT int mount( const QString& devicePath,
 
 /** @brief Unmount the given @p path (device or mount point).
  *
- * Runs umount(8) in the host system.
+ * A mount point is unmounted with umount2(2); the options -l, -f, -R
+ * and -v (also combined, like "-lv") are understood. Before unmounting,
+ * the filesystem is written out with syncfs(2), which does not touch
+ * any other filesystem. For a device, or other options, umount(8)
+ * in the host system is used.
  *
- * @returns the program's exit code, or special codes like mount().
+ * @returns 0 on success, 32 if umount2(2) fails, or the program's
+ *          exit code and special codes like mount().
  */
 DLLEXPORT int unmount( const QString& path, const QStringList& options = QStringList() );
 
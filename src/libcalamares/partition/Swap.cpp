@@ -0,0 +1,248 @@
+/* === This file is part of Calamares - <https://calamares.io> ===
+ *
+ *   SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *   SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ *   Calamares is Free Software: see the License-Identifier above.
+ *
+ */
+
+#include "Swap.h"
+
+#include "utils/Logger.h"
+
+#include <QByteArray>
+#include <QFile>
+#include <QUuid>
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <linux/magic.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/statfs.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#ifndef XFS_SUPER_MAGIC
+#define XFS_SUPER_MAGIC 0x58465342
+#endif
+
+/// @brief Size of the chunks written when the file can't be preallocated
+static constexpr const qint64 writeChunkSize = 1024 * 1024;
+
+/** @brief Closes a file descriptor on scope exit
+ *
+ * Unless @c keep is set (on success), also removes the file.
+ */
+struct SwapFileGuard
+{
+    int fd;
+    QString path;
+    bool keep = false;
+
+    ~SwapFileGuard()
+    {
+        if ( fd >= 0 )
+        {
+            ::close( fd );
+        }
+        if ( !keep )
+        {
+            QFile::remove( path );
+        }
+    }
+};
+
+/// @brief Calls @p progress once per percent of @p done out of @p total
+class ProgressThrottle
+{
+public:
+    ProgressThrottle( const std::function< void( double ) >& progress, qint64 total )
+        : m_progress( progress )
+        , m_total( total )
+    {
+    }
+
+    void update( qint64 done )
+    {
+        const int percent = m_total > 0 ? int( done * 100 / m_total ) : 100;
+        if ( m_progress && percent != m_lastPercent )
+        {
+            m_lastPercent = percent;
+            m_progress( percent / 100.0 );
+        }
+    }
+
+private:
+    const std::function< void( double ) >& m_progress;
+    qint64 m_total;
+    int m_lastPercent = -1;
+};
+
+/** @brief Switch off copy-on-write and compression (btrfs)
+ *
+ * This must be done while the file is still empty. It is the
+ * equivalent of `chattr +C` and `btrfs property set compression none`.
+ */
+static bool
+setNoCow( int fd )
+{
+    int flags = 0;
+    if ( ::ioctl( fd, FS_IOC_GETFLAGS, &flags ) != 0 )
+    {
+        return false;
+    }
+    flags |= FS_NOCOW_FL | FS_NOCOMP_FL;
+    flags &= ~FS_COMPR_FL;
+    return ::ioctl( fd, FS_IOC_SETFLAGS, &flags ) == 0;
+}
+
+static bool
+writeZeroes( int fd, qint64 size, ProgressThrottle& progress )
+{
+    const QByteArray zeroes( int( qMin( size, writeChunkSize ) ), '\0' );
+    qint64 done = 0;
+    while ( done < size )
+    {
+        const ssize_t r = ::write( fd, zeroes.constData(), size_t( qMin( size - done, qint64( zeroes.size() ) ) ) );
+        if ( r < 0 && errno == EINTR )
+        {
+            continue;
+        }
+        if ( r <= 0 )
+        {
+            return false;
+        }
+        done += r;
+        progress.update( done );
+    }
+    return true;
+}
+
+/** @brief Writes a (version 1) swap header to the first page of @p fd
+ *
+ * This is the layout of union swap_header from the kernel's linux/swap.h;
+ * it is in native byte order, like mkswap(8) writes it.
+ */
+static bool
+writeSwapHeader( int fd, qint64 pageSize, qint64 pages )
+{
+    struct Info
+    {
+        char bootbits[ 1024 ];
+        quint32 version;
+        quint32 last_page;
+        quint32 nr_badpages;
+        unsigned char uuid[ 16 ];
+        char volume_name[ 16 ];
+    };
+    static constexpr const char signature[] = "SWAPSPACE2";
+    static constexpr const int signatureLength = sizeof( signature ) - 1;
+
+    QByteArray page( int( pageSize ), '\0' );
+    Info info {};
+    info.version = 1;
+    info.last_page = quint32( pages - 1 );
+    info.nr_badpages = 0;
+    const QByteArray uuid = QUuid::createUuid().toRfc4122();
+    std::memcpy( info.uuid, uuid.constData(), sizeof( info.uuid ) );
+    std::memcpy( page.data(), &info, sizeof( info ) );
+    std::memcpy( page.data() + pageSize - signatureLength, signature, signatureLength );
+
+    qint64 done = 0;
+    while ( done < pageSize )
+    {
+        const ssize_t r = ::pwrite( fd, page.constData() + done, size_t( pageSize - done ), off_t( done ) );
+        if ( r < 0 && errno == EINTR )
+        {
+            continue;
+        }
+        if ( r <= 0 )
+        {
+            return false;
+        }
+        done += r;
+    }
+    return true;
+}
+
+namespace CalamaresUtils
+{
+namespace Partition
+{
+
+bool
+createSwapFile( const QString& path, qint64 size, const std::function< void( double ) >& progress )
+{
+    const qint64 pageSize = ::sysconf( _SC_PAGESIZE );
+    const qint64 pages = pageSize > 0 ? size / pageSize : 0;
+    // mkswap refuses anything less than 10 pages
+    if ( pages < 10 )
+    {
+        cWarning() << "Swapfile" << path << "is too small," << size << "bytes.";
+        return false;
+    }
+    size = pages * pageSize;
+
+    SwapFileGuard file { ::open( QFile::encodeName( path ).constData(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600 ),
+                         path };
+    if ( file.fd < 0 )
+    {
+        cWarning() << "Could not create swapfile" << path << std::strerror( errno );
+        file.keep = true;  // Don't remove what we did not create
+        return false;
+    }
+    // O_CREAT respects the umask, and an existing file keeps its mode
+    ::fchmod( file.fd, 0600 );
+
+    struct statfs fs
+    {
+    };
+    const bool haveFsType = ::fstatfs( file.fd, &fs ) == 0;
+    const bool isBtrfs = haveFsType && fs.f_type == BTRFS_SUPER_MAGIC;
+    const bool isExt4 = haveFsType && fs.f_type == EXT4_SUPER_MAGIC;
+    const bool isXfs = haveFsType && fs.f_type == static_cast< decltype( fs.f_type ) >( XFS_SUPER_MAGIC );
+    const bool canPreallocate = isBtrfs || isExt4 || isXfs;
+
+    if ( isBtrfs && !setNoCow( file.fd ) )
+    {
+        cWarning() << "Could not disable copy-on-write for swapfile" << path << std::strerror( errno );
+        return false;
+    }
+
+    ProgressThrottle throttle( progress, size );
+    throttle.update( 0 );
+    bool allocated = false;
+    if ( canPreallocate )
+    {
+        const int r = ::posix_fallocate( file.fd, 0, off_t( size ) );
+        allocated = r == 0;
+        if ( !allocated )
+        {
+            cDebug() << "Could not preallocate swapfile" << path << std::strerror( r ) << "writing it instead.";
+        }
+    }
+    if ( !allocated && !writeZeroes( file.fd, size, throttle ) )
+    {
+        cWarning() << "Could not write swapfile" << path << std::strerror( errno );
+        return false;
+    }
+    throttle.update( size );
+
+    if ( !writeSwapHeader( file.fd, pageSize, pages ) || ::fsync( file.fd ) != 0 )
+    {
+        cWarning() << "Could not write swap header to" << path << std::strerror( errno );
+        return false;
+    }
+
+    cDebug() << "Created swapfile" << path << size << "bytes" << ( allocated ? "(preallocated)" : "(written)" );
+    file.keep = true;
+    return true;
+}
+
+}  // namespace Partition
+}  // namespace CalamaresUtils
@@ -0,0 +1,51 @@
+/* === This file is part of Calamares - <https://calamares.io> ===
+ *
+ *   SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *   SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ *   Calamares is Free Software: see the License-Identifier above.
+ *
+ */
+
+/*
+ * Swapfile provisioning.
+ */
+#ifndef PARTITION_SWAP_H
+#define PARTITION_SWAP_H
+
+#include "DllMacro.h"
+
+#include <QString>
+
+#include <functional>
+
+namespace CalamaresUtils
+{
+namespace Partition
+{
+
+/** @brief Creates a swapfile at @p path, of @p size bytes
+ *
+ * The file is created (or truncated) with mode 0600. Space is
+ * preallocated with fallocate(2) on filesystems where the kernel
+ * accepts preallocated swapfiles (btrfs, ext4, xfs), and written
+ * with zeroes elsewhere. On btrfs, copy-on-write and compression
+ * are switched off for the file before any space is allocated,
+ * which btrfs requires of a swapfile.
+ *
+ * The size is rounded down to a whole number of pages. A swap
+ * header (as mkswap(8) writes it, with a fresh UUID) is written to
+ * the first page, so the file is ready for swapon(8).
+ *
+ * While allocating, @p progress (if set) is called with a fraction
+ * between 0 and 1; it is called at most once for each percent.
+ *
+ * Returns @c true on success. On failure, the partial file is removed.
+ */
+DLLEXPORT bool
+createSwapFile( const QString& path, qint64 size, const std::function< void( double ) >& progress = nullptr );
+
+}  // namespace Partition
+}  // namespace CalamaresUtils
+
+#endif
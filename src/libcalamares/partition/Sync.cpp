@@ -13,8 +13,16 @@
 #include "utils/CalamaresUtilsSystem.h"
 #include "utils/Logger.h"
 
+#include <QFile>
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+
 void
-CalamaresUtils::Partition::sync()
+CalamaresUtils::Partition::settle()
 {
     /* I would normally use full paths here, e.g. /sbin/udevadm and /bin/sync,
      * but there's enough variation / opinion on where these executables
@@ -30,6 +38,27 @@ CalamaresUtils::Partition::sync()
         cWarning() << "Could not settle disks.";
         r.explainProcess( "udevadm", std::chrono::seconds( 10 ) );
     }
+}
 
+void
+CalamaresUtils::Partition::sync()
+{
+    settle();
     CalamaresUtils::System::runCommand( { "sync" }, std::chrono::seconds( 10 ) );
 }
+
+void
+CalamaresUtils::Partition::syncFilesystem( const QString& path )
+{
+    const int fd = ::open( QFile::encodeName( path ).constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC );
+    if ( fd < 0 )
+    {
+        cWarning() << "Could not open" << path << "to sync it" << std::strerror( errno );
+        return;
+    }
+    if ( ::syncfs( fd ) != 0 )
+    {
+        cWarning() << "Could not sync filesystem at" << path << std::strerror( errno );
+    }
+    ::close( fd );
+}
@@ -13,6 +13,8 @@
 
 #include "DllMacro.h"
 
+#include <QString>
+
 namespace CalamaresUtils
 {
 namespace Partition
@@ -28,6 +30,20 @@ namespace Partition
  */
 DLLEXPORT void sync();
 
+/** @brief Run "udevadm settle" only
+ *
+ * Mounting and unmounting do not wait for udev; call this when the
+ * next step needs udev to have caught up (e.g. before partitioning).
+ */
+DLLEXPORT void settle();
+
+/** @brief Write out the filesystem that contains @p path
+ *
+ * This is syncfs(2): unlike sync(), other filesystems (e.g. a slow
+ * USB stick that happens to be mounted) are left alone.
+ */
+DLLEXPORT void syncFilesystem( const QString& path );
+
 /** @brief RAII class for calling sync() */
 struct DLLEXPORT Syncer
 {
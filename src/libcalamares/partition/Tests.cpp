@@ -8,15 +8,27 @@
  *
  */
 
+#include "DeviceInventory.h"
 #include "Global.h"
+#include "Mount.h"
 #include "PartitionSize.h"
+#include "Swap.h"
 
 #include "GlobalStorage.h"
 #include "utils/Logger.h"
 
+#include <QFile>
 #include <QObject>
+#include <QProcess>
+#include <QTemporaryDir>
 #include <QtTest/QtTest>
 
+#include <algorithm>
+
+#include <sys/mount.h>
+#include <sys/statvfs.h>
+#include <unistd.h>
+
 using SizeUnit = CalamaresUtils::Partition::SizeUnit;
 using PartitionSize = CalamaresUtils::Partition::PartitionSize;
 
@@ -39,6 +51,17 @@ private Q_SLOTS:
     void testUnitNormalisation();
 
     void testFilesystemGS();
+
+    void testSwapFile();
+
+    void testInventorySysfs();
+    void testInventoryBlkid();
+
+    void testMountOptions_data();
+    void testMountOptions();
+    void testReadOnlyBind();
+    void testUnmountOptions();
+    void testLoopMount();
 };
 
 PartitionServiceTests::PartitionServiceTests() {}
@@ -218,6 +241,370 @@ PartitionServiceTests::testFilesystemGS()
     QVERIFY( !isFilesystemUsedGS( &gs, "ext4" ) );
 }
 
+void
+PartitionServiceTests::testSwapFile()
+{
+    using CalamaresUtils::Partition::createSwapFile;
+
+    QTemporaryDir tempRoot( QDir::tempPath() + QStringLiteral( "/test-swapfile-XXXXXX" ) );
+    QVERIFY( tempRoot.isValid() );
+
+    // Too small for mkswap, so it's not created
+    const QString tinyPath = tempRoot.filePath( "tiny" );
+    QVERIFY( !createSwapFile( tinyPath, 4096 ) );
+    QVERIFY( !QFile::exists( tinyPath ) );
+
+    const qint64 size = 3 * 1024 * 1024;
+    const QString path = tempRoot.filePath( "swapfile" );
+    QList< double > reported;
+    QVERIFY( createSwapFile( path, size, [ &reported ]( double f ) { reported.append( f ); } ) );
+
+    QFile f( path );
+    QCOMPARE( f.size(), size );
+    QCOMPARE( f.permissions() & ( QFile::ReadGroup | QFile::ReadOther ), QFile::Permissions() );
+    QVERIFY( f.open( QIODevice::ReadOnly ) );
+    const qint64 pageSize = sysconf( _SC_PAGESIZE );
+    f.seek( pageSize - 10 );
+    QCOMPARE( f.read( 10 ), QByteArray( "SWAPSPACE2" ) );
+
+    // Progress goes up, once per percent at most, and finishes at 1
+    QVERIFY( !reported.isEmpty() );
+    QVERIFY( reported.count() <= 101 );
+    QCOMPARE( reported.last(), 1.0 );
+    QVERIFY( std::is_sorted( reported.cbegin(), reported.cend() ) );
+}
+
+using CalamaresUtils::Partition::BlockDeviceList;
+
+// Implementation details being tested
+extern BlockDeviceList scanSysfs( const QString& sysClassBlock );
+extern void applyBlkid( BlockDeviceList& devices, const QString& output );
+
+/// @brief Writes @p contents to @p file in @p dir (which is created)
+static bool
+writeSysfsFile( const QString& dir, const QString& file, const QByteArray& contents )
+{
+    QDir().mkpath( dir );
+    QFile f( dir + '/' + file );
+    return f.open( QIODevice::WriteOnly ) && f.write( contents ) == contents.size();
+}
+
+void
+PartitionServiceTests::testInventorySysfs()
+{
+    QTemporaryDir tempRoot( QDir::tempPath() + QStringLiteral( "/test-sysfs-XXXXXX" ) );
+    QVERIFY( tempRoot.isValid() );
+
+    // A fake sysfs: devices live in the device tree, and /sys/class/block links to them
+    const QString devices = tempRoot.filePath( "devices" );
+    const QString classBlock = tempRoot.filePath( "class/block" );
+    QVERIFY( QDir().mkpath( classBlock ) );
+
+    const QString sda = devices + "/pci/block/sda";
+    QVERIFY( writeSysfsFile( sda, "size", "2097152\n" ) );  // 1GiB
+    QVERIFY( writeSysfsFile( sda, "ro", "0\n" ) );
+    QVERIFY( writeSysfsFile( sda, "removable", "1\n" ) );
+    QVERIFY( writeSysfsFile( sda, "uevent", "MAJOR=8\nMINOR=0\nDEVNAME=sda\nDEVTYPE=disk\n" ) );
+    const QString sda1 = sda + "/sda1";
+    QVERIFY( writeSysfsFile( sda1, "size", "1024\n" ) );
+    QVERIFY( writeSysfsFile( sda1, "ro", "0\n" ) );
+    QVERIFY( writeSysfsFile( sda1, "partition", "1\n" ) );
+    const QString sda10 = sda + "/sda10";
+    QVERIFY( writeSysfsFile( sda10, "size", "2048\n" ) );
+    QVERIFY( writeSysfsFile( sda10, "partition", "10\n" ) );
+    const QString cciss = devices + "/virtual/block/cciss!c0d0";
+    QVERIFY( writeSysfsFile( cciss, "size", "8\n" ) );
+    QVERIFY( writeSysfsFile( cciss, "ro", "1\n" ) );
+    const QString loop = devices + "/virtual/block/loop0";
+    QVERIFY( writeSysfsFile( loop, "size", "0\n" ) );
+
+    QVERIFY( QFile::link( sda, classBlock + "/sda" ) );
+    QVERIFY( QFile::link( sda1, classBlock + "/sda1" ) );
+    QVERIFY( QFile::link( sda10, classBlock + "/sda10" ) );
+    QVERIFY( QFile::link( cciss, classBlock + "/cciss!c0d0" ) );
+    QVERIFY( QFile::link( loop, classBlock + "/loop0" ) );
+
+    const auto l = scanSysfs( classBlock );
+    QCOMPARE( l.count(), 5 );
+    // Sorted by name
+    QCOMPARE( l[ 0 ].name, QStringLiteral( "cciss!c0d0" ) );
+    QCOMPARE( l[ 0 ].path, QStringLiteral( "/dev/cciss/c0d0" ) );
+    QCOMPARE( l[ 0 ].size, 8 * 512_qi );
+    QVERIFY( l[ 0 ].readOnly );
+    QVERIFY( l[ 0 ].isDisk() );
+
+    QCOMPARE( l[ 1 ].name, QStringLiteral( "loop0" ) );
+    QVERIFY( !l[ 1 ].isDisk() );
+
+    QCOMPARE( l[ 2 ].name, QStringLiteral( "sda" ) );
+    QCOMPARE( l[ 2 ].path, QStringLiteral( "/dev/sda" ) );
+    QCOMPARE( l[ 2 ].size, 1024 * 1024 * 1024_qi );
+    QVERIFY( !l[ 2 ].readOnly );
+    QVERIFY( l[ 2 ].removable );
+    QVERIFY( !l[ 2 ].isPartition );
+    QVERIFY( l[ 2 ].isDisk() );
+
+    QCOMPARE( l[ 3 ].name, QStringLiteral( "sda1" ) );
+    QCOMPARE( l[ 3 ].path, QStringLiteral( "/dev/sda1" ) );
+    QCOMPARE( l[ 3 ].size, 512 * 1024_qi );
+    QVERIFY( l[ 3 ].isPartition );
+    QCOMPARE( l[ 3 ].partitionNumber, 1 );
+    QCOMPARE( l[ 3 ].parent, QStringLiteral( "sda" ) );
+    QVERIFY( l[ 3 ].removable );  // From the disk
+    QVERIFY( !l[ 3 ].isDisk() );
+
+    QCOMPARE( l[ 4 ].name, QStringLiteral( "sda10" ) );
+    QCOMPARE( l[ 4 ].partitionNumber, 10 );
+    QCOMPARE( l[ 4 ].parent, QStringLiteral( "sda" ) );
+
+    // Nothing there
+    QVERIFY( scanSysfs( tempRoot.filePath( "nonexistent" ) ).isEmpty() );
+}
+
+void
+PartitionServiceTests::testInventoryBlkid()
+{
+    BlockDeviceList l( 3 );
+    l[ 0 ].name = "sda";
+    l[ 0 ].path = "/dev/sda";
+    l[ 1 ].name = "sda1";
+    l[ 1 ].path = "/dev/sda1";
+    l[ 2 ].name = "sda2";
+    l[ 2 ].path = "/dev/sda2";
+
+    const QString output = QStringLiteral( "DEVNAME=/dev/sda\n"
+                                           "PTUUID=d0c8b5b1-6a8a-4bd4-a0b5-3d42c0a1b1a5\n"
+                                           "PTTYPE=gpt\n"
+                                           "\n"
+                                           "DEVNAME=/dev/sda1\n"
+                                           "LABEL=My\\ Disk\n"
+                                           "UUID=0f3b4a4e-3e2c-4a6b-9d5e-2f9a1c7b8e10\n"
+                                           "TYPE=ext4\n"
+                                           "PARTUUID=5f4c1e2d-01\n"
+                                           "\n"
+                                           "DEVNAME=/dev/sdz1\n"
+                                           "TYPE=vfat\n"
+                                           "\n"
+                                           "DEVNAME=/dev/sda2\n"
+                                           "UUID=a7a5bd1c-5f7d-4b8b-8f67-4ad1c0dd9e31\n"
+                                           "TYPE=crypto_LUKS\n" );
+    applyBlkid( l, output );
+
+    QVERIFY( l[ 0 ].fsType.isEmpty() );
+    QVERIFY( l[ 0 ].uuid.isEmpty() );
+
+    QCOMPARE( l[ 1 ].fsType, QStringLiteral( "ext4" ) );
+    QCOMPARE( l[ 1 ].label, QStringLiteral( "My Disk" ) );
+    QCOMPARE( l[ 1 ].uuid, QStringLiteral( "0f3b4a4e-3e2c-4a6b-9d5e-2f9a1c7b8e10" ) );
+    QCOMPARE( l[ 1 ].partUuid, QStringLiteral( "5f4c1e2d-01" ) );
+
+    // The unknown sdz1 in between doesn't leak into its neighbours
+    QCOMPARE( l[ 2 ].fsType, QStringLiteral( "crypto_LUKS" ) );
+    QCOMPARE( l[ 2 ].uuid, QStringLiteral( "a7a5bd1c-5f7d-4b8b-8f67-4ad1c0dd9e31" ) );
+    QVERIFY( l[ 2 ].label.isEmpty() );
+}
+
+// Implementation details being tested
+extern bool parseMountOptions( const QString& options, unsigned long& flags, QString& data );
+extern bool parseUnmountOptions( const QStringList& options, int& flags, bool& recursive );
+extern bool isReadOnlyBind( unsigned long flags );
+
+void
+PartitionServiceTests::testMountOptions_data()
+{
+    QTest::addColumn< QString >( "options" );
+    QTest::addColumn< bool >( "native" );
+    QTest::addColumn< qulonglong >( "flags" );
+    QTest::addColumn< QString >( "data" );
+
+    QTest::newRow( "empty" ) << QString() << true << 0ULL << QString();
+    QTest::newRow( "defaults" ) << QStringLiteral( "defaults" ) << true << 0ULL << QString();
+    QTest::newRow( "bind" ) << QStringLiteral( "--bind" ) << true << qulonglong( MS_BIND ) << QString();
+    QTest::newRow( "rbind" ) << QStringLiteral( "--rbind" ) << true << qulonglong( MS_BIND | MS_REC ) << QString();
+    QTest::newRow( "bind,ro" ) << QStringLiteral( "bind,ro" ) << true << qulonglong( MS_BIND | MS_RDONLY )
+                               << QString();
+    QTest::newRow( "other-dash" ) << QStringLiteral( "--make-private" ) << false << 0ULL << QString();
+    QTest::newRow( "loop" ) << QStringLiteral( "loop" ) << false << 0ULL << QString();
+    QTest::newRow( "loop=" ) << QStringLiteral( "ro,loop=/dev/loop3" ) << false << 0ULL << QString();
+    QTest::newRow( "flags" ) << QStringLiteral( "ro,noatime,nodev,nosuid" ) << true
+                             << qulonglong( MS_RDONLY | MS_NOATIME | MS_NODEV | MS_NOSUID ) << QString();
+    // Later options win, like they do for mount(8)
+    QTest::newRow( "ro,rw" ) << QStringLiteral( "ro,rw" ) << true << 0ULL << QString();
+    QTest::newRow( "fs-data" ) << QStringLiteral( "subvol=@home,noatime,compress=zstd" ) << true
+                               << qulonglong( MS_NOATIME ) << QStringLiteral( "subvol=@home,compress=zstd" );
+    QTest::newRow( "fstab-only" ) << QStringLiteral( "defaults,nofail,x-systemd.automount,umask=0077" ) << true
+                                  << 0ULL << QStringLiteral( "umask=0077" );
+}
+
+void
+PartitionServiceTests::testMountOptions()
+{
+    QFETCH( QString, options );
+    QFETCH( bool, native );
+    QFETCH( qulonglong, flags );
+    QFETCH( QString, data );
+
+    unsigned long parsedFlags = 0;
+    QString parsedData;
+    QCOMPARE( parseMountOptions( options, parsedFlags, parsedData ), native );
+    if ( native )
+    {
+        QCOMPARE( qulonglong( parsedFlags ), flags );
+        QCOMPARE( parsedData, data );
+    }
+}
+
+void
+PartitionServiceTests::testReadOnlyBind()
+{
+    QVERIFY( isReadOnlyBind( MS_BIND | MS_RDONLY ) );
+    QVERIFY( isReadOnlyBind( MS_BIND | MS_REC | MS_RDONLY | MS_NOSUID ) );
+    QVERIFY( !isReadOnlyBind( MS_BIND ) );
+    QVERIFY( !isReadOnlyBind( MS_RDONLY ) );
+    // Already the remount, don't do it twice
+    QVERIFY( !isReadOnlyBind( MS_REMOUNT | MS_BIND | MS_RDONLY ) );
+}
+
+void
+PartitionServiceTests::testUnmountOptions()
+{
+    int flags = 0;
+    bool recursive = false;
+
+    QVERIFY( parseUnmountOptions( {}, flags, recursive ) );
+    QCOMPARE( flags, 0 );
+    QVERIFY( !recursive );
+
+    QVERIFY( parseUnmountOptions( { "-lv" }, flags, recursive ) );
+    QCOMPARE( flags, int( MNT_DETACH ) );
+    QVERIFY( !recursive );
+
+    QVERIFY( parseUnmountOptions( { "-R" }, flags, recursive ) );
+    QCOMPARE( flags, 0 );
+    QVERIFY( recursive );
+
+    QVERIFY( parseUnmountOptions( { "--lazy", "--force" }, flags, recursive ) );
+    QCOMPARE( flags, int( MNT_DETACH | MNT_FORCE ) );
+    QVERIFY( !recursive );
+
+    QVERIFY( !parseUnmountOptions( { "-a" }, flags, recursive ) );
+    QVERIFY( !parseUnmountOptions( { "--all-targets" }, flags, recursive ) );
+}
+
+/// @brief Is @p mountPoint in the mount table?
+static bool
+isMounted( const QString& mountPoint )
+{
+    const auto mounts = CalamaresUtils::Partition::MtabInfo::fromMtabFilteredByPrefix(
+        QString(), QStringLiteral( "/proc/self/mounts" ) );
+    return std::any_of(
+        mounts.cbegin(), mounts.cend(), [ &mountPoint ]( const auto& m ) { return m.mountPoint == mountPoint; } );
+}
+
+/// @brief Is the filesystem at @p path mounted read-only?
+static bool
+isReadOnly( const QString& path )
+{
+    struct statvfs info;
+    return statvfs( QFile::encodeName( path ).constData(), &info ) == 0 && ( info.f_flag & ST_RDONLY );
+}
+
+/** @brief Cleans up after testLoopMount, also when a check fails
+ *
+ * Restores PATH, unmounts whatever is left below the mount point
+ * and detaches the loop device.
+ */
+struct LoopMountCleanup
+{
+    QByteArray path;
+    QString mountPoint;
+    QString device;
+
+    ~LoopMountCleanup()
+    {
+        qputenv( "PATH", path );
+        if ( !mountPoint.isEmpty() && isMounted( mountPoint ) )
+        {
+            QProcess::execute( "umount", { "-R", "-l", mountPoint } );
+        }
+        if ( !device.isEmpty() )
+        {
+            QProcess::execute( "losetup", { "-d", device } );
+        }
+    }
+};
+
+void
+PartitionServiceTests::testLoopMount()
+{
+    if ( geteuid() != 0 )
+    {
+        QSKIP( "Mounting needs root" );
+    }
+
+    QTemporaryDir tempRoot( QDir::tempPath() + QStringLiteral( "/test-mount-XXXXXX" ) );
+    QVERIFY( tempRoot.isValid() );
+
+    const QString image = tempRoot.filePath( "image" );
+    {
+        QFile f( image );
+        QVERIFY( f.open( QIODevice::WriteOnly ) );
+        QVERIFY( f.resize( 8 * 1024 * 1024 ) );
+    }
+    if ( QProcess::execute( "mkfs.ext2", { "-q", "-F", image } ) != 0 )
+    {
+        QSKIP( "No mkfs.ext2" );
+    }
+    QProcess losetup;
+    losetup.start( "losetup", { "--find", "--show", image } );
+    if ( !losetup.waitForFinished() || losetup.exitCode() != 0 )
+    {
+        QSKIP( "No loop devices" );
+    }
+    const QString device = QString::fromLocal8Bit( losetup.readAllStandardOutput() ).trimmed();
+    QVERIFY( device.startsWith( "/dev/loop" ) );
+    const QString mountPoint = tempRoot.filePath( "mnt" );
+    LoopMountCleanup cleanup { qgetenv( "PATH" ), mountPoint, device };
+
+    // Stand-ins for sync and udevadm that record that they were called
+    const QString bin = tempRoot.filePath( "bin" );
+    const QString record = tempRoot.filePath( "called" );
+    QVERIFY( QDir().mkpath( bin ) );
+    for ( const auto& name : { "sync", "udevadm" } )
+    {
+        QFile script( bin + '/' + name );
+        QVERIFY( script.open( QIODevice::WriteOnly ) );
+        script.write( QStringLiteral( "#!/bin/sh\necho %1 >> %2\n" ).arg( name, record ).toUtf8() );
+        script.close();
+        QVERIFY( script.setPermissions( script.permissions() | QFile::ExeOwner ) );
+    }
+    qputenv( "PATH", QFile::encodeName( bin ) + ':' + cleanup.path );
+
+    const QString subMount = mountPoint + "/sub";
+    QCOMPARE( CalamaresUtils::Partition::mount( device, mountPoint, "ext2" ), 0 );
+    QVERIFY( isMounted( mountPoint ) );
+    QVERIFY( QDir().mkpath( subMount ) );
+    QCOMPARE( CalamaresUtils::Partition::mount( bin, subMount, QString(), "--bind" ), 0 );
+    QVERIFY( isMounted( subMount ) );
+    QVERIFY( QFile::exists( subMount + "/udevadm" ) );
+    QVERIFY( !isReadOnly( subMount ) );
+
+    // The kernel ignores ro when binding, so this takes a remount
+    const QString readOnlyMount = mountPoint + "/ro";
+    QVERIFY( QDir().mkpath( readOnlyMount ) );
+    QCOMPARE( CalamaresUtils::Partition::mount( bin, readOnlyMount, QString(), "bind,ro" ), 0 );
+    QVERIFY( isMounted( readOnlyMount ) );
+    QVERIFY( isReadOnly( readOnlyMount ) );
+    QVERIFY( !isReadOnly( bin ) );
+
+    QCOMPARE( CalamaresUtils::Partition::unmount( mountPoint, { "-R" } ), 0 );
+    QVERIFY( !isMounted( readOnlyMount ) );
+    QVERIFY( !isMounted( subMount ) );
+    QVERIFY( !isMounted( mountPoint ) );
+
+    // Only syncfs(2) on the one filesystem, no global sync and no settling
+    QVERIFY( !QFile::exists( record ) );
+}
 
 QTEST_GUILESS_MAIN( PartitionServiceTests )
 
@@ -0,0 +1,217 @@
+/* === This file is part of Calamares - <https://calamares.io> ===
+ *
+ *   SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *   SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ *   Calamares is Free Software: see the License-Identifier above.
+ *
+ */
+
+#include "ConfigCache.h"
+
+#include "CalamaresVersion.h"
+#include "utils/Logger.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <atomic>
+
+/// Bump this when the layout of the cache file changes
+static constexpr quint32 cacheFormatVersion = 2;
+static constexpr quint32 cacheMagic = 0x43436663;  // "CCfc"
+
+static std::atomic< CalamaresUtils::ConfigCache::Mode > s_mode { CalamaresUtils::ConfigCache::Mode::Use };
+static std::atomic< int > s_mismatches { 0 };
+
+static void
+setStreamVersion( QDataStream& stream )
+{
+    // Fixed, so that a Qt update doesn't silently change the format
+    stream.setVersion( QDataStream::Qt_5_9 );
+}
+
+/** @brief The state of each of the files (or directories) in @p paths
+ *
+ * A directory changes its modification time when entries are
+ * added or removed, so this notices files appearing in it, too.
+ */
+static QVariantList
+fingerprint( const QStringList& paths )
+{
+    QVariantList l;
+    for ( const auto& path : paths )
+    {
+        QFileInfo fi( path );
+        l.append( QVariantList { fi.absoluteFilePath(),
+                                 fi.exists() ? fi.size() : qint64( -1 ),
+                                 fi.exists() ? fi.lastModified().toMSecsSinceEpoch() : qint64( 0 ) } );
+    }
+    return l;
+}
+
+namespace CalamaresUtils
+{
+
+ConfigCache::ConfigCache( const QString& name, const QStringList& sources, const QVariant& context )
+    : m_name( name )
+{
+    const QDir cacheDir( QStandardPaths::writableLocation( QStandardPaths::CacheLocation ) );
+    m_filePath = cacheDir.filePath( name + QStringLiteral( ".cache" ) );
+
+    m_key.append( QStringLiteral( CALAMARES_VERSION ) );
+    m_key.append( context );
+    m_key.append( fingerprint( sources ) );
+}
+
+bool
+ConfigCache::load( QVariantMap& data ) const
+{
+    if ( mode() == Mode::Off )
+    {
+        return false;
+    }
+
+    QFile f( m_filePath );
+    if ( !f.open( QIODevice::ReadOnly ) )
+    {
+        return false;
+    }
+
+    QDataStream stream( &f );
+    setStreamVersion( stream );
+    quint32 magic = 0;
+    quint32 version = 0;
+    stream >> magic >> version;
+    if ( stream.status() != QDataStream::Ok || magic != cacheMagic || version != cacheFormatVersion )
+    {
+        cDebug() << "Ignoring cache" << m_filePath << "with unknown format.";
+        return false;
+    }
+
+    QVariantList key;
+    QStringList dependencies;
+    QVariantList dependencyKey;
+    QVariantMap cached;
+    stream >> key >> dependencies >> dependencyKey >> cached;
+    if ( stream.status() != QDataStream::Ok || !stream.atEnd() )
+    {
+        cWarning() << "Ignoring damaged cache" << m_filePath;
+        return false;
+    }
+    if ( key != m_key || dependencyKey != fingerprint( dependencies ) )
+    {
+        cDebug() << "Cache" << m_filePath << "is out of date.";
+        return false;
+    }
+
+    data = cached;
+    return true;
+}
+
+bool
+ConfigCache::store( const QVariantMap& data, const QStringList& dependencies ) const
+{
+    if ( mode() == Mode::Off )
+    {
+        return false;
+    }
+
+    QDir cacheDir = QFileInfo( m_filePath ).absoluteDir();
+    if ( !cacheDir.exists() && !cacheDir.mkpath( QStringLiteral( "." ) ) )
+    {
+        cWarning() << "Could not create cache directory" << cacheDir.absolutePath();
+        return false;
+    }
+
+    QByteArray contents;
+    {
+        QDataStream stream( &contents, QIODevice::WriteOnly );
+        setStreamVersion( stream );
+        stream << cacheMagic << cacheFormatVersion << m_key << dependencies << fingerprint( dependencies ) << data;
+        if ( stream.status() != QDataStream::Ok )
+        {
+            cWarning() << "Could not serialize" << m_name << "for the cache.";
+            return false;
+        }
+    }
+
+    QSaveFile f( m_filePath );
+    if ( !f.open( QIODevice::WriteOnly ) || f.write( contents ) < 0 || !f.commit() )
+    {
+        cWarning() << "Could not write cache" << m_filePath;
+        return false;
+    }
+    return true;
+}
+
+bool
+ConfigCache::verify( const QVariantMap& cached, const QVariantMap& fresh ) const
+{
+    if ( cached == fresh )
+    {
+        cDebug() << "Cached" << m_name << "matches the configuration.";
+        return true;
+    }
+
+    QStringList keys = cached.keys() + fresh.keys();
+    keys.removeDuplicates();
+    for ( const auto& k : qAsConst( keys ) )
+    {
+        if ( cached.value( k ) != fresh.value( k ) )
+        {
+            cWarning() << "Cached" << m_name << "differs in" << k << Logger::Continuation << "cached"
+                       << cached.value( k ) << Logger::Continuation << "parsed" << fresh.value( k );
+        }
+    }
+    s_mismatches++;
+    return false;
+}
+
+ConfigCache::Mode
+ConfigCache::mode()
+{
+    return s_mode;
+}
+
+void
+ConfigCache::setMode( Mode m )
+{
+    s_mode = m;
+}
+
+bool
+ConfigCache::setMode( const QString& name )
+{
+    const QString n = name.trimmed().toLower();
+    if ( n == QStringLiteral( "off" ) )
+    {
+        setMode( Mode::Off );
+    }
+    else if ( n == QStringLiteral( "use" ) )
+    {
+        setMode( Mode::Use );
+    }
+    else if ( n == QStringLiteral( "verify" ) )
+    {
+        setMode( Mode::Verify );
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+int
+ConfigCache::mismatchCount()
+{
+    return s_mismatches;
+}
+
+}  // namespace CalamaresUtils
@@ -0,0 +1,103 @@
+/* === This file is part of Calamares - <https://calamares.io> ===
+ *
+ *   SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *   SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ *   Calamares is Free Software: see the License-Identifier above.
+ *
+ */
+
+/**@file Cache of interpreted configuration files
+ *
+ * Reading the central configuration (settings.conf, branding.desc) means
+ * parsing YAML and then looking for files mentioned in it. The result of
+ * all that is a handful of strings and numbers, which can be stored in
+ * binary form and read back on the next start. The cache is only used
+ * if the files it was made from have not changed since.
+ */
+
+#ifndef UTILS_CONFIGCACHE_H
+#define UTILS_CONFIGCACHE_H
+
+#include "DllMacro.h"
+
+#include <QStringList>
+#include <QVariantList>
+#include <QVariantMap>
+
+namespace CalamaresUtils
+{
+
+/** @brief Cached data derived from configuration files
+ *
+ * The data is a QVariantMap, stored with QDataStream in the
+ * cache directory (usually ~/.cache/calamares/) along with a key:
+ * the size and modification time of each of the source files,
+ * the version of Calamares and an (optional) extra context
+ * value. Cached data is only returned if the key still matches.
+ *
+ * Files and directories that only turn out to matter while the
+ * sources are interpreted can be passed to store() as dependencies;
+ * they are checked in the same way when the cache is loaded.
+ *
+ * Callers that cache paths of other files (e.g. images) should check
+ * that those still exist before using the cached data.
+ */
+class DLLEXPORT ConfigCache
+{
+public:
+    enum class Mode
+    {
+        Off,  ///< Never use the cache (nor write it)
+        Use,  ///< Use cached data if it is still valid (the default)
+        Verify  ///< Always parse the sources, and compare with the cache
+    };
+
+    /** @brief Cache @p name for data derived from the files @p sources
+     *
+     * The @p context is anything else the data depends on (e.g. the
+     * debug-mode flag); a change in context invalidates the cache.
+     */
+    ConfigCache( const QString& name, const QStringList& sources, const QVariant& context = QVariant() );
+
+    /** @brief Load the cached data into @p data
+     *
+     * Returns @c false (and leaves @p data alone) if there is no
+     * cache, if it is stale or damaged, or if the mode is Off.
+     */
+    bool load( QVariantMap& data ) const;
+    /** @brief Store @p data in the cache (unless the mode is Off)
+     *
+     * The @p dependencies are other files and directories that the
+     * data was derived from; a change in any of them (including
+     * one appearing or disappearing) invalidates the cache, too.
+     */
+    bool store( const QVariantMap& data, const QStringList& dependencies = QStringList() ) const;
+    /** @brief Compare @p cached and @p fresh data
+     *
+     * Differences are logged and counted in mismatchCount(). Returns
+     * @c true if the data is the same.
+     */
+    bool verify( const QVariantMap& cached, const QVariantMap& fresh ) const;
+
+    QString filePath() const { return m_filePath; }
+
+    static Mode mode();
+    static void setMode( Mode m );
+    /** @brief Set the mode by @p name (off, use or verify)
+     *
+     * Returns @c false, and leaves the mode alone, for other names.
+     */
+    static bool setMode( const QString& name );
+    /// @brief Number of failed verify() calls since startup
+    static int mismatchCount();
+
+private:
+    QString m_name;
+    QString m_filePath;
+    QVariantList m_key;
+};
+
+}  // namespace CalamaresUtils
+
+#endif
@@ -17,6 +17,10 @@
 #include <QCoreApplication>
 #include <QDir>
 #include <QEvent>
+#include <QFile>
+#include <QHash>
+#include <QMap>
+#include <QResource>
 #include <QTranslator>
 
 namespace
@@ -64,11 +68,18 @@ struct CalamaresLoader : public TranslationLoader
     bool tryLoad( QTranslator* translator ) override;
 };
 
-/// @brief Loads timezone name translations
-struct TZLoader : public TranslationLoader
+/// @brief Loads translations for a module (e.g. timezone names) with a given prefix
+struct ModuleLoader : public TranslationLoader
 {
-    using TranslationLoader::TranslationLoader;
+    ModuleLoader( const QString& locale, const QString& prefix )
+        : TranslationLoader( locale )
+        , m_prefix( prefix )
+    {
+    }
+
     bool tryLoad( QTranslator* translator ) override;
+
+    QString m_prefix;
 };
 
 TranslationLoader::~TranslationLoader() {}
@@ -102,11 +113,123 @@ BrandingLoader::tryLoad( QTranslator* translator )
     return false;
 }
 
+/** @brief A translation catalogue (.qm data) that stays in memory
+ *
+ * Catalogues in QRC are used in-place (the translations QRC is not
+ * compressed, so the data is part of the mapped executable); catalogues
+ * in files are mmap'ed. Either way, nothing is copied to the heap and
+ * switching back and forth between languages costs no I/O.
+ */
+struct Catalogue
+{
+    const uchar* data = nullptr;
+    int size = 0;
+};
+
+static bool
+isUncompressed( const QResource& resource )
+{
+#if QT_VERSION < QT_VERSION_CHECK( 5, 13, 0 )
+    return !resource.isCompressed();
+#else
+    return resource.compressionAlgorithm() == QResource::NoCompression;
+#endif
+}
+
+/// @brief Map the catalogue @p filename, if it exists
+static Catalogue
+mapCatalogue( const QString& filename )
+{
+    Catalogue c;
+    if ( filename.startsWith( ':' ) )
+    {
+        QResource resource( filename );
+        if ( resource.isValid() && isUncompressed( resource ) && resource.size() > 0 )
+        {
+            c.data = resource.data();
+            c.size = int( resource.size() );
+        }
+    }
+    else
+    {
+        auto* file = new QFile( filename );
+        const bool canMap = file->open( QIODevice::ReadOnly ) && file->size() > 0;
+        uchar* data = canMap ? file->map( 0, file->size() ) : nullptr;
+        if ( data )
+        {
+            // The file stays open (and mapped)
+            c.data = data;
+            c.size = int( file->size() );
+        }
+        else
+        {
+            delete file;
+        }
+    }
+    return c;
+}
+
+/** @brief Finds the catalogue for @p path (without .qm)
+ *
+ * Like QTranslator::load(), this tries with and without .qm, and then
+ * drops parts of the name after _ or . so that e.g. "calamares_de_DE"
+ * finds "calamares_de".
+ *
+ * Looked-up catalogues, and catalogues that don't exist, are remembered
+ * for the rest of the program: the mappings are never undone, since
+ * translators may be using them.
+ */
+static Catalogue
+findCatalogue( const QString& path )
+{
+    static QHash< QString, Catalogue > catalogues;
+
+    const auto it = catalogues.constFind( path );
+    if ( it != catalogues.constEnd() )
+    {
+        return *it;
+    }
+
+    Catalogue c;
+    const int directoryLength = path.lastIndexOf( '/' ) + 1;
+    QString name = path;
+    while ( true )
+    {
+        c = mapCatalogue( name + QStringLiteral( ".qm" ) );
+        if ( !c.data )
+        {
+            c = mapCatalogue( name );
+        }
+        const int delimiter = qMax( name.lastIndexOf( '_' ), name.lastIndexOf( '.' ) );
+        if ( c.data || delimiter <= directoryLength )
+        {
+            break;
+        }
+        name.truncate( delimiter );
+    }
+    catalogues.insert( path, c );
+    return c;
+}
+
+/// @brief Loads the catalogue at @p path (without .qm) into @p translator
+static bool
+loadCatalogue( QTranslator* translator, const QString& path )
+{
+    const auto c = findCatalogue( path );
+    if ( c.data )
+    {
+        return translator->load( c.data, c.size );
+    }
+    // A compressed QRC can't be used in-place; QTranslator will decompress it
+    return path.startsWith( ':' ) && translator->load( path );
+}
+
 static bool
 tryLoad( QTranslator* translator, const QString& prefix, const QString& localeName )
 {
     // In debug-mode, try loading from the current directory
-    if ( s_allowLocalTranslations && translator->load( prefix + localeName ) )
+    if ( s_allowLocalTranslations
+         && loadCatalogue( translator, QDir::current().absoluteFilePath( prefix + localeName ) ) )
     {
         cDebug() << Logger::SubEntry << "Loaded local translation" << prefix << localeName;
         return true;
@@ -115,14 +238,14 @@ tryLoad( QTranslator* translator, const QString& prefix, const QString& localeNa
     // Or load from appDataDir -- often /usr/share/calamares -- subdirectory land/
     QDir localeData( CalamaresUtils::appDataDir() );
     if ( localeData.exists()
-         && translator->load( localeData.absolutePath() + QStringLiteral( "/lang/" ) + prefix + localeName ) )
+         && loadCatalogue( translator, localeData.absolutePath() + QStringLiteral( "/lang/" ) + prefix + localeName ) )
     {
         cDebug() << Logger::SubEntry << "Loaded appdata translation" << prefix << localeName;
         return true;
     }
 
     // Or from QRC (most common)
-    if ( translator->load( QStringLiteral( ":/lang/" ) + prefix + localeName ) )
+    if ( loadCatalogue( translator, QStringLiteral( ":/lang/" ) + prefix + localeName ) )
     {
         cDebug() << Logger::SubEntry << "Loaded QRC translation" << prefix << localeName;
         return true;
@@ -130,7 +253,7 @@ tryLoad( QTranslator* translator, const QString& prefix, const QString& localeNa
     else
     {
         cDebug() << Logger::SubEntry << "No translation for" << prefix << localeName << "using default (en)";
-        return translator->load( QStringLiteral( ":/lang/" ) + prefix + QStringLiteral( "en" ) );
+        return loadCatalogue( translator, QStringLiteral( ":/lang/" ) + prefix + QStringLiteral( "en" ) );
     }
 }
 
@@ -141,9 +264,9 @@ CalamaresLoader::tryLoad( QTranslator* translator )
 }
 
 bool
-TZLoader::tryLoad( QTranslator* translator )
+ModuleLoader::tryLoad( QTranslator* translator )
 {
-    return ::tryLoad( translator, QStringLiteral( "tz_" ), m_localeName );
+    return ::tryLoad( translator, m_prefix, m_localeName );
 }
 
 static void
@@ -168,19 +291,42 @@ namespace CalamaresUtils
 {
 static QTranslator* s_brandingTranslator = nullptr;
 static QTranslator* s_translator = nullptr;
-static QTranslator* s_tztranslator = nullptr;
 static QString s_translatorLocaleName;
+static QString s_brandingTranslationsPrefix;
+/// Module translators, by prefix; these are loaded only once a module asks
+static QMap< QString, QTranslator* > s_moduleTranslators;
 
 void
 installTranslator( const CalamaresUtils::Locale::Translation::Id& locale, const QString& brandingTranslationsPrefix )
 {
+    if ( s_translator && locale.name == s_translatorLocaleName
+         && brandingTranslationsPrefix == s_brandingTranslationsPrefix )
+    {
+        // Nothing changes, and re-installing would cause a retranslation of everything
+        return;
+    }
     s_translatorLocaleName = locale.name;
+    s_brandingTranslationsPrefix = brandingTranslationsPrefix;
 
     loadSingletonTranslator( BrandingLoader( locale.name, brandingTranslationsPrefix ), s_brandingTranslator );
-    loadSingletonTranslator( TZLoader( locale.name ), s_tztranslator );
+    for ( auto it = s_moduleTranslators.begin(); it != s_moduleTranslators.end(); ++it )
+    {
+        loadSingletonTranslator( ModuleLoader( locale.name, it.key() ), it.value() );
+    }
     loadSingletonTranslator( CalamaresLoader( locale.name ), s_translator );
 }
 
+void
+installModuleTranslator( const QString& prefix )
+{
+    if ( s_moduleTranslators.contains( prefix ) )
+    {
+        return;
+    }
+    QTranslator*& translator = s_moduleTranslators[ prefix ];
+    loadSingletonTranslator( ModuleLoader( s_translatorLocaleName, prefix ), translator );
+}
+
 void
 installTranslator()
 {
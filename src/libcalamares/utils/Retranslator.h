@@ -28,6 +28,10 @@ namespace CalamaresUtils
 /** @brief changes the application language.
  * @param locale the new locale (names as defined by Calamares).
  * @param brandingTranslationsPrefix the branding path prefix, from Calamares::Branding.
+ *
+ * This loads the application and branding translations, and the
+ * translations of modules that have called installModuleTranslator().
+ * Installing the same locale again does nothing.
  */
 DLLEXPORT void installTranslator( const CalamaresUtils::Locale::Translation::Id& locale,
                                   const QString& brandingTranslationsPrefix );
@@ -36,6 +40,16 @@ DLLEXPORT void installTranslator( const CalamaresUtils::Locale::Translation::Id&
  */
 DLLEXPORT void installTranslator();
 
+/** @brief Installs the <prefix><locale> translations for a module
+ *
+ * Translations that only a module needs (e.g. "tz_" for timezone names)
+ * are not loaded at startup; the module calls this when it is first
+ * shown. From then on, the translations follow the language set
+ * with installTranslator(). Calling this again for the same @p prefix
+ * does nothing.
+ */
+DLLEXPORT void installModuleTranslator( const QString& prefix );
+
 /** @brief The name of the (locale of the) most recently installed translator
  *
  * May return something different from the locale.name() of the
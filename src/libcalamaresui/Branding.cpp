@@ -15,6 +15,7 @@
 
 #include "GlobalStorage.h"
 #include "utils/CalamaresUtilsGui.h"
+#include "utils/ConfigCache.h"
 #include "utils/ImageRegistry.h"
 #include "utils/Logger.h"
 #include "utils/NamedEnum.h"
@@ -169,10 +170,62 @@ uploadServerFromMap( const QVariantMap& map )
     return Branding::UploadServerInfo {
         names.find( typestring, bogus ),
         QUrl( urlstring, QUrl::ParsingMode::StrictMode ),
-        sizeLimitKiB >= 0 ? CalamaresUtils::KiBtoBytes( static_cast< unsigned long long >( sizeLimitKiB ) ) : -1
+        sizeLimitKiB >= 0 ? CalamaresUtils::KiBtoBytes( static_cast< unsigned long long >( sizeLimitKiB ) ) : -1,
+        map[ "compress" ].toBool()
     };
 }
 
+/** @brief The files that the branding depends on
+ *
+ * The descriptor, and os-release if that is used to expand the strings.
+ */
+static QStringList
+brandingSources( const QString& descriptorPath )
+{
+    QStringList sources { descriptorPath };
+#ifdef WITH_KOSRelease
+    sources << QStringLiteral( "/etc/os-release" ) << QStringLiteral( "/usr/lib/os-release" );
+#endif
+    return sources;
+}
+
+static QVariantMap
+stringMapToVariant( const QMap< QString, QString >& map )
+{
+    QVariantMap m;
+    for ( auto it = map.constBegin(); it != map.constEnd(); ++it )
+    {
+        m.insert( it.key(), it.value() );
+    }
+    return m;
+}
+
+static QMap< QString, QString >
+variantToStringMap( const QVariant& v )
+{
+    QMap< QString, QString > map;
+    const auto m = v.toMap();
+    for ( auto it = m.constBegin(); it != m.constEnd(); ++it )
+    {
+        map.insert( it.key(), it.value().toString() );
+    }
+    return map;
+}
+
+static QVariant
+dimensionToVariant( const Branding::WindowDimension& d )
+{
+    return QVariantList { d.value(), int( d.unit() ) };
+}
+
+static Branding::WindowDimension
+variantToDimension( const QVariant& v )
+{
+    const auto l = v.toList();
+    const auto unit = Branding::WindowDimensionUnit( l.value( 1 ).toInt() );
+    return Branding::WindowDimension( l.value( 0 ).toLongLong(), unit );
+}
+
 /** @brief Load the @p map with strings from @p config
  *
  * If os-release is supported (with KF5 CoreAddons >= 5.58) then
@@ -184,6 +237,8 @@ Branding::Branding( const QString& brandingFilePath, QObject* parent )
     : QObject( parent )
     , m_descriptorPath( brandingFilePath )
     , m_slideshowAPI( 1 )
+    , m_slideshowPreload( 2 )
+    , m_slideshowCacheSize( 16 )
     , m_welcomeStyleCalamares( false )
     , m_welcomeExpandingLogo( true )
 {
@@ -195,7 +250,40 @@ Branding::Branding( const QString& brandingFilePath, QObject* parent )
         bail( m_descriptorPath, "Bad component directory path." );
     }
 
-    QFile file( brandingFilePath );
+    using CalamaresUtils::ConfigCache;
+    ConfigCache cache( QStringLiteral( "branding-" ) + componentDir.dirName(), brandingSources( brandingFilePath ) );
+    QVariantMap cached;
+    const bool haveCache = cache.load( cached );
+    if ( haveCache && ConfigCache::mode() == ConfigCache::Mode::Use && setCacheData( cached ) )
+    {
+        cDebug() << Logger::SubEntry << "Using cached branding" << cache.filePath();
+    }
+    else if ( loadDescriptor( componentDir ) )
+    {
+        const auto fresh = cacheData();
+        if ( haveCache && ConfigCache::mode() == ConfigCache::Mode::Verify )
+        {
+            cache.verify( cached, fresh );
+        }
+        cache.store( fresh );
+    }
+
+    s_instance = this;
+    if ( m_componentName.isEmpty() )
+    {
+        cWarning() << "Failed to load component from" << brandingFilePath;
+    }
+    else
+    {
+        cDebug() << "Loaded branding component" << m_componentName;
+    }
+}
+
+
+bool
+Branding::loadDescriptor( const QDir& componentDir )
+{
+    QFile file( m_descriptorPath );
     if ( file.exists() && file.open( QFile::ReadOnly | QFile::Text ) )
     {
         QByteArray ba = file.readAll();
@@ -285,17 +373,113 @@ Branding::Branding( const QString& brandingFilePath, QObject* parent )
     else
     {
         cWarning() << "Cannot read branding file" << file.fileName();
+        return false;
     }
+    return true;
+}
 
-    s_instance = this;
-    if ( m_componentName.isEmpty() )
+
+QVariantMap
+Branding::cacheData() const
+{
+    return QVariantMap {
+        { QStringLiteral( "componentName" ), m_componentName },
+        { QStringLiteral( "strings" ), stringMapToVariant( m_strings ) },
+        { QStringLiteral( "images" ), stringMapToVariant( m_images ) },
+        { QStringLiteral( "style" ), stringMapToVariant( m_style ) },
+        { QStringLiteral( "uploadServer" ),
+          QVariantMap { { QStringLiteral( "type" ), int( m_uploadServer.type ) },
+                        { QStringLiteral( "url" ), m_uploadServer.url.toString() },
+                        { QStringLiteral( "size" ), m_uploadServer.size },
+                        { QStringLiteral( "compress" ), m_uploadServer.compress } } },
+        { QStringLiteral( "slideshowImages" ), m_slideshowFilenames },
+        { QStringLiteral( "slideshowPath" ), m_slideshowPath },
+        { QStringLiteral( "slideshowAPI" ), m_slideshowAPI },
+        { QStringLiteral( "slideshowPreload" ), m_slideshowPreload },
+        { QStringLiteral( "slideshowCacheSize" ), m_slideshowCacheSize },
+        { QStringLiteral( "translations" ), m_translationsPathPrefix },
+        { QStringLiteral( "welcomeStyleCalamares" ), m_welcomeStyleCalamares },
+        { QStringLiteral( "welcomeExpandingLogo" ), m_welcomeExpandingLogo },
+        { QStringLiteral( "windowExpansion" ), int( m_windowExpansion ) },
+        { QStringLiteral( "windowWidth" ), dimensionToVariant( m_windowWidth ) },
+        { QStringLiteral( "windowHeight" ), dimensionToVariant( m_windowHeight ) },
+        { QStringLiteral( "windowPlacement" ), int( m_windowPlacement ) },
+        { QStringLiteral( "sidebarFlavor" ), int( m_sidebarFlavor ) },
+        { QStringLiteral( "sidebarSide" ), int( m_sidebarSide ) },
+        { QStringLiteral( "navigationFlavor" ), int( m_navigationFlavor ) },
+        { QStringLiteral( "navigationSide" ), int( m_navigationSide ) },
+    };
+}
+
+bool
+Branding::setCacheData( const QVariantMap& data )
+{
+    // Anything missing from older (or damaged) data means: parse again
+    const auto reference = cacheData();
+    for ( auto it = reference.constBegin(); it != reference.constEnd(); ++it )
     {
-        cWarning() << "Failed to load component from" << brandingFilePath;
+        if ( !data.contains( it.key() ) )
+        {
+            return false;
+        }
     }
-    else
+
+    const QString componentName = data.value( "componentName" ).toString();
+    if ( componentName != QDir( componentDirectory() ).dirName() )
     {
-        cDebug() << "Loaded branding component" << m_componentName;
+        return false;
+    }
+
+    // The files the cache points to must still be there, and icon names
+    // must still be in the theme; if not, parsing again explains what is wrong.
+    const auto images = variantToStringMap( data.value( "images" ) );
+    for ( const auto& image : images )
+    {
+        if ( image.contains( '/' ) ? !QFileInfo::exists( image ) : QIcon::fromTheme( image ).isNull() )
+        {
+            return false;
+        }
     }
+    const QStringList slideshowImages = data.value( "slideshowImages" ).toStringList();
+    for ( const auto& image : slideshowImages )
+    {
+        if ( !QFileInfo::exists( image ) )
+        {
+            return false;
+        }
+    }
+    const QString slideshowPath = data.value( "slideshowPath" ).toString();
+    if ( !slideshowPath.isEmpty() && !QFileInfo::exists( slideshowPath ) )
+    {
+        return false;
+    }
+
+    m_componentName = componentName;
+    m_strings = variantToStringMap( data.value( "strings" ) );
+    m_images = images;
+    m_style = variantToStringMap( data.value( "style" ) );
+    const auto upload = data.value( "uploadServer" ).toMap();
+    m_uploadServer = UploadServerInfo { UploadServerType( upload.value( "type" ).toInt() ),
+                                        QUrl( upload.value( "url" ).toString(), QUrl::ParsingMode::StrictMode ),
+                                        upload.value( "size" ).toLongLong(),
+                                        upload.value( "compress" ).toBool() };
+    m_slideshowFilenames = slideshowImages;
+    m_slideshowPath = slideshowPath;
+    m_slideshowAPI = data.value( "slideshowAPI" ).toInt();
+    m_slideshowPreload = data.value( "slideshowPreload" ).toInt();
+    m_slideshowCacheSize = data.value( "slideshowCacheSize" ).toInt();
+    m_translationsPathPrefix = data.value( "translations" ).toString();
+    m_welcomeStyleCalamares = data.value( "welcomeStyleCalamares" ).toBool();
+    m_welcomeExpandingLogo = data.value( "welcomeExpandingLogo" ).toBool();
+    m_windowExpansion = WindowExpansion( data.value( "windowExpansion" ).toInt() );
+    m_windowWidth = variantToDimension( data.value( "windowWidth" ) );
+    m_windowHeight = variantToDimension( data.value( "windowHeight" ) );
+    m_windowPlacement = WindowPlacement( data.value( "windowPlacement" ).toInt() );
+    m_sidebarFlavor = PanelFlavor( data.value( "sidebarFlavor" ).toInt() );
+    m_sidebarSide = PanelSide( data.value( "sidebarSide" ).toInt() );
+    m_navigationFlavor = PanelFlavor( data.value( "navigationFlavor" ).toInt() );
+    m_navigationSide = PanelSide( data.value( "navigationSide" ).toInt() );
+    return true;
 }
 
 
@@ -604,6 +788,8 @@ Branding::initSlideshowSettings( const YAML::Node& doc )
 
         m_slideshowFilenames = slideShowPictures;
         m_slideshowAPI = -1;
+        m_slideshowPreload = qMax( 0, doc[ "slideshowPreload" ].as< int >( 2 ) );
+        m_slideshowCacheSize = qMax( 0, doc[ "slideshowCacheSize" ].as< int >( 16 ) );
     }
 #ifdef WITH_QML
     else if ( slideshow.IsScalar() )
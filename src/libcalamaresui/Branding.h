@@ -24,6 +24,9 @@
 #include <QSize>
 #include <QStringList>
 #include <QUrl>
+#include <QVariantMap>
+
+class QDir;
 
 namespace YAML
 {
@@ -186,6 +189,10 @@ public:
      *  - -1    For oldschool image-slideshows.
      */
     int slideshowAPI() const { return m_slideshowAPI; }
+    /// @brief How many upcoming slideshow images to decode ahead of time (API == -1)
+    int slideshowPreload() const { return m_slideshowPreload; }
+    /// @brief Memory budget for decoded slideshow images, in MiB (API == -1)
+    int slideshowCacheSize() const { return m_slideshowCacheSize; }
 
     QPixmap image( Branding::ImageEntry imageEntry, const QSize& size ) const;
 
@@ -230,15 +237,17 @@ public:
 
     /** @brief Upload server configuration
      *
-     * This object has 3 items : the type (which may be none, in which case the URL
-     * is irrelevant and usually empty), the URL for the upload and the size limit of upload
-     * in bytes (for configuration value < 0, it serves -1, which stands for having no limit).
+     * This object has 4 items : the type (which may be none, in which case the URL
+     * is irrelevant and usually empty), the URL for the upload, the size limit of upload
+     * in bytes (for configuration value < 0, it serves -1, which stands for having no limit)
+     * and whether to send the log gzip-compressed.
      */
     struct UploadServerInfo
     {
         UploadServerType type;
         QUrl url;
         qint64 size;
+        bool compress = false;
 
         operator bool() const { return type != Calamares::Branding::UploadServerType::None && size != 0; }
     };
@@ -290,8 +299,25 @@ private:
     QStringList m_slideshowFilenames;
     QString m_slideshowPath;
     int m_slideshowAPI;
+    int m_slideshowPreload;
+    int m_slideshowCacheSize;
     QString m_translationsPathPrefix;
 
+    /** @brief Read and interpret the descriptor file
+     *
+     * Returns @c false if the file can't be read; exits if
+     * the branding is broken.
+     */
+    bool loadDescriptor( const QDir& componentDir );
+    /// @brief The interpreted branding, for the cache
+    QVariantMap cacheData() const;
+    /** @brief Restore the branding from @p data made by cacheData()
+     *
+     * Returns @c false (and changes nothing) if the data is incomplete,
+     * or the files it names are no longer there.
+     */
+    bool setCacheData( const QVariantMap& data );
+
     /** @brief Initialize the simple settings below */
     void initSimpleSettings( const YAML::Node& doc );
     ///@brief Initialize the slideshow settings, above
@@ -0,0 +1,145 @@
+/* === This file is part of Calamares - <https://calamares.io> ===
+ *
+ *   SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *   SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ *
+ *   Calamares is Free Software: see the License-Identifier above.
+ *
+ *
+ */
+
+#include "Branding.h"
+
+#include "utils/ConfigCache.h"
+#include "utils/Logger.h"
+
+#include <QTemporaryDir>
+#include <QtTest/QtTest>
+
+using CalamaresUtils::ConfigCache;
+
+class TestBranding : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestBranding() {}
+    ~TestBranding() override {}
+
+private Q_SLOTS:
+    void initTestCase();
+    void testCache();
+
+private:
+    QTemporaryDir m_dir;
+    QString m_descriptor;
+};
+
+void
+TestBranding::initTestCase()
+{
+    Logger::setupLogLevel( Logger::LOGDEBUG );
+    QStandardPaths::setTestModeEnabled( true );
+    QVERIFY( m_dir.isValid() );
+
+    // A copy of the default branding, which the tests can change
+    QDir source( QStringLiteral( BUILD_AS_TEST "/../branding/default" ) );
+    QVERIFY( source.exists() );
+    QDir target( m_dir.path() );
+    QVERIFY( target.mkdir( "default" ) );
+    QVERIFY( target.cd( "default" ) );
+    for ( const auto& name : source.entryList( QDir::Files ) )
+    {
+        QVERIFY( QFile::copy( source.filePath( name ), target.filePath( name ) ) );
+    }
+    m_descriptor = target.filePath( "branding.desc" );
+}
+
+/// @brief Checks that @p a and @p b have the same branding
+static void
+compareBranding( const Calamares::Branding& a, const Calamares::Branding& b )
+{
+    using B = Calamares::Branding;
+    QCOMPARE( a.componentName(), b.componentName() );
+    QCOMPARE( a.string( B::ProductName ), b.string( B::ProductName ) );
+    QCOMPARE( a.string( B::VersionedName ), b.string( B::VersionedName ) );
+    QCOMPARE( a.imagePath( B::ProductLogo ), b.imagePath( B::ProductLogo ) );
+    QCOMPARE( a.styleString( B::SidebarText ), b.styleString( B::SidebarText ) );
+    QCOMPARE( a.slideshowPath(), b.slideshowPath() );
+    QCOMPARE( a.slideshowImages(), b.slideshowImages() );
+    QCOMPARE( a.slideshowAPI(), b.slideshowAPI() );
+    QCOMPARE( a.translationsDirectory(), b.translationsDirectory() );
+    QCOMPARE( a.windowSize().first.value(), b.windowSize().first.value() );
+    QCOMPARE( a.windowSize().second.value(), b.windowSize().second.value() );
+    QCOMPARE( a.windowPlacementCentered(), b.windowPlacementCentered() );
+    QVERIFY( a.sidebarFlavor() == b.sidebarFlavor() );
+    QVERIFY( a.navigationSide() == b.navigationSide() );
+    QVERIFY( a.uploadServer().type == b.uploadServer().type );
+    QCOMPARE( a.uploadServer().url, b.uploadServer().url );
+}
+
+void
+TestBranding::testCache()
+{
+    using B = Calamares::Branding;
+
+    const QString cacheFile = ConfigCache( QStringLiteral( "branding-default" ), {} ).filePath();
+    QFile::remove( cacheFile );
+    const int mismatches = ConfigCache::mismatchCount();
+
+    // Self-check: parse every time, and compare with the cache once there is one
+    ConfigCache::setMode( ConfigCache::Mode::Verify );
+    B cold( m_descriptor );
+    QCOMPARE( cold.componentName(), QStringLiteral( "default" ) );
+    QVERIFY( cold.imagePath( B::ProductLogo ).endsWith( "/default/squid.png" ) );
+    QVERIFY( QFile::exists( cacheFile ) );
+    B verified( m_descriptor );
+    QCOMPARE( ConfigCache::mismatchCount(), mismatches );
+    compareBranding( cold, verified );
+
+    // Warm start from the cache
+    ConfigCache::setMode( ConfigCache::Mode::Use );
+    B warm( m_descriptor );
+    compareBranding( cold, warm );
+
+    // A changed descriptor is parsed again
+    {
+        QFile f( m_descriptor );
+        QVERIFY( f.open( QIODevice::ReadOnly ) );
+        QByteArray contents = f.readAll();
+        f.close();
+        QVERIFY( contents.contains( "shortProductName:    Generic" ) );
+        contents.replace( "shortProductName:    Generic", "shortProductName:    Specific" );
+        QVERIFY( f.open( QIODevice::WriteOnly | QIODevice::Truncate ) );
+        f.write( contents );
+    }
+    B changed( m_descriptor );
+    QCOMPARE( changed.shortProductName(), QStringLiteral( "Specific" ) );
+    QCOMPARE( changed.productName(), cold.productName() );
+
+    // A damaged cache is ignored (and replaced)
+    {
+        QFile f( cacheFile );
+        QVERIFY( f.open( QIODevice::WriteOnly | QIODevice::Truncate ) );
+        f.write( "not a cache" );
+    }
+    B repaired( m_descriptor );
+    QCOMPARE( repaired.shortProductName(), QStringLiteral( "Specific" ) );
+    compareBranding( cold, repaired );
+    B warmAgain( m_descriptor );
+    compareBranding( repaired, warmAgain );
+    QCOMPARE( warmAgain.shortProductName(), QStringLiteral( "Specific" ) );
+
+    ConfigCache::setMode( ConfigCache::Mode::Off );
+    QFile::remove( cacheFile );
+    B uncached( m_descriptor );
+    compareBranding( cold, uncached );
+    QVERIFY( !QFile::exists( cacheFile ) );
+}
+
+QTEST_MAIN( TestBranding )
+
+#include "utils/moc-warnings.h"
+
+#include "TestBranding.moc"
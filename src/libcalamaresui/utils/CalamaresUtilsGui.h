@@ -78,6 +78,14 @@ UIDLLEXPORT QPixmap defaultPixmap( ImageType type,
                                    ImageMode mode = CalamaresUtils::Original,
                                    const QSize& size = QSize( 0, 0 ) );
 
+/**
+ * @brief prewarmDefaultPixmaps renders all the ImageTypes in the background
+ *
+ * Afterwards, defaultPixmap() for any ImageType at the given @p size
+ * (and Original mode) is served from the cache.
+ */
+UIDLLEXPORT void prewarmDefaultPixmaps( const QSize& size );
+
 // TODO:3.3:This has only one consumer, move to ImageRegistry, make static
 /**
  * @brief createRoundedImage returns a rounded version of a pixmap.
@@ -8,11 +8,36 @@
 
 #include "ImageRegistry.h"
 
+#include <QFutureWatcher>
+#include <QGuiApplication>
 #include <QIcon>
 #include <QPainter>
 #include <QSvgRenderer>
+#include <QtConcurrent/QtConcurrent>
 
-static QHash< QString, QHash< int, QHash< qint64, QPixmap > > > s_cache;
+/// @brief Default memory budget of the cache, in KiB
+static constexpr const int defaultBudgetKiB = 32 * 1024;
+
+uint
+qHash( const ImageRegistry::CacheKey& key, uint seed )
+{
+    return qHash( key.image, seed ) ^ qHash( key.mode, seed ) ^ qHash( key.size.width(), seed )
+        ^ qHash( key.size.height() << 16, seed ) ^ qHash( qRound( key.devicePixelRatio * 100 ), seed );
+}
+
+/// @brief Memory used by @p pixmap, in KiB (at least 1, so that everything counts)
+static int
+cost( const QPixmap& pixmap )
+{
+    const qint64 bytes = qint64( pixmap.width() ) * pixmap.height() * qMax( pixmap.depth(), 8 ) / 8;
+    return int( qMax< qint64 >( 1, bytes / 1024 ) );
+}
+
+static qreal
+devicePixelRatio()
+{
+    return qGuiApp ? qGuiApp->devicePixelRatio() : 1.0;
+}
 
 
 ImageRegistry*
@@ -23,7 +48,10 @@ ImageRegistry::instance()
 }
 
 
-ImageRegistry::ImageRegistry() {}
+ImageRegistry::ImageRegistry()
+    : m_cache( defaultBudgetKiB )
+{
+}
 
 
 QIcon
@@ -33,13 +61,6 @@ ImageRegistry::icon( const QString& image, CalamaresUtils::ImageMode mode )
 }
 
 
-qint64
-ImageRegistry::cacheKey( const QSize& size )
-{
-    return size.width() * 100 + size.height() * 10;
-}
-
-
 QPixmap
 ImageRegistry::pixmap( const QString& image, const QSize& size, CalamaresUtils::ImageMode mode )
 {
@@ -49,93 +70,155 @@ ImageRegistry::pixmap( const QString& image, const QSize& size, CalamaresUtils::
         return QPixmap();
     }
 
-    QHash< qint64, QPixmap > subsubcache;
-    QHash< int, QHash< qint64, QPixmap > > subcache;
-
-    if ( s_cache.contains( image ) )
+    const qreal dpr = devicePixelRatio();
+    const CacheKey key { image, int( mode ), size, dpr };
     {
-        subcache = s_cache.value( image );
-
-        if ( subcache.contains( mode ) )
+        QMutexLocker lock( &m_mutex );
+        if ( const QPixmap* cached = m_cache.object( key ) )
         {
-            subsubcache = subcache.value( mode );
-
-            const qint64 ck = cacheKey( size );
-            if ( subsubcache.contains( ck ) )
-            {
-                return subsubcache.value( ck );
-            }
+            ++m_hits;
+            return *cached;
         }
+        ++m_misses;
     }
 
     // Image not found in cache. Let's load it.
-    QPixmap pixmap;
-    if ( image.toLower().endsWith( ".svg" ) )
+    QPixmap pixmap = QPixmap::fromImage( render( image, size, dpr ) );
+    if ( !pixmap.isNull() )
     {
-        QSvgRenderer svgRenderer( image );
-        QPixmap p( size.isNull() || size.height() == 0 || size.width() == 0 ? svgRenderer.defaultSize() : size );
-        p.fill( Qt::transparent );
+        if ( mode == CalamaresUtils::RoundedCorners )
+        {
+            pixmap = CalamaresUtils::createRoundedImage( pixmap, size * dpr );
+            pixmap.setDevicePixelRatio( dpr );
+        }
+
+        putInCache( key, pixmap );
+    }
 
-        QPainter pixPainter( &p );
-        svgRenderer.render( &pixPainter );
-        pixPainter.end();
+    return pixmap;
+}
+
+
+QImage
+ImageRegistry::render( const QString& image, const QSize& size, qreal devicePixelRatio )
+{
+    const QSize deviceSize = size * devicePixelRatio;
+
+    QImage img;
+    const QString lowerImage = image.toLower();
+    if ( lowerImage.endsWith( ".svg" ) || lowerImage.endsWith( ".svgz" ) )
+    {
+        QSvgRenderer svgRenderer( image );
+        img = QImage( deviceSize.isNull() || deviceSize.height() == 0 || deviceSize.width() == 0
+                          ? svgRenderer.defaultSize()
+                          : deviceSize,
+                      QImage::Format_ARGB32_Premultiplied );
+        if ( img.isNull() )
+        {
+            return img;
+        }
+        img.fill( Qt::transparent );
 
-        pixmap = p;
+        QPainter imgPainter( &img );
+        svgRenderer.render( &imgPainter );
+        imgPainter.end();
     }
     else
     {
-        pixmap = QPixmap( image );
+        img = QImage( image );
     }
 
-    if ( !pixmap.isNull() )
+    if ( !img.isNull() && !deviceSize.isNull() && img.size() != deviceSize )
     {
-        if ( mode == CalamaresUtils::RoundedCorners )
+        if ( deviceSize.width() == 0 )
         {
-            pixmap = CalamaresUtils::createRoundedImage( pixmap, size );
+            img = img.scaledToHeight( deviceSize.height(), Qt::SmoothTransformation );
         }
+        else if ( deviceSize.height() == 0 )
+        {
+            img = img.scaledToWidth( deviceSize.width(), Qt::SmoothTransformation );
+        }
+        else
+        {
+            img = img.scaled( deviceSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation );
+        }
+    }
+
+    img.setDevicePixelRatio( devicePixelRatio );
+    return img;
+}
+
+
+void
+ImageRegistry::prewarm( const QStringList& images, const QSize& size )
+{
+    if ( images.isEmpty() || size.width() < 0 || size.height() < 0 )
+    {
+        return;
+    }
+
+    using Rendered = QVector< QPair< QString, QImage > >;
+    using Watcher = QFutureWatcher< Rendered >;
 
-        if ( !size.isNull() && pixmap.size() != size )
+    const qreal dpr = devicePixelRatio();
+    auto* watcher = new Watcher();
+    QObject::connect( watcher, &Watcher::finished, watcher, [ this, watcher, size, dpr ]() {
+        // Back in the GUI thread, where pixmaps may be created
+        for ( const auto& r : watcher->result() )
         {
-            if ( size.width() == 0 )
+            const CacheKey key { r.first, int( CalamaresUtils::Original ), size, dpr };
+            if ( r.second.isNull() )
             {
-                pixmap = pixmap.scaledToHeight( size.height(), Qt::SmoothTransformation );
+                continue;
             }
-            else if ( size.height() == 0 )
             {
-                pixmap = pixmap.scaledToWidth( size.width(), Qt::SmoothTransformation );
-            }
-            else
-            {
-                pixmap = pixmap.scaled( size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation );
+                QMutexLocker lock( &m_mutex );
+                if ( m_cache.contains( key ) )
+                {
+                    continue;
+                }
             }
+            putInCache( key, QPixmap::fromImage( r.second ) );
         }
+        watcher->deleteLater();
+    } );
+    watcher->setFuture( QtConcurrent::run( [ images, size, dpr ]() {
+        Rendered rendered;
+        rendered.reserve( images.count() );
+        for ( const auto& image : images )
+        {
+            rendered.append( qMakePair( image, render( image, size, dpr ) ) );
+        }
+        return rendered;
+    } ) );
+}
 
-        putInCache( image, size, mode, pixmap );
-    }
 
-    return pixmap;
+void
+ImageRegistry::setBudget( int kib )
+{
+    QMutexLocker lock( &m_mutex );
+    m_cache.setMaxCost( qMax( 0, kib ) );
 }
 
 
-void
-ImageRegistry::putInCache( const QString& image,
-                           const QSize& size,
-                           CalamaresUtils::ImageMode mode,
-                           const QPixmap& pixmap )
+ImageRegistry::Statistics
+ImageRegistry::statistics() const
 {
-    QHash< qint64, QPixmap > subsubcache;
-    QHash< int, QHash< qint64, QPixmap > > subcache;
+    QMutexLocker lock( &m_mutex );
+    Statistics s;
+    s.hits = m_hits;
+    s.misses = m_misses;
+    s.count = m_cache.count();
+    s.costKiB = m_cache.totalCost();
+    s.budgetKiB = m_cache.maxCost();
+    return s;
+}
 
-    if ( s_cache.contains( image ) )
-    {
-        subcache = s_cache.value( image );
-        if ( subcache.contains( mode ) )
-        {
-            subsubcache = subcache.value( mode );
-        }
-    }
 
-    subsubcache.insert( cacheKey( size ), pixmap );
-    subcache.insert( mode, subsubcache );
-    s_cache.insert( image, subcache );
+void
+ImageRegistry::putInCache( const CacheKey& key, const QPixmap& pixmap )
+{
+    QMutexLocker lock( &m_mutex );
+    m_cache.insert( key, new QPixmap( pixmap ), cost( pixmap ) );
 }
@@ -9,14 +9,38 @@
 #ifndef IMAGE_REGISTRY_H
 #define IMAGE_REGISTRY_H
 
+#include <QCache>
+#include <QImage>
+#include <QMutex>
 #include <QPixmap>
 
 #include "DllMacro.h"
 #include "utils/CalamaresUtilsGui.h"
 
+/** @brief Cache of (scaled) images, by filename
+ *
+ * Images are cached by path, mode, size and device-pixel-ratio.
+ * The cache has a memory budget; the least-recently-used images
+ * are evicted when the budget is exceeded.
+ *
+ * Pixmaps are GUI-thread objects, so pixmap() and icon() must be
+ * called from the GUI thread. Reading and rasterizing images (which
+ * for SVG files can be slow) can be done on a worker thread through
+ * render(), and prewarm() uses that to fill the cache in the background.
+ */
 class UIDLLEXPORT ImageRegistry
 {
 public:
+    /// @brief Hit-and-miss information about the cache
+    struct Statistics
+    {
+        quint64 hits = 0;
+        quint64 misses = 0;
+        int count = 0;  ///< Number of images in the cache
+        int costKiB = 0;  ///< Memory used by those images
+        int budgetKiB = 0;  ///< Memory budget of the cache
+    };
+
     static ImageRegistry* instance();
 
     explicit ImageRegistry();
@@ -25,9 +49,48 @@ public:
     QPixmap
     pixmap( const QString& image, const QSize& size, CalamaresUtils::ImageMode mode = CalamaresUtils::Original );
 
+    /** @brief Rasterize @p images at @p size on a worker thread
+     *
+     * When the worker is done, the images are added to the cache
+     * (in the GUI thread) so that later calls to pixmap() for the same
+     * image and size are cheap. Only CalamaresUtils::Original mode
+     * is pre-warmed.
+     */
+    void prewarm( const QStringList& images, const QSize& size );
+
+    /** @brief Reads and scales @p image to @p size (in device-independent pixels)
+     *
+     * The image is rendered at @p size scaled by @p devicePixelRatio.
+     * This is thread-safe. Returns a null image if the file can't be read.
+     */
+    static QImage render( const QString& image, const QSize& size, qreal devicePixelRatio = 1.0 );
+
+    /// @brief Sets the memory budget of the cache, in KiB
+    void setBudget( int kib );
+    Statistics statistics() const;
+
 private:
-    qint64 cacheKey( const QSize& size );
-    void putInCache( const QString& image, const QSize& size, CalamaresUtils::ImageMode mode, const QPixmap& pixmap );
+    struct CacheKey
+    {
+        QString image;
+        int mode;
+        QSize size;
+        qreal devicePixelRatio;
+
+        bool operator==( const CacheKey& other ) const
+        {
+            return image == other.image && mode == other.mode && size == other.size
+                && qFuzzyCompare( devicePixelRatio, other.devicePixelRatio );
+        }
+    };
+    friend uint qHash( const CacheKey& key, uint seed );
+
+    void putInCache( const CacheKey& key, const QPixmap& pixmap );
+
+    mutable QMutex m_mutex;
+    QCache< CacheKey, QPixmap > m_cache;
+    quint64 m_hits = 0;
+    quint64 m_misses = 0;
 };
 
 #endif  // IMAGE_REGISTRY_H
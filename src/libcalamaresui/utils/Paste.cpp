@@ -19,19 +19,37 @@
 #include <QClipboard>
 #include <QFile>
 #include <QFileInfo>
+#include <QFutureWatcher>
 #include <QMessageBox>
+#include <QProgressDialog>
 #include <QTcpSocket>
+#include <QTimer>
 #include <QUrl>
 #include <QWidget>
+#include <QtConcurrent/QtConcurrent>
+
+#ifdef WITH_ZLIB
+#include <zlib.h>
+#endif
 
 using namespace CalamaresUtils::Units;
 
-/** @brief Reads the logfile, returns its contents.
+using CalamaresUtils::Paste::UploadState;
+
+/// @brief Size of the chunks read from the log file
+static constexpr const qint64 chunkSize = 64 * 1024;
+/// @brief How long to wait for the server in one go, to notice cancellation
+static constexpr const int pollIntervalMs = 100;
+/// @brief How long to wait for the server, overall, at each step
+static constexpr const int serverTimeoutMs = 30000;
+
+/** @brief Opens the logfile, positioned so that at most @p sizeLimitBytes remain
  *
- * Returns an empty QByteArray() on any kind of error.
+ * Returns the number of bytes to read from @p logFile, or -1 on any kind
+ * of error (@p logFile is not open, then).
  */
-STATICTEST QByteArray
-logFileContents( const qint64 sizeLimitBytes )
+STATICTEST qint64
+openLogFile( QFile& logFile, const qint64 sizeLimitBytes )
 {
     if ( sizeLimitBytes > 0 )
     {
@@ -40,68 +58,241 @@ logFileContents( const qint64 sizeLimitBytes )
     if ( sizeLimitBytes == 0 )
     {
         cDebug() << "Log upload size is 0, upload disabled.";
-        return QByteArray();
+        return -1;
     }
 
-    const QString name = Logger::logFile();
-    QFile pasteSourceFile( name );
-    if ( !pasteSourceFile.open( QIODevice::ReadOnly | QIODevice::Text ) )
+    logFile.setFileName( Logger::logFile() );
+    if ( !logFile.open( QIODevice::ReadOnly ) )
     {
-        cWarning() << "Could not open log file" << name;
-        return QByteArray();
+        cWarning() << "Could not open log file" << logFile.fileName();
+        return -1;
     }
-    if ( sizeLimitBytes < 0 )
-    {
-        return pasteSourceFile.readAll();
-    }
-    QFileInfo fi( pasteSourceFile );
-    if ( fi.size() > sizeLimitBytes )
+    QFileInfo fi( logFile );
+    if ( sizeLimitBytes > 0 && fi.size() > sizeLimitBytes )
     {
         cDebug() << "Only last" << sizeLimitBytes << "bytes of log file (sized" << fi.size() << "bytes) uploaded";
         fi.refresh();  // Because we just wrote to the file with that cDebug() ^^
-        pasteSourceFile.seek( fi.size() - sizeLimitBytes );
+        logFile.seek( fi.size() - sizeLimitBytes );
+        return sizeLimitBytes;
     }
-    return pasteSourceFile.read( sizeLimitBytes );
+    // Whatever is logged while uploading is not sent
+    return fi.size();
 }
 
+static bool
+isCancelled( const UploadState* state )
+{
+    return state && state->cancel;
+}
+
+enum class Wait
+{
+    Connected,
+    BytesWritten,
+    ReadyRead
+};
+
+/** @brief Waits (up to serverTimeoutMs) for the @p socket to be ready
+ *
+ * Returns @c false on errors, timeout, and cancellation.
+ */
+static bool
+waitFor( QTcpSocket& socket, Wait what, const UploadState* state )
+{
+    for ( int waited = 0; waited < serverTimeoutMs; waited += pollIntervalMs )
+    {
+        if ( isCancelled( state ) )
+        {
+            cDebug() << "Log upload cancelled.";
+            return false;
+        }
+
+        bool done = false;
+        switch ( what )
+        {
+        case Wait::Connected:
+            done = socket.waitForConnected( pollIntervalMs );
+            break;
+        case Wait::BytesWritten:
+            done = socket.bytesToWrite() == 0 || socket.waitForBytesWritten( pollIntervalMs );
+            break;
+        case Wait::ReadyRead:
+            done = socket.waitForReadyRead( pollIntervalMs );
+            break;
+        }
+        if ( done )
+        {
+            return true;
+        }
+        if ( socket.error() != QAbstractSocket::SocketTimeoutError )
+        {
+            return false;
+        }
+    }
+    return false;
+}
 
+/// @brief Writes @p data to @p socket, waits until it is all sent
+static bool
+writeAll( QTcpSocket& socket, const QByteArray& data, const UploadState* state )
+{
+    if ( data.isEmpty() )
+    {
+        return true;
+    }
+    if ( socket.write( data ) != data.size() )
+    {
+        return false;
+    }
+    while ( socket.bytesToWrite() > 0 )
+    {
+        if ( !waitFor( socket, Wait::BytesWritten, state ) )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+#ifdef WITH_ZLIB
+/// @brief Compresses data in gzip format, a chunk at a time
+class GzipStream
+{
+public:
+    GzipStream()
+    {
+        // 15 bits of window, +16 for a gzip header
+        m_ok = deflateInit2( &m_z, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY ) == Z_OK;
+    }
+    ~GzipStream() { deflateEnd( &m_z ); }
+
+    bool isValid() const { return m_ok; }
+
+    /// @brief Compresses @p data; pass @p finish for the last chunk
+    QByteArray deflate( const QByteArray& data, bool finish )
+    {
+        QByteArray out;
+        char buffer[ 16 * 1024 ];
+        m_z.next_in = reinterpret_cast< Bytef* >( const_cast< char* >( data.constData() ) );
+        m_z.avail_in = uInt( data.size() );
+        int r = Z_OK;
+        do
+        {
+            m_z.next_out = reinterpret_cast< Bytef* >( buffer );
+            m_z.avail_out = sizeof( buffer );
+            r = ::deflate( &m_z, finish ? Z_FINISH : Z_NO_FLUSH );
+            if ( r == Z_STREAM_ERROR )
+            {
+                m_ok = false;
+                return QByteArray();
+            }
+            out.append( buffer, int( sizeof( buffer ) - m_z.avail_out ) );
+        } while ( m_z.avail_out == 0 || ( finish && r != Z_STREAM_END ) );
+        return out;
+    }
+
+private:
+    z_stream m_z {};
+    bool m_ok = false;
+};
+#endif
+
+/** @brief Sends @p size bytes from @p source to a fiche server at @p serverUrl
+ *
+ * The data is sent in chunks, gzip-compressed if @p compress is set,
+ * so that there is never much of it in memory. The @p state (if not
+ * @c nullptr) is updated with progress, and is checked for cancellation.
+ *
+ * Returns the URL the server sends back, or an empty string on failure.
+ */
 STATICTEST QString
-ficheLogUpload( const QByteArray& pasteData, const QUrl& serverUrl, QObject* parent )
+ficheLogUpload( QIODevice& source, qint64 size, const QUrl& serverUrl, bool compress, UploadState* state )
 {
-    QTcpSocket* socket = new QTcpSocket( parent );
+#ifdef WITH_ZLIB
+    std::unique_ptr< GzipStream > gzip;
+    if ( compress )
+    {
+        gzip = std::make_unique< GzipStream >();
+        if ( !gzip->isValid() )
+        {
+            cError() << "Could not compress log for paste server";
+            return QString();
+        }
+    }
+#else
+    if ( compress )
+    {
+        cWarning() << "Calamares was built without zlib, log is sent uncompressed.";
+    }
+#endif
+    if ( state )
+    {
+        state->total = size;
+        state->sent = 0;
+    }
+
+    QTcpSocket socket;
     // 16 bits of port-number
-    socket->connectToHost( serverUrl.host(), quint16( serverUrl.port() ) );
+    socket.connectToHost( serverUrl.host(), quint16( serverUrl.port() ) );
 
-    if ( !socket->waitForConnected() )
+    if ( !waitFor( socket, Wait::Connected, state ) )
     {
         cError() << "Could not connect to paste server";
-        socket->close();
+        socket.abort();
         return QString();
     }
 
     cDebug() << "Connected to paste server" << serverUrl.host();
 
-    socket->write( pasteData );
-
-    if ( !socket->waitForBytesWritten() )
+    qint64 sent = 0;
+    while ( sent < size )
+    {
+        QByteArray chunk = source.read( qMin( chunkSize, size - sent ) );
+        if ( chunk.isEmpty() )
+        {
+            // Shorter than expected, send what there is
+            break;
+        }
+        sent += chunk.size();
+#ifdef WITH_ZLIB
+        if ( gzip )
+        {
+            chunk = gzip->deflate( chunk, false );
+        }
+#endif
+        if ( !writeAll( socket, chunk, state ) )
+        {
+            cError() << "Could not write to paste server";
+            socket.abort();
+            return QString();
+        }
+        if ( state )
+        {
+            state->sent = sent;
+        }
+    }
+#ifdef WITH_ZLIB
+    // The gzip trailer, and whatever zlib was holding on to
+    if ( gzip && !writeAll( socket, gzip->deflate( QByteArray(), true ), state ) )
     {
         cError() << "Could not write to paste server";
-        socket->close();
+        socket.abort();
         return QString();
     }
+#endif
 
-    cDebug() << Logger::SubEntry << "Paste data written to paste server";
+    cDebug() << Logger::SubEntry << "Paste data written to paste server" << sent << "bytes";
 
-    if ( !socket->waitForReadyRead() )
+    if ( !waitFor( socket, Wait::ReadyRead, state ) )
     {
         cError() << "No data from paste server";
-        socket->close();
+        socket.abort();
         return QString();
     }
 
     cDebug() << Logger::SubEntry << "Reading response from paste server";
-    QByteArray responseText = socket->readLine( 1024 );
-    socket->close();
+    QByteArray responseText = socket.readLine( 1024 );
+    socket.close();
 
     QUrl pasteUrl = QUrl( QString( responseText ).trimmed(), QUrl::StrictMode );
     if ( pasteUrl.isValid() && pasteUrl.host() == serverUrl.host() )
@@ -116,10 +307,14 @@ ficheLogUpload( const QByteArray& pasteData, const QUrl& serverUrl, QObject* par
     }
 }
 
-QString
-CalamaresUtils::Paste::doLogUpload( QObject* parent )
+/** @brief Uploads the log file as configured in the branding
+ *
+ * This is run on a worker thread by LogUpload.
+ */
+static QString
+logUpload( const Calamares::Branding::UploadServerInfo& server, UploadState* state )
 {
-    auto [ type, serverUrl, sizeLimitBytes ] = Calamares::Branding::instance()->uploadServer();
+    auto [ type, serverUrl, sizeLimitBytes, compress ] = server;
     if ( !serverUrl.isValid() )
     {
         cWarning() << "Upload configured with invalid URL";
@@ -137,8 +332,9 @@ CalamaresUtils::Paste::doLogUpload( QObject* parent )
         return QString();
     }
 
-    QByteArray pasteData = logFileContents( sizeLimitBytes );
-    if ( pasteData.isEmpty() )
+    QFile logFile;
+    const qint64 size = openLogFile( logFile, sizeLimitBytes );
+    if ( size <= 0 )
     {
         // An error has already been logged
         return QString();
@@ -150,16 +346,108 @@ CalamaresUtils::Paste::doLogUpload( QObject* parent )
         cWarning() << "No upload configured.";
         return QString();
     case Calamares::Branding::UploadServerType::Fiche:
-        return ficheLogUpload( pasteData, serverUrl, parent );
+        return ficheLogUpload( logFile, size, serverUrl, compress, state );
     }
     return QString();
 }
 
+CalamaresUtils::Paste::LogUpload::LogUpload( QObject* parent )
+    : QObject( parent )
+    , m_state( std::make_shared< UploadState >() )
+    , m_progressTimer( new QTimer( this ) )
+{
+    m_progressTimer->setInterval( 250 );
+    connect( m_progressTimer, &QTimer::timeout, this, &LogUpload::reportProgress );
+}
+
+CalamaresUtils::Paste::LogUpload::~LogUpload()
+{
+    // The worker keeps the state alive until it notices
+    cancel();
+}
+
+bool
+CalamaresUtils::Paste::LogUpload::start()
+{
+    if ( m_running || !isEnabled() )
+    {
+        return false;
+    }
+
+    using Watcher = QFutureWatcher< QString >;
+
+    // A fresh state, since a cancelled worker may still be using the old one
+    m_state = std::make_shared< UploadState >();
+    m_running = true;
+    auto* watcher = new Watcher( this );
+    connect( watcher, &Watcher::finished, this, [ this, watcher ]() {
+        m_running = false;
+        m_progressTimer->stop();
+        reportProgress();
+        const QString url = m_state->cancel ? QString() : watcher->result();
+        watcher->deleteLater();
+        emit finished( url );
+    } );
+    m_progressTimer->start();
+
+    const auto server = Calamares::Branding::instance()->uploadServer();
+    auto state = m_state;
+    watcher->setFuture( QtConcurrent::run( [ server, state ]() { return logUpload( server, state.get() ); } ) );
+    return true;
+}
+
+void
+CalamaresUtils::Paste::LogUpload::cancel()
+{
+    m_state->cancel = true;
+}
+
+void
+CalamaresUtils::Paste::LogUpload::reportProgress()
+{
+    emit progress( m_state->sent, m_state->total );
+}
+
 QString
 CalamaresUtils::Paste::doLogUploadUI( QWidget* parent )
 {
+    QString pasteUrl;
+    bool cancelled = false;
+    {
+        QProgressDialog progress( QCoreApplication::translate( "Calamares::ViewManager", "Uploading install log..." ),
+                                  QCoreApplication::translate( "Calamares::ViewManager", "&Cancel" ),
+                                  0,
+                                  100,
+                                  parent );
+        progress.setWindowModality( Qt::WindowModal );
+        progress.setMinimumDuration( 0 );
+        progress.setAutoReset( false );
+        progress.setAutoClose( false );
+
+        // Parented to the dialog, so that it is cancelled when the dialog goes away
+        LogUpload* upload = new LogUpload( &progress );
+        QObject::connect( upload, &LogUpload::progress, &progress, [ &progress ]( qint64 sent, qint64 total ) {
+            progress.setValue( total > 0 ? int( sent * 100 / total ) : 0 );
+        } );
+        QObject::connect( upload, &LogUpload::finished, &progress, [ &progress, &pasteUrl ]( const QString& url ) {
+            pasteUrl = url;
+            progress.accept();
+        } );
+        QObject::connect( &progress, &QProgressDialog::canceled, upload, [ upload, &cancelled ]() {
+            cancelled = true;
+            upload->cancel();
+        } );
+        if ( upload->start() )
+        {
+            progress.exec();
+        }
+    }
+    if ( cancelled )
+    {
+        return QString();
+    }
+
     // These strings originated in the ViewManager class
-    QString pasteUrl = CalamaresUtils::Paste::doLogUpload( parent );
     QString pasteUrlMessage;
     if ( pasteUrl.isEmpty() )
     {
@@ -193,6 +481,6 @@ CalamaresUtils::Paste::doLogUploadUI( QWidget* parent )
 bool
 CalamaresUtils::Paste::isEnabled()
 {
-    auto [ type, serverUrl, sizeLimitBytes ] = Calamares::Branding::instance()->uploadServer();
+    auto [ type, serverUrl, sizeLimitBytes, compress ] = Calamares::Branding::instance()->uploadServer();
     return type != Calamares::Branding::UploadServerType::None && sizeLimitBytes != 0;
 }
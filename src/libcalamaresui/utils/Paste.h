@@ -10,24 +10,78 @@
 #ifndef UTILS_PASTE_H
 #define UTILS_PASTE_H
 
+#include "DllMacro.h"
+
+#include <QObject>
 #include <QString>
 
-class QObject;
+#include <atomic>
+#include <memory>
+
+class QTimer;
 class QWidget;
 
 namespace CalamaresUtils
 {
 namespace Paste
 {
-/** @brief Send the current log file to a pastebin
+/// @brief Shared between the GUI and the upload on a worker thread
+struct UploadState
+{
+    std::atomic< bool > cancel { false };
+    std::atomic< qint64 > sent { 0 };  ///< Bytes of the log read and sent
+    std::atomic< qint64 > total { 0 };  ///< Bytes of the log to send
+};
+
+/** @brief Sends the current log file to a pastebin, on a worker thread
  *
- * Returns the (string) URL that the pastebin gives us.
+ * The log file is read in chunks, (optionally) compressed as it
+ * is read, and sent to the pastebin configured in the branding.
+ * Nothing blocks the thread that calls start(); progress() is
+ * emitted a few times per second while sending, and finished()
+ * once when the upload is done, has failed, or was cancelled.
  */
-QString doLogUpload( QObject* parent );
+class UIDLLEXPORT LogUpload : public QObject
+{
+    Q_OBJECT
+public:
+    explicit LogUpload( QObject* parent = nullptr );
+    /// @brief Cancels the upload, if it is still running
+    ~LogUpload() override;
+
+    /** @brief Start the upload
+     *
+     * Returns @c false (and does not emit finished()) if paste is not
+     * enabled, or is already running.
+     */
+    bool start();
+    /** @brief Stop the upload as soon as possible
+     *
+     * The worker thread notices this within a fraction of a second;
+     * finished() is then emitted with an empty URL.
+     */
+    void cancel();
+
+    bool isRunning() const { return m_running; }
+
+signals:
+    /// @brief @p sent out of @p total bytes of the log have been sent
+    void progress( qint64 sent, qint64 total );
+    /// @brief Upload is done; @p url is empty on failure or cancellation
+    void finished( const QString& url );
+
+private:
+    void reportProgress();
+
+    std::shared_ptr< UploadState > m_state;
+    QTimer* m_progressTimer;
+    bool m_running = false;
+};
 
 /** @brief Send the current log file to a pastebin
  *
- * As doLogUpload(), but also sets the clipboard and displays
+ * As LogUpload, but shows the progress (with a button to cancel
+ * the upload), and then sets the clipboard and displays
  * a message saying it's been done.
  */
 QString doLogUploadUI( QWidget* parent );
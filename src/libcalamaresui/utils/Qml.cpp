@@ -17,9 +17,13 @@
 #include "network/Manager.h"
 #include "utils/Dirs.h"
 #include "utils/Logger.h"
+#include "utils/Retranslator.h"
 
 #include <QByteArray>
+#include <QCoreApplication>
 #include <QObject>
+#include <QQmlEngine>
+#include <QQmlIncubator>
 #include <QQuickItem>
 #include <QString>
 #include <QVariant>
@@ -241,4 +245,59 @@ registerQmlModels()
     }
 }
 
+/** @brief Drives incubation (asynchronous creation) on the shared engine
+ *
+ * Otherwise, the first QQuickWidget on the engine installs a controller
+ * that only makes progress while that widget is shown. This one works
+ * a few milliseconds per event-loop iteration, whatever is on screen.
+ */
+class TimerIncubationController : public QObject, public QQmlIncubationController
+{
+public:
+    explicit TimerIncubationController( QObject* parent )
+        : QObject( parent )
+    {
+    }
+
+protected:
+    void incubatingObjectCountChanged( int count ) override
+    {
+        if ( count > 0 && !m_timerId )
+        {
+            m_timerId = startTimer( 16 );
+        }
+        else if ( count == 0 && m_timerId )
+        {
+            killTimer( m_timerId );
+            m_timerId = 0;
+        }
+    }
+
+    void timerEvent( QTimerEvent* ) override { incubateFor( 5 ); }
+
+private:
+    int m_timerId = 0;
+};
+
+QQmlEngine*
+qmlEngine()
+{
+    static QQmlEngine* engine = nullptr;
+    if ( !engine )
+    {
+        registerQmlModels();
+
+        // Owned by the application, so it outlives the view steps using it
+        engine = new QQmlEngine( QCoreApplication::instance() );
+        engine->addImportPath( qmlModulesDir().absolutePath() );
+        // Before any QQuickWidget can install its own
+        engine->setIncubationController( new TimerIncubationController( engine ) );
+        cDebug() << "QML import paths:" << Logger::DebugList( engine->importPathList() );
+#if QT_VERSION >= QT_VERSION_CHECK( 5, 10, 0 )
+        CALAMARES_RETRANSLATE_FOR( engine, engine->retranslate(); );
+#endif
+    }
+    return engine;
+}
+
 }  // namespace CalamaresUtils
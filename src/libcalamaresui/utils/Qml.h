@@ -17,6 +17,7 @@
 
 #include <QDir>
 
+class QQmlEngine;
 class QQuickItem;
 
 namespace CalamaresUtils
@@ -48,6 +49,19 @@ UIDLLEXPORT bool initQmlModulesDir();
  */
 UIDLLEXPORT void registerQmlModels();
 
+/** @brief The QML engine shared by all of Calamares
+ *
+ * Every QML view step (and the QML slideshow) shows its QML through
+ * this engine, so that the engine is set up, and QML imports and
+ * types loaded, only once. The engine has the QML modules directory
+ * in its import paths, and the global Calamares models are registered
+ * (see registerQmlModels()). Objects that need their own context
+ * properties should create a child context of the root context.
+ *
+ * The engine is created on first use, which must be in the GUI thread.
+ */
+UIDLLEXPORT QQmlEngine* qmlEngine();
+
 /** @brief Calls the QML method @p method on @p qmlObject
  *
  * Pass in only the name of the method (e.g. onActivate). This function
@@ -0,0 +1,117 @@
+/* === This file is part of Calamares - <https://calamares.io> ===
+ *
+ *   SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *   SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ *
+ *   Calamares is Free Software: see the License-Identifier above.
+ *
+ *
+ */
+
+#include "ImageRegistry.h"
+
+#include "utils/Logger.h"
+
+#include <QTemporaryDir>
+#include <QtTest/QtTest>
+
+class TestImageRegistry : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestImageRegistry() {}
+    ~TestImageRegistry() override {}
+
+private Q_SLOTS:
+    void initTestCase();
+    void testSizeKeys();
+    void testEviction();
+    void testPrewarm();
+
+private:
+    QTemporaryDir m_dir;
+    QString m_png;
+};
+
+void
+TestImageRegistry::initTestCase()
+{
+    Logger::setupLogLevel( Logger::LOGDEBUG );
+    QVERIFY( m_dir.isValid() );
+
+    QImage img( 64, 64, QImage::Format_ARGB32 );
+    img.fill( Qt::red );
+    m_png = m_dir.filePath( "red.png" );
+    QVERIFY( img.save( m_png ) );
+}
+
+void
+TestImageRegistry::testSizeKeys()
+{
+    ImageRegistry r;
+
+    // These sizes collided in the old width*100 + height*10 cache key
+    QPixmap a = r.pixmap( m_png, QSize( 10, 20 ) );
+    QPixmap b = r.pixmap( m_png, QSize( 12, 0 ) );
+    QCOMPARE( a.size(), QSize( 10, 20 ) );
+    QCOMPARE( b.size(), QSize( 12, 12 ) );
+
+    auto s = r.statistics();
+    QCOMPARE( s.misses, quint64( 2 ) );
+    QCOMPARE( s.hits, quint64( 0 ) );
+    QCOMPARE( s.count, 2 );
+
+    QPixmap c = r.pixmap( m_png, QSize( 10, 20 ) );
+    QCOMPARE( c.size(), QSize( 10, 20 ) );
+    s = r.statistics();
+    QCOMPARE( s.hits, quint64( 1 ) );
+    QCOMPARE( s.count, 2 );
+}
+
+void
+TestImageRegistry::testEviction()
+{
+    ImageRegistry r;
+    // Each 64x64 ARGB image is 16KiB
+    r.setBudget( 40 );
+
+    QVERIFY( !r.pixmap( m_png, QSize( 64, 64 ) ).isNull() );
+    QVERIFY( !r.pixmap( m_png, QSize( 64, 63 ) ).isNull() );
+    QCOMPARE( r.statistics().count, 2 );
+    QVERIFY( !r.pixmap( m_png, QSize( 63, 64 ) ).isNull() );
+    QCOMPARE( r.statistics().count, 2 );
+    QVERIFY( r.statistics().costKiB <= 40 );
+
+    // The first one was least-recently used, so it is gone
+    const auto misses = r.statistics().misses;
+    r.pixmap( m_png, QSize( 63, 64 ) );
+    QCOMPARE( r.statistics().misses, misses );
+    r.pixmap( m_png, QSize( 64, 64 ) );
+    QCOMPARE( r.statistics().misses, misses + 1 );
+}
+
+void
+TestImageRegistry::testPrewarm()
+{
+    ImageRegistry r;
+
+    QImage img = ImageRegistry::render( m_png, QSize( 32, 0 ) );
+    QCOMPARE( img.size(), QSize( 32, 32 ) );
+    QVERIFY( ImageRegistry::render( m_dir.filePath( "missing.png" ), QSize( 32, 32 ) ).isNull() );
+
+    r.prewarm( { m_png }, QSize( 16, 16 ) );
+    QTRY_COMPARE( r.statistics().count, 1 );
+    QCOMPARE( r.statistics().misses, quint64( 0 ) );
+
+    QCOMPARE( r.pixmap( m_png, QSize( 16, 16 ) ).size(), QSize( 16, 16 ) );
+    QCOMPARE( r.statistics().hits, quint64( 1 ) );
+    QCOMPARE( r.statistics().misses, quint64( 0 ) );
+}
+
+QTEST_MAIN( TestImageRegistry )
+
+#include "utils/moc-warnings.h"
+
+#include "TestImageRegistry.moc"
@@ -14,11 +14,141 @@
 
 #include "utils/Logger.h"
 
+#include <QBuffer>
 #include <QDateTime>
+#include <QSemaphore>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QThread>
 #include <QtTest/QtTest>
 
-extern QByteArray logFileContents( qint64 sizeLimitBytes );
-extern QString ficheLogUpload( const QByteArray& pasteData, const QUrl& serverUrl, QObject* parent );
+#ifdef WITH_ZLIB
+#include <zlib.h>
+#endif
+
+using CalamaresUtils::Paste::UploadState;
+
+extern qint64 openLogFile( QFile& logFile, const qint64 sizeLimitBytes );
+extern QString
+ficheLogUpload( QIODevice& source, qint64 size, const QUrl& serverUrl, bool compress, UploadState* state );
+
+/// @brief Reads the (limited) log file, as it would be uploaded
+static QByteArray
+logFileContents( qint64 sizeLimitBytes )
+{
+    QFile f;
+    const qint64 size = openLogFile( f, sizeLimitBytes );
+    return size > 0 ? f.read( size ) : QByteArray();
+}
+
+/// @brief Uploads @p data to @p serverUrl
+static QString
+ficheLogUpload( const QByteArray& data, const QUrl& serverUrl, bool compress = false )
+{
+    QBuffer buffer;
+    buffer.setData( data );
+    buffer.open( QIODevice::ReadOnly );
+    return ficheLogUpload( buffer, data.size(), serverUrl, compress, nullptr );
+}
+
+/** @brief A fiche-like paste server, for one paste
+ *
+ * This runs on its own thread, since the upload blocks. It reads until
+ * the client is quiet for a bit, like fiche does, or until the end
+ * of a gzip stream if it is started with @c compressed set. It answers
+ * with a URL on the same host.
+ */
+class TestPasteServer : public QThread
+{
+public:
+    explicit TestPasteServer( bool compressed )
+        : m_compressed( compressed )
+    {
+    }
+
+    /// @brief Starts the thread, returns the server's URL
+    QUrl listen()
+    {
+        start();
+        m_listening.acquire();
+        return QUrl( QStringLiteral( "http://127.0.0.1:%1" ).arg( m_port ) );
+    }
+
+    QByteArray received() const { return m_received; }
+
+protected:
+    void run() override
+    {
+        QTcpServer server;
+        server.listen( QHostAddress::LocalHost );
+        m_port = server.serverPort();
+        m_listening.release();
+
+        if ( !server.waitForNewConnection( 5000 ) )
+        {
+            return;
+        }
+        QTcpSocket* socket = server.nextPendingConnection();
+        QByteArray data;
+        while ( socket->waitForReadyRead( 500 ) )
+        {
+            data.append( socket->readAll() );
+            if ( m_compressed && isCompleteGzip( data ) )
+            {
+                break;
+            }
+        }
+        m_received = m_compressed ? gunzip( data ) : data;
+
+        socket->write( "http://127.0.0.1/paste\n" );
+        socket->waitForBytesWritten( 1000 );
+        socket->disconnectFromHost();
+        delete socket;
+    }
+
+private:
+#ifdef WITH_ZLIB
+    static QByteArray inflate( const QByteArray& data, bool* complete )
+    {
+        QByteArray out;
+        z_stream z {};
+        inflateInit2( &z, 15 + 16 );  // gzip header
+        z.next_in = reinterpret_cast< Bytef* >( const_cast< char* >( data.constData() ) );
+        z.avail_in = uInt( data.size() );
+        char buffer[ 4096 ];
+        int r = Z_OK;
+        do
+        {
+            z.next_out = reinterpret_cast< Bytef* >( buffer );
+            z.avail_out = sizeof( buffer );
+            r = ::inflate( &z, Z_NO_FLUSH );
+            out.append( buffer, int( sizeof( buffer ) - z.avail_out ) );
+        } while ( r == Z_OK && z.avail_out == 0 );
+        inflateEnd( &z );
+        *complete = r == Z_STREAM_END;
+        return out;
+    }
+    static bool isCompleteGzip( const QByteArray& data )
+    {
+        bool complete = false;
+        (void)inflate( data, &complete );
+        return complete;
+    }
+    static QByteArray gunzip( const QByteArray& data )
+    {
+        bool complete = false;
+        return inflate( data, &complete );
+    }
+#else
+    static bool isCompleteGzip( const QByteArray& ) { return false; }
+    static QByteArray gunzip( const QByteArray& data ) { return data; }
+#endif
+
+    bool m_compressed;
+    QSemaphore m_listening;
+    quint16 m_port = 0;
+    QByteArray m_received;
+};
 
 class TestPaste : public QObject
 {
@@ -32,6 +162,9 @@ private Q_SLOTS:
     void testGetLogFile();
     void testFichePaste();
     void testUploadSize();
+    void testLocalPaste_data();
+    void testLocalPaste();
+    void testCancel();
 };
 
 void
@@ -60,7 +193,7 @@ TestPaste::testFichePaste()
     QDateTime now = QDateTime::currentDateTime();
 
     QByteArray d = ( blabla + now.toString() ).toUtf8();
-    QString s = ficheLogUpload( d, QUrl( "http://termbin.com:9999" ), nullptr );
+    QString s = ficheLogUpload( d, QUrl( "http://termbin.com:9999" ) );
 
     cDebug() << "Paste data to" << s;
     QVERIFY( !s.isEmpty() );
@@ -70,7 +203,7 @@ void
 TestPaste::testUploadSize()
 {
     QByteArray logContent = logFileContents( 100 );
-    QString s = ficheLogUpload( logContent, QUrl( "http://termbin.com:9999" ), nullptr );
+    QString s = ficheLogUpload( logContent, QUrl( "http://termbin.com:9999" ) );
 
     QVERIFY( !s.isEmpty() );
 
@@ -79,6 +212,58 @@ TestPaste::testUploadSize()
 
     QCOMPARE( returnedData.size(), 100 );
 }
+
+void
+TestPaste::testLocalPaste_data()
+{
+    QTest::addColumn< bool >( "compress" );
+    QTest::newRow( "plain" ) << false;
+#ifdef WITH_ZLIB
+    QTest::newRow( "gzip" ) << true;
+#endif
+}
+
+void
+TestPaste::testLocalPaste()
+{
+    QFETCH( bool, compress );
+
+    // Several chunks' worth of log, so that it's streamed
+    QByteArray d;
+    for ( int i = 0; d.size() < 300 * 1024; ++i )
+    {
+        d.append( QStringLiteral( "%1 the quick brown fox tested Calamares\n" ).arg( i ).toUtf8() );
+    }
+
+    TestPasteServer server( compress );
+    const QUrl url = server.listen();
+
+    QBuffer buffer;
+    buffer.setData( d );
+    buffer.open( QIODevice::ReadOnly );
+    UploadState state;
+    QString s = ficheLogUpload( buffer, d.size(), url, compress, &state );
+    QVERIFY( server.wait( 10000 ) );
+
+    QCOMPARE( s, QStringLiteral( "http://127.0.0.1/paste" ) );
+    QCOMPARE( state.sent.load(), qint64( d.size() ) );
+    QCOMPARE( state.total.load(), qint64( d.size() ) );
+    QCOMPARE( server.received().size(), d.size() );
+    QCOMPARE( server.received(), d );
+}
+
+void
+TestPaste::testCancel()
+{
+    QBuffer buffer;
+    buffer.setData( QByteArray( 1024, 'x' ) );
+    buffer.open( QIODevice::ReadOnly );
+    UploadState state;
+    state.cancel = true;
+    QString s = ficheLogUpload( buffer, buffer.size(), QUrl( "http://127.0.0.1:9999" ), false, &state );
+    QVERIFY( s.isEmpty() );
+    QCOMPARE( state.sent.load(), qint64( 0 ) );
+}
 QTEST_GUILESS_MAIN( TestPaste )
 
 #include "utils/moc-warnings.h"
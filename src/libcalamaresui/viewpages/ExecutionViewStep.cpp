@@ -191,14 +191,18 @@ ExecutionViewStep::onActivate()
         if ( module )
         {
             auto jl = module->jobs();
-            if ( module->isEmergency() )
+            for ( auto& j : jl )
             {
-                for ( auto& j : jl )
+                if ( module->isEmergency() )
                 {
                     j->setEmergency( true );
                 }
+                if ( module->isRerunOnResume() )
+                {
+                    j->setRerunOnResume( true );
+                }
             }
-            queue->enqueue( weight, jl );
+            queue->enqueue( weight, jl, instanceKey.toString() );
         }
     }
 
@@ -22,11 +22,14 @@
 #include <QQmlComponent>
 #include <QQmlContext>
 #include <QQmlEngine>
+#include <QQmlIncubator>
 #include <QQuickItem>
 #include <QQuickWidget>
+#include <QTimer>
 #include <QVBoxLayout>
 #include <QWidget>
 
+#include <functional>
 
 /// @brief State-change of the QML, for changeQMLState()
 enum class QMLAction
@@ -58,6 +61,23 @@ changeQMLState( QMLAction action, QQuickItem* item )
     }
 }
 
+/// @brief Calls a function whenever the status of (asynchronous) object creation changes
+class CallbackIncubator : public QQmlIncubator
+{
+public:
+    CallbackIncubator( std::function< void( Status ) > callback )
+        : QQmlIncubator( QQmlIncubator::Asynchronous )
+        , m_callback( callback )
+    {
+    }
+
+protected:
+    void statusChanged( Status status ) override { m_callback( status ); }
+
+private:
+    std::function< void( Status ) > m_callback;
+};
+
 namespace Calamares
 {
 
@@ -65,21 +85,22 @@ QmlViewStep::QmlViewStep( QObject* parent )
     : ViewStep( parent )
     , m_widget( new QWidget )
     , m_spinner( new WaitingWidget( tr( "Loading ..." ) ) )
-    , m_qmlWidget( new QQuickWidget )
+    , m_qmlWidget( new QQuickWidget( CalamaresUtils::qmlEngine(), nullptr ) )
+    , m_qmlContext( new QQmlContext( CalamaresUtils::qmlEngine()->rootContext(), this ) )
 {
-    CalamaresUtils::registerQmlModels();
-
     QVBoxLayout* layout = new QVBoxLayout( m_widget );
     layout->addWidget( m_spinner );
 
     m_qmlWidget->setSizePolicy( QSizePolicy::Expanding, QSizePolicy::Expanding );
     m_qmlWidget->setResizeMode( QQuickWidget::SizeRootObjectToView );
-    m_qmlWidget->engine()->addImportPath( CalamaresUtils::qmlModulesDir().absolutePath() );
 
     // QML Loading starts when the configuration for the module is set.
 }
 
-QmlViewStep::~QmlViewStep() {}
+QmlViewStep::~QmlViewStep()
+{
+    delete m_qmlIncubator;
+}
 
 QString
 QmlViewStep::prettyName() const
@@ -121,6 +142,8 @@ QmlViewStep::jobs() const
 void
 QmlViewStep::onActivate()
 {
+    // The page is needed now
+    forceCreate();
     if ( m_qmlObject )
     {
         changeQMLState( QMLAction::Start, m_qmlObject );
@@ -172,22 +195,58 @@ QmlViewStep::loadComplete()
         // Don't do this again
         disconnect( m_qmlComponent, &QQmlComponent::statusChanged, this, &QmlViewStep::loadComplete );
 
-        QObject* o = m_qmlComponent->create();
-        m_qmlObject = qobject_cast< QQuickItem* >( o );
-        if ( !m_qmlObject )
-        {
-            cError() << Logger::SubEntry << "Could not create QML from" << m_qmlFileName;
-            delete o;
-        }
-        else
-        {
-            // setContent() is public API, but not documented publicly.
-            // It is marked \internal in the Qt sources, but does exactly
-            // what is needed: sets up visual parent by replacing the root
-            // item, and handling resizes.
-            m_qmlWidget->setContent( QUrl( m_qmlFileName ), m_qmlComponent, m_qmlObject );
-            showQml();
-        }
+        // Creation is spread over several event-loop iterations, so that
+        // large QML does not block the UI; createComplete() picks it up.
+        m_qmlIncubator = new CallbackIncubator( [ this ]( QQmlIncubator::Status status ) {
+            if ( status == QQmlIncubator::Ready || status == QQmlIncubator::Error )
+            {
+                QTimer::singleShot( 0, this, &QmlViewStep::createComplete );
+            }
+        } );
+        m_qmlComponent->create( *m_qmlIncubator, m_qmlContext );
+    }
+}
+
+void
+QmlViewStep::forceCreate()
+{
+    if ( m_qmlIncubator && m_qmlIncubator->isLoading() )
+    {
+        cDebug() << "Finishing creation of QML" << m_qmlFileName;
+        m_qmlIncubator->forceCompletion();
+        createComplete();
+    }
+}
+
+void
+QmlViewStep::createComplete()
+{
+    if ( !m_qmlIncubator || m_qmlObject )
+    {
+        return;
+    }
+    if ( m_qmlIncubator->isError() )
+    {
+        cError() << Logger::SubEntry << "Could not create QML from" << m_qmlFileName << m_qmlIncubator->errors();
+        showFailedQml();
+        return;
+    }
+
+    QObject* o = m_qmlIncubator->object();
+    m_qmlObject = qobject_cast< QQuickItem* >( o );
+    if ( !m_qmlObject )
+    {
+        cError() << Logger::SubEntry << "Could not create QML from" << m_qmlFileName;
+        delete o;
+    }
+    else
+    {
+        // setContent() is public API, but not documented publicly.
+        // It is marked \internal in the Qt sources, but does exactly
+        // what is needed: sets up visual parent by replacing the root
+        // item, and handling resizes.
+        m_qmlWidget->setContent( QUrl( m_qmlFileName ), m_qmlComponent, m_qmlObject );
+        showQml();
     }
 }
 
@@ -277,7 +336,7 @@ QmlViewStep::getConfig()
 void
 QmlViewStep::setContextProperty( const char* name, QObject* property )
 {
-    m_qmlWidget->engine()->rootContext()->setContextProperty( name, property );
+    m_qmlContext->setContextProperty( name, property );
 }
 
 }  // namespace Calamares
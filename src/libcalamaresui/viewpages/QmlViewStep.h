@@ -14,6 +14,8 @@
 #include "viewpages/ViewStep.h"
 
 class QQmlComponent;
+class QQmlContext;
+class QQmlIncubator;
 class QQuickItem;
 class QQuickWidget;
 class WaitingWidget;
@@ -35,6 +37,11 @@ namespace Calamares
  * For details on the interaction between the config object and
  * the QML in the module, see the module documentation:
  *      src/modules/README.md
+ *
+ * All QML view steps share one QML engine (see CalamaresUtils::qmlEngine()),
+ * each with its own context for context properties. The QML is compiled
+ * and the object created asynchronously; a spinner is shown until
+ * that is done.
  */
 class QmlViewStep : public Calamares::ViewStep
 {
@@ -88,6 +95,7 @@ protected:
 
     /** @brief Adds a context property for this QML file
      *
+     * The property is visible only to the QML of this view step.
      * Does not take ownership.
      */
     void setContextProperty( const char* name, QObject* property );
@@ -96,6 +104,10 @@ private Q_SLOTS:
     void loadComplete();
 
 private:
+    /// @brief Picks up the created object once (asynchronous) creation is done
+    void createComplete();
+    /// @brief Finishes an asynchronous creation that is still going on
+    void forceCreate();
     /// @brief Swap out the spinner for the QQuickWidget
     void showQml();
     /// @brief Show error message in spinner.
@@ -110,7 +122,9 @@ private:
     QWidget* m_widget = nullptr;
     WaitingWidget* m_spinner = nullptr;
     QQuickWidget* m_qmlWidget = nullptr;
+    QQmlContext* m_qmlContext = nullptr;
     QQmlComponent* m_qmlComponent = nullptr;
+    QQmlIncubator* m_qmlIncubator = nullptr;
     QQuickItem* m_qmlObject = nullptr;
 };
 
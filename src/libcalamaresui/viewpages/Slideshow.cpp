@@ -17,19 +17,129 @@
 #ifdef WITH_QML
 #include "utils/Qml.h"
 #endif
-#include "utils/Retranslator.h"
 
+#include <QDir>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QImageReader>
 #include <QLabel>
 #include <QMutexLocker>
 #ifdef WITH_QML
 #include <QQmlComponent>
 #include <QQmlEngine>
+#include <QQuickImageProvider>
 #include <QQuickItem>
 #include <QQuickWidget>
 #endif
+#include <QRunnable>
+#include <QThreadPool>
 #include <QTimer>
+#include <QtConcurrent/QtConcurrent>
 
 #include <chrono>
+#include <limits>
+
+/** @brief Reads the image at @p path, scaled down to fit in @p bounds
+ *
+ * The aspect ratio is kept, and images are never scaled up. A bounds
+ * dimension of 0 (or less) does not constrain that dimension; if neither
+ * is constrained, the image is read at its own size. This is thread-safe.
+ */
+static QImage
+decodeImage( const QString& path, QSize bounds )
+{
+    QImageReader reader( path );
+    reader.setAutoTransform( true );
+
+    const QSize size = reader.size();
+    if ( size.isValid() && ( bounds.width() > 0 || bounds.height() > 0 ) )
+    {
+        if ( bounds.width() <= 0 )
+        {
+            bounds.setWidth( std::numeric_limits< int >::max() );
+        }
+        if ( bounds.height() <= 0 )
+        {
+            bounds.setHeight( std::numeric_limits< int >::max() );
+        }
+        if ( size.width() > bounds.width() || size.height() > bounds.height() )
+        {
+            // Scaling in the reader lets e.g. JPEG decode at a lower resolution
+            reader.setScaledSize( size.scaled( bounds, Qt::KeepAspectRatio ) );
+        }
+    }
+
+    QImage image = reader.read();
+    if ( image.isNull() )
+    {
+        cWarning() << "Could not read slideshow image" << path << reader.errorString();
+    }
+    return image;
+}
+
+/// @brief Memory used by @p image, in KiB (at least 1, so that everything counts)
+static int
+cost( const QImage& image )
+{
+    return qMax( 1, int( qint64( image.bytesPerLine() ) * image.height() / 1024 ) );
+}
+
+#ifdef WITH_QML
+/// @brief Decodes one image for the QML engine, on a thread-pool thread
+class SlideshowImageResponse
+    : public QQuickImageResponse
+    , public QRunnable
+{
+public:
+    SlideshowImageResponse( const QString& path, const QSize& requestedSize )
+        : m_path( path )
+        , m_requestedSize( requestedSize )
+    {
+        setAutoDelete( false );
+    }
+
+    void run() override
+    {
+        m_image = decodeImage( m_path, m_requestedSize );
+        emit finished();
+    }
+
+    QQuickTextureFactory* textureFactory() const override
+    {
+        return QQuickTextureFactory::textureFactoryForImage( m_image );
+    }
+
+private:
+    QString m_path;
+    QSize m_requestedSize;
+    QImage m_image;
+};
+
+/** @brief Image provider for the slideshow
+ *
+ * Image ids are paths relative to the directory containing the slideshow
+ * QML (absolute paths are used as-is). All decoding happens off the
+ * GUI thread, so a slide with large images does not stall the UI.
+ */
+class SlideshowImageProvider : public QQuickAsyncImageProvider
+{
+public:
+    SlideshowImageProvider( const QString& directory )
+        : m_directory( directory )
+    {
+    }
+
+    QQuickImageResponse* requestImageResponse( const QString& id, const QSize& requestedSize ) override
+    {
+        auto* response = new SlideshowImageResponse( m_directory.absoluteFilePath( id ), requestedSize );
+        QThreadPool::globalInstance()->start( response );
+        return response;
+    }
+
+private:
+    QDir m_directory;
+};
+#endif
 
 namespace Calamares
 {
@@ -39,22 +149,22 @@ Slideshow::~Slideshow() {}
 #ifdef WITH_QML
 SlideshowQML::SlideshowQML( QWidget* parent )
     : Slideshow( parent )
-    , m_qmlShow( new QQuickWidget )
+    , m_qmlShow( new QQuickWidget( CalamaresUtils::qmlEngine(), nullptr ) )
     , m_qmlComponent( nullptr )
     , m_qmlObject( nullptr )
 {
     m_qmlShow->setObjectName( "qml" );
 
-    CalamaresUtils::registerQmlModels();
-
     m_qmlShow->setSizePolicy( QSizePolicy::Expanding, QSizePolicy::Expanding );
     m_qmlShow->setResizeMode( QQuickWidget::SizeRootObjectToView );
-    m_qmlShow->engine()->addImportPath( CalamaresUtils::qmlModulesDir().absolutePath() );
-
-    cDebug() << "QML import paths:" << Logger::DebugList( m_qmlShow->engine()->importPathList() );
-#if QT_VERSION >= QT_VERSION_CHECK( 5, 10, 0 )
-    CALAMARES_RETRANSLATE( if ( m_qmlShow ) { m_qmlShow->engine()->retranslate(); } );
-#endif
+    static const QString providerName = QStringLiteral( "slideshow" );
+    if ( !m_qmlShow->engine()->imageProvider( providerName ) )
+    {
+        // The engine takes ownership of the provider
+        m_qmlShow->engine()->addImageProvider(
+            providerName,
+            new SlideshowImageProvider( QFileInfo( Branding::instance()->slideshowPath() ).absolutePath() ) );
+    }
 
     if ( Branding::instance()->slideshowAPI() == 2 )
     {
@@ -204,6 +314,8 @@ SlideshowPictures::SlideshowPictures( QWidget* parent )
     , m_timer( new QTimer( this ) )
     , m_imageIndex( 0 )
     , m_images( Branding::instance()->slideshowImages() )
+    , m_preload( Branding::instance()->slideshowPreload() )
+    , m_decoded( Branding::instance()->slideshowCacheSize() * 1024 )
 {
     m_label->setObjectName( "image" );
 
@@ -277,7 +389,65 @@ SlideshowPictures::next()
         return;
     }
 
-    m_label->setPixmap( QPixmap( m_images.at( m_imageIndex ) ) );
+    const QSize bounds = imageBounds();
+    if ( bounds != m_decodedBounds )
+    {
+        // The label was resized, so the decoded images are the wrong size
+        m_decoded.clear();
+        m_decodedBounds = bounds;
+    }
+
+    if ( const QImage* image = m_decoded.object( m_imageIndex ) )
+    {
+        m_label->setPixmap( QPixmap::fromImage( *image ) );
+    }
+    else
+    {
+        // Not pre-loaded (yet), so this one has to wait for the disk
+        m_label->setPixmap( QPixmap::fromImage( decodeImage( m_images.at( m_imageIndex ), bounds ) ) );
+    }
+
+    prefetch();
+}
+
+QSize
+SlideshowPictures::imageBounds() const
+{
+    return m_label->isVisible() ? m_label->contentsRect().size() : QSize();
+}
+
+void
+SlideshowPictures::prefetch()
+{
+    using Watcher = QFutureWatcher< QImage >;
+
+    const int count = m_images.count();
+    for ( int ahead = 1; ahead <= qMin( m_preload, count - 1 ); ++ahead )
+    {
+        const int index = ( m_imageIndex + ahead ) % count;
+        if ( m_pending.contains( index ) || m_decoded.contains( index ) )
+        {
+            continue;
+        }
+
+        m_pending.insert( index );
+        const QString path = m_images.at( index );
+        const QSize bounds = m_decodedBounds;
+        auto* watcher = new Watcher( this );
+        connect( watcher, &Watcher::finished, this, [ = ]() {
+            QMutexLocker l( &m_mutex );
+            m_pending.remove( index );
+            const QImage image = watcher->result();
+            watcher->deleteLater();
+
+            // Drop images decoded for a label size that is no longer current
+            if ( !image.isNull() && bounds == m_decodedBounds )
+            {
+                m_decoded.insert( index, new QImage( image ), cost( image ) );
+            }
+        } );
+        watcher->setFuture( QtConcurrent::run( decodeImage, path, bounds ) );
+    }
 }
 
 
@@ -14,7 +14,10 @@
 
 #include "CalamaresConfig.h"
 
+#include <QCache>
+#include <QImage>
 #include <QMutex>
+#include <QSet>
 #include <QStringList>
 #include <QWidget>
 
@@ -85,6 +88,11 @@ protected:
  * file from *slideshow*. The API version influences when and how the
  * QML is loaded; version 1 does so only when the slideshow is activated,
  * while version 2 does so asynchronously.
+ *
+ * The QML engine has an image provider "slideshow" which decodes
+ * (and scales, to the *sourceSize*) images on a worker thread; an image
+ * source "image://slideshow/squid.png" names an image relative to
+ * the directory of the slideshow QML file.
  */
 class SlideshowQML : public Slideshow
 {
@@ -117,6 +125,12 @@ private:
  * do not use QML at all. It is configured through the Branding
  * setting *slideshow*. When using this widget, the setting must
  * be a list of filenames; the API is set to -1.
+ *
+ * The next few images (Branding setting *slideshowPreload*) are decoded
+ * and scaled to fit the label on a worker thread, while the current
+ * one is shown. Decoded images are kept within a memory budget
+ * (Branding setting *slideshowCacheSize*), so that a short show does
+ * not need to read the disk again when it wraps around.
  */
 class SlideshowPictures : public Slideshow
 {
@@ -132,10 +146,20 @@ public slots:
     void next();
 
 private:
+    /// @brief Starts decoding the images after the current one
+    void prefetch();
+    /// @brief The size to scale images to (invalid if the label isn't shown)
+    QSize imageBounds() const;
+
     QLabel* m_label;
     QTimer* m_timer;
     int m_imageIndex;
     QStringList m_images;
+
+    int m_preload;  ///< Number of images to decode ahead
+    QCache< int, QImage > m_decoded;  ///< Decoded images by index, cost is in KiB
+    QSet< int > m_pending;  ///< Indexes being decoded right now
+    QSize m_decodedBounds;  ///< The bounds that the images in m_decoded fit
 };
 
 }  // namespace Calamares
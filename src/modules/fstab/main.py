@@ -14,7 +14,6 @@
 
 import os
 import re
-import subprocess
 
 import libcalamares
 
@@ -304,45 +303,52 @@ class FstabGenerator(object):
                                       self.mount_options["default"])
 
 
-def create_swapfile(root_mount_point, root_btrfs):
+def swapfile_size(conf):
+    """
+    Returns the size (in bytes) of the swapfile, from the *swapfileSize*
+    setting in @p conf. This is either a size with a unit (KiB, MiB, GiB)
+    or a percentage of the installed memory, e.g. "100%" to be able
+    to hibernate.
+    """
+    default_size = 512 * 1024 * 1024  # 512MiB
+    size = str(conf.get("swapfileSize", "512MiB")).strip()
+    try:
+        if size.endswith("%"):
+            memory = os.sysconf("SC_PAGE_SIZE") * os.sysconf("SC_PHYS_PAGES")
+            return int(memory * float(size[:-1]) / 100)
+        for suffix, factor in (("KiB", 1024), ("MiB", 1024 ** 2), ("GiB", 1024 ** 3)):
+            if size.endswith(suffix):
+                return int(float(size[:-len(suffix)]) * factor)
+        return int(size)
+    except ValueError:
+        libcalamares.utils.warning("Invalid *swapfileSize* {!s}, using 512MiB".format(size))
+        return default_size
+
+
+def create_swapfile(root_mount_point, root_btrfs, size):
     """
     Creates /swapfile in @p root_mount_point ; if the root filesystem
-    is on btrfs, then handle some btrfs specific features as well,
-    as documented in
+    is on btrfs, then the swapfile goes in /swap/swapfile, which is
+    a subvolume that is not snapshotted. The btrfs-specific settings
+    (no copy-on-write, no compression) as documented in
         https://wiki.archlinux.org/index.php/Swap#Swap_file
+    are applied by libcalamares, which also writes the swap header.
 
     The swapfile-creation covers progress from 0.2 to 0.5
+
+    Returns True on success.
     """
     libcalamares.job.setprogress(0.2)
     if root_btrfs:
         # btrfs swapfiles must reside on a subvolume that is not snapshotted to prevent file system corruption
         swapfile_path = os.path.join(root_mount_point, "swap/swapfile")
-        with open(swapfile_path, "wb") as f:
-            pass
-        o = subprocess.check_output(["chattr", "+C", swapfile_path])
-        libcalamares.utils.debug("swapfile attributes: {!s}".format(o))
-        o = subprocess.check_output(["btrfs", "property", "set", swapfile_path, "compression", "none"])
-        libcalamares.utils.debug("swapfile compression: {!s}".format(o))
     else:
         swapfile_path = os.path.join(root_mount_point, "swapfile")
-        with open(swapfile_path, "wb") as f:
-            pass
-    # Create the swapfile; swapfiles are small-ish
-    zeroes = bytes(16384)
-    with open(swapfile_path, "wb") as f:
-        total = 0
-        desired_size = 512 * 1024 * 1024  # 512MiB
-        while total < desired_size:
-            chunk = f.write(zeroes)
-            if chunk < 1:
-                libcalamares.utils.debug("Short write on {!s}, cancelling.".format(swapfile_path))
-                break
-            libcalamares.job.setprogress(0.2 + 0.3 * ( total / desired_size ) )
-            total += chunk
-    os.chmod(swapfile_path, 0o600)
-    o = subprocess.check_output(["mkswap", swapfile_path])
-    libcalamares.utils.debug("swapfile mkswap: {!s}".format(o))
+
+    ok = libcalamares.utils.create_swapfile(swapfile_path, size,
+                                            lambda f: libcalamares.job.setprogress(0.2 + 0.3 * f))
     libcalamares.job.setprogress(0.5)
+    return ok
 
 
 def run():
@@ -405,7 +411,9 @@ def run():
         libcalamares.job.setprogress(0.2)
         root_partitions = [ p["fs"].lower() for p in partitions if p["mountPoint"] == "/" ]
         root_btrfs = (root_partitions[0] == "btrfs") if root_partitions else False
-        create_swapfile(root_mount_point, root_btrfs)
+        if not create_swapfile(root_mount_point, root_btrfs, swapfile_size(conf)):
+            return (_("Swapfile creation failed"),
+                    _("Could not create a swapfile in <pre>{!s}</pre>.").format(root_mount_point))
 
     try:
         libcalamares.job.setprogress(0.5)
@@ -157,10 +157,9 @@ Config::Config( QObject* parent )
 
     // Connect signals and slots
     connect( m_keyboardModelsModel, &KeyboardModelsModel::currentIndexChanged, [&]( int index ) {
-        // Set Xorg keyboard model
+        // Set Xorg keyboard model, together with the layout (in xkbApply)
         m_selectedModel = m_keyboardModelsModel->key( index );
-        QProcess::execute( "setxkbmap", xkbmap_model_args( m_selectedModel ) );
-        emit prettyStatusChanged();
+        xkbChanged( m_keyboardVariantsModel->currentIndex() );
     } );
 
     connect( m_keyboardLayoutsModel, &KeyboardLayoutModel::currentIndexChanged, [&]( int index ) {
@@ -205,19 +204,30 @@ Config::xkbApply()
 {
     m_additionalLayoutInfo = getAdditionalLayoutInfo( m_selectedLayout );
 
-    if ( !m_additionalLayoutInfo.additionalLayout.isEmpty() )
+    // One setxkbmap for model and layout: detached processes could finish in any order
+    QStringList args;
+    if ( !m_selectedModel.isEmpty() )
     {
-        m_additionalLayoutInfo.groupSwitcher = xkbmap_query_grp_option();
+        args << xkbmap_model_args( m_selectedModel );
+    }
 
-        if ( m_additionalLayoutInfo.groupSwitcher.isEmpty() )
+    if ( !m_additionalLayoutInfo.additionalLayout.isEmpty() )
+    {
+        // The group-switch option is not changed by Calamares, so query it only once
+        if ( m_groupSwitcher.isEmpty() )
         {
-            m_additionalLayoutInfo.groupSwitcher = "grp:alt_shift_toggle";
+            m_groupSwitcher = xkbmap_query_grp_option();
+            if ( m_groupSwitcher.isEmpty() )
+            {
+                m_groupSwitcher = "grp:alt_shift_toggle";
+            }
         }
+        m_additionalLayoutInfo.groupSwitcher = m_groupSwitcher;
 
-        QProcess::execute( "setxkbmap",
-                           xkbmap_layout_args( { m_additionalLayoutInfo.additionalLayout, m_selectedLayout },
-                                               { m_additionalLayoutInfo.additionalVariant, m_selectedVariant },
-                                               m_additionalLayoutInfo.groupSwitcher ) );
+        args << xkbmap_layout_args( { m_additionalLayoutInfo.additionalLayout, m_selectedLayout },
+                                    { m_additionalLayoutInfo.additionalVariant, m_selectedVariant },
+                                    m_additionalLayoutInfo.groupSwitcher );
+        QProcess::startDetached( "setxkbmap", args );
 
 
         cDebug() << "xkbmap selection changed to: " << m_selectedLayout << '-' << m_selectedVariant << "(added "
@@ -226,7 +236,8 @@ Config::xkbApply()
     }
     else
     {
-        QProcess::execute( "setxkbmap", xkbmap_layout_args( m_selectedLayout, m_selectedVariant ) );
+        args << xkbmap_layout_args( m_selectedLayout, m_selectedVariant );
+        QProcess::startDetached( "setxkbmap", args );
         cDebug() << "xkbmap selection changed to: " << m_selectedLayout << '-' << m_selectedVariant;
     }
     m_setxkbmapTimer.disconnect( this );
@@ -85,7 +85,9 @@ private:
      * you don't get buried under xkbset processes.
      *
      * xkbChanged() is called when the selection changes, and triggers
-     * a delayed call to xkbApply() which does the actual work.
+     * a delayed call to xkbApply() which does the actual work. The
+     * setxkbmap process, which sets both model and layout, is started
+     * detached, so the GUI does not wait for it to finish.
      */
     void xkbChanged( int index );
     void xkbApply();
@@ -100,6 +102,8 @@ private:
 
     // Layout (and corresponding info) added if current one doesn't support ASCII (e.g. Russian or Japanese)
     AdditionalLayoutInfo m_additionalLayoutInfo;
+    // The system's group-switch option, queried the first time it is needed
+    QString m_groupSwitcher;
 
     QTimer m_setxkbmapTimer;
 
@@ -89,6 +89,9 @@ KeyboardPage::KeyboardPage( Config* config, QWidget* parent )
         m_keyboardPreview->setLayout( m_config->keyboardLayouts()->key( index ) );
         m_keyboardPreview->setVariant(
             m_config->keyboardVariants()->key( m_config->keyboardVariants()->currentIndex() ) );
+        // Moving through the list is likely to continue up or down
+        m_keyboardPreview->prefetch( m_config->keyboardLayouts()->key( index - 1 ), QString() );
+        m_keyboardPreview->prefetch( m_config->keyboardLayouts()->key( index + 1 ), QString() );
     } );
 
     connect( ui->variantSelector->selectionModel(),
@@ -97,6 +100,10 @@ KeyboardPage::KeyboardPage( Config* config, QWidget* parent )
     connect( config->keyboardVariants(), &KeyboardVariantsModel::currentIndexChanged, [this]( int index ) {
         ui->variantSelector->setCurrentIndex( m_config->keyboardVariants()->index( index ) );
         m_keyboardPreview->setVariant( m_config->keyboardVariants()->key( index ) );
+
+        const QString layout = m_config->keyboardLayouts()->key( m_config->keyboardLayouts()->currentIndex() );
+        m_keyboardPreview->prefetch( layout, m_config->keyboardVariants()->key( index - 1 ) );
+        m_keyboardPreview->prefetch( layout, m_config->keyboardVariants()->key( index + 1 ) );
     } );
     CALAMARES_RETRANSLATE_SLOT( &KeyboardPage::retranslate );
 }
@@ -6,6 +6,8 @@
  *   Calamares is Free Software: see the License-Identifier above.
  *
  */
+#include "keyboardwidget/keymapresolver.h"
+
 #include "utils/Logger.h"
 
 #include <QtTest/QtTest>
@@ -25,12 +27,16 @@ private Q_SLOTS:
 
     void testSimpleLayoutLookup_data();
     void testSimpleLayoutLookup();
+
+    void testResolveKeymap();
+    void testResolverCache();
 };
 
 void
 KeyboardLayoutTests::initTestCase()
 {
     Logger::setupLogLevel( Logger::LOGDEBUG );
+    qRegisterMetaType< KeyCodes >( "KeyCodes" );
 }
 
 void
@@ -59,6 +65,54 @@ KeyboardLayoutTests::testSimpleLayoutLookup()
     QCOMPARE( findLegacyKeymap( layout, model, variant ), vconsole );
 }
 
+void
+KeyboardLayoutTests::testResolveKeymap()
+{
+    QVERIFY( KeymapResolver::resolve( QString(), QString() ).isEmpty() );
+
+    const KeyCodes us = KeymapResolver::resolve( "us", QString() );
+    if ( us.isEmpty() )
+    {
+        QSKIP( "Neither libxkbcommon nor ckbcomp can resolve layouts here." );
+    }
+    // Keycode 0x10 is the top-left letter key
+    QVERIFY( us.count() >= 0x10 );
+    QCOMPARE( us.at( 0x10 - 1 ).plain, QStringLiteral( "q" ) );
+    QCOMPARE( us.at( 0x10 - 1 ).shift, QStringLiteral( "Q" ) );
+
+    const KeyCodes fr = KeymapResolver::resolve( "fr", QString() );
+    QVERIFY( fr.count() >= 0x10 );
+    QCOMPARE( fr.at( 0x10 - 1 ).plain, QStringLiteral( "a" ) );
+}
+
+void
+KeyboardLayoutTests::testResolverCache()
+{
+    if ( KeymapResolver::resolve( "us", QString() ).isEmpty() )
+    {
+        QSKIP( "Neither libxkbcommon nor ckbcomp can resolve layouts here." );
+    }
+
+    KeymapResolver resolver;
+    QSignalSpy spy( &resolver, &KeymapResolver::keymapResolved );
+
+    // The first request is resolved in the background
+    resolver.request( "us", QString() );
+    QCOMPARE( spy.count(), 0 );
+    QVERIFY( spy.wait( 5000 ) );
+    QCOMPARE( spy.count(), 1 );
+    QCOMPARE( spy.at( 0 ).at( 0 ).toString(), QStringLiteral( "us" ) );
+
+    // A second request comes from the cache, immediately
+    resolver.request( "us", QString() );
+    QCOMPARE( spy.count(), 2 );
+
+    // A prefetch does not report anything
+    resolver.prefetch( "de", QString() );
+    QTest::qWait( 500 );
+    QCOMPARE( spy.count(), 2 );
+}
+
 
 QTEST_GUILESS_MAIN( KeyboardLayoutTests )
 
@@ -15,14 +15,10 @@
 
 #include "keyboardpreview.h"
 
-#include "utils/Logger.h"
-#include "utils/String.h"
-
-#include <QProcess>
-
 KeyBoardPreview::KeyBoardPreview( QWidget* parent )
     : QWidget( parent )
     , layout( "us" )
+    , resolver( new KeymapResolver( this ) )
     , space( 0 )
     , usable_width( 0 )
     , key_w( 0 )
@@ -67,6 +63,8 @@ KeyBoardPreview::KeyBoardPreview( QWidget* parent )
                                                  << 0x35 << 0x36 );
 
     kb = &kbList[ KB_104 ];
+
+    connect( resolver, &KeymapResolver::keymapResolved, this, &KeyBoardPreview::codesResolved );
 }
 
 
@@ -82,13 +80,19 @@ KeyBoardPreview::setVariant( QString _variant )
 {
     variant = _variant;
 
-    if ( !loadCodes() )
+    // The labels arrive in codesResolved(); until then the
+    // previous layout remains visible.
+    if ( !layout.isEmpty() )
     {
-        return;
+        resolver->request( layout, variant );
     }
+}
 
-    loadInfo();
-    repaint();
+
+void
+KeyBoardPreview::prefetch( const QString& _layout, const QString& _variant )
+{
+    resolver->prefetch( _layout, _variant );
 }
 
 
@@ -118,96 +122,18 @@ KeyBoardPreview::loadInfo()
 }
 
 
-bool
-KeyBoardPreview::loadCodes()
-{
-    if ( layout.isEmpty() )
-    {
-        return false;
-    }
-
-    QStringList param { "-model", "pc106", "-layout", layout, "-compact" };
-    if ( !variant.isEmpty() )
-    {
-        param << "-variant" << variant;
-    }
-
-
-    QProcess process;
-    process.setEnvironment( QStringList() << "LANG=C"
-                                          << "LC_MESSAGES=C" );
-    process.start( "ckbcomp", param );
-    if ( !process.waitForStarted() )
-    {
-        static bool need_warning = true;
-        if ( need_warning )
-        {
-            cWarning() << "ckbcomp not found , keyboard preview disabled";
-            need_warning = false;
-        }
-        return false;
-    }
-
-    if ( !process.waitForFinished() )
-    {
-        cWarning() << "ckbcomp failed, keyboard preview skipped for" << layout << variant;
-        return false;
-    }
-
-    // Clear codes
-    codes.clear();
-
-    const QStringList list = QString( process.readAll() ).split( "\n", SplitSkipEmptyParts );
-
-    for ( const QString& line : list )
-    {
-        if ( !line.startsWith( "keycode" ) || !line.contains( '=' ) )
-        {
-            continue;
-        }
-
-        QStringList split = line.split( '=' ).at( 1 ).trimmed().split( ' ' );
-        if ( split.size() < 4 )
-        {
-            continue;
-        }
-
-        Code code;
-        code.plain = fromUnicodeString( split.at( 0 ) );
-        code.shift = fromUnicodeString( split.at( 1 ) );
-        code.ctrl = fromUnicodeString( split.at( 2 ) );
-        code.alt = fromUnicodeString( split.at( 3 ) );
-
-        if ( code.ctrl == code.plain )
-        {
-            code.ctrl = "";
-        }
-
-        if ( code.alt == code.plain )
-        {
-            code.alt = "";
-        }
-
-        codes.append( code );
-    }
-
-    return true;
-}
-
-
-QString
-KeyBoardPreview::fromUnicodeString( QString raw )
+void
+KeyBoardPreview::codesResolved( const QString& _layout, const QString& _variant, const KeyCodes& _codes )
 {
-    if ( raw.startsWith( "U+" ) )
-    {
-        return QChar( raw.mid( 2 ).toInt( nullptr, 16 ) );
-    }
-    else if ( raw.startsWith( "+U" ) )
+    if ( _layout != layout || _variant != variant )
     {
-        return QChar( raw.mid( 3 ).toInt( nullptr, 16 ) );
+        // Stale result, the selection has moved on
+        return;
     }
 
-    return "";
+    codes = _codes;
+    loadInfo();
+    update();
 }
 
 
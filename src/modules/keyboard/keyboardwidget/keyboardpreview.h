@@ -15,6 +15,8 @@
 #ifndef KEYBOARDPREVIEW_H
 #define KEYBOARDPREVIEW_H
 
+#include "keymapresolver.h"
+
 #include <QColor>
 #include <QFont>
 #include <QPainter>
@@ -36,6 +38,14 @@ public:
     void setLayout( QString layout );
     void setVariant( QString variant );
 
+    /** @brief Resolve @p layout and @p variant in the background
+     *
+     * Use this for entries near the current one in the layout or
+     * variant lists, so that moving through the list shows the
+     * preview without delay.
+     */
+    void prefetch( const QString& layout, const QString& variant );
+
 private:
     enum KB_TYPE
     {
@@ -50,24 +60,19 @@ private:
         QList< QList< int > > keys;
     };
 
-    struct Code
-    {
-        QString plain, shift, ctrl, alt;
-    };
-
     QString layout, variant;
     QFont lowerFont, upperFont;
     KB *kb, kbList[ 3 ];
-    QList< Code > codes;
+    KeyCodes codes;
+    KeymapResolver* resolver;
     int space, usable_width, key_w;
 
     void loadInfo();
-    bool loadCodes();
+    void codesResolved( const QString& layout, const QString& variant, const KeyCodes& codes );
     QString regular_text( int index );
     QString shift_text( int index );
     QString ctrl_text( int index );
     QString alt_text( int index );
-    QString fromUnicodeString( QString raw );
 
 protected:
     void paintEvent( QPaintEvent* event ) override;
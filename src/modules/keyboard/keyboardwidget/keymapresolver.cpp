@@ -0,0 +1,280 @@
+/* === This file is part of Calamares - <https://calamares.io> ===
+ *
+ *   SPDX-FileCopyrightText: 2007 Free Software Foundation, Inc.
+ *   SPDX-FileCopyrightText: 2014 Teo Mrnjavac <teo@kde.org>
+ *   SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *   SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ *   Calamares is Free Software: see the License-Identifier above.
+ *
+ */
+
+#include "keymapresolver.h"
+
+#include "utils/Logger.h"
+#include "utils/String.h"
+
+#include <QFutureWatcher>
+#include <QProcess>
+#include <QtConcurrent/QtConcurrent>
+
+#ifdef HAVE_XKBCOMMON
+#include <xkbcommon/xkbcommon.h>
+#endif
+
+#include <atomic>
+
+/// @brief Keys to resolve; the preview does not draw anything above this
+static constexpr const int maxKeyCode = 0x80;
+
+static inline QString
+cacheKey( const QString& layout, const QString& variant )
+{
+    return layout + QChar( '/' ) + variant;
+}
+
+/// @brief ckbcomp shows the plain and shift levels as-is; drop repeats in the others
+static inline void
+dropRepeatedLevels( KeyCode& code )
+{
+    if ( code.ctrl == code.plain )
+    {
+        code.ctrl = QString();
+    }
+    if ( code.alt == code.plain )
+    {
+        code.alt = QString();
+    }
+}
+
+#ifdef HAVE_XKBCOMMON
+/// @brief Printable label for the key at @p level in the first group, or empty
+static QString
+levelLabel( xkb_keymap* keymap, xkb_keycode_t key, xkb_level_index_t level )
+{
+    const xkb_keysym_t* syms = nullptr;
+    if ( xkb_keymap_key_get_syms_by_level( keymap, key, 0, level, &syms ) != 1 )
+    {
+        return QString();
+    }
+
+    const uint u = xkb_keysym_to_utf32( syms[ 0 ] );
+    if ( u < 0x20 || u == 0x7f )
+    {
+        // Unprintable, or no Unicode representation (e.g. a dead key)
+        return QString();
+    }
+    return QString::fromUcs4( &u, 1 );
+}
+
+static KeyCodes
+resolveXkbCommon( const QString& layout, const QString& variant )
+{
+    xkb_context* context = xkb_context_new( XKB_CONTEXT_NO_FLAGS );
+    if ( !context )
+    {
+        return KeyCodes();
+    }
+
+    const QByteArray layoutName = layout.toUtf8();
+    const QByteArray variantName = variant.toUtf8();
+
+    xkb_rule_names names {};
+    names.rules = "evdev";
+    names.model = "pc105";
+    names.layout = layoutName.constData();
+    names.variant = variantName.isEmpty() ? nullptr : variantName.constData();
+    names.options = nullptr;
+
+    xkb_keymap* keymap = xkb_keymap_new_from_names( context, &names, XKB_KEYMAP_COMPILE_NO_FLAGS );
+    if ( !keymap )
+    {
+        xkb_context_unref( context );
+        return KeyCodes();
+    }
+
+    // xkb keycodes are the evdev keycodes offset by 8
+    KeyCodes codes;
+    codes.reserve( maxKeyCode );
+    for ( int keycode = 1; keycode <= maxKeyCode; ++keycode )
+    {
+        const xkb_keycode_t key = xkb_keycode_t( keycode + 8 );
+
+        KeyCode code;
+        code.plain = levelLabel( keymap, key, 0 );
+        code.shift = levelLabel( keymap, key, 1 );
+        code.ctrl = levelLabel( keymap, key, 2 );
+        code.alt = levelLabel( keymap, key, 3 );
+        dropRepeatedLevels( code );
+        codes.append( code );
+    }
+
+    xkb_keymap_unref( keymap );
+    xkb_context_unref( context );
+    return codes;
+}
+#endif
+
+static QString
+fromUnicodeString( const QString& raw )
+{
+    if ( raw.startsWith( "U+" ) )
+    {
+        return QChar( raw.mid( 2 ).toInt( nullptr, 16 ) );
+    }
+    else if ( raw.startsWith( "+U" ) )
+    {
+        return QChar( raw.mid( 3 ).toInt( nullptr, 16 ) );
+    }
+
+    return QString();
+}
+
+static KeyCodes
+resolveCkbcomp( const QString& layout, const QString& variant )
+{
+    QStringList param { "-model", "pc106", "-layout", layout, "-compact" };
+    if ( !variant.isEmpty() )
+    {
+        param << "-variant" << variant;
+    }
+
+    QProcess process;
+    process.setEnvironment( QStringList() << "LANG=C"
+                                          << "LC_MESSAGES=C" );
+    process.start( "ckbcomp", param );
+    if ( !process.waitForStarted() )
+    {
+        static std::atomic< bool > need_warning { true };
+        if ( need_warning.exchange( false ) )
+        {
+            cWarning() << "ckbcomp not found , keyboard preview disabled";
+        }
+        return KeyCodes();
+    }
+
+    if ( !process.waitForFinished() )
+    {
+        cWarning() << "ckbcomp failed, keyboard preview skipped for" << layout << variant;
+        return KeyCodes();
+    }
+
+    KeyCodes codes;
+    const QStringList list = QString( process.readAll() ).split( "\n", SplitSkipEmptyParts );
+    for ( const QString& line : list )
+    {
+        if ( !line.startsWith( "keycode" ) || !line.contains( '=' ) )
+        {
+            continue;
+        }
+
+        const QStringList parts = line.split( '=' );
+        QStringList split = parts.at( 1 ).trimmed().split( ' ' );
+        if ( split.size() < 4 )
+        {
+            continue;
+        }
+
+        bool ok = false;
+        const int keycode = parts.at( 0 ).mid( 7 ).trimmed().toInt( &ok );
+        if ( !ok || keycode < 1 || keycode > maxKeyCode )
+        {
+            continue;
+        }
+
+        KeyCode code;
+        code.plain = fromUnicodeString( split.at( 0 ) );
+        code.shift = fromUnicodeString( split.at( 1 ) );
+        code.ctrl = fromUnicodeString( split.at( 2 ) );
+        code.alt = fromUnicodeString( split.at( 3 ) );
+        dropRepeatedLevels( code );
+
+        while ( codes.count() < keycode )
+        {
+            codes.append( KeyCode() );
+        }
+        codes[ keycode - 1 ] = code;
+    }
+
+    return codes;
+}
+
+KeyCodes
+KeymapResolver::resolve( const QString& layout, const QString& variant )
+{
+    if ( layout.isEmpty() )
+    {
+        return KeyCodes();
+    }
+
+#ifdef HAVE_XKBCOMMON
+    KeyCodes codes = resolveXkbCommon( layout, variant );
+    if ( !codes.isEmpty() )
+    {
+        return codes;
+    }
+#endif
+    return resolveCkbcomp( layout, variant );
+}
+
+KeymapResolver::KeymapResolver( QObject* parent )
+    : QObject( parent )
+    , m_cache( 32 )
+{
+}
+
+KeymapResolver::~KeymapResolver() {}
+
+void
+KeymapResolver::request( const QString& layout, const QString& variant )
+{
+    const QString key = cacheKey( layout, variant );
+    m_requested = key;
+
+    if ( const auto* codes = m_cache.object( key ) )
+    {
+        emit keymapResolved( layout, variant, *codes );
+        return;
+    }
+    if ( !m_pending.contains( key ) )
+    {
+        start( key, layout, variant );
+    }
+}
+
+void
+KeymapResolver::prefetch( const QString& layout, const QString& variant )
+{
+    const QString key = cacheKey( layout, variant );
+    if ( layout.isEmpty() || m_pending.contains( key ) || m_cache.contains( key ) )
+    {
+        return;
+    }
+    start( key, layout, variant );
+}
+
+void
+KeymapResolver::start( const QString& key, const QString& layout, const QString& variant )
+{
+    using Watcher = QFutureWatcher< KeyCodes >;
+
+    m_pending.insert( key );
+    auto* watcher = new Watcher( this );
+    connect( watcher, &Watcher::finished, this, [ = ]() {
+        m_pending.remove( key );
+        const KeyCodes codes = watcher->result();
+        watcher->deleteLater();
+
+        // Failures are not cached, so that a later request tries again
+        if ( codes.isEmpty() )
+        {
+            return;
+        }
+        m_cache.insert( key, new KeyCodes( codes ) );
+        if ( key == m_requested )
+        {
+            emit keymapResolved( layout, variant, codes );
+        }
+    } );
+    watcher->setFuture( QtConcurrent::run( &KeymapResolver::resolve, layout, variant ) );
+}
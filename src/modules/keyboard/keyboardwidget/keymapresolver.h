@@ -0,0 +1,93 @@
+/* === This file is part of Calamares - <https://calamares.io> ===
+ *
+ *   SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *   SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ *   Calamares is Free Software: see the License-Identifier above.
+ *
+ */
+
+#ifndef KEYMAPRESOLVER_H
+#define KEYMAPRESOLVER_H
+
+#include <QCache>
+#include <QList>
+#include <QMetaType>
+#include <QObject>
+#include <QSet>
+#include <QString>
+
+/** @brief Key labels for a single key, in the four shift levels
+ *
+ * The levels are (in order) plain, shift, AltGr and Shift+AltGr;
+ * the names are historical (from the ckbcomp output the preview
+ * was originally built on).
+ */
+struct KeyCode
+{
+    QString plain, shift, ctrl, alt;
+};
+
+/** @brief Key labels for a whole keymap
+ *
+ * The list is indexed by (Linux, evdev) keycode minus one, so
+ * keycode 0x10 (the Q key on a US keyboard) is at index 0x0f.
+ */
+using KeyCodes = QList< KeyCode >;
+
+Q_DECLARE_METATYPE( KeyCode )
+
+/** @brief Computes the key labels for xkb layouts off the GUI thread
+ *
+ * Resolving a layout (with libxkbcommon if available, by running
+ * `ckbcomp` otherwise) happens on a worker thread. Results are kept
+ * in a least-recently-used cache, so scrolling back and forth through
+ * the list of layouts does not re-compute anything.
+ *
+ * Call request() for the layout that should be shown; the result
+ * arrives through keymapResolved() (immediately, if it is cached).
+ * Call prefetch() for layouts that are likely to be requested soon;
+ * those are resolved in the background and only cached.
+ *
+ * All the methods of the resolver must be called from the thread
+ * that owns it (normally the GUI thread).
+ */
+class KeymapResolver : public QObject
+{
+    Q_OBJECT
+public:
+    explicit KeymapResolver( QObject* parent = nullptr );
+    ~KeymapResolver() override;
+
+    /** @brief Ask for the key labels of @p layout and @p variant
+     *
+     * Emits keymapResolved() once the labels are known; this may
+     * happen before request() returns, if the labels were cached.
+     */
+    void request( const QString& layout, const QString& variant );
+    /** @brief Resolve @p layout and @p variant in the background
+     *
+     * Does not emit keymapResolved() unless the same layout and variant
+     * are request()ed while the prefetch is running.
+     */
+    void prefetch( const QString& layout, const QString& variant );
+
+    /** @brief Computes the key labels synchronously
+     *
+     * This is what the worker threads run. It is thread-safe. Returns
+     * an empty list if the layout could not be resolved.
+     */
+    static KeyCodes resolve( const QString& layout, const QString& variant );
+
+signals:
+    void keymapResolved( const QString& layout, const QString& variant, const KeyCodes& codes );
+
+private:
+    void start( const QString& key, const QString& layout, const QString& variant );
+
+    QCache< QString, KeyCodes > m_cache;
+    QSet< QString > m_pending;  ///< Keys currently being resolved
+    QString m_requested;  ///< Key of the most recent request()
+};
+
+#endif  // KEYMAPRESOLVER_H
@@ -17,7 +17,6 @@
 #include "locale/Global.h"
 #include "locale/Translation.h"
 #include "modulesystem/ModuleManager.h"
-#include "network/Manager.h"
 #include "utils/Logger.h"
 #include "utils/Variant.h"
 
@@ -471,14 +470,10 @@ getGeoIP( const QVariantMap& configurationMap, std::unique_ptr< CalamaresUtils::
     QVariantMap map = CalamaresUtils::getSubMap( configurationMap, "geoip", ok );
     if ( ok )
     {
-        QString url = CalamaresUtils::getString( map, "url" );
-        QString style = CalamaresUtils::getString( map, "style" );
-        QString selector = CalamaresUtils::getString( map, "selector" );
-
-        geoip = std::make_unique< CalamaresUtils::GeoIP::Handler >( style, url, selector );
+        geoip = std::make_unique< CalamaresUtils::GeoIP::Handler >( map );
         if ( !geoip->isValid() )
         {
-            cWarning() << "GeoIP Style" << style << "is not recognized.";
+            cWarning() << "GeoIP Style" << CalamaresUtils::getString( map, "style" ) << "is not recognized.";
         }
     }
 }
@@ -529,14 +524,11 @@ Config::startGeoIP()
 {
     if ( m_geoip && m_geoip->isValid() )
     {
-        auto& network = CalamaresUtils::Network::Manager::instance();
-        if ( network.hasInternet() || network.synchronousPing( m_geoip->url() ) )
-        {
-            using Watcher = QFutureWatcher< CalamaresUtils::GeoIP::RegionZonePair >;
-            m_geoipWatcher = std::make_unique< Watcher >();
-            m_geoipWatcher->setFuture( m_geoip->query() );
-            connect( m_geoipWatcher.get(), &Watcher::finished, this, &Config::completeGeoIP );
-        }
+        // No need to ping first: the lookup itself gives up after the GeoIP timeout
+        using Watcher = QFutureWatcher< CalamaresUtils::GeoIP::RegionZonePair >;
+        m_geoipWatcher = std::make_unique< Watcher >();
+        m_geoipWatcher->setFuture( m_geoip->query() );
+        connect( m_geoipWatcher.get(), &Watcher::finished, this, &Config::completeGeoIP );
     }
 }
 
@@ -552,7 +544,7 @@ Config::completeGeoIP()
         }
         else
         {
-            cWarning() << "GeoIP returned invalid result.";
+            cWarning() << "GeoIP returned invalid result, using" << m_startingTimezone;
         }
     }
     else
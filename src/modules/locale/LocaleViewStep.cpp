@@ -20,6 +20,7 @@
 #include "network/Manager.h"
 #include "utils/CalamaresUtilsGui.h"
 #include "utils/Logger.h"
+#include "utils/Retranslator.h"
 #include "utils/Variant.h"
 #include "utils/Yaml.h"
 
@@ -129,6 +130,8 @@ LocaleViewStep::jobs() const
 void
 LocaleViewStep::onActivate()
 {
+    // Timezone names are translated separately, and only needed here
+    CalamaresUtils::installModuleTranslator( QStringLiteral( "tz_" ) );
     m_config->setCurrentLocation();  // Finalize the location
     if ( !m_actualWidget )
     {
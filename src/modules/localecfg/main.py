@@ -13,6 +13,7 @@
 #   Calamares is Free Software: see the License-Identifier above.
 #
 
+import concurrent.futures
 import os
 import re
 import shutil
@@ -108,6 +109,84 @@ def rewrite_locale_gen(srcfilename, destfilename, locale_conf):
                 gen.write("# Missing: %s\n" % locale)
 
 
+def enabled_locales(filename):
+    """
+    Returns the locales enabled in locale.gen file @p filename,
+    as a list of (locale, charset) pairs.
+    """
+    locales = []
+    with open(filename, "r") as gen:
+        for line in gen.readlines():
+            if is_comment(line):
+                continue
+            fields = RE_TRAILING_COMMENT.sub("", line).strip().split()
+            if len(fields) == 2:
+                locales.append((fields[0], fields[1]))
+    return locales
+
+
+def localedef_input(locale):
+    """
+    Returns the name of the locale source for @p locale, which is
+    the locale without the charset (but with the modifier), as
+    locale-gen does it: e.g. "de_DE.UTF-8" -> "de_DE",
+    "sr_RS.UTF-8@latin" -> "sr_RS@latin".
+    """
+    name, _sep, modifier = locale.partition("@")
+    name = name.split(".")[0]
+    return name + ("@" + modifier if modifier else "")
+
+
+def compile_locales(locales):
+    """
+    Compiles the @p locales (pairs of locale and charset) into the
+    locale archive of the target system, running one localedef
+    (in the target environment) for each locale, and as many at
+    the same time as there are CPUs. localedef locks the archive
+    while adding the compiled locale to it.
+
+    Progress is reported as locales are done. Returns True if all
+    of the locales were compiled.
+    """
+    def localedef(locale, charset):
+        return libcalamares.utils.target_env_call(["localedef", "-i", localedef_input(locale), "-c",
+                                                   "-f", charset, "-A", "/usr/share/locale/locale.alias", locale])
+
+    ok = True
+    done = 0
+    with concurrent.futures.ThreadPoolExecutor(max_workers=os.cpu_count() or 1) as executor:
+        futures = {executor.submit(localedef, locale, charset): locale for locale, charset in locales}
+        for future in concurrent.futures.as_completed(futures):
+            locale = futures[future]
+            returncode = future.result()
+            if returncode != 0:
+                libcalamares.utils.warning("localedef for {!s} failed ({!s})".format(locale, returncode))
+                ok = False
+            done += 1
+            libcalamares.job.setprogress(0.1 + 0.8 * done / len(locales))
+    return ok
+
+
+def generate_locales(install_path, locale_gen):
+    """
+    Generates the locales enabled in @p locale_gen. If the target
+    has localedef, the locales are compiled concurrently; otherwise
+    (or if that fails) locale-gen in the target does the work.
+    """
+    locales = enabled_locales(locale_gen)
+    if locales and os.path.exists(os.path.join(install_path, "usr/bin/localedef")):
+        # Like locale-gen, start from an empty archive, so that locales
+        # that are no longer enabled are gone.
+        archive = os.path.join(install_path, "usr/lib/locale/locale-archive")
+        if os.path.exists(archive):
+            os.remove(archive)
+        libcalamares.utils.debug("Compiling {!s} locales in parallel".format(len(locales)))
+        if compile_locales(locales):
+            return
+        libcalamares.utils.warning("Parallel locale compilation failed, running locale-gen")
+    libcalamares.utils.target_env_call(['locale-gen'])
+
+
 def run():
     """ Create locale """
     import libcalamares
@@ -151,7 +230,7 @@ def run():
     # in that case, fix your installation filesystem.
     if os.path.exists('/etc/locale.gen'):
         rewrite_locale_gen(target_locale_gen, target_locale_gen, locale_conf)
-        libcalamares.utils.target_env_call(['locale-gen'])
+        generate_locales(install_path, target_locale_gen)
         libcalamares.utils.debug('{!s} done'.format(target_locale_gen))
 
     # write /etc/locale.conf
@@ -0,0 +1,91 @@
+#   SPDX-FileCopyrightText: no
+#   SPDX-License-Identifier: CC0-1.0
+#
+# Calamares Boilerplate
+import libcalamares
+libcalamares.globalstorage = libcalamares.GlobalStorage(None)
+libcalamares.globalstorage.insert("testing", True)
+
+# Module prep-work
+from src.modules.localecfg import main
+
+import os
+import tempfile
+import threading
+
+
+# .. we don't have a job in this test, so fake one
+class Job(object):
+    def __init__(self):
+        self.progress = []
+
+    def setprogress(self, p):
+        self.progress.append(p)
+
+
+# .. and record the commands instead of running them in a target
+class Target(object):
+    def __init__(self, failing=()):
+        self.lock = threading.Lock()
+        self.commands = []
+        self.failing = failing
+
+    def target_env_call(self, command, stdin=None, timeout=0):
+        with self.lock:
+            self.commands.append(command)
+        return 1 if command[-1] in self.failing else 0
+
+
+def make_target(root):
+    for d in ("etc", "usr/bin", "usr/lib/locale"):
+        os.makedirs(os.path.join(root, d))
+    with open(os.path.join(root, "usr/bin/localedef"), "w") as f:
+        f.write("")
+    with open(os.path.join(root, "usr/lib/locale/locale-archive"), "w") as f:
+        f.write("stale")
+    locale_gen = os.path.join(root, "etc/locale.gen")
+    with open(locale_gen, "w") as f:
+        f.write("# Not a locale\n#nl_NL.UTF-8 UTF-8\nen_US.UTF-8 UTF-8\nsr_RS@latin UTF-8\nde_DE ISO-8859-1\n")
+    return locale_gen
+
+
+with tempfile.TemporaryDirectory() as root:
+    locale_gen = make_target(root)
+    target = Target()
+    libcalamares.utils.target_env_call = target.target_env_call
+    libcalamares.job = Job()
+    main.generate_locales(root, locale_gen)
+
+    # The stale archive is gone, each locale is compiled once, and
+    # locale-gen is not needed.
+    assert not os.path.exists(os.path.join(root, "usr/lib/locale/locale-archive"))
+    commands = sorted(target.commands, key=lambda c: c[-1])
+    assert len(commands) == 3, commands
+    assert commands[0] == ["localedef", "-i", "de_DE", "-c", "-f", "ISO-8859-1",
+                           "-A", "/usr/share/locale/locale.alias", "de_DE"], commands[0]
+    assert commands[1][:6] == ["localedef", "-i", "en_US", "-c", "-f", "UTF-8"], commands[1]
+    assert commands[2][:3] == ["localedef", "-i", "sr_RS@latin"], commands[2]
+    assert len(libcalamares.job.progress) == 3
+    assert abs(libcalamares.job.progress[-1] - 0.9) < 1e-6
+
+with tempfile.TemporaryDirectory() as root:
+    locale_gen = make_target(root)
+    target = Target(failing=("en_US.UTF-8",))
+    libcalamares.utils.target_env_call = target.target_env_call
+    libcalamares.job = Job()
+    main.generate_locales(root, locale_gen)
+
+    # A failed localedef falls back to locale-gen
+    assert len(target.commands) == 4, target.commands
+    assert target.commands[-1] == ["locale-gen"], target.commands
+
+with tempfile.TemporaryDirectory() as root:
+    locale_gen = make_target(root)
+    os.remove(os.path.join(root, "usr/bin/localedef"))
+    target = Target()
+    libcalamares.utils.target_env_call = target.target_env_call
+    main.generate_locales(root, locale_gen)
+
+    # Without localedef in the target, it's locale-gen only
+    assert target.commands == [["locale-gen"]], target.commands
+    assert os.path.exists(os.path.join(root, "usr/lib/locale/locale-archive"))
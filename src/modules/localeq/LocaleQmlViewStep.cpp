@@ -11,6 +11,7 @@
 #include "LocaleQmlViewStep.h"
 
 #include "utils/Logger.h"
+#include "utils/Retranslator.h"
 
 CALAMARES_PLUGIN_FACTORY_DEFINITION( LocaleQmlViewStepFactory, registerPlugin< LocaleQmlViewStep >(); )
 
@@ -73,6 +74,8 @@ LocaleQmlViewStep::jobs() const
 void
 LocaleQmlViewStep::onActivate()
 {
+    // Timezone names are translated separately, and only needed here
+    CalamaresUtils::installModuleTranslator( QStringLiteral( "tz_" ) );
     m_config->setCurrentLocation();  // Finalize the location
     QmlViewStep::onActivate();
 }
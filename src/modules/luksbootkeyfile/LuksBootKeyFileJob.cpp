@@ -18,6 +18,15 @@
 #include "JobQueue.h"
 
 #include <QDir>
+#include <QFile>
+#include <QFutureSynchronizer>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrent>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
 
 LuksBootKeyFileJob::LuksBootKeyFileJob( QObject* parent )
     : Calamares::CppJob( parent )
@@ -134,12 +143,15 @@ generateTargetKeyfile()
 }
 
 static bool
-setupLuks( const LuksDevice& d )
+setupLuks( const LuksDevice& d, const QString& keyfilePath, const QStringList& pbkdfOptions )
 {
     // Adding the key can take some times, measured around 15 seconds with
     // a HDD (spinning rust) and a slow-ish computer. Give it a minute.
     auto r = CalamaresUtils::System::instance()->targetEnvCommand(
-        { "cryptsetup", "luksAddKey", d.device, keyfile }, QString(), d.passphrase, std::chrono::seconds( 60 ) );
+        QStringList { "cryptsetup", "luksAddKey" } << pbkdfOptions << d.device << keyfilePath,
+        QString(),
+        d.passphrase,
+        std::chrono::seconds( 60 ) );
     if ( r.getExitCode() != 0 )
     {
         cWarning() << "Could not configure LUKS keyfile on" << d.device << ':' << r.getOutput() << "(exit code"
@@ -149,6 +161,94 @@ setupLuks( const LuksDevice& d )
     return true;
 }
 
+/// @brief Memory one argon2 keyslot may use: cryptsetup's default, in KiB
+static constexpr const qint64 argon2MemoryKiB = 1024 * 1024;
+
+/// @brief MemAvailable from /proc/meminfo, in KiB; 0 if unknown
+static qint64
+availableMemoryKiB()
+{
+    QFile f( QStringLiteral( "/proc/meminfo" ) );
+    if ( !f.open( QIODevice::ReadOnly ) )
+    {
+        return 0;
+    }
+    const auto lines = QString::fromLatin1( f.readAll() ).split( '\n' );
+    for ( const auto& line : lines )
+    {
+        if ( line.startsWith( QStringLiteral( "MemAvailable:" ) ) )
+        {
+            // The line is "MemAvailable:   12345678 kB"
+            return line.mid( 13 ).trimmed().split( ' ' ).first().toLongLong();
+        }
+    }
+    return 0;
+}
+
+/** @brief How many keys to add at the same time
+ *
+ * Each luksAddKey spends its time in the PBKDF, which is CPU-bound
+ * and (for argon2) needs up to @p pbkdfMemoryKiB of memory, so
+ * the number of CPUs and the available memory set the limit.
+ * There is always at least one.
+ */
+STATICTEST int
+enrollmentConcurrency( int deviceCount, int cpuCount, qint64 availableKiB, qint64 pbkdfMemoryKiB )
+{
+    const qint64 byMemory = pbkdfMemoryKiB > 0 ? availableKiB / pbkdfMemoryKiB : deviceCount;
+    return int( std::max( qint64( 1 ), std::min( { qint64( deviceCount ), qint64( cpuCount ), byMemory } ) ) );
+}
+
+/** @brief Adds the key file at @p keyfilePath to all the LUKS @p partitions
+ *
+ * The @p partitions are in the format of GS[partitions]. The keys are
+ * added concurrently, up to @p concurrency at a time; @p pbkdfOptions are
+ * passed to cryptsetup. Each time a device is done, @p progress is called
+ * (from a worker thread) with the fraction of devices done.
+ *
+ * Returns the devices that failed, in the order of @p partitions.
+ */
+STATICTEST QStringList
+enrollKeyfile( const QVariantList& partitions,
+               const QString& keyfilePath,
+               const QStringList& pbkdfOptions,
+               int concurrency,
+               const std::function< void( qreal ) >& progress )
+{
+    const auto devices = getLuksDevices( partitions );
+
+    QThreadPool pool;
+    pool.setMaxThreadCount( std::max( 1, concurrency ) );
+    std::atomic< int > done { 0 };
+
+    QList< QFuture< bool > > futures;
+    QFutureSynchronizer< bool > synchronizer;
+    for ( const auto& d : devices )
+    {
+        auto future = QtConcurrent::run( &pool, [ & ]() {
+            const bool ok = setupLuks( d, keyfilePath, pbkdfOptions );
+            if ( progress )
+            {
+                progress( qreal( ++done ) / devices.count() );
+            }
+            return ok;
+        } );
+        futures.append( future );
+        synchronizer.addFuture( future );
+    }
+    synchronizer.waitForFinished();
+
+    QStringList failed;
+    for ( int i = 0; i < devices.count(); ++i )
+    {
+        if ( !futures.at( i ).result() )
+        {
+            failed.append( devices.at( i ).device );
+        }
+    }
+    return failed;
+}
+
 static QVariantList
 partitions()
 {
@@ -239,12 +339,21 @@ LuksBootKeyFileJob::exec()
             tr( "Could not create LUKS key file for root partition %1." ).arg( s.devices.first().device ) );
     }
 
-    for ( const auto& d : s.devices )
+    const qint64 pbkdfMemoryKiB
+        = std::min( argon2MemoryKiB, CalamaresUtils::System::instance()->getTotalMemoryB().first / 1024 / 2 );
+    const int concurrency = enrollmentConcurrency(
+        s.devices.count(), QThread::idealThreadCount(), availableMemoryKiB(), pbkdfMemoryKiB );
+    cDebug() << "Adding LUKS key file to" << s.devices.count() << "devices," << concurrency << "at a time.";
+
+    const QStringList failed = enrollKeyfile(
+        gs->value( "partitions" ).toList(), keyfile, QStringList(), concurrency, [ this ]( qreal p ) {
+            emit progress( p );
+        } );
+    if ( !failed.isEmpty() )
     {
-        if ( !setupLuks( d ) )
-            return Calamares::JobResult::error(
-                tr( "Encrypted rootfs setup error" ),
-                tr( "Could not configure LUKS key file on partition %1." ).arg( d.device ) );
+        return Calamares::JobResult::error( tr( "Encrypted rootfs setup error" ),
+                                            tr( "Could not configure LUKS key file on partition %1." )
+                                                .arg( failed.join( QStringLiteral( ", " ) ) ) );
     }
 
     return Calamares::JobResult::ok();
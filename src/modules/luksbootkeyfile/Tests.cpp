@@ -0,0 +1,157 @@
+/* === This file is part of Calamares - <https://calamares.io> ===
+ *
+ *   SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *   SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ *   Calamares is Free Software: see the License-Identifier above.
+ *
+ */
+
+#include "utils/CalamaresUtilsSystem.h"
+#include "utils/Logger.h"
+
+#include <QFile>
+#include <QProcess>
+#include <QTemporaryDir>
+#include <QtTest/QtTest>
+
+#include <functional>
+
+#include <unistd.h>
+
+// Implementation details being tested
+extern int enrollmentConcurrency( int deviceCount, int cpuCount, qint64 availableKiB, qint64 pbkdfMemoryKiB );
+extern QStringList enrollKeyfile( const QVariantList& partitions,
+                                  const QString& keyfilePath,
+                                  const QStringList& pbkdfOptions,
+                                  int concurrency,
+                                  const std::function< void( qreal ) >& progress );
+
+class LuksBootKeyFileTests : public QObject
+{
+    Q_OBJECT
+public:
+    LuksBootKeyFileTests() {}
+    ~LuksBootKeyFileTests() override {}
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void testConcurrency();
+    void testEnrollment();
+};
+
+void
+LuksBootKeyFileTests::initTestCase()
+{
+    Logger::setupLogLevel( Logger::LOGDEBUG );
+    // No chroot: commands for the "target" run in the host
+    (void)new CalamaresUtils::System( false, this );
+}
+
+void
+LuksBootKeyFileTests::testConcurrency()
+{
+    constexpr qint64 GiB = 1024 * 1024;  // in KiB
+
+    // Plenty of everything: one per device
+    QCOMPARE( enrollmentConcurrency( 3, 16, 64 * GiB, GiB ), 3 );
+    // CPU-bound
+    QCOMPARE( enrollmentConcurrency( 3, 2, 64 * GiB, GiB ), 2 );
+    // Memory-bound
+    QCOMPARE( enrollmentConcurrency( 3, 16, 2 * GiB + 10, GiB ), 2 );
+    // Never less than one, even when memory is short or unknown
+    QCOMPARE( enrollmentConcurrency( 3, 16, GiB / 2, GiB ), 1 );
+    QCOMPARE( enrollmentConcurrency( 3, 16, 0, GiB ), 1 );
+    QCOMPARE( enrollmentConcurrency( 1, 0, 64 * GiB, GiB ), 1 );
+    // PBKDF2 needs no memory to speak of
+    QCOMPARE( enrollmentConcurrency( 4, 8, 0, 0 ), 4 );
+}
+
+/// @brief Runs @p program with @p args and @p input on stdin; true if it exits 0
+static bool
+run( const QString& program, const QStringList& args, const QByteArray& input = QByteArray() )
+{
+    QProcess p;
+    p.start( program, args );
+    if ( !p.waitForStarted() )
+    {
+        return false;
+    }
+    p.write( input );
+    p.closeWriteChannel();
+    return p.waitForFinished( 60000 ) && p.exitStatus() == QProcess::NormalExit && p.exitCode() == 0;
+}
+
+void
+LuksBootKeyFileTests::testEnrollment()
+{
+    if ( geteuid() != 0 )
+    {
+        QSKIP( "cryptsetup needs root" );
+    }
+
+    QTemporaryDir tempRoot( QDir::tempPath() + QStringLiteral( "/test-luks-XXXXXX" ) );
+    QVERIFY( tempRoot.isValid() );
+
+    // Keep the PBKDF cheap, it's the concurrency that is being tested
+    const QStringList pbkdf { "--pbkdf", "pbkdf2", "--pbkdf-force-iterations", "1000" };
+    const QByteArray passphrase( "sekrit" );
+
+    QVariantList partitions;
+    QStringList images;
+    for ( const auto& name : { "root", "home", "swap" } )
+    {
+        const QString image = tempRoot.filePath( name );
+        {
+            QFile f( image );
+            QVERIFY( f.open( QIODevice::WriteOnly ) );
+            QVERIFY( f.resize( 20 * 1024 * 1024 ) );
+        }
+        if ( !run( "cryptsetup", QStringList { "luksFormat", "-q", "--type", "luks2" } << pbkdf << image, passphrase ) )
+        {
+            QSKIP( "Could not create a LUKS image" );
+        }
+        images.append( image );
+        partitions.append( QVariantMap { { "device", image },
+                                         { "fs", QString( name ) == "swap" ? "linuxswap" : "ext4" },
+                                         { "mountPoint", QString( name ) == "swap" ? QString() : QString( "/" ) + name },
+                                         { "luksMapperName", QString( "luks-" ) + name },
+                                         { "luksPassphrase", QString::fromLatin1( passphrase ) } } );
+    }
+    // The last one has the wrong passphrase
+    auto last = partitions.last().toMap();
+    last.insert( "luksPassphrase", "wrong" );
+    partitions.last() = last;
+
+    const QString keyfile = tempRoot.filePath( "crypto_keyfile.bin" );
+    {
+        QFile f( keyfile );
+        QVERIFY( f.open( QIODevice::WriteOnly ) );
+        QByteArray key( 2048, 'k' );
+        QCOMPARE( f.write( key ), key.size() );
+    }
+
+    QList< qreal > reported;
+    QMutex reportedLock;
+    const QStringList failed = enrollKeyfile( partitions, keyfile, pbkdf, 3, [ & ]( qreal p ) {
+        QMutexLocker lock( &reportedLock );
+        reported.append( p );
+    } );
+
+    // Every device reports, and the failure is reported too
+    QCOMPARE( failed, QStringList { images.last() } );
+    QCOMPARE( reported.count(), 3 );
+    std::sort( reported.begin(), reported.end() );
+    QCOMPARE( reported.last(), 1.0 );
+
+    QVERIFY( run( "cryptsetup", { "open", "--test-passphrase", "--key-file", keyfile, images.at( 0 ) } ) );
+    QVERIFY( run( "cryptsetup", { "open", "--test-passphrase", "--key-file", keyfile, images.at( 1 ) } ) );
+    QVERIFY( !run( "cryptsetup", { "open", "--test-passphrase", "--key-file", keyfile, images.at( 2 ) } ) );
+}
+
+QTEST_GUILESS_MAIN( LuksBootKeyFileTests )
+
+#include "utils/moc-warnings.h"
+
+#include "Tests.moc"
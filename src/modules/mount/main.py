@@ -74,6 +74,17 @@ def get_btrfs_subvolumes(partitions):
     return btrfs_subvolumes
 
 
+def is_btrfs_subvolume(path):
+    """
+    Is there a btrfs subvolume at @p path already? This is the
+    case when the install is resumed after the subvolumes were made.
+    """
+    if not os.path.isdir(path):
+        return False
+    return subprocess.call(["btrfs", "subvolume", "show", path],
+                           stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL) == 0
+
+
 def mount_zfs(root_mount_point, partition):
     """ Mounts a zfs partition at @p root_mount_point
 
@@ -193,9 +204,13 @@ def mount_partition(root_mount_point, partition, partitions):
         for s in btrfs_subvolumes:
             if not s["subvolume"]:
                 continue
-            os.makedirs(root_mount_point + os.path.dirname(s["subvolume"]), exist_ok=True)
-            subprocess.check_call(["btrfs", "subvolume", "create",
-                                   root_mount_point + s["subvolume"]])
+            subvolume_path = root_mount_point + s["subvolume"]
+            # This module is re-run on resume, so it must not fail on what it did before
+            if is_btrfs_subvolume(subvolume_path):
+                libcalamares.utils.debug("Subvolume {!s} exists already".format(s["subvolume"]))
+            else:
+                os.makedirs(root_mount_point + os.path.dirname(s["subvolume"]), exist_ok=True)
+                subprocess.check_call(["btrfs", "subvolume", "create", subvolume_path])
             if s["mountPoint"] == "/":
                 # insert the root subvolume into global storage
                 libcalamares.globalstorage.insert("btrfsRootSubvolume", s["subvolume"])
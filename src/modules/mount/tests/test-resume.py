@@ -0,0 +1,71 @@
+#   SPDX-FileCopyrightText: no
+#   SPDX-License-Identifier: CC0-1.0
+#
+# Calamares Boilerplate
+import libcalamares
+libcalamares.globalstorage = libcalamares.GlobalStorage(None)
+libcalamares.globalstorage.insert("testing", True)
+
+# Module prep-work
+from src.modules.mount import main
+
+import os
+import subprocess
+import tempfile
+
+
+# .. we don't have a job in this test, so fake one
+class Job(object):
+    def __init__(self):
+        self.configuration = {"btrfsSubvolumes": [{"mountPoint": "/", "subvolume": "/@"},
+                                                  {"mountPoint": "/home", "subvolume": "/@home"}]}
+
+    def setprogress(self, p):
+        pass
+
+
+# .. and record the commands instead of running them; btrfs
+# subvolumes are plain directories.
+class Host(object):
+    def __init__(self):
+        self.commands = []
+        self.mounts = []
+
+    def mount(self, device, mount_point, fs, options):
+        self.mounts.append(mount_point)
+        return 0
+
+    def call(self, command, **kwargs):
+        self.commands.append(command)
+        if command[:3] == ["btrfs", "subvolume", "show"]:
+            return 0 if os.path.isdir(command[3]) else 1
+        return 0
+
+    def check_call(self, command, **kwargs):
+        self.commands.append(command)
+        if command[:3] == ["btrfs", "subvolume", "create"]:
+            if os.path.exists(command[3]):
+                raise subprocess.CalledProcessError(1, command)
+            os.mkdir(command[3])
+        return 0
+
+
+libcalamares.job = Job()
+libcalamares.globalstorage.insert("partitions", [{"device": "/dev/sdb1", "mountPoint": "/", "fs": "btrfs"}])
+
+with tempfile.TemporaryDirectory() as root:
+    tempfile.mkdtemp = lambda prefix=None: root
+
+    # The first run creates the subvolumes, a resumed run finds them
+    for attempt in (1, 2):
+        host = Host()
+        libcalamares.utils.mount = host.mount
+        subprocess.call = host.call
+        subprocess.check_call = host.check_call
+
+        assert main.run() is None, attempt
+        created = [c for c in host.commands if c[:3] == ["btrfs", "subvolume", "create"]]
+        assert len(created) == (2 if attempt == 1 else 0), (attempt, created)
+        assert os.path.isdir(os.path.join(root, "@home"))
+        assert len(host.mounts) == 3, host.mounts  # the volume, and both subvolumes
+        assert libcalamares.globalstorage.value("btrfsRootSubvolume") == "/@"
@@ -0,0 +1,195 @@
+/* === This file is part of Calamares - <https://calamares.io> ===
+ *
+ *   SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *   SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ *   Calamares is Free Software: see the License-Identifier above.
+ *
+ */
+
+#include "PackageModel.h"
+
+#include "utils/Logger.h"
+#include "utils/Yaml.h"
+
+#include <QtTest/QtTest>
+
+class NetInstallBenchmarks : public QObject
+{
+    Q_OBJECT
+public:
+    NetInstallBenchmarks() {}
+    ~NetInstallBenchmarks() override {}
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void benchSetupModelData_data();
+    void benchSetupModelData();
+
+    void benchToggle_data();
+    void benchToggle();
+    void benchGetPackages();
+};
+
+/** @brief A netinstall tree with @p groups groups at each of @p depth levels
+ *
+ * Each group has @p packages packages; every other package is
+ * a map (with name and description) instead of a plain name.
+ */
+static QVariantList
+sampleGroups( int groups, int depth, int packages, const QString& prefix = QString() )
+{
+    QVariantList l;
+    for ( int g = 0; g < groups; ++g )
+    {
+        const QString name = prefix + QStringLiteral( "g%1" ).arg( g );
+        QVariantList packageList;
+        for ( int p = 0; p < packages; ++p )
+        {
+            const QString packageName = name + QStringLiteral( "-package%1" ).arg( p );
+            if ( p % 2 )
+            {
+                packageList.append( QVariantMap { { "name", packageName }, { "description", "A package" } } );
+            }
+            else
+            {
+                packageList.append( packageName );
+            }
+        }
+
+        QVariantMap group { { "name", name },
+                            { "description", QStringLiteral( "Group %1" ).arg( name ) },
+                            { "selected", bool( g % 2 ) },
+                            { "packages", packageList } };
+        if ( depth > 1 )
+        {
+            group.insert( "subgroups", sampleGroups( groups, depth - 1, packages, name + '/' ) );
+        }
+        l.append( group );
+    }
+    return l;
+}
+
+void
+NetInstallBenchmarks::initTestCase()
+{
+    Logger::setupLogLevel( Logger::LOGERROR );
+}
+
+void
+NetInstallBenchmarks::benchSetupModelData_data()
+{
+    QTest::addColumn< int >( "groups" );
+    QTest::addColumn< int >( "depth" );
+    QTest::addColumn< int >( "packages" );
+
+    // Roughly the size of a distro's netinstall.yaml
+    QTest::newRow( "flat" ) << 20 << 1 << 20;
+    // 8 + 64 + 512 groups, ~12k packages
+    QTest::newRow( "deep" ) << 8 << 3 << 20;
+    // 4 + 16 + ... + 1024 groups, ~68k packages
+    QTest::newRow( "huge" ) << 4 << 5 << 50;
+}
+
+void
+NetInstallBenchmarks::benchSetupModelData()
+{
+    QFETCH( int, groups );
+    QFETCH( int, depth );
+    QFETCH( int, packages );
+
+    const QVariantList tree = sampleGroups( groups, depth, packages );
+    PackageModel model;
+    QBENCHMARK
+    {
+        model.setupModelData( tree );
+    }
+    QCOMPARE( model.rowCount(), groups );
+}
+
+/** @brief Loads a synthetic netinstall.yaml with about 20k packages
+ *
+ * The groups are written out to a YAML file and read back
+ * the way the netinstall module reads a groups file:
+ * 10 top-level groups with 10 subgroups each, 182 packages per group.
+ */
+static QVariantList
+sampleYaml()
+{
+    QTemporaryDir dir;
+    const QString filename = dir.filePath( QStringLiteral( "netinstall.yaml" ) );
+    if ( !CalamaresUtils::saveYaml( filename, QVariantMap { { "groups", sampleGroups( 10, 2, 182 ) } } ) )
+    {
+        return QVariantList();
+    }
+    return CalamaresUtils::loadYaml( filename ).value( "groups" ).toList();
+}
+
+void
+NetInstallBenchmarks::benchToggle_data()
+{
+    QTest::addColumn< int >( "row" );
+    QTest::addColumn< int >( "childRow" );
+
+    // Each group has 182 packages, then the subgroups
+    // A whole top-level group, with its subgroups: 2002 packages
+    QTest::newRow( "group" ) << 0 << -1;
+    // A subgroup with only packages
+    QTest::newRow( "subgroup" ) << 0 << 182;
+    // A single package
+    QTest::newRow( "package" ) << 0 << 0;
+}
+
+void
+NetInstallBenchmarks::benchToggle()
+{
+    QFETCH( int, row );
+    QFETCH( int, childRow );
+
+    const QVariantList tree = sampleYaml();
+    QCOMPARE( tree.count(), 10 );
+
+    PackageModel model;
+    model.setupModelData( tree );
+    QModelIndex index = model.index( row, 0 );
+    if ( childRow >= 0 )
+    {
+        index = model.index( childRow, 0, index );
+    }
+    QVERIFY( index.isValid() );
+
+    const int selected = model.getPackages().count();
+    QBENCHMARK
+    {
+        model.setData( index, Qt::Checked, Qt::CheckStateRole );
+        model.setData( index, Qt::Unchecked, Qt::CheckStateRole );
+    }
+    QCOMPARE( model.data( index, Qt::CheckStateRole ).toInt(), int( Qt::Unchecked ) );
+    QVERIFY( model.getPackages().count() <= selected );
+}
+
+void
+NetInstallBenchmarks::benchGetPackages()
+{
+    const QVariantList tree = sampleYaml();
+    QCOMPARE( tree.count(), 10 );
+
+    PackageModel model;
+    model.setupModelData( tree );
+    // Odd groups are selected, and their subgroups and packages
+    QVERIFY( model.getPackages().count() > 9000 );
+
+    int count = 0;
+    QBENCHMARK
+    {
+        count = model.getPackages().count();
+    }
+    QVERIFY( count > 9000 );
+}
+
+QTEST_GUILESS_MAIN( NetInstallBenchmarks )
+
+#include "utils/moc-warnings.h"
+
+#include "Benchmarks.moc"
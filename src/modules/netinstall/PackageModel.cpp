@@ -29,6 +29,29 @@ setSelections( const QStringList& selectNames, PackageTreeItem* item )
     }
 }
 
+/// Recursive helper for getItemPackages(), appends to @p selectedPackages
+static void
+collectPackages( PackageTreeItem* item, PackageTreeItem::List& selectedPackages )
+{
+    for ( int i = 0; i < item->childCount(); i++ )
+    {
+        auto* child = item->child( i );
+        if ( child->isSelected() == Qt::Unchecked )
+        {
+            continue;
+        }
+
+        if ( child->isPackage() )  // package
+        {
+            selectedPackages.append( child );
+        }
+        else
+        {
+            collectPackages( child, selectedPackages );
+        }
+    }
+}
+
 /** @brief Collects all the "source" values from @p groupList
  *
  * Iterates over @p groupList and returns all nonempty "source"
@@ -224,12 +247,14 @@ PackageModel::getPackages() const
         return PackageTreeItem::List();
     }
 
-    auto items = getItemPackages( m_rootItem );
+    // The root keeps track of the selected packages, only the
+    // hidden groups (which are not in the tree) need collecting.
+    auto items = m_rootItem->selectedPackages();
     for ( auto package : m_hiddenItems )
     {
         if ( package->hiddenSelected() )
         {
-            items.append( getItemPackages( package ) );
+            collectPackages( package, items );
         }
     }
     return items;
@@ -239,23 +264,7 @@ PackageTreeItem::List
 PackageModel::getItemPackages( PackageTreeItem* item ) const
 {
     PackageTreeItem::List selectedPackages;
-    for ( int i = 0; i < item->childCount(); i++ )
-    {
-        auto* child = item->child( i );
-        if ( child->isSelected() == Qt::Unchecked )
-        {
-            continue;
-        }
-
-        if ( child->isPackage() )  // package
-        {
-            selectedPackages.append( child );
-        }
-        else
-        {
-            selectedPackages.append( getItemPackages( child ) );
-        }
-    }
+    collectPackages( item, selectedPackages );
     return selectedPackages;
 }
 
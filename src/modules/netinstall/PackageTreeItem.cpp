@@ -13,6 +13,8 @@
 #include "utils/Logger.h"
 #include "utils/Variant.h"
 
+#include <atomic>
+
 /** @brief Should a package be selected, given its parent's state? */
 static Qt::CheckState
 parentCheckState( PackageTreeItem* parent )
@@ -92,10 +94,20 @@ PackageTreeItem::~PackageTreeItem()
     qDeleteAll( m_childItems );
 }
 
+quint64
+PackageTreeItem::nextSequence()
+{
+    static std::atomic< quint64 > sequence { 0 };
+    return sequence++;
+}
+
 void
 PackageTreeItem::appendChild( PackageTreeItem* child )
 {
+    child->m_row = m_childItems.count();
     m_childItems.append( child );
+    countChild( child->m_selected, 1 );
+    child->trackPackages( root(), true );
 }
 
 PackageTreeItem*
@@ -113,11 +125,7 @@ PackageTreeItem::childCount() const
 int
 PackageTreeItem::row() const
 {
-    if ( m_parentItem )
-    {
-        return m_parentItem->m_childItems.indexOf( const_cast< PackageTreeItem* >( this ) );
-    }
-    return 0;
+    return m_parentItem ? m_row : 0;
 }
 
 QVariant
@@ -177,76 +185,187 @@ PackageTreeItem::hiddenSelected() const
 }
 
 
-void
-PackageTreeItem::setSelected( Qt::CheckState isSelected )
+/** @brief The root of the tree this item is in
+ *
+ * Returns @c nullptr if the item is not (yet) connected to a root,
+ * e.g. because it is being built up, or is under a hidden group.
+ */
+PackageTreeItem*
+PackageTreeItem::root()
 {
-    if ( parentItem() == nullptr )
+    PackageTreeItem* item = this;
+    while ( item->m_parentItem )
     {
-        // This is the root, it is always checked so don't change state
-        return;
+        if ( item->m_row < 0 )
+        {
+            return nullptr;
+        }
+        item = item->m_parentItem;
     }
+    return item;
+}
 
-    m_selected = isSelected;
-    setChildrenSelected( isSelected );
+Qt::CheckState
+PackageTreeItem::childrenCheckState() const
+{
+    if ( !m_checkedChildren && !m_partiallyCheckedChildren )
+    {
+        return Qt::Unchecked;
+    }
+    return m_checkedChildren == childCount() ? Qt::Checked : Qt::PartiallyChecked;
+}
 
-    // Look for suitable parent item which may change checked-state
-    // when one of its children changes.
-    PackageTreeItem* currentItem = parentItem();
-    while ( ( currentItem != nullptr ) && ( currentItem->childCount() == 0 ) )
+void
+PackageTreeItem::countChild( Qt::CheckState state, int delta )
+{
+    if ( state == Qt::Checked )
     {
-        currentItem = currentItem->parentItem();
+        m_checkedChildren += delta;
     }
-    if ( currentItem == nullptr )
+    else if ( state == Qt::PartiallyChecked )
     {
-        // Reached the root .. don't bother
-        return;
+        m_partiallyCheckedChildren += delta;
     }
-
-    currentItem->updateSelected();
 }
 
+/** @brief Adds (or removes) the selected packages in this subtree to @p rootItem
+ *
+ * This is called when the subtree is attached to (or detached from)
+ * a tree; if that tree isn't connected to a root yet, @p rootItem is
+ * @c nullptr and the packages are added when it gets connected.
+ */
 void
-PackageTreeItem::updateSelected()
+PackageTreeItem::trackPackages( PackageTreeItem* rootItem, bool attach )
 {
-    // Figure out checked-state based on the children
-    int childrenSelected = 0;
-    int childrenPartiallySelected = 0;
-    for ( int i = 0; i < childCount(); i++ )
+    if ( !rootItem || m_selected == Qt::Unchecked )
+    {
+        // Nothing selected in this subtree
+        return;
+    }
+    if ( isPackage() )
     {
-        if ( child( i )->isSelected() == Qt::Checked )
+        if ( attach )
         {
-            childrenSelected++;
+            rootItem->m_selectedPackages.insert( m_sequence, this );
         }
-        if ( child( i )->isSelected() == Qt::PartiallyChecked )
+        else
         {
-            childrenPartiallySelected++;
+            rootItem->m_selectedPackages.remove( m_sequence );
         }
     }
-    if ( !childrenSelected && !childrenPartiallySelected )
+    for ( auto* child : qAsConst( m_childItems ) )
     {
-        setSelected( Qt::Unchecked );
+        child->trackPackages( rootItem, attach );
     }
-    else if ( childrenSelected == childCount() )
+}
+
+/** @brief Sets the state of this item only
+ *
+ * Keeps the counts in the parent and the selected packages in @p rootItem
+ * up-to-date. Returns @c true if the state changed.
+ */
+bool
+PackageTreeItem::setState( Qt::CheckState isSelected, PackageTreeItem* rootItem )
+{
+    if ( m_selected == isSelected )
     {
-        setSelected( Qt::Checked );
+        return false;
     }
-    else
+
+    const auto previous = m_selected;
+    m_selected = isSelected;
+    if ( m_parentItem && m_row >= 0 )
     {
-        setSelected( Qt::PartiallyChecked );
+        m_parentItem->countChild( previous, -1 );
+        m_parentItem->countChild( isSelected, 1 );
+    }
+    if ( rootItem && isPackage() )
+    {
+        if ( isSelected == Qt::Unchecked )
+        {
+            rootItem->m_selectedPackages.remove( m_sequence );
+        }
+        else
+        {
+            rootItem->m_selectedPackages.insert( m_sequence, this );
+        }
+    }
+    return true;
+}
+
+/** @brief Updates the state of the parents after this item changed
+ *
+ * Walks up the tree only as long as the parents actually change.
+ */
+void
+PackageTreeItem::updateParents( PackageTreeItem* rootItem )
+{
+    PackageTreeItem* item = this;
+    // The root is always checked, so stop below it
+    while ( item->m_row >= 0 && item->m_parentItem && item->m_parentItem->m_parentItem )
+    {
+        PackageTreeItem* parent = item->m_parentItem;
+        if ( !parent->setState( parent->childrenCheckState(), rootItem ) )
+        {
+            return;
+        }
+        item = parent;
     }
 }
 
+void
+PackageTreeItem::setSelected( Qt::CheckState isSelected )
+{
+    if ( parentItem() == nullptr )
+    {
+        // This is the root, it is always checked so don't change state
+        return;
+    }
+
+    PackageTreeItem* r = root();
+    setState( isSelected, r );
+    setChildrenSelected( isSelected, r );
+    updateParents( r );
+}
+
+void
+PackageTreeItem::updateSelected()
+{
+    if ( parentItem() == nullptr )
+    {
+        return;
+    }
+
+    // Figure out checked-state based on the children
+    PackageTreeItem* r = root();
+    if ( setState( childrenCheckState(), r ) )
+    {
+        updateParents( r );
+    }
+}
 
 void
 PackageTreeItem::setChildrenSelected( Qt::CheckState isSelected )
 {
-    if ( isSelected != Qt::PartiallyChecked )
-        // Children are never root; don't need to use setSelected on them.
-        for ( auto child : m_childItems )
+    setChildrenSelected( isSelected, root() );
+}
+
+void
+PackageTreeItem::setChildrenSelected( Qt::CheckState isSelected, PackageTreeItem* rootItem )
+{
+    if ( isSelected == Qt::PartiallyChecked )
+    {
+        return;
+    }
+    // Children are never root; don't need to use setSelected on them.
+    // A child that already has the state has a whole subtree with that state.
+    for ( auto* child : qAsConst( m_childItems ) )
+    {
+        if ( child->setState( isSelected, rootItem ) )
         {
-            child->m_selected = isSelected;
-            child->setChildrenSelected( isSelected );
+            child->setChildrenSelected( isSelected, rootItem );
         }
+    }
 }
 
 void
@@ -254,7 +373,15 @@ PackageTreeItem::removeChild( int row )
 {
     if ( 0 <= row && row < m_childItems.count() )
     {
+        PackageTreeItem* child = m_childItems.at( row );
+        child->trackPackages( root(), false );
+        countChild( child->m_selected, -1 );
+        child->m_row = -1;
         m_childItems.removeAt( row );
+        for ( int i = row; i < m_childItems.count(); ++i )
+        {
+            m_childItems.at( i )->m_row = i;
+        }
     }
     else
     {
@@ -12,6 +12,7 @@
 #define PACKAGETREEITEM_H
 
 #include <QList>
+#include <QMap>
 #include <QStandardItem>
 #include <QVariant>
 
@@ -45,6 +46,12 @@ public:
     PackageTreeItem* child( int row );
     int childCount() const;
     QVariant data( int column ) const override;
+    /** @brief The row of this item in its parent
+     *
+     * The row is stored when the item is appended to its parent,
+     * so this is cheap. Items that have a parent, but have not been
+     * appended to it (e.g. hidden groups) have row -1.
+     */
     int row() const;
 
     PackageTreeItem* parentItem();
@@ -122,6 +129,13 @@ public:
      */
     QVariant toOperation() const;
 
+    /** @brief Sets the selected state of this item
+     *
+     * The children get the same state (unless it is partially-checked)
+     * and the parents are updated to match. Only the items whose state
+     * actually changes are visited, so the cost is proportional
+     * to the change and not to the size of the tree.
+     */
     void setSelected( Qt::CheckState isSelected );
     void setChildrenSelected( Qt::CheckState isSelected );
 
@@ -130,10 +144,21 @@ public:
     /** @brief Update selectedness based on the children's states
      *
      * This only makes sense for groups, which might have packages
-     * or subgroups; it checks only direct children.
+     * or subgroups; it checks only direct children, using the
+     * counts of checked and partially-checked children that are
+     * kept up-to-date as children change.
      */
     void updateSelected();
 
+    /** @brief The selected packages under this root item, in tree order
+     *
+     * This is maintained as items are selected and de-selected,
+     * and only for a root item (one without a parent). Hidden
+     * groups are not part of the tree, so their packages
+     * are not included.
+     */
+    List selectedPackages() const { return m_selectedPackages.values(); }
+
     // QStandardItem methods
     int type() const override;
 
@@ -148,8 +173,22 @@ public:
     bool operator!=( const PackageTreeItem& rhs ) const { return !( *this == rhs ); }
 
 private:
+    static quint64 nextSequence();
+    PackageTreeItem* root();
+    Qt::CheckState childrenCheckState() const;
+    bool setState( Qt::CheckState isSelected, PackageTreeItem* rootItem );
+    void setChildrenSelected( Qt::CheckState isSelected, PackageTreeItem* rootItem );
+    void updateParents( PackageTreeItem* rootItem );
+    void countChild( Qt::CheckState state, int delta );
+    void trackPackages( PackageTreeItem* rootItem, bool attach );
+
     PackageTreeItem* m_parentItem;
     List m_childItems;
+    int m_row = -1;
+    int m_checkedChildren = 0;
+    int m_partiallyCheckedChildren = 0;
+    quint64 m_sequence = nextSequence();  ///< Creation order, which is also the order in the tree
+    QMap< quint64, PackageTreeItem* > m_selectedPackages;  ///< Only for the root
 
     // An entry can be a package, or a group.
     QString m_name;
@@ -43,6 +43,7 @@ private Q_SLOTS:
     void testGroup();
     void testCompare();
     void testModel();
+    void testSelection();
     void testExampleFiles();
 
     void testUrlFallback_data();
@@ -308,6 +309,90 @@ ItemTests::testModel()
     QVERIFY( *( m2.m_rootItem->child( 0 ) ) != *group );
 }
 
+static const char doc_nested[] =
+    "- name: one\n"
+    "  description: First group\n"
+    "  selected: true\n"
+    "  packages: [ a1, a2 ]\n"
+    "  subgroups:\n"
+    "  - name: one-sub\n"
+    "    description: First subgroup\n"
+    "    selected: false\n"
+    "    packages: [ b1, b2 ]\n"
+    "  - name: one-hidden\n"
+    "    description: Hidden subgroup\n"
+    "    hidden: true\n"
+    "    selected: true\n"
+    "    packages: [ h1 ]\n"
+    "- name: two\n"
+    "  description: Second group\n"
+    "  source: extra\n"
+    "  selected: false\n"
+    "  packages: [ c1, c2, c3 ]\n"
+    "- name: three\n"
+    "  description: Third group\n"
+    "  selected: true\n"
+    "  packages: [ d1 ]\n";
+
+static QStringList
+packageNames( const PackageTreeItem::List& items )
+{
+    QStringList names;
+    for ( const auto* item : items )
+    {
+        names.append( item->packageName() );
+    }
+    return names;
+}
+
+void
+ItemTests::testSelection()
+{
+    PackageModel m( nullptr );
+    m.setupModelData( CalamaresUtils::yamlSequenceToVariant( YAML::Load( doc_nested ) ) );
+    QCOMPARE( m.rowCount(), 3 );
+
+    const QModelIndex one = m.index( 0, 0 );
+    const QModelIndex sub = m.index( 2, 0, one );  // after two packages
+    QCOMPARE( m.data( one, Qt::CheckStateRole ).toInt(), int( Qt::PartiallyChecked ) );
+    QCOMPARE( m.data( sub, Qt::CheckStateRole ).toInt(), int( Qt::Unchecked ) );
+    QCOMPARE( packageNames( m.getPackages() ), QStringList( { "a1", "a2", "d1", "h1" } ) );
+
+    // Checking the last unchecked child checks the parent
+    m.setData( sub, Qt::Checked, Qt::CheckStateRole );
+    QCOMPARE( m.data( one, Qt::CheckStateRole ).toInt(), int( Qt::Checked ) );
+    QCOMPARE( packageNames( m.getPackages() ), QStringList( { "a1", "a2", "b1", "b2", "d1", "h1" } ) );
+
+    // Unchecking the packages one by one unchecks the parents
+    m.setData( m.index( 0, 0, one ), Qt::Unchecked, Qt::CheckStateRole );
+    m.setData( m.index( 1, 0, one ), Qt::Unchecked, Qt::CheckStateRole );
+    QCOMPARE( m.data( one, Qt::CheckStateRole ).toInt(), int( Qt::PartiallyChecked ) );
+    m.setData( m.index( 0, 0, sub ), Qt::Unchecked, Qt::CheckStateRole );
+    QCOMPARE( m.data( sub, Qt::CheckStateRole ).toInt(), int( Qt::PartiallyChecked ) );
+    m.setData( m.index( 1, 0, sub ), Qt::Unchecked, Qt::CheckStateRole );
+    QCOMPARE( m.data( sub, Qt::CheckStateRole ).toInt(), int( Qt::Unchecked ) );
+    QCOMPARE( m.data( one, Qt::CheckStateRole ).toInt(), int( Qt::Unchecked ) );
+    // .. and the hidden group goes with its parent
+    QCOMPARE( packageNames( m.getPackages() ), QStringList( { "d1" } ) );
+
+    // The maintained list matches walking the tree
+    m.setData( m.index( 1, 0 ), Qt::Checked, Qt::CheckStateRole );
+    m.setData( m.index( 1, 0, sub ), Qt::Checked, Qt::CheckStateRole );
+    QVERIFY( m.m_rootItem->selectedPackages() == m.getItemPackages( m.m_rootItem ) );
+    QCOMPARE( packageNames( m.getPackages() ), QStringList( { "b2", "c1", "c2", "c3", "d1", "h1" } ) );
+
+    // Replacing the group from source "extra" renumbers the rows
+    QCOMPARE( m.m_rootItem->child( 2 )->row(), 2 );
+    m.appendModelData( CalamaresUtils::yamlSequenceToVariant(
+        YAML::Load( "- name: four\n  description: Fourth\n  source: extra\n  selected: true\n  packages: [ e1 ]\n" ) ) );
+    QCOMPARE( m.rowCount(), 3 );
+    QCOMPARE( m.m_rootItem->child( 1 )->name(), QStringLiteral( "three" ) );
+    QCOMPARE( m.m_rootItem->child( 1 )->row(), 1 );
+    QCOMPARE( m.m_rootItem->child( 2 )->row(), 2 );
+    QCOMPARE( packageNames( m.getPackages() ), QStringList( { "b2", "d1", "e1", "h1" } ) );
+    QVERIFY( m.m_rootItem->selectedPackages() == m.getItemPackages( m.m_rootItem ) );
+}
+
 void
 ItemTests::testExampleFiles()
 {
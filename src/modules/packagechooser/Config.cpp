@@ -16,8 +16,8 @@
 
 #ifdef HAVE_APPSTREAM
 #include "ItemAppStream.h"
-#include <AppStreamQt/pool.h>
-#include <memory>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrent>
 #endif
 
 
@@ -25,6 +25,7 @@
 #include "JobQueue.h"
 #include "packages/Globals.h"
 #include "utils/Logger.h"
+#include "utils/Retranslator.h"
 #include "utils/Variant.h"
 
 /** @brief This removes any values from @p groups that match @p source
@@ -243,8 +244,21 @@ Config::prettyStatus() const
     return tr( "Install option: <strong>%1</strong>" ).arg( m_packageChoice.value_or( tr( "None" ) ) );
 }
 
+/// @brief The id an *appstream* item will have in the model
+static QString
+appStreamItemId( const QVariantMap& item_map )
+{
+    const QString id = CalamaresUtils::getString( item_map, "id" );
+    return id.isEmpty() ? CalamaresUtils::getString( item_map, "appstream" ) : id;
+}
+
+/** @brief Fills the @p model with the @p items from the configuration
+ *
+ * Items with AppStream data get a placeholder in the model, and
+ * are added to @p appStreamItems to be filled in later.
+ */
 static void
-fillModel( PackageListModel* model, const QVariantList& items )
+fillModel( PackageListModel* model, const QVariantList& items, QList< QVariantMap >& appStreamItems )
 {
     if ( items.isEmpty() )
     {
@@ -252,11 +266,6 @@ fillModel( PackageListModel* model, const QVariantList& items )
         return;
     }
 
-#ifdef HAVE_APPSTREAM
-    std::unique_ptr< AppStream::Pool > pool;
-    bool poolOk = false;
-#endif
-
     cDebug() << "Loading PackageChooser model items from config";
     int item_index = 0;
     for ( const auto& item_it : items )
@@ -280,16 +289,12 @@ fillModel( PackageListModel* model, const QVariantList& items )
         else if ( item_map.contains( "appstream" ) )
         {
 #ifdef HAVE_APPSTREAM
-            if ( !pool )
-            {
-                pool = std::make_unique< AppStream::Pool >();
-                pool->setLocale( QStringLiteral( "ALL" ) );
-                poolOk = pool->load();
-            }
-            if ( pool && poolOk )
-            {
-                model->addPackage( fromAppStream( *pool, item_map ) );
-            }
+            PackageItem placeholder( appStreamItemId( item_map ),
+                                     CalamaresUtils::getString( item_map, "appstream" ),
+                                     QObject::tr( "Loading package information ..." ) );
+            placeholder.isPlaceholder = true;
+            model->addPackage( std::move( placeholder ) );
+            appStreamItems.append( item_map );
 #else
             cWarning() << "Loading AppStream data is not supported.";
 #endif
@@ -317,7 +322,7 @@ Config::setConfigurationMap( const QVariantMap& configurationMap )
 
     if ( configurationMap.contains( "items" ) )
     {
-        fillModel( m_model, configurationMap.value( "items" ).toList() );
+        fillModel( m_model, configurationMap.value( "items" ).toList(), m_appStreamItems );
 
         QString default_item_id = CalamaresUtils::getString( configurationMap, "default" );
         if ( !default_item_id.isEmpty() )
@@ -334,6 +339,12 @@ Config::setConfigurationMap( const QVariantMap& configurationMap )
                 }
             }
         }
+
+        if ( !m_appStreamItems.isEmpty() )
+        {
+            // Also loads now, for the current language
+            CALAMARES_RETRANSLATE_SLOT( &Config::loadAppStream );
+        }
     }
     else
     {
@@ -344,3 +355,70 @@ Config::setConfigurationMap( const QVariantMap& configurationMap )
         }
     }
 }
+
+void
+Config::loadAppStream()
+{
+#ifdef HAVE_APPSTREAM
+    const QString locale = CalamaresUtils::translatorLocaleName().name;
+    if ( m_appStreamItems.isEmpty() || ( m_appStreamLoaded && locale == m_appStreamLocale ) )
+    {
+        return;
+    }
+    m_appStreamLocale = locale;
+
+    QStringList ids;
+    for ( const auto& item_map : qAsConst( m_appStreamItems ) )
+    {
+        ids.append( CalamaresUtils::getString( item_map, "appstream" ) );
+    }
+
+    const int generation = ++m_appStreamGeneration;
+    auto* watcher = new QFutureWatcher< QVariantMap >( this );
+    connect( watcher,
+             &QFutureWatcher< QVariantMap >::finished,
+             this,
+             [ this, watcher, generation ]()
+             {
+                 watcher->deleteLater();
+                 // A later load (for another language) replaces this one
+                 if ( generation == m_appStreamGeneration )
+                 {
+                     setAppStreamComponents( watcher->result() );
+                 }
+             } );
+    cDebug() << "Loading AppStream data for" << ids.count() << "items, locale" << locale;
+    watcher->setFuture( QtConcurrent::run( loadAppStreamComponents, ids, locale ) );
+#endif
+}
+
+void
+Config::setAppStreamComponents( const QVariantMap& components )
+{
+#ifdef HAVE_APPSTREAM
+    for ( const auto& item_map : qAsConst( m_appStreamItems ) )
+    {
+        const int row = m_model->rowForId( appStreamItemId( item_map ) );
+        const auto component = components.value( CalamaresUtils::getString( item_map, "appstream" ) ).toMap();
+        PackageItem p = component.isEmpty() ? PackageItem() : fromAppStream( component, item_map );
+        if ( p.isValid() )
+        {
+            m_model->setPackage( row, std::move( p ) );
+        }
+        else if ( !m_appStreamLoaded )
+        {
+            // Like any other invalid item, it's not offered at all
+            m_model->removePackage( row );
+        }
+    }
+    const bool wasLoaded = m_appStreamLoaded;
+    m_appStreamLoaded = true;
+    cDebug() << "PackageChooser has" << m_model->packageCount() << "entries with AppStream data.";
+    if ( !wasLoaded )
+    {
+        emit readyChanged();
+    }
+#else
+    Q_UNUSED( components )
+#endif
+}
@@ -16,6 +16,8 @@
 #include "modulesystem/Config.h"
 #include "modulesystem/InstanceKey.h"
 
+#include <QPersistentModelIndex>
+
 #include <memory>
 #include <optional>
 
@@ -100,13 +102,40 @@ public:
 
     QString prettyStatus() const;
 
+    /** @brief Is the model complete?
+     *
+     * While AppStream data is being loaded, the model has placeholders
+     * that can't be selected; selecting anything then is premature.
+     */
+    bool isReady() const { return m_appStreamItems.isEmpty() || m_appStreamLoaded; }
+
 signals:
     void packageChoiceChanged( QString packageChoice );
     void prettyStatusChanged();
+    /// @brief Emitted once, when the AppStream data has been loaded
+    void readyChanged();
 
 private:
+    /** @brief Fills in the AppStream items in the model
+     *
+     * The AppStream data is loaded in the background, for the
+     * current language; until then, the model has placeholders.
+     * Called again when the language changes.
+     */
+    void loadAppStream();
+    void setAppStreamComponents( const QVariantMap& components );
+
     PackageListModel* m_model = nullptr;
-    QModelIndex m_defaultModelIndex;
+    /// Persistent, since placeholders without AppStream data are removed
+    QPersistentModelIndex m_defaultModelIndex;
+
+    /// Item-maps of the *appstream* items in the configuration
+    QList< QVariantMap > m_appStreamItems;
+    /// Locale of the most recent AppStream load
+    QString m_appStreamLocale;
+    /// Only the results of the most recent AppStream load are used
+    int m_appStreamGeneration = 0;
+    bool m_appStreamLoaded = false;
 
     /// Selection mode for this module
     PackageChooserMode m_mode = PackageChooserMode::Optional;
@@ -13,7 +13,6 @@
  */
 #include "PackageModel.h"
 
-#include "locale/TranslationsModel.h"
 #include "utils/Logger.h"
 #include "utils/Variant.h"
 
@@ -21,6 +20,17 @@
 #include <AppStreamQt/pool.h>
 #include <AppStreamQt/screenshot.h>
 
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <algorithm>
+
 /// @brief Return number of pixels in a size, for < ordering purposes
 static inline quint64
 sizeOrder( const QSize& size )
@@ -54,25 +64,26 @@ setScreenshot( QVariantMap& map, const AppStream::Screenshot& screenshot )
     }
 }
 
-/// @brief Interpret an AppStream Component
-static PackageItem
-fromComponent( AppStream::Component& component )
+/** @brief Interpret an AppStream Component
+ *
+ * The pool has loaded only @p locale, so the component has untranslated
+ * strings (locale C) and the ones for @p locale (or a fallback for it,
+ * like "pt" for "pt_BR"), and nothing else.
+ */
+static QVariantMap
+fromComponent( AppStream::Component& component, const QString& locale )
 {
     QVariantMap map;
     map.insert( "id", component.id() );
     map.insert( "package", component.packageNames().join( "," ) );
 
-    // Assume that the pool has loaded "ALL" locales, but it might be set
-    // to any of them; get the en_US locale as "untranslated" and then
-    // loop over Calamares locales (since there is no way to query for
-    // available locales in the Component) to see if there's anything else.
-    component.setActiveLocale( QStringLiteral( "en_US" ) );
+    component.setActiveLocale( QStringLiteral( "C" ) );
     QString en_name = component.name();
     QString en_description = component.description();
     map.insert( "name", en_name );
     map.insert( "description", en_description );
 
-    for ( const QString& locale : CalamaresUtils::Locale::availableTranslations()->localeIds() )
+    if ( !locale.isEmpty() )
     {
         component.setActiveLocale( locale );
         QString name = component.name();
@@ -106,44 +117,179 @@ fromComponent( AppStream::Component& component )
         }
     }
 
-    return PackageItem( map );
+    return map;
 }
 
-PackageItem
-fromAppStream( AppStream::Pool& pool, const QVariantMap& item_map )
+/// @brief Where AppStream catalogue data lives, old and new names
+static const char* const catalogueDirs[] = {
+    "/usr/share/swcatalog", "/usr/share/app-info", "/var/lib/app-info", "/var/cache/app-info", "/usr/share/metainfo",
+};
+
+/** @brief When was the AppStream catalogue last changed?
+ *
+ * Catalogue updates add and replace files, which changes the
+ * modification time of the directories holding them.
+ */
+static qint64
+catalogueTimestamp()
+{
+    qint64 timestamp = 0;
+    for ( const auto* dirName : catalogueDirs )
+    {
+        QFileInfo info( QString::fromLatin1( dirName ) );
+        if ( !info.isDir() )
+        {
+            continue;
+        }
+        timestamp = std::max( timestamp, info.lastModified().toMSecsSinceEpoch() );
+        const auto subdirs = QDir( info.filePath() ).entryInfoList( QDir::Dirs | QDir::NoDotAndDotDot );
+        for ( const auto& sub : subdirs )
+        {
+            timestamp = std::max( timestamp, sub.lastModified().toMSecsSinceEpoch() );
+        }
+    }
+    return timestamp;
+}
+
+static QString
+cacheFilePath()
 {
-    QString appstreamId = CalamaresUtils::getString( item_map, "appstream" );
-    if ( appstreamId.isEmpty() )
+    QDir dir( QStandardPaths::writableLocation( QStandardPaths::CacheLocation ) );
+    if ( !dir.exists() && !dir.mkpath( QStringLiteral( "." ) ) )
     {
-        cWarning() << "Can't load AppStream without a suitable appstreamId.";
-        return PackageItem();
+        return QString();
     }
-    cDebug() << "Loading AppStream data for" << appstreamId;
+    return dir.filePath( QStringLiteral( "packagechooser-appstream.json" ) );
+}
 
-    auto itemList = pool.componentsById( appstreamId );
-    if ( itemList.count() < 1 )
+static QVariantMap
+readCacheFile( const QString& cacheFile, qint64 timestamp )
+{
+    QFile f( cacheFile );
+    if ( cacheFile.isEmpty() || !f.open( QIODevice::ReadOnly ) )
     {
-        cWarning() << "No AppStream data for" << appstreamId;
-        return PackageItem();
+        return QVariantMap();
     }
-    if ( itemList.count() > 1 )
+    const auto cache = QJsonDocument::fromJson( f.readAll() ).object().toVariantMap();
+    if ( cache.value( "timestamp" ).toLongLong() != timestamp )
     {
-        cDebug() << "Multiple AppStream data for" << appstreamId << "using first.";
+        return QVariantMap();
     }
+    return cache;
+}
 
-    auto r = fromComponent( itemList.first() );
-    if ( r.isValid() )
+bool
+readAppStreamCache( const QString& cacheFile,
+                    qint64 timestamp,
+                    const QString& locale,
+                    const QStringList& ids,
+                    QVariantMap& components )
+{
+    const auto cached = readCacheFile( cacheFile, timestamp ).value( "locales" ).toMap().value( locale ).toMap();
+    bool complete = true;
+    for ( const auto& id : ids )
     {
-        QString id = CalamaresUtils::getString( item_map, "id" );
-        QString screenshotPath = CalamaresUtils::getString( item_map, "screenshot" );
-        if ( !id.isEmpty() )
+        if ( !cached.contains( id ) )
         {
-            r.id = id;
+            complete = false;
+            continue;
         }
-        if ( !screenshotPath.isEmpty() )
+        const auto component = cached.value( id ).toMap();
+        // An empty map records an id that is not in the catalogue
+        if ( !component.isEmpty() )
         {
-            r.screenshot = screenshotPath;
+            components.insert( id, component );
         }
     }
-    return r;
+    return complete;
+}
+
+void
+writeAppStreamCache( const QString& cacheFile,
+                     qint64 timestamp,
+                     const QString& locale,
+                     const QStringList& ids,
+                     const QVariantMap& components )
+{
+    if ( cacheFile.isEmpty() )
+    {
+        return;
+    }
+
+    auto cache = readCacheFile( cacheFile, timestamp );
+    auto locales = cache.value( "locales" ).toMap();
+    auto cached = locales.value( locale ).toMap();
+    for ( const auto& id : ids )
+    {
+        cached.insert( id, components.value( id ).toMap() );
+    }
+    locales.insert( locale, cached );
+    cache.insert( "timestamp", timestamp );
+    cache.insert( "locales", locales );
+
+    QSaveFile f( cacheFile );
+    if ( !f.open( QIODevice::WriteOnly )
+         || f.write( QJsonDocument( QJsonObject::fromVariantMap( cache ) ).toJson( QJsonDocument::Compact ) ) < 0
+         || !f.commit() )
+    {
+        cWarning() << "Could not write AppStream cache" << cacheFile;
+    }
+}
+
+QVariantMap
+loadAppStreamComponents( const QStringList& ids, const QString& locale )
+{
+    const qint64 timestamp = catalogueTimestamp();
+    const QString cacheFile = cacheFilePath();
+
+    QVariantMap components;
+    if ( readAppStreamCache( cacheFile, timestamp, locale, ids, components ) )
+    {
+        cDebug() << "Using cached AppStream data for" << ids.count() << "components.";
+        return components;
+    }
+
+    AppStream::Pool pool;
+    // Only the untranslated data and this locale, instead of ALL
+    pool.setLocale( locale.isEmpty() ? QStringLiteral( "C" ) : locale );
+    if ( !pool.load() )
+    {
+        cWarning() << "Could not load AppStream data:" << pool.lastError();
+        return components;
+    }
+
+    components.clear();
+    for ( const auto& id : ids )
+    {
+        auto itemList = pool.componentsById( id );
+        if ( itemList.count() < 1 )
+        {
+            cWarning() << "No AppStream data for" << id;
+            continue;
+        }
+        if ( itemList.count() > 1 )
+        {
+            cDebug() << "Multiple AppStream data for" << id << "using first.";
+        }
+        components.insert( id, fromComponent( itemList.first(), locale ) );
+    }
+    writeAppStreamCache( cacheFile, timestamp, locale, ids, components );
+    return components;
+}
+
+PackageItem
+fromAppStream( const QVariantMap& component, const QVariantMap& item_map )
+{
+    QVariantMap map = component;
+    QString id = CalamaresUtils::getString( item_map, "id" );
+    QString screenshotPath = CalamaresUtils::getString( item_map, "screenshot" );
+    if ( !id.isEmpty() )
+    {
+        map.insert( "id", id );
+    }
+    if ( !screenshotPath.isEmpty() )
+    {
+        map.insert( "screenshot", screenshotPath );
+    }
+    return PackageItem( map );
 }
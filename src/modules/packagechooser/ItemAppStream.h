@@ -12,23 +12,56 @@
 
 #include "PackageModel.h"
 
-namespace AppStream
-{
-class Pool;
-}
+/** @brief Makes a PackageItem from AppStream @p component data
+ *
+ * The @p component map is one of the values returned by
+ * loadAppStreamComponents(). The item @p map must have a key
+ * *appstream*, that is the id of the component. The keys *id*
+ * and *screenshot* of the item @p map may be used to override
+ * parts of the AppStream data -- so that the ID is under the
+ * control of Calamares, and the screenshot can be forced to a
+ * local path available on the installation medium.
+ *
+ * This loads the screenshot, so call it from the GUI thread.
+ */
+PackageItem fromAppStream( const QVariantMap& component, const QVariantMap& map );
+
+/** @brief Looks up the AppStream components @p ids
+ *
+ * Returns a map from AppStream id to the component's data, as
+ * item-map (see PackageItem) with only the untranslated strings
+ * and the ones for @p locale. Ids without AppStream data are
+ * left out.
+ *
+ * Only the @p locale (and the untranslated data) is loaded from
+ * the AppStream catalogue, and the results are cached on disk
+ * until the catalogue changes, so usually there is no catalogue
+ * to load at all. This does not touch the GUI, and is meant
+ * to be called from a worker thread.
+ */
+QVariantMap loadAppStreamComponents( const QStringList& ids, const QString& locale );
 
-/** @brief Loads an item from AppStream data.
+/** @brief Reads the components for @p ids in @p locale from @p cacheFile
  *
- * The @p map must have a key *appstream*. That is used as the
- * primary source of information from the AppStream cache, but
- * keys *id* and *screenshotPath* may be used to override parts
- * of the AppStream data -- so that the ID is under the control
- * of Calamares, and the screenshot can be forced to a local path
- * available on the installation medium.
+ * The cache is only valid for a catalogue last modified at @p timestamp.
+ * Returns false (and an incomplete @p components map) if not all of
+ * the @p ids are in the cache. Ids that are known to be missing from
+ * the catalogue are in the cache, but not in @p components.
+ */
+bool readAppStreamCache( const QString& cacheFile,
+                         qint64 timestamp,
+                         const QString& locale,
+                         const QStringList& ids,
+                         QVariantMap& components );
+/** @brief Adds @p components for @p ids in @p locale to @p cacheFile
  *
- * Requires AppStreamQt, if not present will return invalid
- * PackageItems.
+ * Ids in @p ids that are not in @p components are remembered as missing.
+ * Cached data for another @p timestamp is dropped.
  */
-PackageItem fromAppStream( AppStream::Pool& pool, const QVariantMap& map );
+void writeAppStreamCache( const QString& cacheFile,
+                          qint64 timestamp,
+                          const QString& locale,
+                          const QStringList& ids,
+                          const QVariantMap& components );
 
 #endif
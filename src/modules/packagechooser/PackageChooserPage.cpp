@@ -97,6 +97,8 @@ PackageChooserPage::setModel( QAbstractItemModel* model )
              &QItemSelectionModel::selectionChanged,
              this,
              &PackageChooserPage::updateLabels );
+    // Items may be filled in later, e.g. with AppStream data
+    connect( model, &QAbstractItemModel::dataChanged, this, &PackageChooserPage::updateLabels );
 }
 
 void
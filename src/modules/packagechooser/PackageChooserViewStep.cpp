@@ -31,6 +31,14 @@ PackageChooserViewStep::PackageChooserViewStep( QObject* parent )
     , m_widget( nullptr )
     , m_stepName( nullptr )
 {
+    connect( m_config, &Config::readyChanged, this, [ = ]() {
+        // The default may have been a placeholder, which can't be selected
+        if ( m_widget && !m_widget->hasSelection() )
+        {
+            m_widget->setSelection( m_config->defaultSelectionIndex() );
+        }
+        emit nextStatusChanged( isNextEnabled() );
+    } );
     emit nextStatusChanged( false );
 }
 
@@ -70,6 +78,11 @@ PackageChooserViewStep::widget()
 bool
 PackageChooserViewStep::isNextEnabled() const
 {
+    if ( !m_config->isReady() )
+    {
+        // Placeholders still, which would select nothing
+        return false;
+    }
     if ( !m_widget )
     {
         // No way to have changed anything
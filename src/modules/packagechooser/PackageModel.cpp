@@ -109,6 +109,40 @@ PackageListModel::addPackage( PackageItem&& p )
     }
 }
 
+void
+PackageListModel::setPackage( int r, PackageItem&& p )
+{
+    if ( p.isValid() && r >= 0 && r < m_packages.count() )
+    {
+        m_packages[ r ] = p;
+        emit dataChanged( index( r, 0 ), index( r, 0 ) );
+    }
+}
+
+void
+PackageListModel::removePackage( int r )
+{
+    if ( r >= 0 && r < m_packages.count() )
+    {
+        beginRemoveRows( QModelIndex(), r, r );
+        m_packages.removeAt( r );
+        endRemoveRows();
+    }
+}
+
+int
+PackageListModel::rowForId( const QString& id ) const
+{
+    for ( int r = 0; r < m_packages.count(); ++r )
+    {
+        if ( m_packages[ r ].id == id )
+        {
+            return r;
+        }
+    }
+    return -1;
+}
+
 QStringList
 PackageListModel::getInstallPackagesForName( const QString& id ) const
 {
@@ -162,6 +196,16 @@ PackageListModel::rowCount( const QModelIndex& index ) const
     return index.isValid() ? 0 : m_packages.count();
 }
 
+Qt::ItemFlags
+PackageListModel::flags( const QModelIndex& index ) const
+{
+    if ( index.isValid() && index.row() < m_packages.count() && m_packages[ index.row() ].isPlaceholder )
+    {
+        return Qt::NoItemFlags;
+    }
+    return QAbstractListModel::flags( index );
+}
+
 QVariant
 PackageListModel::data( const QModelIndex& index, int role ) const
 {
@@ -27,6 +27,12 @@ struct PackageItem
     QPixmap screenshot;
     QStringList packageNames;
     QVariantMap netinstallData;
+    /** @brief Is this a placeholder for data that is still loading?
+     *
+     * Placeholders are shown, but can't be selected: they
+     * have no packages yet.
+     */
+    bool isPlaceholder = false;
 
     /// @brief Create blank PackageItem
     PackageItem();
@@ -90,9 +96,21 @@ public:
      * Only valid packages are added -- that is, they must have a name.
      */
     void addPackage( PackageItem&& p );
+    /** @brief Replace the package in row @p r with @p p
+     *
+     * This is for placeholders that are filled in later. Invalid
+     * packages are not used, and @p r must be an existing row.
+     */
+    void setPackage( int r, PackageItem&& p );
+    /// @brief Remove the package in row @p r
+    void removePackage( int r );
+    /// @brief The row of the package with the given @p id, or -1
+    int rowForId( const QString& id ) const;
 
     int rowCount( const QModelIndex& index ) const override;
     QVariant data( const QModelIndex& index, int role ) const override;
+    /// @brief Placeholders are neither enabled nor selectable
+    Qt::ItemFlags flags( const QModelIndex& index ) const override;
 
     /// @brief Direct (non-abstract) access to package data
     const PackageItem& packageData( int r ) const { return m_packages[ r ]; }
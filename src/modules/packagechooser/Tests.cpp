@@ -19,6 +19,8 @@
 
 #include "utils/Logger.h"
 
+#include <QSignalSpy>
+#include <QTemporaryDir>
 #include <QtTest/QtTest>
 
 QTEST_MAIN( PackageChooserTests )
@@ -82,3 +84,88 @@ PackageChooserTests::testAppData()
     QVERIFY( !p2.screenshot.isNull() );
 #endif
 }
+
+void
+PackageChooserTests::testPlaceholders()
+{
+    PackageListModel model( nullptr );
+    model.addPackage( PackageItem( "first", "First", "The first one" ) );
+    for ( const auto& id : { "org.kde.kate", "missing" } )
+    {
+        PackageItem placeholder( id, id, "Loading" );
+        placeholder.isPlaceholder = true;
+        model.addPackage( std::move( placeholder ) );
+    }
+    QCOMPARE( model.packageCount(), 3 );
+    QVERIFY( model.flags( model.index( 0, 0 ) ) & Qt::ItemIsSelectable );
+    QCOMPARE( model.flags( model.index( 1, 0 ) ), Qt::ItemFlags( Qt::NoItemFlags ) );
+    QCOMPARE( model.rowForId( "org.kde.kate" ), 1 );
+    QCOMPARE( model.rowForId( "nonexistent" ), -1 );
+
+    QPersistentModelIndex last( model.index( 2, 0 ) );
+    QSignalSpy changed( &model, &QAbstractItemModel::dataChanged );
+
+    // Filling in a placeholder keeps the row
+    model.setPackage( 1, PackageItem( "org.kde.kate", "Kate", "Advanced text editor" ) );
+    QCOMPARE( changed.count(), 1 );
+    QCOMPARE( model.packageCount(), 3 );
+    QCOMPARE( model.data( model.index( 1, 0 ), PackageListModel::NameRole ).toString(), QStringLiteral( "Kate" ) );
+    QVERIFY( model.flags( model.index( 1, 0 ) ) & Qt::ItemIsSelectable );
+
+    // Invalid items don't replace anything
+    model.setPackage( 2, PackageItem() );
+    QCOMPARE( changed.count(), 1 );
+    QCOMPARE( model.packageData( 2 ).id, QStringLiteral( "missing" ) );
+    model.setPackage( 7, PackageItem( "x", "X", "Out of range" ) );
+    QCOMPARE( changed.count(), 1 );
+
+    model.removePackage( model.rowForId( "first" ) );
+    QCOMPARE( model.packageCount(), 2 );
+    QCOMPARE( model.rowForId( "org.kde.kate" ), 0 );
+    QCOMPARE( last.row(), 1 );
+}
+
+void
+PackageChooserTests::testAppStreamCache()
+{
+#ifdef HAVE_APPSTREAM
+    QTemporaryDir tempDir;
+    QVERIFY( tempDir.isValid() );
+    const QString cacheFile = tempDir.filePath( "appstream.json" );
+    const QStringList ids { "org.kde.kate", "org.kde.missing" };
+
+    QVariantMap components;
+    QVERIFY( !readAppStreamCache( cacheFile, 1000, "nl", ids, components ) );
+    QVERIFY( components.isEmpty() );
+
+    const QVariantMap kate {
+        { "id", "org.kde.kate" }, { "name", "Kate" }, { "name[nl]", "Kate" }, { "description", "Text editor" }
+    };
+    writeAppStreamCache( cacheFile, 1000, "nl", ids, { { "org.kde.kate", kate } } );
+
+    // Both are known, only one of them exists
+    QVERIFY( readAppStreamCache( cacheFile, 1000, "nl", ids, components ) );
+    QCOMPARE( components.count(), 1 );
+    QCOMPARE( components.value( "org.kde.kate" ).toMap(), kate );
+
+    // Another locale is not cached yet
+    components.clear();
+    QVERIFY( !readAppStreamCache( cacheFile, 1000, "de", ids, components ) );
+    writeAppStreamCache( cacheFile, 1000, "de", { "org.kde.kate" }, { { "org.kde.kate", kate } } );
+    QVERIFY( readAppStreamCache( cacheFile, 1000, "de", { "org.kde.kate" }, components ) );
+    QVERIFY( readAppStreamCache( cacheFile, 1000, "nl", ids, components ) );
+
+    // The catalogue changed, so nothing is cached any more
+    components.clear();
+    QVERIFY( !readAppStreamCache( cacheFile, 2000, "nl", ids, components ) );
+    QVERIFY( components.isEmpty() );
+
+    // The overrides from the configuration apply
+    PackageItem p = fromAppStream( kate, { { "appstream", "org.kde.kate" }, { "id", "kate" } } );
+    QVERIFY( p.isValid() );
+    QCOMPARE( p.id, QStringLiteral( "kate" ) );
+    QCOMPARE( p.name.get(), QStringLiteral( "Kate" ) );
+#else
+    QSKIP( "AppStream support is not built" );
+#endif
+}
@@ -10,8 +10,8 @@
 
 #include "DeviceList.h"
 
+#include "partition/DeviceInventory.h"
 #include "partition/PartitionIterator.h"
-#include "utils/CalamaresUtilsSystem.h"
 #include "utils/Logger.h"
 
 #include <kpmcore/backend/corebackend.h>
@@ -19,8 +19,6 @@
 #include <kpmcore/core/device.h>
 #include <kpmcore/core/partition.h>
 
-#include <QProcess>
-
 using CalamaresUtils::Partition::PartitionIterator;
 
 namespace PartUtils
@@ -43,21 +41,20 @@ hasRootPartition( Device* device )
 
 /** @brief Check if @p path holds an iso9660 filesystem
  *
- * The @p path should point to a device; blkid is used to check the FS type.
+ * The @p path should point to a device; the shared device inventory
+ * knows the FS type of every device.
  */
 static bool
-blkIdCheckIso9660( const QString& path )
+isIso9660Path( const QString& path )
 {
-    // If blkid fails, there's no output, but we don't care
-    auto r = CalamaresUtils::System::runCommand( { "blkid", path }, std::chrono::seconds( 30 ) );
-    return r.getOutput().contains( "iso9660" );
+    return CalamaresUtils::Partition::DeviceInventory::instance()->device( path ).fsType == QStringLiteral( "iso9660" );
 }
 
 /// @brief Convenience to check if @p partition holds an iso9660 filesystem
 static bool
-blkIdCheckIso9660P( const Partition* partition )
+isIso9660Partition( const Partition* partition )
 {
-    return blkIdCheckIso9660( partition->partitionPath() );
+    return isIso9660Path( partition->partitionPath() );
 }
 
 /** @brief Check if the @p device is an iso9660 device
@@ -73,7 +70,7 @@ isIso9660( const Device* device )
     {
         return false;
     }
-    if ( blkIdCheckIso9660( path ) )
+    if ( isIso9660Path( path ) )
     {
         return true;
     }
@@ -81,7 +78,7 @@ isIso9660( const Device* device )
     if ( device->partitionTable() && !device->partitionTable()->children().isEmpty() )
     {
         const auto& p = device->partitionTable()->children();
-        return std::any_of( p.cbegin(), p.cend(), blkIdCheckIso9660P );
+        return std::any_of( p.cbegin(), p.cend(), isIso9660Partition );
     }
     return false;
 }
@@ -13,6 +13,7 @@
 
 #include "core/PartitionInfo.h"
 
+#include "partition/DeviceInventory.h"
 #include "partition/PartitionIterator.h"
 #include "utils/Logger.h"
 #include "utils/String.h"
@@ -133,7 +134,10 @@ execute( Operation& operation, const QString& failureMessage )
     operation.setStatus( Operation::StatusRunning );
 
     Report report( nullptr );
-    if ( operation.execute( report ) )
+    const bool ok = operation.execute( report );
+    // Even a failed operation may have changed something on disk
+    CalamaresUtils::Partition::DeviceInventory::instance()->invalidate();
+    if ( ok )
     {
         return Calamares::JobResult::ok();
     }
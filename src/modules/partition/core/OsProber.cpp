@@ -0,0 +1,447 @@
+/* === This file is part of Calamares - <https://calamares.io> ===
+ *
+ *   SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *   SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ *   Calamares is Free Software: see the License-Identifier above.
+ *
+ */
+
+#include "OsProber.h"
+
+#include "partition/Mount.h"
+#include "utils/Logger.h"
+#include "utils/String.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QtConcurrent/QtConcurrent>
+
+#include <algorithm>
+#include <memory>
+
+using CalamaresUtils::Partition::BlockDevice;
+using CalamaresUtils::Partition::BlockDeviceList;
+using CalamaresUtils::Partition::MtabInfo;
+
+/// @brief NTFS keeps its boot code in the first 16 sectors
+static constexpr const int bootSectorsSize = 16 * 512;
+
+/** @brief Filesystems that are mounted to look for an OS
+ *
+ * NTFS is only mounted when the boot sectors have a Windows loader.
+ */
+static const QStringList&
+probedFilesystems()
+{
+    static const QStringList fs {
+        "btrfs", "ext2", "ext3", "ext4", "f2fs", "hfsplus", "jfs", "ntfs", "reiserfs", "vfat", "xfs"
+    };
+    return fs;
+}
+
+/// @brief An entry like os-prober would produce it, for device @p path and (optional) @p file
+static OsproberEntry
+makeEntry( const QString& path,
+           const QString& file,
+           const QString& longName,
+           const QString& shortName,
+           const QString& type )
+{
+    const QString device = file.isEmpty() ? path : path + '@' + file;
+    return OsproberEntry { longName.isEmpty() ? shortName : longName,
+                           path,
+                           file,
+                           QString(),
+                           false,
+                           QStringList { device, longName, shortName, type },
+                           FstabEntryList(),
+                           QString() };
+}
+
+/// @brief Does @p data contain @p name, in ASCII or in UTF-16 (as NTFS stores names)?
+static bool
+containsName( const QByteArray& data, const char* name )
+{
+    QByteArray utf16;
+    for ( const char* p = name; *p; ++p )
+    {
+        utf16.append( *p );
+        utf16.append( '\0' );
+    }
+    return data.contains( name ) || data.contains( utf16 );
+}
+
+/** @brief Finds @p relativePath under @p root, ignoring case
+ *
+ * FAT and NTFS are case-insensitive, but a filesystem that is read
+ * otherwise (e.g. in the tests) need not be. Returns the path relative
+ * to @p root, with the case as it is on disk, or empty if not found.
+ */
+static QString
+findIgnoringCase( const QString& root, const QString& relativePath )
+{
+    QDir dir( root );
+    QStringList found;
+    const auto components = relativePath.split( '/', SplitSkipEmptyParts );
+    for ( const auto& component : components )
+    {
+        const auto entries = dir.entryList( QDir::AllEntries | QDir::Hidden | QDir::NoDotAndDotDot );
+        auto it = std::find_if( entries.cbegin(), entries.cend(), [ &component ]( const QString& e ) {
+            return e.compare( component, Qt::CaseInsensitive ) == 0;
+        } );
+        if ( it == entries.cend() )
+        {
+            return QString();
+        }
+        found.append( *it );
+        dir.setPath( dir.filePath( *it ) );
+    }
+    return found.join( '/' );
+}
+
+/// @brief Reads the KEY=value pairs of an os-release file, without quotes
+static QMap< QString, QString >
+readOsRelease( const QString& fileName )
+{
+    QMap< QString, QString > values;
+    QFile f( fileName );
+    if ( !f.open( QIODevice::ReadOnly | QIODevice::Text ) )
+    {
+        return values;
+    }
+    const auto lines = QString::fromUtf8( f.readAll() ).split( '\n' );
+    for ( const auto& line : lines )
+    {
+        const int eq = line.indexOf( '=' );
+        if ( eq < 1 || line.startsWith( '#' ) )
+        {
+            continue;
+        }
+        QString value = line.mid( eq + 1 ).trimmed();
+        if ( value.length() >= 2 && ( value.startsWith( '"' ) || value.startsWith( '\'' ) )
+             && value.endsWith( value.at( 0 ) ) )
+        {
+            value = value.mid( 1, value.length() - 2 );
+        }
+        values.insert( line.left( eq ).trimmed(), value );
+    }
+    return values;
+}
+
+/// @brief The value for @p key in a (macOS) property list
+static QString
+plistValue( const QString& plist, const QString& key )
+{
+    QRegularExpression re( QStringLiteral( "<key>%1</key>\\s*<string>([^<]*)</string>" ).arg( key ) );
+    return re.match( plist ).captured( 1 ).trimmed();
+}
+
+/// @brief Entries for the EFI loaders in an EFI system partition mounted at @p root
+static OsproberEntryList
+probeEfi( const QString& path, const QString& root )
+{
+    struct EfiLoader
+    {
+        const char* file;
+        const char* longName;
+        const char* shortName;
+    };
+    static const EfiLoader loaders[] = {
+        { "EFI/Microsoft/Boot/bootmgfw.efi", "Windows Boot Manager", "Windows" },
+    };
+
+    OsproberEntryList entries;
+    for ( const auto& loader : loaders )
+    {
+        const QString file = findIgnoringCase( root, loader.file );
+        if ( !file.isEmpty() )
+        {
+            entries.append( makeEntry( path, '/' + file, loader.longName, loader.shortName, QStringLiteral( "efi" ) ) );
+        }
+    }
+    return entries;
+}
+
+/// @brief An entry for the Linux installation mounted at @p root, if any
+static OsproberEntryList
+probeLinux( const QString& path, const QString& root )
+{
+    // /etc/os-release is usually a symlink, which may be absolute, so
+    // it would point into the running system: read the target instead.
+    const QDir dir( root );
+    QString osRelease = dir.filePath( QStringLiteral( "etc/os-release" ) );
+    if ( QFileInfo( osRelease ).isSymLink() || !QFileInfo::exists( osRelease ) )
+    {
+        osRelease = dir.filePath( QStringLiteral( "usr/lib/os-release" ) );
+    }
+
+    const auto values = readOsRelease( osRelease );
+    if ( values.isEmpty() )
+    {
+        return OsproberEntryList();
+    }
+
+    const QString name = values.value( QStringLiteral( "NAME" ), QStringLiteral( "Linux" ) );
+    QString longName = values.value( QStringLiteral( "PRETTY_NAME" ) );
+    if ( longName.isEmpty() )
+    {
+        longName = name;
+    }
+    return { makeEntry( path, QString(), longName, QString( name ).remove( ' ' ), QStringLiteral( "linux" ) ) };
+}
+
+/// @brief An entry for the macOS installation mounted at @p root, if any
+static OsproberEntryList
+probeMacOS( const QString& path, const QString& root )
+{
+    QFile f( QDir( root ).filePath( QStringLiteral( "System/Library/CoreServices/SystemVersion.plist" ) ) );
+    if ( !f.open( QIODevice::ReadOnly | QIODevice::Text ) )
+    {
+        return OsproberEntryList();
+    }
+
+    const QString plist = QString::fromUtf8( f.readAll() );
+    const QString longName = QStringLiteral( "%1 %2" )
+                                 .arg( plistValue( plist, QStringLiteral( "ProductName" ) ),
+                                       plistValue( plist, QStringLiteral( "ProductVersion" ) ) )
+                                 .trimmed();
+    return { makeEntry( path,
+                        QString(),
+                        longName.isEmpty() ? QStringLiteral( "Mac OS X" ) : longName,
+                        QStringLiteral( "MacOSX" ),
+                        QStringLiteral( "macosx" ) ) };
+}
+
+/// @brief The valid entries in the /etc/fstab under @p root
+static FstabEntryList
+readFstab( const QString& root )
+{
+    FstabEntryList fstabEntries;
+    QFile fstabFile( QDir( root ).filePath( QStringLiteral( "etc/fstab" ) ) );
+    if ( !fstabFile.open( QIODevice::ReadOnly | QIODevice::Text ) )
+    {
+        return fstabEntries;
+    }
+
+    const QStringList fstabLines = QString::fromLocal8Bit( fstabFile.readAll() ).split( '\n' );
+    for ( const QString& rawLine : fstabLines )
+    {
+        const auto entry = FstabEntry::fromEtcFstab( rawLine );
+        if ( entry.isValid() )
+        {
+            fstabEntries.append( entry );
+        }
+    }
+    cDebug() << Logger::SubEntry << "got" << fstabEntries.count() << "fstab entries from" << fstabLines.count()
+             << "lines in" << fstabFile.fileName();
+    return fstabEntries;
+}
+
+/// @brief Where is @p device mounted, according to @p mounts? Empty if it isn't.
+static QString
+mountPointOf( const BlockDevice& device, const QList< MtabInfo >& mounts )
+{
+    const QString canonical = QFileInfo( device.path ).canonicalFilePath();
+    for ( const auto& m : mounts )
+    {
+        if ( m.device == device.path
+             || ( !canonical.isEmpty() && QFileInfo( m.device ).canonicalFilePath() == canonical ) )
+        {
+            return m.mountPoint;
+        }
+    }
+    return QString();
+}
+
+/// @brief Reads the boot sectors of @p path, or an empty array if it can't be read
+static QByteArray
+readBootSectors( const QString& path )
+{
+    QFile f( path );
+    if ( !f.open( QIODevice::ReadOnly ) )
+    {
+        cWarning() << "Could not read boot sectors of" << path;
+        return QByteArray();
+    }
+    return f.read( bootSectorsSize );
+}
+
+static OsproberEntryList
+probePartition( const BlockDevice& device, const QList< MtabInfo >& mounts )
+{
+    if ( !( device.isPartition || device.isVolume() ) || !probedFilesystems().contains( device.fsType ) )
+    {
+        return OsproberEntryList();
+    }
+
+    const bool isNtfs = device.fsType == QStringLiteral( "ntfs" );
+    OsproberEntry windows;
+    if ( isNtfs )
+    {
+        windows = PartUtils::probeBootSectors( device.path, readBootSectors( device.path ) );
+        if ( windows.path.isEmpty() )
+        {
+            // A data partition
+            return OsproberEntryList();
+        }
+        windows.uuid = device.uuid;
+    }
+
+    QString root = mountPointOf( device, mounts );
+    if ( root == QStringLiteral( "/" ) )
+    {
+        // That's the running system
+        return OsproberEntryList();
+    }
+
+    std::unique_ptr< CalamaresUtils::Partition::TemporaryMount > mount;
+    if ( root.isEmpty() )
+    {
+        QStringList mountOptions { "ro" };
+        if ( device.fsType == QStringLiteral( "ext3" ) || device.fsType == QStringLiteral( "ext4" ) )
+        {
+            // Don't replay the journal
+            mountOptions.append( "noload" );
+        }
+        mount = std::make_unique< CalamaresUtils::Partition::TemporaryMount >(
+            device.path, device.fsType, mountOptions.join( ',' ) );
+        if ( !mount->isValid() )
+        {
+            cWarning() << "Could not mount" << device.path << "to probe it.";
+            return isNtfs ? OsproberEntryList { windows } : OsproberEntryList();
+        }
+        root = mount->path();
+    }
+
+    if ( isNtfs )
+    {
+        // The boot code is the same on any NTFS that Windows formatted,
+        // so check that there is a loader, too.
+        if ( findIgnoringCase( root, QStringLiteral( "bootmgr" ) ).isEmpty()
+             && findIgnoringCase( root, QStringLiteral( "ntldr" ) ).isEmpty() )
+        {
+            return OsproberEntryList();
+        }
+        return { windows };
+    }
+
+    auto entries = PartUtils::probeFilesystem( device.path, root );
+    for ( auto& e : entries )
+    {
+        e.uuid = device.uuid;
+    }
+    return entries;
+}
+
+namespace PartUtils
+{
+
+OsproberEntry
+probeBootSectors( const QString& path, const QByteArray& bootSectors )
+{
+    // The OEM ID of an NTFS volume
+    if ( bootSectors.mid( 3, 8 ) != QByteArrayLiteral( "NTFS    " ) )
+    {
+        return OsproberEntry();
+    }
+
+    if ( containsName( bootSectors, "BOOTMGR" ) )
+    {
+        return makeEntry( path,
+                          QString(),
+                          QStringLiteral( "Windows (loader)" ),
+                          QStringLiteral( "Windows" ),
+                          QStringLiteral( "chain" ) );
+    }
+    if ( containsName( bootSectors, "NTLDR" ) )
+    {
+        return makeEntry( path,
+                          QString(),
+                          QStringLiteral( "Windows NT/2000/XP (loader)" ),
+                          QStringLiteral( "Windows" ),
+                          QStringLiteral( "chain" ) );
+    }
+    return OsproberEntry();
+}
+
+OsproberEntryList
+probeFilesystem( const QString& path, const QString& root )
+{
+    OsproberEntryList entries = probeEfi( path, root );
+    entries.append( probeLinux( path, root ) );
+    entries.append( probeMacOS( path, root ) );
+    if ( entries.isEmpty() )
+    {
+        return entries;
+    }
+
+    const auto fstab = readFstab( root );
+    for ( auto& e : entries )
+    {
+        cDebug() << "Found" << e.prettyName << "on" << e.line.first();
+        e.fstab = fstab;
+    }
+    return entries;
+}
+
+OsproberEntryList
+probePartition( const CalamaresUtils::Partition::BlockDevice& device )
+{
+    return ::probePartition( device, MtabInfo::fromMtabFilteredByPrefix() );
+}
+
+OsproberEntryList
+probePartitions( const CalamaresUtils::Partition::BlockDeviceList& devices )
+{
+    const auto mounts = MtabInfo::fromMtabFilteredByPrefix();
+
+    QList< QFuture< OsproberEntryList > > futures;
+    for ( const auto& d : devices )
+    {
+        if ( d.isPartition || d.isVolume() )
+        {
+            futures.append( QtConcurrent::run( [ d, &mounts ]() { return ::probePartition( d, mounts ); } ) );
+        }
+    }
+
+    OsproberEntryList entries;
+    for ( auto& f : futures )
+    {
+        entries.append( f.result() );
+    }
+    return entries;
+}
+
+}  // namespace PartUtils
+
+/* Implementation of methods for FstabEntry, from OsproberEntry.h */
+
+bool
+FstabEntry::isValid() const
+{
+    return !partitionNode.isEmpty() && !mountPoint.isEmpty() && !fsType.isEmpty();
+}
+
+FstabEntry
+FstabEntry::fromEtcFstab( const QString& rawLine )
+{
+    QString line = rawLine.simplified();
+    if ( line.startsWith( '#' ) )
+        return FstabEntry { QString(), QString(), QString(), QString(), 0, 0 };
+
+    QStringList splitLine = line.split( ' ' );
+    if ( splitLine.length() != 6 )
+        return FstabEntry { QString(), QString(), QString(), QString(), 0, 0 };
+
+    return FstabEntry {
+        splitLine.at( 0 ),  // path, or UUID, or LABEL, etc.
+        splitLine.at( 1 ),  // mount point
+        splitLine.at( 2 ),  // fs type
+        splitLine.at( 3 ),  // options
+        splitLine.at( 4 ).toInt(),  //dump
+        splitLine.at( 5 ).toInt()  //pass
+    };
+}
@@ -0,0 +1,69 @@
+/* === This file is part of Calamares - <https://calamares.io> ===
+ *
+ *   SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *   SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ *   Calamares is Free Software: see the License-Identifier above.
+ *
+ */
+
+/*
+ * A built-in replacement for os-prober.
+ *
+ * os-prober mounts every partition in turn, runs its probes, and unmounts
+ * it again; then Calamares mounts every hit a second time to read /etc/fstab.
+ * This prober reads each partition once, read-only, with all the partitions
+ * probed in parallel. The results are in the same format as os-prober's
+ * output, so the rest of the module does not need to know the difference.
+ */
+#ifndef PARTITION_OSPROBER_H
+#define PARTITION_OSPROBER_H
+
+#include "OsproberEntry.h"
+
+#include "partition/DeviceInventory.h"
+
+#include <QByteArray>
+#include <QString>
+
+namespace PartUtils
+{
+
+/** @brief Look for a Windows loader in the boot sectors of a partition
+ *
+ * The @p bootSectors are the first sectors of the partition @p path;
+ * an NTFS volume with NTLDR or BOOTMGR in its boot code is a Windows
+ * (system) partition. Returns an entry with an empty path if
+ * there is no Windows loader.
+ */
+OsproberEntry probeBootSectors( const QString& path, const QByteArray& bootSectors );
+
+/** @brief Look for an installed OS in a filesystem mounted at @p root
+ *
+ * The filesystem is the partition @p path. This looks for EFI loaders
+ * (for an EFI system partition), /etc/os-release (for Linux) and
+ * the macOS system version. There may be more than one OS on one
+ * partition (e.g. multiple EFI loaders). /etc/fstab, if there is one,
+ * is read as well and stored in the entries.
+ */
+OsproberEntryList probeFilesystem( const QString& path, const QString& root );
+
+/** @brief Probe a single partition (or LVM / LUKS volume)
+ *
+ * Reads the boot sectors of NTFS partitions, and mounts the filesystems
+ * that can hold an OS read-only (if they are not mounted already) for
+ * probeFilesystem(). The partition mounted at / is never probed, since
+ * that is the running system.
+ */
+OsproberEntryList probePartition( const CalamaresUtils::Partition::BlockDevice& device );
+
+/** @brief Probe all the @p devices, in parallel
+ *
+ * Only partitions and device-mapper volumes are probed (whole disks
+ * are not); the results are in the order of @p devices.
+ */
+OsproberEntryList probePartitions( const CalamaresUtils::Partition::BlockDeviceList& devices );
+
+}  // namespace PartUtils
+
+#endif  // PARTITION_OSPROBER_H
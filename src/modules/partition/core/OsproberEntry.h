@@ -23,7 +23,7 @@ struct FstabEntry
     int pass;
 
     /// Does this entry make sense and is it complete?
-    bool isValid() const;  // implemented in Partutils.cpp
+    bool isValid() const;  // implemented in OsProber.cpp
 
     /** @brief Create an entry from a live of /etc/fstab
      *
@@ -32,7 +32,7 @@ struct FstabEntry
      * If the string isn't valid (e.g. comment-line, or broken
      * fstab entry) then the entry that is returned is invalid.
      */
-    static FstabEntry fromEtcFstab( const QString& );  // implemented in Partutils.cpp
+    static FstabEntry fromEtcFstab( const QString& );  // implemented in OsProber.cpp
 };
 
 typedef QList< FstabEntry > FstabEntryList;
@@ -13,11 +13,12 @@
 
 #include "core/DeviceModel.h"
 #include "core/KPMHelpers.h"
+#include "core/OsProber.h"
 #include "core/PartitionInfo.h"
 
 #include "GlobalStorage.h"
 #include "JobQueue.h"
-#include "partition/Mount.h"
+#include "partition/DeviceInventory.h"
 #include "partition/PartitionIterator.h"
 #include "partition/PartitionQuery.h"
 #include "utils/CalamaresUtilsSystem.h"
@@ -222,64 +223,6 @@ canBeResized( DeviceModel* dm, const QString& partitionPath, const Logger::Once&
 }
 
 
-static FstabEntryList
-lookForFstabEntries( const QString& partitionPath )
-{
-    QStringList mountOptions { "ro" };
-
-    auto r = CalamaresUtils::System::runCommand( CalamaresUtils::System::RunLocation::RunInHost,
-                                                 { "blkid", "-s", "TYPE", "-o", "value", partitionPath } );
-    if ( r.getExitCode() )
-    {
-        cWarning() << "blkid on" << partitionPath << "failed.";
-    }
-    else
-    {
-        QString fstype = r.getOutput().trimmed();
-        if ( ( fstype == "ext3" ) || ( fstype == "ext4" ) )
-        {
-            mountOptions.append( "noload" );
-        }
-    }
-
-    cDebug() << "Checking device" << partitionPath << "for fstab (fs=" << r.getOutput() << ')';
-
-    FstabEntryList fstabEntries;
-
-    CalamaresUtils::Partition::TemporaryMount mount( partitionPath, QString(), mountOptions.join( ',' ) );
-    if ( mount.isValid() )
-    {
-        QFile fstabFile( mount.path() + "/etc/fstab" );
-
-        if ( fstabFile.open( QIODevice::ReadOnly | QIODevice::Text ) )
-        {
-            const QStringList fstabLines = QString::fromLocal8Bit( fstabFile.readAll() ).split( '\n' );
-
-            for ( const QString& rawLine : fstabLines )
-            {
-                fstabEntries.append( FstabEntry::fromEtcFstab( rawLine ) );
-            }
-            fstabFile.close();
-            const int lineCount = fstabEntries.count();
-            std::remove_if(
-                fstabEntries.begin(), fstabEntries.end(), []( const FstabEntry& x ) { return !x.isValid(); } );
-            cDebug() << Logger::SubEntry << "got" << fstabEntries.count() << "fstab entries from" << lineCount
-                     << "lines in" << fstabFile.fileName();
-        }
-        else
-        {
-            cWarning() << "Could not read fstab from mounted fs";
-        }
-    }
-    else
-    {
-        cWarning() << "Could not mount existing fs";
-    }
-
-    return fstabEntries;
-}
-
-
 static QString
 findPartitionPathForMountPoint( const FstabEntryList& fstab, const QString& mountPoint )
 {
@@ -361,69 +304,14 @@ runOsprober( DeviceModel* dm )
 {
     Logger::Once o;
 
-    QString osproberOutput;
-    QProcess osprober;
-    osprober.setProgram( "os-prober" );
-    osprober.setProcessChannelMode( QProcess::SeparateChannels );
-    osprober.start();
-    if ( !osprober.waitForStarted() )
-    {
-        cError() << "os-prober cannot start.";
-    }
-    else if ( !osprober.waitForFinished( 60000 ) )
-    {
-        cError() << "os-prober timed out.";
-    }
-    else
-    {
-        osproberOutput.append( QString::fromLocal8Bit( osprober.readAllStandardOutput() ).trimmed() );
-    }
-
     QStringList osproberCleanLines;
-    OsproberEntryList osproberEntries;
-    const auto lines = osproberOutput.split( '\n' );
-    for ( const QString& line : lines )
+    OsproberEntryList osproberEntries
+        = probePartitions( CalamaresUtils::Partition::DeviceInventory::instance()->devices() );
+    for ( auto& entry : osproberEntries )
     {
-        if ( !line.simplified().isEmpty() )
-        {
-            QStringList lineColumns = line.split( ':' );
-            QString prettyName;
-            if ( !lineColumns.value( 1 ).simplified().isEmpty() )
-            {
-                prettyName = lineColumns.value( 1 ).simplified();
-            }
-            else if ( !lineColumns.value( 2 ).simplified().isEmpty() )
-            {
-                prettyName = lineColumns.value( 2 ).simplified();
-            }
-
-            QString file, path = lineColumns.value( 0 ).simplified();
-            if ( !path.startsWith( "/dev/" ) )  //basic sanity check
-            {
-                continue;
-            }
-
-            // strip extra file after device: /dev/name@/path/to/file
-            int index = path.indexOf( '@' );
-            if ( index != -1 )
-            {
-                file = path.right( path.length() - index - 1 );
-                path = path.left( index );
-            }
-
-            FstabEntryList fstabEntries = lookForFstabEntries( path );
-            QString homePath = findPartitionPathForMountPoint( fstabEntries, "/home" );
-
-            osproberEntries.append( { prettyName,
-                                      path,
-                                      file,
-                                      QString(),
-                                      canBeResized( dm, path, o ),
-                                      lineColumns,
-                                      fstabEntries,
-                                      homePath } );
-            osproberCleanLines.append( line );
-        }
+        entry.canBeResized = canBeResized( dm, entry.path, o );
+        entry.homePath = findPartitionPathForMountPoint( entry.fstab, "/home" );
+        osproberCleanLines.append( entry.line.join( ':' ) );
     }
 
     if ( osproberCleanLines.count() > 0 )
@@ -432,7 +320,7 @@ runOsprober( DeviceModel* dm )
     }
     else
     {
-        cDebug() << o << "os-prober gave no output.";
+        cDebug() << o << "os-prober found nothing.";
     }
 
     Calamares::JobQueue::instance()->globalStorage()->insert( "osproberLines", osproberCleanLines );
@@ -605,32 +493,3 @@ canonicalFilesystemName( const QString& fsName, FileSystem::Type* fsType )
 }
 
 }  // namespace PartUtils
-
-/* Implementation of methods for FstabEntry, from OsproberEntry.h */
-
-bool
-FstabEntry::isValid() const
-{
-    return !partitionNode.isEmpty() && !mountPoint.isEmpty() && !fsType.isEmpty();
-}
-
-FstabEntry
-FstabEntry::fromEtcFstab( const QString& rawLine )
-{
-    QString line = rawLine.simplified();
-    if ( line.startsWith( '#' ) )
-        return FstabEntry { QString(), QString(), QString(), QString(), 0, 0 };
-
-    QStringList splitLine = line.split( ' ' );
-    if ( splitLine.length() != 6 )
-        return FstabEntry { QString(), QString(), QString(), QString(), 0, 0 };
-
-    return FstabEntry {
-        splitLine.at( 0 ),  // path, or UUID, or LABEL, etc.
-        splitLine.at( 1 ),  // mount point
-        splitLine.at( 2 ),  // fs type
-        splitLine.at( 3 ),  // options
-        splitLine.at( 4 ).toInt(),  //dump
-        splitLine.at( 5 ).toInt()  //pass
-    };
-}
@@ -70,10 +70,10 @@ bool canBeResized( Partition* candidate, const Logger::Once& o );
 bool canBeResized( DeviceModel* dm, const QString& partitionPath, const Logger::Once& o );
 
 /**
- * @brief runOsprober executes os-prober, parses the output and writes relevant
- * data to GlobalStorage.
+ * @brief runOsprober probes the partitions for installed OSes (see OsProber.h)
+ * and writes relevant data to GlobalStorage, in the format of os-prober.
  * @param dm the DeviceModel instance.
- * @return a list of os-prober entries, parsed.
+ * @return a list of os-prober entries, with their fstab entries.
  */
 OsproberEntryList runOsprober( DeviceModel* dm );
 
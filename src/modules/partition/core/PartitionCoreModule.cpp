@@ -31,6 +31,7 @@
 #include "jobs/DeactivateVolumeGroupJob.h"
 #include "jobs/DeletePartitionJob.h"
 #include "jobs/FillGlobalStorageJob.h"
+#include "jobs/FormatPartitionBatchJob.h"
 #include "jobs/FormatPartitionJob.h"
 #include "jobs/RemoveVolumeGroupJob.h"
 #include "jobs/ResizePartitionJob.h"
@@ -655,15 +656,18 @@ PartitionCoreModule::jobs( const Config* config ) const
     }
 #endif
 
+    Calamares::JobList deviceJobs;
     for ( const auto* info : m_deviceInfos )
     {
 #ifdef DEBUG_PARTITION_SKIP
         cWarning() << Logger::SubEntry << "Skipping jobs for" << info->device.data()->deviceNode();
 #else
-        lst << info->jobs();
+        deviceJobs << info->jobs();
 #endif
         devices << info->device.data();
     }
+    // Formatting on different disks (or different partitions) can run side-by-side
+    lst << batchFormatJobs( deviceJobs );
     lst << Calamares::job_ptr( new FillGlobalStorageJob( config, devices, m_bootLoaderInstallPath ) );
     lst << automountControl;
 
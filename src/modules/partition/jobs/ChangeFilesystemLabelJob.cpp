@@ -9,6 +9,7 @@
 
 #include "ChangeFilesystemLabelJob.h"
 
+#include "partition/DeviceInventory.h"
 #include "utils/Logger.h"
 
 #include <kpmcore/backend/corebackend.h>
@@ -62,7 +63,9 @@ ChangeFilesystemLabelJob::exec()
     SetFileSystemLabelOperation op( *partition(), m_label );
     op.setStatus( Operation::StatusRunning );
 
-    if ( op.execute( report ) )
+    const bool ok = op.execute( report );
+    CalamaresUtils::Partition::DeviceInventory::instance()->invalidate();
+    if ( ok )
     {
         return Calamares::JobResult::ok();
     }
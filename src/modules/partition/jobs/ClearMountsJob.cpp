@@ -13,10 +13,10 @@
 
 #include "core/PartitionInfo.h"
 
+#include "partition/DeviceInventory.h"
 #include "partition/PartitionIterator.h"
 #include "partition/Sync.h"
 #include "utils/Logger.h"
-#include "utils/String.h"
 
 // KPMcore
 #include <kpmcore/core/device.h>
@@ -25,8 +25,24 @@
 
 #include <QCoreApplication>
 #include <QDir>
+#include <QFuture>
 #include <QProcess>
+#include <QRegularExpression>
+#include <QSet>
 #include <QStringList>
+#include <QThread>
+#include <QtConcurrent/QtConcurrent>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <linux/dm-ioctl.h>
+#include <sys/ioctl.h>
+#include <sys/mount.h>
+#include <sys/swap.h>
+#include <unistd.h>
 
 using CalamaresUtils::Partition::PartitionIterator;
 
@@ -34,82 +50,39 @@ using CalamaresUtils::Partition::PartitionIterator;
 /** @brief Returns list of partitions on a given @p deviceName
  *
  * The @p deviceName is a (whole-block) device, like "sda", and the partitions
- * returned are then "sdaX". The whole-block device itself is ignored, if
- * present. Partitions are returned with their full /dev/ path (e.g. /dev/sda1).
- *
- * The format for /etc/partitions is, e.g.
- *      major minor #blocks name
- *      8     0     33554422 sda
- *      8     1     33554400 sda1
+ * returned are then "sdaX". The whole-block device itself is ignored.
+ * Partitions are returned with their full /dev/ path (e.g. /dev/sda1).
  */
 STATICTEST QStringList
 getPartitionsForDevice( const QString& deviceName )
 {
     QStringList partitions;
-
-    QFile dev_partitions( "/proc/partitions" );
-    if ( dev_partitions.open( QFile::ReadOnly ) )
+    for ( const auto& p : CalamaresUtils::Partition::DeviceInventory::instance()->partitions( deviceName ) )
     {
-        cDebug() << "Reading from" << dev_partitions.fileName() << "looking for" << deviceName;
-        QTextStream in( &dev_partitions );
-        (void)in.readLine();  // That's the header line, skip it
-        while ( !in.atEnd() )
-        {
-            // The fourth column (index from 0, so index 3) is the name of the device;
-            // keep it if it is followed by something.
-            QStringList columns = in.readLine().split( ' ', SplitSkipEmptyParts );
-            if ( ( columns.count() >= 4 ) && ( columns[ 3 ].startsWith( deviceName ) )
-                 && ( columns[ 3 ] != deviceName ) )
-            {
-                partitions.append( QStringLiteral( "/dev/" ) + columns[ 3 ] );
-            }
-        }
+        partitions.append( p.path );
     }
-    else
-    {
-        cDebug() << "Could not open" << dev_partitions.fileName();
-    }
-
     return partitions;
 }
 
+/** @brief Returns the swap partitions on the given @p deviceName
+ *
+ * We need to clear them just in case they contain something resumable from a
+ * previous suspend-to-disk.
+ */
 STATICTEST QStringList
 getSwapsForDevice( const QString& deviceName )
 {
-    QProcess process;
-
-    // Build a list of partitions of type 82 (Linux swap / Solaris).
-    // We then need to clear them just in case they contain something resumable from a
-    // previous suspend-to-disk.
     QStringList swapPartitions;
-    process.start( "sfdisk", { "-d", deviceName } );
-    process.waitForFinished();
-    // Sample output:
-    //    % sudo sfdisk -d /dev/sda
-    //    label: dos
-    //    label-id: 0x000ced89
-    //    device: /dev/sda
-    //    unit: sectors
-
-    //    /dev/sda1 : start=          63, size=    29329345, type=83, bootable
-    //    /dev/sda2 : start=    29331456, size=     2125824, type=82
-
-    swapPartitions = QString::fromLocal8Bit( process.readAllStandardOutput() ).split( '\n' );
-    swapPartitions = swapPartitions.filter( "type=82" );
-    for ( QStringList::iterator it = swapPartitions.begin(); it != swapPartitions.end(); ++it )
+    for ( const auto& p : CalamaresUtils::Partition::DeviceInventory::instance()->partitions( deviceName ) )
     {
-        *it = ( *it ).simplified().split( ' ' ).first();
+        if ( p.fsType == QStringLiteral( "swap" ) )
+        {
+            swapPartitions.append( p.path );
+        }
     }
-
     return swapPartitions;
 }
 
-static inline bool
-isControl( const QString& baseName )
-{
-    return baseName == "control";
-}
-
 static inline bool
 isFedoraSpecial( const QString& baseName )
 {
@@ -119,96 +92,216 @@ isFedoraSpecial( const QString& baseName )
     return baseName.startsWith( "live-" );
 }
 
-/** @brief Returns a list of unneeded crypto devices
+/// @brief Undo the octal escapes (e.g. \040 for space) of /proc/self/mountinfo and /proc/swaps
+static QString
+unescapeProc( const QString& field )
+{
+    QString s;
+    s.reserve( field.length() );
+    for ( int i = 0; i < field.length(); ++i )
+    {
+        if ( field.at( i ) == '\\' && i + 3 < field.length() )
+        {
+            bool ok = false;
+            const int c = field.mid( i + 1, 3 ).toInt( &ok, 8 );
+            if ( ok )
+            {
+                s.append( QChar( c ) );
+                i += 3;
+                continue;
+            }
+        }
+        s.append( field.at( i ) );
+    }
+    return s;
+}
+
+/** @brief Returns (device number, mount point) pairs from @p mountInfo
  *
- * These are the crypto devices to unmount and close; some are "needed"
- * for system operation: on Fedora, the live- mappers are special.
- * Some other devices are special, too, so those do not end up in
- * the list.
+ * The @p mountInfo is the contents of /proc/self/mountinfo, e.g.
+ *      36 35 98:0 /mnt1 /mnt2 rw,noatime master:1 - ext3 /dev/root rw
+ * where the third field is the major:minor device number and the
+ * fifth is the mount point. The pairs are in mount order.
  */
-STATICTEST QStringList
-getCryptoDevices( const QStringList& mapperExceptions )
+STATICTEST QList< QPair< QString, QString > >
+parseMountInfo( const QString& mountInfo )
 {
-    QDir mapperDir( "/dev/mapper" );
-    const QFileInfoList fiList = mapperDir.entryInfoList( QDir::Files );
-    QStringList list;
-    for ( const QFileInfo& fi : fiList )
+    QList< QPair< QString, QString > > mounts;
+    const auto lines = mountInfo.split( '\n' );
+    for ( const auto& line : lines )
     {
-        QString baseName = fi.baseName();
-        if ( isControl( baseName ) || isFedoraSpecial( baseName ) || mapperExceptions.contains( baseName ) )
+        const auto fields = line.split( ' ' );
+        if ( fields.count() >= 5 )
         {
-            continue;
+            mounts.append( qMakePair( fields[ 2 ], unescapeProc( fields[ 4 ] ) ) );
         }
-        list.append( fi.absoluteFilePath() );
     }
-    return list;
+    return mounts;
 }
 
+/** @brief Returns the active swap devices and files from @p swaps
+ *
+ * The @p swaps is the contents of /proc/swaps, e.g.
+ *      Filename        Type        Size    Used    Priority
+ *      /dev/sda2       partition   2097148 0       -2
+ */
 STATICTEST QStringList
-getLVMVolumes()
+parseSwaps( const QString& swaps )
 {
-    QProcess process;
-
-    // First we umount all LVM logical volumes we can find
-    process.start( "lvscan", { "-a" } );
-    process.waitForFinished();
-    if ( process.exitCode() == 0 )  //means LVM2 tools are installed
+    QStringList l;
+    auto lines = swaps.split( '\n' );
+    if ( !lines.isEmpty() )
     {
-        QStringList lvscanLines = QString::fromLocal8Bit( process.readAllStandardOutput() ).split( '\n' );
-        // Get the second column (`value(1)`) sinec that is the device name,
-        // remove quoting.
-        std::transform( lvscanLines.begin(),
-                        lvscanLines.end(),
-                        lvscanLines.begin(),
-                        []( const QString& lvscanLine )
-                        { return lvscanLine.simplified().split( ' ' ).value( 1 ).replace( '\'', "" ); } );
-        return lvscanLines;
+        lines.removeFirst();  // That's the header line, skip it
     }
-    else
+    for ( const auto& line : qAsConst( lines ) )
     {
-        cWarning() << "this system does not seem to have LVM2 tools.";
+        const QString name = line.section( QRegularExpression( "\\s+" ), 0, 0 );
+        if ( !name.isEmpty() )
+        {
+            l.append( unescapeProc( name ) );
+        }
     }
-    return QStringList();
+    return l;
 }
-STATICTEST QStringList
-getPVGroups( const QString& deviceName )
+
+static QString
+readProcFile( const QString& path )
 {
-    QProcess process;
-    // Then we go looking for volume groups that use this device for physical volumes
-    process.start( "pvdisplay", { "-C", "--noheadings" } );
-    process.waitForFinished();
-    if ( process.exitCode() == 0 )  //means LVM2 tools are installed
+    QFile f( path );
+    // Files in /proc have size 0, so read until the end rather than by size
+    return f.open( QIODevice::ReadOnly ) ? QString::fromLocal8Bit( f.readAll() ) : QString();
+}
+
+/** @brief A block device that has to be released before partitioning
+ *
+ * The holders are the devices that are built on top of this one
+ * (e.g. a LUKS mapper on a partition, or the LVM volumes of a
+ * physical volume); those have to be torn down first.
+ */
+struct TeardownNode
+{
+    QString name;  ///< Kernel name, e.g. "sda1" or "dm-0"
+    QString path;  ///< Device node, for messages and swapoff
+    QString deviceNumber;  ///< major:minor, to match mounts
+    QString mapperName;  ///< For device-mapper devices, the name in /dev/mapper
+    QStringList holders;  ///< Kernel names
+};
+
+using TeardownGraph = QMap< QString, TeardownNode >;
+
+/** @brief Collects @p roots and everything built on top of them
+ *
+ * The @p roots are kernel names; the holders are read from sysfs
+ * below @p sysClassBlock (normally /sys/class/block).
+ */
+static TeardownGraph
+buildTeardownGraph( const QStringList& roots, const QString& sysClassBlock )
+{
+    TeardownGraph graph;
+    QStringList todo = roots;
+    while ( !todo.isEmpty() )
     {
-        QString pvdisplayOutput = process.readAllStandardOutput();
-        if ( !pvdisplayOutput.simplified().isEmpty() )  //means there is at least one LVM PV
+        const QString name = todo.takeFirst();
+        if ( graph.contains( name ) )
         {
-            QSet< QString > vgSet;
+            continue;
+        }
+        const QDir dir( sysClassBlock + '/' + name );
+
+        TeardownNode node;
+        node.name = name;
+        node.deviceNumber = readProcFile( dir.filePath( "dev" ) ).trimmed();
+        node.mapperName = readProcFile( dir.filePath( "dm/name" ) ).trimmed();
+        node.path = node.mapperName.isEmpty() ? QStringLiteral( "/dev/" ) + name
+                                              : QStringLiteral( "/dev/mapper/" ) + node.mapperName;
+        node.holders = QDir( dir.filePath( "holders" ) ).entryList( QDir::Dirs | QDir::NoDotAndDotDot );
+        todo.append( node.holders );
+        graph.insert( name, node );
+    }
+    return graph;
+}
 
-            const QStringList pvdisplayLines = pvdisplayOutput.split( '\n' );
-            for ( const QString& pvdisplayLine : pvdisplayLines )
-            {
-                QString pvPath = pvdisplayLine.simplified().split( ' ' ).value( 0 );
-                QString vgName = pvdisplayLine.simplified().split( ' ' ).value( 1 );
-                if ( !pvPath.contains( deviceName ) )
-                {
-                    continue;
-                }
-
-                vgSet.insert( vgName );
-            }
-// toList() was deprecated, but old-old versions don't support QStringList construction like this
-#if QT_VERSION < QT_VERSION_CHECK( 5, 15, 0 )
-            return vgSet.toList();
-#else
-            return QStringList { vgSet.cbegin(), vgSet.cend() };
-#endif
+/** @brief Returns the mounts from @p mounts to undo, in order
+ *
+ * These are the mounts of any of the @p deviceNumbers, and everything
+ * that is mounted below those (which would keep them busy). Deeper
+ * mount points come first, e.g. /mnt/boot before /mnt, and of mounts
+ * on the same mount point, the most recent comes first.
+ */
+STATICTEST QList< QPair< QString, QString > >
+unmountOrder( const QList< QPair< QString, QString > >& mounts, const QStringList& deviceNumbers )
+{
+    QStringList mountPoints;
+    for ( const auto& m : mounts )
+    {
+        if ( deviceNumbers.contains( m.first ) && m.second != QStringLiteral( "/" ) )
+        {
+            mountPoints.append( m.second );
         }
     }
-    else
+
+    QList< QPair< QString, QString > > order;
+    for ( auto it = mounts.crbegin(); it != mounts.crend(); ++it )
     {
-        cWarning() << "this system does not seem to have LVM2 tools.";
+        const QString& point = it->second;
+        if ( deviceNumbers.contains( it->first )
+             || std::any_of( mountPoints.cbegin(),
+                             mountPoints.cend(),
+                             [ &point ]( const QString& p ) { return point.startsWith( p + '/' ); } ) )
+        {
+            order.append( *it );
+        }
     }
-    return QStringList();
+    const auto depth = []( const QPair< QString, QString >& m ) { return QDir::cleanPath( m.second ).count( '/' ); };
+    std::stable_sort( order.begin(),
+                      order.end(),
+                      [ &depth ]( const QPair< QString, QString >& a, const QPair< QString, QString >& b )
+                      { return depth( a ) > depth( b ); } );
+    return order;
+}
+
+/** @brief Sorts the devices in @p holders into teardown levels
+ *
+ * The @p holders maps each device to the devices built on top of it.
+ * The first level holds the devices that nothing is built on; each
+ * next level holds the devices whose holders are all in earlier
+ * levels. The devices in one level are independent of each other,
+ * so they can be torn down in parallel.
+ *
+ * Devices that are part of a cycle (which should not happen) end up
+ * in the last level.
+ */
+STATICTEST QList< QStringList >
+teardownLevels( const QMap< QString, QStringList >& holders )
+{
+    QList< QStringList > levels;
+    QSet< QString > done;
+    QStringList remaining = holders.keys();
+    while ( !remaining.isEmpty() )
+    {
+        QStringList level;
+        for ( const auto& name : qAsConst( remaining ) )
+        {
+            const auto& h = holders[ name ];
+            if ( std::all_of( h.cbegin(), h.cend(), [ &done ]( const QString& n ) { return done.contains( n ); } ) )
+            {
+                level.append( name );
+            }
+        }
+        if ( level.isEmpty() )
+        {
+            levels.append( remaining );
+            break;
+        }
+        for ( const auto& name : qAsConst( level ) )
+        {
+            done.insert( name );
+            remaining.removeAll( name );
+        }
+        levels.append( level );
+    }
+    return levels;
 }
 
 /*
@@ -260,41 +353,17 @@ operator<<( QDebug& s, const MessageAndPath& m )
 }
 
 
-///@brief Returns a debug-string if @p partPath could be unmounted
-STATICTEST MessageAndPath
-tryUmount( const QString& partPath )
-{
-    QProcess process;
-    process.start( "umount", { partPath } );
-    process.waitForFinished();
-    if ( process.exitCode() == 0 )
-    {
-        return { QT_TRANSLATE_NOOP( "ClearMountsJob", "Successfully unmounted %1." ), partPath };
-    }
-
-    process.start( "swapoff", { partPath } );
-    process.waitForFinished();
-    if ( process.exitCode() == 0 )
-    {
-        return { QT_TRANSLATE_NOOP( "ClearMountsJob", "Successfully disabled swap %1." ), partPath };
-    }
-
-    return {};
-}
-
 ///@brief Returns a debug-string if @p partPath was swap and could be cleared
 STATICTEST MessageAndPath
 tryClearSwap( const QString& partPath )
 {
-    QProcess process;
-    process.start( "blkid", { "-s", "UUID", "-o", "value", partPath } );
-    process.waitForFinished();
-    QString swapPartUuid = QString::fromLocal8Bit( process.readAllStandardOutput() ).simplified();
-    if ( process.exitCode() != 0 || swapPartUuid.isEmpty() )
+    const QString swapPartUuid = CalamaresUtils::Partition::DeviceInventory::instance()->device( partPath ).uuid;
+    if ( swapPartUuid.isEmpty() )
     {
         return {};
     }
 
+    QProcess process;
     process.start( "mkswap", { "-U", swapPartUuid, partPath } );
     process.waitForFinished();
     if ( process.exitCode() != 0 )
@@ -305,32 +374,134 @@ tryClearSwap( const QString& partPath )
     return { QT_TRANSLATE_NOOP( "ClearMountsJob", "Successfully cleared swap %1." ), partPath };
 }
 
-///@brief Returns a debug-string if @p mapperPath could be closed
-STATICTEST MessageAndPath
-tryCryptoClose( const QString& mapperPath )
+/** @brief Removes the device-mapper device @p name
+ *
+ * This is what `cryptsetup close` does for a LUKS mapper, and
+ * what deactivating does for an LVM logical volume. Since udev may
+ * still hold the device open briefly after it is unmounted, a
+ * busy device is tried again a few times.
+ *
+ * Returns 0 on success, or the errno of the failure.
+ */
+static int
+removeMapperDevice( const QString& name )
 {
-    /* ignored */ tryUmount( mapperPath );
+    const int fd = ::open( "/dev/mapper/control", O_RDWR | O_CLOEXEC );
+    if ( fd < 0 )
+    {
+        return errno;
+    }
 
-    QProcess process;
-    process.start( "cryptsetup", { "close", mapperPath } );
-    process.waitForFinished();
-    if ( process.exitCode() == 0 )
+    struct dm_ioctl dmi
+    {
+    };
+    // Version 4.0.0 is understood by every kernel that has device-mapper
+    dmi.version[ 0 ] = DM_VERSION_MAJOR;
+    dmi.data_size = sizeof( dmi );
+    dmi.data_start = sizeof( dmi );
+    const QByteArray encodedName = QFile::encodeName( name );
+    std::strncpy( dmi.name, encodedName.constData(), DM_NAME_LEN - 1 );
+
+    int error = 0;
+    for ( int attempt = 0; attempt < 5; ++attempt )
     {
-        return { QT_TRANSLATE_NOOP( "ClearMountsJob", "Successfully closed mapper device %1." ), mapperPath };
+        error = ::ioctl( fd, DM_DEV_REMOVE, &dmi ) == 0 ? 0 : errno;
+        if ( error != EBUSY )
+        {
+            break;
+        }
+        QThread::msleep( 200 );
     }
+    ::close( fd );
+    return error;
+}
 
-    return {};
+/** @brief Unmounts the @p mounts, one after the other
+ *
+ * The mounts are (device number, mount point) pairs, in the order
+ * returned by unmountOrder(); @p graph is used to name the devices.
+ */
+static QList< MessageAndPath >
+unmountAll( const QList< QPair< QString, QString > >& mounts, const TeardownGraph& graph )
+{
+    QList< MessageAndPath > news;
+    for ( const auto& m : mounts )
+    {
+        QString path = m.second;
+        for ( const auto& node : graph )
+        {
+            if ( node.deviceNumber == m.first )
+            {
+                path = node.path;
+                break;
+            }
+        }
+
+        if ( ::umount2( QFile::encodeName( m.second ).constData(), 0 ) == 0 )
+        {
+            news.append( MessageAndPath( QT_TRANSLATE_NOOP( "ClearMountsJob", "Successfully unmounted %1." ), path ) );
+        }
+        else
+        {
+            cWarning() << "Could not unmount" << m.second << "from" << path << std::strerror( errno );
+        }
+    }
+    return news;
 }
 
-STATICTEST MessageAndPath
-tryVGDisable( const QString& vgName )
+/// @brief Is @p node a device-mapper device that must be left alone?
+static bool
+isExcepted( const TeardownNode& node, const QStringList& mapperExceptions )
 {
-    QProcess vgProcess;
-    vgProcess.start( "vgchange", { "-an", vgName } );
-    vgProcess.waitForFinished();
-    return ( vgProcess.exitCode() == 0 )
-        ? MessageAndPath { QT_TRANSLATE_NOOP( "ClearMountsJob", "Successfully disabled volume group %1." ), vgName }
-        : MessageAndPath {};
+    return !node.mapperName.isEmpty()
+        && ( isFedoraSpecial( node.mapperName ) || mapperExceptions.contains( node.mapperName ) );
+}
+
+/** @brief Releases the single (already unmounted) device @p node
+ *
+ * Swap on the device is switched off, and if it is a device-mapper
+ * device that is not in @p mapperExceptions, it is removed.
+ */
+static QList< MessageAndPath >
+releaseDevice( const TeardownNode& node, const QStringList& swaps, const QStringList& mapperExceptions )
+{
+    QList< MessageAndPath > news;
+    if ( isExcepted( node, mapperExceptions ) )
+    {
+        return news;
+    }
+
+    const QString kernelPath = QStringLiteral( "/dev/" ) + node.name;
+    for ( const auto& swap : swaps )
+    {
+        if ( swap == node.path || QFileInfo( swap ).canonicalFilePath() == kernelPath )
+        {
+            if ( ::swapoff( QFile::encodeName( swap ).constData() ) == 0 )
+            {
+                news.append(
+                    MessageAndPath( QT_TRANSLATE_NOOP( "ClearMountsJob", "Successfully disabled swap %1." ), node.path ) );
+            }
+            else
+            {
+                cWarning() << "Could not disable swap" << swap << std::strerror( errno );
+            }
+        }
+    }
+
+    if ( !node.mapperName.isEmpty() )
+    {
+        const int error = removeMapperDevice( node.mapperName );
+        if ( error == 0 )
+        {
+            news.append( MessageAndPath(
+                QT_TRANSLATE_NOOP( "ClearMountsJob", "Successfully closed mapper device %1." ), node.path ) );
+        }
+        else
+        {
+            cWarning() << "Could not close mapper device" << node.path << std::strerror( error );
+        }
+    }
+    return news;
 }
 
 ///@brief Apply @p f to all the @p paths, appending successes to @p news
@@ -380,17 +551,53 @@ ClearMountsJob::prettyStatusMessage() const
 Calamares::JobResult
 ClearMountsJob::exec()
 {
-    const QString deviceName = m_deviceNode.split( '/' ).last();
+    auto* inventory = CalamaresUtils::Partition::DeviceInventory::instance();
     CalamaresUtils::Partition::Syncer s;
     QList< MessageAndPath > goodNews;
 
-    apply( getCryptoDevices( m_mapperExceptions ), tryCryptoClose, goodNews );
-    apply( getLVMVolumes(), tryUmount, goodNews );
-    apply( getPVGroups( deviceName ), tryVGDisable, goodNews );
+    const QString deviceName = inventory->device( m_deviceNode ).name;
+    QStringList roots { deviceName.isEmpty() ? m_deviceNode.split( '/' ).last() : deviceName };
+    for ( const auto& p : inventory->partitions( m_deviceNode ) )
+    {
+        roots.append( p.name );
+    }
+    const TeardownGraph graph = buildTeardownGraph( roots, QStringLiteral( "/sys/class/block" ) );
+    const auto mounts = parseMountInfo( readProcFile( QStringLiteral( "/proc/self/mountinfo" ) ) );
+    const auto swaps = parseSwaps( readProcFile( QStringLiteral( "/proc/swaps" ) ) );
+
+    QMap< QString, QStringList > holders;
+    QStringList deviceNumbers;
+    for ( const auto& node : graph )
+    {
+        holders.insert( node.name, node.holders );
+        if ( !node.deviceNumber.isEmpty() && !isExcepted( node, m_mapperExceptions ) )
+        {
+            deviceNumbers.append( node.deviceNumber );
+        }
+    }
+    // Mounts nest independently of the devices (e.g. /mnt/boot on a
+    // partition and /mnt on an LV), so they all go first, one at a time.
+    goodNews.append( unmountAll( unmountOrder( mounts, deviceNumbers ), graph ) );
+
+    // LUKS over LVM over partitions: each level only holds devices whose
+    // holders are all gone already, and the devices within a level are
+    // independent of each other.
+    for ( const auto& level : teardownLevels( holders ) )
+    {
+        QList< QFuture< QList< MessageAndPath > > > futures;
+        for ( const auto& name : level )
+        {
+            futures.append( QtConcurrent::run( releaseDevice, graph.value( name ), swaps, m_mapperExceptions ) );
+        }
+        for ( auto& f : futures )
+        {
+            goodNews.append( f.result() );
+        }
+    }
 
-    apply( getCryptoDevices( m_mapperExceptions ), tryCryptoClose, goodNews );
-    apply( getPartitionsForDevice( deviceName ), tryUmount, goodNews );
     apply( getSwapsForDevice( m_deviceNode ), tryClearSwap, goodNews );
+    // Mounts, mappers and swap signatures have changed
+    inventory->invalidate();
 
     Calamares::JobResult ok = Calamares::JobResult::ok();
     ok.setMessage( tr( "Cleared all mounts for %1" ).arg( m_deviceNode ) );
@@ -18,20 +18,21 @@ class Device;
  * This job tries to free all mounts for the given device, so partitioning
  * operations can proceed.
  *
- * - partitions on the device are unmounted
- * - swap on the device is disabled and cleared
- * - physical volumes for LVM on the device are disabled
+ * The device, its partitions and everything built on top of them
+ * (LUKS mappers, LVM logical volumes, and so on, as listed in the
+ * holders/ directories in sysfs) are released from the top down:
  *
- * In addition, regardless of device:
- * - almost all(*) /dev/mapper entries (crypto / LUKS, also LVM) are closed
- * - all logical volumes for LVM are unmounted
- * Exceptions to "all /dev/mapper" may be configured through
- * the setMapperExceptions() method. Pass in names of mapper
- * files that should not be closed (e.g. "myvg-mylv").
+ * - filesystems on them are unmounted
+ * - swap on them is disabled
+ * - device-mapper devices (crypto / LUKS, also LVM) are closed
  *
- * (*) Some exceptions always exist: /dev/mapper/control is never
- *     closed. /dev/mapper/live-* is never closed.
+ * Devices that do not depend on each other are released in parallel.
+ * Afterwards, swap partitions on the device are cleared.
  *
+ * Exceptions to closing device-mapper devices may be configured through
+ * the setMapperExceptions() method. Pass in names of mapper
+ * files that should not be closed (e.g. "myvg-mylv").
+ * Some exceptions always exist: /dev/mapper/live-* is never closed.
  */
 class ClearMountsJob : public Calamares::Job
 {
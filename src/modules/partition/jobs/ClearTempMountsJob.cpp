@@ -10,6 +10,7 @@
 #include "ClearTempMountsJob.h"
 
 #include "partition/Mount.h"
+#include "partition/Sync.h"
 #include "utils/Logger.h"
 #include "utils/String.h"
 
@@ -66,6 +67,9 @@ ClearTempMountsJob::exec()
         }
     }
 
+    // Unmounting doesn't wait for udev, but partitioning comes next
+    CalamaresUtils::Partition::settle();
+
     Calamares::JobResult ok = Calamares::JobResult::ok();
     ok.setMessage( tr( "Cleared all temporary mounts." ) );
     ok.setDetails( goodNews.join( "\n" ) );
@@ -25,12 +25,15 @@
 #include <kpmcore/core/partition.h>
 #include <kpmcore/core/partitiontable.h>
 #include <kpmcore/fs/filesystem.h>
+#include <kpmcore/fs/filesystemfactory.h>
 #include <kpmcore/ops/newoperation.h>
 #include <kpmcore/util/report.h>
 
 #include <qcoreapplication.h>
 #include <qregularexpression.h>
 
+#include <memory>
+
 using CalamaresUtils::Partition::untranslatedFS;
 using CalamaresUtils::Partition::userVisibleFS;
 
@@ -265,6 +268,30 @@ CreatePartitionJob::prettyStatusMessage() const
         .arg( m_device->deviceNode() );
 }
 
+/** @brief Gives a partition another filesystem, until destruction
+ *
+ * The partition does not own @p replacement; the original filesystem
+ * is put back however the scope is left.
+ */
+class FileSystemSwap
+{
+public:
+    FileSystemSwap( Partition* partition, FileSystem* replacement )
+        : m_partition( partition )
+        , m_original( &partition->fileSystem() )
+    {
+        m_partition->setFileSystem( replacement );
+    }
+    ~FileSystemSwap() { m_partition->setFileSystem( m_original ); }
+
+    FileSystemSwap( const FileSystemSwap& ) = delete;
+    FileSystemSwap& operator=( const FileSystemSwap& ) = delete;
+
+private:
+    Partition* m_partition;
+    FileSystem* m_original;
+};
+
 Calamares::JobResult
 CreatePartitionJob::exec()
 {
@@ -275,9 +302,20 @@ CreatePartitionJob::exec()
         return createZfs( m_partition, m_device );
     }
 
-    return KPMHelpers::execute(
-        NewOperation( *m_device, m_partition ),
-        tr( "The installer failed to create partition on disk '%1'." ).arg( m_device->name() ) );
+    const QString failureMessage
+        = tr( "The installer failed to create partition on disk '%1'." ).arg( m_device->name() );
+    if ( !m_formatSeparately )
+    {
+        return KPMHelpers::execute( NewOperation( *m_device, m_partition ), failureMessage );
+    }
+
+    // NewOperation creates whatever filesystem the partition has, so give it
+    // none for the duration; the partition keeps its real filesystem object.
+    FileSystem* fs = &m_partition->fileSystem();
+    std::unique_ptr< FileSystem > unformatted( FileSystemFactory::create(
+        FileSystem::Type::Unformatted, fs->firstSector(), fs->lastSector(), fs->sectorSize() ) );
+    FileSystemSwap swap( m_partition, unformatted.get() );
+    return KPMHelpers::execute( NewOperation( *m_device, m_partition ), failureMessage );
 }
 
 void
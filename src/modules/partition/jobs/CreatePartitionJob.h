@@ -23,6 +23,9 @@ class FileSystem;
  * This job does two things:
  * 1. Create the partition
  * 2. Create the filesystem on the partition
+ *
+ * The second step can be left to a separate FormatPartitionJob,
+ * see setFormatSeparately().
  */
 class CreatePartitionJob : public PartitionJob
 {
@@ -37,8 +40,17 @@ public:
     void updatePreview();
     Device* device() const { return m_device; }
 
+    /** @brief Create the partition only, leaving it unformatted
+     *
+     * The filesystem is then created by a FormatPartitionJob, which
+     * can run alongside formatting on other disks (see batchFormatJobs()).
+     */
+    void setFormatSeparately( bool separately ) { m_formatSeparately = separately; }
+    bool formatSeparately() const { return m_formatSeparately; }
+
 private:
     Device* m_device;
+    bool m_formatSeparately = false;
 };
 
 #endif /* CREATEPARTITIONJOB_H */
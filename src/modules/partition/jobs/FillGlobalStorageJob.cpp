@@ -17,9 +17,11 @@
 #include "Branding.h"
 #include "GlobalStorage.h"
 #include "JobQueue.h"
+#include "partition/DeviceInventory.h"
 #include "partition/FileSystem.h"
 #include "partition/Global.h"
 #include "partition/PartitionIterator.h"
+#include "partition/Sync.h"
 #include "utils/Logger.h"
 
 #include <kpmcore/core/device.h>
@@ -30,7 +32,6 @@
 #include <QDebug>
 #include <QDir>
 #include <QFileInfo>
-#include <QProcess>
 
 using CalamaresUtils::Partition::PartitionIterator;
 using CalamaresUtils::Partition::untranslatedFS;
@@ -38,18 +39,46 @@ using CalamaresUtils::Partition::userVisibleFS;
 
 typedef QHash< QString, QString > UuidForPartitionHash;
 
+/** @brief The filesystem UUID of partition @p p
+ *
+ * For an open LUKS container, this is the UUID of the filesystem
+ * inside it (like KPMcore's readUUID() reports it), otherwise it
+ * is the UUID of the partition's own filesystem (or LUKS header).
+ */
+static QString
+filesystemUuid( CalamaresUtils::Partition::DeviceInventory* inventory, const Partition* p )
+{
+    if ( p->fileSystem().type() == FileSystem::Luks )
+    {
+        const auto* luksFs = dynamic_cast< const FS::luks* >( &p->fileSystem() );
+        if ( luksFs && luksFs->innerFS() && !luksFs->mapperName().isEmpty() )
+        {
+            // The inventory knows the mapper by its kernel name, e.g. /dev/dm-0
+            const auto inner = inventory->device( QFileInfo( luksFs->mapperName() ).canonicalFilePath() );
+            if ( inner.isValid() )
+            {
+                return inner.uuid;
+            }
+        }
+    }
+    return inventory->device( p->partitionPath() ).uuid;
+}
+
+/** @brief Collects the UUIDs of all partitions on @p devices
+ *
+ * The UUIDs come from the shared device inventory, which reads them
+ * all at once and keeps them until a partitioning job changes the disks.
+ */
 static UuidForPartitionHash
 findPartitionUuids( QList< Device* > devices )
 {
+    auto* inventory = CalamaresUtils::Partition::DeviceInventory::instance();
     UuidForPartitionHash hash;
-    foreach ( Device* device, devices )
+    for ( Device* device : qAsConst( devices ) )
     {
         for ( auto it = PartitionIterator::begin( device ); it != PartitionIterator::end( device ); ++it )
         {
-            Partition* p = *it;
-            QString path = p->partitionPath();
-            QString uuid = p->fileSystem().readUUID( p->partitionPath() );
-            hash.insert( path, uuid );
+            hash.insert( ( *it )->partitionPath(), filesystemUuid( inventory, *it ) );
         }
     }
 
@@ -61,20 +90,12 @@ findPartitionUuids( QList< Device* > devices )
 }
 
 
+/// @brief The UUID from the LUKS header on @p path, if there is one
 static QString
 getLuksUuid( const QString& path )
 {
-    QProcess process;
-    process.setProgram( "cryptsetup" );
-    process.setArguments( { "luksUUID", path } );
-    process.start();
-    process.waitForFinished();
-    if ( process.exitStatus() != QProcess::NormalExit || process.exitCode() )
-    {
-        return QString();
-    }
-    QString uuid = QString::fromLocal8Bit( process.readAllStandardOutput() ).trimmed();
-    return uuid;
+    const auto d = CalamaresUtils::Partition::DeviceInventory::instance()->device( path );
+    return d.fsType == QStringLiteral( "crypto_LUKS" ) ? d.uuid : QString();
 }
 
 
@@ -326,6 +347,11 @@ storeFSUse( Calamares::GlobalStorage* storage, const QVariantList& partitions )
 Calamares::JobResult
 FillGlobalStorageJob::exec()
 {
+    // This runs right after the partitioning jobs; mount() does not wait
+    // for udev, so let it catch up before anything mounts the new devices
+    // (and before reading their UUIDs).
+    CalamaresUtils::Partition::settle();
+
     Calamares::GlobalStorage* storage = Calamares::JobQueue::instance()->globalStorage();
     const auto partitions = createPartitionList();
     cDebug() << "Saving partition information map to GlobalStorage[\"partitions\"]";
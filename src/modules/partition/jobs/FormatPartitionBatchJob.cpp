@@ -0,0 +1,301 @@
+/* === This file is part of Calamares - <https://calamares.io> ===
+ *
+ *   SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *   SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ *   Calamares is Free Software: see the License-Identifier above.
+ *
+ */
+
+#include "FormatPartitionBatchJob.h"
+
+#include "jobs/ChangeFilesystemLabelJob.h"
+#include "jobs/CreatePartitionJob.h"
+#include "jobs/CreatePartitionTableJob.h"
+#include "jobs/DeletePartitionJob.h"
+#include "jobs/FormatPartitionJob.h"
+#include "jobs/ResizePartitionJob.h"
+#include "jobs/SetPartitionFlagsJob.h"
+
+#include "partition/DeviceInventory.h"
+#include "utils/Logger.h"
+
+#include <kpmcore/core/device.h>
+#include <kpmcore/core/lvmdevice.h>
+#include <kpmcore/core/partition.h>
+
+#include <QFutureSynchronizer>
+#include <QHash>
+#include <QMutex>
+#include <QtConcurrent/QtConcurrent>
+
+#include <algorithm>
+
+/** @brief The one disk that @p job changes
+ *
+ * Returns nullptr for jobs that are not about a single disk,
+ * including anything on an LVM volume group, which may be
+ * spread over several disks.
+ */
+static Device*
+jobDevice( const Calamares::job_ptr& job )
+{
+    Device* device = nullptr;
+    if ( auto* j = dynamic_cast< FormatPartitionJob* >( job.data() ) )
+    {
+        device = j->device();
+    }
+    else if ( auto* j = dynamic_cast< CreatePartitionJob* >( job.data() ) )
+    {
+        device = j->device();
+    }
+    else if ( auto* j = dynamic_cast< CreatePartitionTableJob* >( job.data() ) )
+    {
+        device = j->device();
+    }
+    else if ( auto* j = dynamic_cast< DeletePartitionJob* >( job.data() ) )
+    {
+        device = j->device();
+    }
+    else if ( auto* j = dynamic_cast< ResizePartitionJob* >( job.data() ) )
+    {
+        device = j->device();
+    }
+    else if ( auto* j = dynamic_cast< SetPartFlagsJob* >( job.data() ) )
+    {
+        device = j->device();
+    }
+    else if ( auto* j = dynamic_cast< ChangeFilesystemLabelJob* >( job.data() ) )
+    {
+        device = j->device();
+    }
+    return dynamic_cast< LvmDevice* >( device ) ? nullptr : device;
+}
+
+/// @brief A CreatePartitionJob split in two by splitCreateJobs()
+struct SplitCreate
+{
+    Calamares::job_ptr original;  ///< The job as it was passed in
+    Calamares::job_ptr createOnly;  ///< Creates the partition without the filesystem
+};
+
+/** @brief Splits creating a partition from creating its filesystem
+ *
+ * Only where the filesystem can be created by a command, so that
+ * formatting can go side-by-side with other disks. Each split is
+ * recorded in @p splits, by the FormatPartitionJob that it adds,
+ * so that it can be undone if there's nothing to format alongside.
+ */
+static Calamares::JobList
+splitCreateJobs( const Calamares::JobList& jobs, QHash< const Calamares::Job*, SplitCreate >& splits )
+{
+    Calamares::JobList result;
+    for ( const auto& job : jobs )
+    {
+        auto* create = dynamic_cast< CreatePartitionJob* >( job.data() );
+        Device* device = jobDevice( job );
+        if ( create && device && !create->formatSeparately() )
+        {
+            auto* format = new FormatPartitionJob( device, create->partition() );
+            if ( !format->mkfsCommand().isEmpty() )
+            {
+                auto* createOnly = new CreatePartitionJob( device, create->partition() );
+                createOnly->setFormatSeparately( true );
+                result.append( Calamares::job_ptr( createOnly ) );
+                result.append( Calamares::job_ptr( format ) );
+                splits.insert( format, { job, result.at( result.count() - 2 ) } );
+                continue;
+            }
+            delete format;
+        }
+        result.append( job );
+    }
+    return result;
+}
+
+Calamares::JobList
+batchFormatJobs( const Calamares::JobList& jobs )
+{
+    Calamares::JobList result;
+    Calamares::JobList batch;
+    QList< Device* > batchDevices;
+    QHash< const Calamares::Job*, SplitCreate > splits;
+
+    auto flush = [ & ]()
+    {
+        if ( batch.count() == 1 )
+        {
+            const auto split = splits.constFind( batch.first().data() );
+            if ( split != splits.cend() )
+            {
+                // Formatting on its own gains nothing, so KPMcore's
+                // NewOperation creates the filesystem, as it did before.
+                const int index = result.indexOf( split->createOnly );
+                Q_ASSERT( index >= 0 );
+                result[ index ] = split->original;
+            }
+            else
+            {
+                result.append( batch.first() );
+            }
+        }
+        else if ( batch.count() > 1 )
+        {
+            result.append( Calamares::job_ptr( new FormatPartitionBatchJob( batch ) ) );
+        }
+        batch.clear();
+        batchDevices.clear();
+    };
+
+    for ( const auto& job : splitCreateJobs( jobs, splits ) )
+    {
+        Device* device = jobDevice( job );
+        auto* format = dynamic_cast< FormatPartitionJob* >( job.data() );
+        if ( format && device )
+        {
+            const bool samePartition
+                = std::any_of( batch.cbegin(),
+                               batch.cend(),
+                               [ format ]( const Calamares::job_ptr& j )
+                               { return dynamic_cast< FormatPartitionJob* >( j.data() )->partition()
+                                        == format->partition(); } );
+            if ( samePartition )
+            {
+                flush();
+            }
+            batch.append( job );
+            batchDevices.append( device );
+        }
+        else if ( device && !batchDevices.contains( device ) )
+        {
+            // Nothing in the batch is on this disk, so this can go first
+            result.append( job );
+        }
+        else
+        {
+            flush();
+            result.append( job );
+        }
+    }
+    flush();
+    return result;
+}
+
+FormatPartitionBatchJob::FormatPartitionBatchJob( const Calamares::JobList& jobs )
+    : m_jobs( jobs )
+{
+}
+
+QString
+FormatPartitionBatchJob::prettyName() const
+{
+    return tr( "Format %1 partitions at the same time." ).arg( m_jobs.count() );
+}
+
+QString
+FormatPartitionBatchJob::prettyDescription() const
+{
+    QStringList descriptions;
+    for ( const auto& job : m_jobs )
+    {
+        descriptions.append( job->prettyDescription() );
+    }
+    return descriptions.join( QStringLiteral( "<br/>" ) );
+}
+
+QString
+FormatPartitionBatchJob::prettyStatusMessage() const
+{
+    return tr( "Formatting %1 partitions." ).arg( m_jobs.count() );
+}
+
+int
+FormatPartitionBatchJob::getJobWeight() const
+{
+    int weight = 1;
+    for ( const auto& job : m_jobs )
+    {
+        weight = std::max( weight, job->getJobWeight() );
+    }
+    return weight;
+}
+
+Calamares::JobResult
+FormatPartitionBatchJob::exec()
+{
+    struct Outcome
+    {
+        bool ok = true;
+        QString message;
+        QString details;
+    };
+
+    QMutex progressLock;
+    int done = 0;
+    auto finished = [ this, &progressLock, &done ]()
+    {
+        QMutexLocker lock( &progressLock );
+        ++done;
+        emit progress( qreal( done ) / m_jobs.count() );
+    };
+
+    // The mkfs commands go side-by-side; everything that uses KPMcore
+    // stays in this thread, one job at a time.
+    QList< FormatPartitionJob* > commandJobs;
+    Calamares::JobList kpmcoreJobs;
+    for ( const auto& job : qAsConst( m_jobs ) )
+    {
+        auto* format = dynamic_cast< FormatPartitionJob* >( job.data() );
+        if ( format && !format->mkfsCommand().isEmpty() )
+        {
+            commandJobs.append( format );
+        }
+        else
+        {
+            kpmcoreJobs.append( job );
+        }
+    }
+
+    QList< QFuture< Outcome > > futures;
+    QFutureSynchronizer< Outcome > synchronizer;
+    for ( auto* job : qAsConst( commandJobs ) )
+    {
+        auto future = QtConcurrent::run(
+            [ job, &finished ]()
+            {
+                cDebug() << "Batch format starting" << job->prettyName();
+                const auto r = job->formatWithCommand();
+                finished();
+                return Outcome { r.succeeded(), r.message(), r.details() };
+            } );
+        futures.append( future );
+        synchronizer.addFuture( future );
+    }
+    synchronizer.waitForFinished();
+    // The filesystems have changed
+    CalamaresUtils::Partition::DeviceInventory::instance()->invalidate();
+
+    for ( int i = 0; i < futures.count(); ++i )
+    {
+        const Outcome o = futures.at( i ).result();
+        if ( !o.ok )
+        {
+            return Calamares::JobResult::error( o.message, o.details );
+        }
+        auto r = commandJobs.at( i )->setPartitionType();
+        if ( !r )
+        {
+            return r;
+        }
+    }
+    for ( const auto& job : qAsConst( kpmcoreJobs ) )
+    {
+        auto r = job->exec();
+        if ( !r )
+        {
+            return r;
+        }
+        finished();
+    }
+    return Calamares::JobResult::ok();
+}
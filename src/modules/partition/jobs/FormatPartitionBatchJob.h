@@ -0,0 +1,67 @@
+/* === This file is part of Calamares - <https://calamares.io> ===
+ *
+ *   SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *   SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ *   Calamares is Free Software: see the License-Identifier above.
+ *
+ */
+
+#ifndef FORMATPARTITIONBATCHJOB_H
+#define FORMATPARTITIONBATCHJOB_H
+
+#include "Job.h"
+
+/**
+ * This job runs a number of FormatPartitionJobs at the same time.
+ *
+ * Creating a large filesystem takes a while, and on a multi-disk
+ * install there is no reason for one disk to wait for another.
+ * The jobs in a batch each format a different partition, and
+ * the partition tables they depend on have already been written.
+ * Use batchFormatJobs() to build the batches.
+ *
+ * Only the mkfs commands (see FormatPartitionJob::mkfsCommand())
+ * run side-by-side, each in a thread of its own. KPMcore is not
+ * used from those threads: setting the partition types, and
+ * formatting anything that needs KPMcore, happens afterwards,
+ * one job at a time.
+ */
+class FormatPartitionBatchJob : public Calamares::Job
+{
+    Q_OBJECT
+public:
+    explicit FormatPartitionBatchJob( const Calamares::JobList& jobs );
+
+    QString prettyName() const override;
+    QString prettyDescription() const override;
+    QString prettyStatusMessage() const override;
+    /// @brief The batch takes as long as its slowest job
+    int getJobWeight() const override;
+    Calamares::JobResult exec() override;
+
+    const Calamares::JobList& jobs() const { return m_jobs; }
+
+private:
+    Calamares::JobList m_jobs;
+};
+
+/** @brief Groups independent FormatPartitionJobs from @p jobs into batches
+ *
+ * The returned list has the same jobs, with FormatPartitionJobs
+ * gathered into FormatPartitionBatchJobs where possible. A
+ * CreatePartitionJob for a filesystem with a mkfs command is
+ * replaced by one that only creates the partition, followed by a
+ * FormatPartitionJob, so that new partitions are batched too. A job
+ * that changes a disk (e.g. its partition table) stays in order
+ * with the other jobs for that disk, but may move ahead of
+ * formatting on *other* disks, so that those can be batched.
+ * Jobs that are not about a single disk (e.g. LVM, or filling
+ * global storage) are barriers: nothing moves past them.
+ *
+ * A batch of one is left as a plain FormatPartitionJob; if it
+ * came from a CreatePartitionJob, that job is kept as it was.
+ */
+Calamares::JobList batchFormatJobs( const Calamares::JobList& jobs );
+
+#endif /* FORMATPARTITIONBATCHJOB_H */
@@ -13,10 +13,15 @@
 
 #include "core/KPMHelpers.h"
 
+#include "partition/DeviceInventory.h"
 #include "partition/FileSystem.h"
 #include "utils/CalamaresUtilsSystem.h"
 #include "utils/Logger.h"
 
+#include <kpmcore/backend/corebackend.h>
+#include <kpmcore/backend/corebackenddevice.h>
+#include <kpmcore/backend/corebackendmanager.h>
+#include <kpmcore/backend/corebackendpartitiontable.h>
 #include <kpmcore/core/device.h>
 #include <kpmcore/core/partition.h>
 #include <kpmcore/core/partitiontable.h>
@@ -65,6 +70,16 @@ FormatPartitionJob::prettyStatusMessage() const
 }
 
 
+static void
+setXfsBigtime( const QString& path )
+{
+    // We are going to try to set modern timestamps for the filesystem,
+    // (ignoring whether this succeeds). Requires a sufficiently-new
+    // xfs_admin and xfs_repair and might be made obsolete by newer
+    // kpmcore releases.
+    CalamaresUtils::System::runCommand( { "xfs_admin", "-O", "bigtime=1", path }, std::chrono::seconds( 60 ) );
+}
+
 Calamares::JobResult
 FormatPartitionJob::exec()
 {
@@ -74,12 +89,109 @@ FormatPartitionJob::exec()
                                       .arg( m_partition->partitionPath(), m_device->name() ) );
     if ( fsType == FileSystem::Xfs && r.succeeded() )
     {
-        // We are going to try to set modern timestamps for the filesystem,
-        // (ignoring whether this succeeds). Requires a sufficiently-new
-        // xfs_admin and xfs_repair and might be made obsolete by newer
-        // kpmcore releases.
-        CalamaresUtils::System::runCommand( { "xfs_admin", "-O", "bigtime=1", m_partition->partitionPath() },
-                                            std::chrono::seconds( 60 ) );
+        setXfsBigtime( m_partition->partitionPath() );
     }
     return r;
 }
+
+QStringList
+FormatPartitionJob::mkfsCommand() const
+{
+    const FileSystem& fs = m_partition->fileSystem();
+#if defined( WITH_KPMCORE42API )
+    if ( !fs.features().isEmpty() )
+    {
+        // KPMcore knows how to pass those on
+        return {};
+    }
+#endif
+    const QString label = fs.label();
+    const QString path = m_partition->partitionPath();
+    auto labelled = [ &label, &path ]( QStringList command, const QString& labelOption )
+    {
+        if ( !label.isEmpty() )
+        {
+            command << labelOption << label;
+        }
+        return command << path;
+    };
+
+    switch ( fs.type() )
+    {
+    case FileSystem::Ext2:
+        return labelled( { "mkfs.ext2", "-qF" }, "-L" );
+    case FileSystem::Ext3:
+        return labelled( { "mkfs.ext3", "-qF" }, "-L" );
+    case FileSystem::Ext4:
+        return labelled( { "mkfs.ext4", "-qF" }, "-L" );
+    case FileSystem::Btrfs:
+        return labelled( { "mkfs.btrfs", "-f" }, "-L" );
+    case FileSystem::Xfs:
+        return labelled( { "mkfs.xfs", "-f" }, "-L" );
+    case FileSystem::LinuxSwap:
+        return labelled( { "mkswap" }, "-L" );
+    case FileSystem::Fat32:
+        // FAT labels have rules of their own, leave those to KPMcore
+        return label.isEmpty() ? QStringList { "mkfs.fat", "-F32", "-I", path } : QStringList();
+    default:
+        return {};
+    }
+}
+
+Calamares::JobResult
+FormatPartitionJob::formatWithCommand()
+{
+    const QString path = m_partition->partitionPath();
+    const QString failureMessage
+        = tr( "The installer failed to format partition %1 on disk '%2'." ).arg( path, m_device->name() );
+    const QStringList command = mkfsCommand();
+    if ( command.isEmpty() )
+    {
+        return Calamares::JobResult::internalError( failureMessage,
+                                                    tr( "There is no format command for this file system." ),
+                                                    Calamares::JobResult::InvalidConfiguration );
+    }
+
+    // Like KPMcore, remove the signatures of whatever was there before
+    auto r = CalamaresUtils::System::runCommand( CalamaresUtils::System::RunLocation::RunInHost,
+                                                 { "wipefs", "--all", path } );
+    if ( r.getExitCode() == 0 )
+    {
+        r = CalamaresUtils::System::runCommand( CalamaresUtils::System::RunLocation::RunInHost, command );
+    }
+    if ( r.getExitCode() != 0 )
+    {
+        return Calamares::JobResult::error( failureMessage, r.getOutput() );
+    }
+    if ( m_partition->fileSystem().type() == FileSystem::Xfs )
+    {
+        setXfsBigtime( path );
+    }
+    return Calamares::JobResult::ok();
+}
+
+Calamares::JobResult
+FormatPartitionJob::setPartitionType()
+{
+    if ( m_device->type() != Device::Type::Disk_Device )
+    {
+        // Only disks have a partition table
+        return Calamares::JobResult::ok();
+    }
+
+    Report report( nullptr );
+    bool ok = false;
+    auto backendDevice = CoreBackendManager::self()->backend()->openDevice( *m_device );
+    if ( backendDevice )
+    {
+        auto backendTable = backendDevice->openPartitionTable();
+        ok = backendTable && backendTable->setPartitionSystemType( report, *m_partition ) && backendTable->commit();
+    }
+    CalamaresUtils::Partition::DeviceInventory::instance()->invalidate();
+    if ( ok )
+    {
+        return Calamares::JobResult::ok();
+    }
+    return Calamares::JobResult::error(
+        tr( "The installer failed to update partition table on disk '%1'." ).arg( m_device->name() ), report.toText() );
+}
@@ -13,6 +13,8 @@
 
 #include "PartitionJob.h"
 
+#include <QStringList>
+
 class Device;
 class Partition;
 class FileSystem;
@@ -20,8 +22,9 @@ class FileSystem;
 /**
  * This job formats an existing partition.
  *
- * It is only used for existing partitions: newly created partitions are
- * formatted by the CreatePartitionJob.
+ * Newly created partitions are usually formatted by the CreatePartitionJob,
+ * unless that job leaves it to a FormatPartitionJob (see
+ * CreatePartitionJob::setFormatSeparately()).
  */
 class FormatPartitionJob : public PartitionJob
 {
@@ -35,6 +38,26 @@ public:
 
     Device* device() const { return m_device; }
 
+    /** @brief The command that creates the filesystem, without KPMcore
+     *
+     * For the common filesystems this is a single mkfs command.
+     * Returns an empty list if KPMcore has to do the formatting.
+     */
+    QStringList mkfsCommand() const;
+    /** @brief Creates the filesystem with mkfsCommand()
+     *
+     * This only runs external commands on the partition itself, so it
+     * can run in any thread, alongside formatting of other partitions.
+     * Call setPartitionType() afterwards to finish the job.
+     */
+    Calamares::JobResult formatWithCommand();
+    /** @brief Sets the type of the partition to match the filesystem
+     *
+     * KPMcore does this after creating a filesystem. This changes the
+     * partition table, so it must not run alongside other jobs.
+     */
+    Calamares::JobResult setPartitionType();
+
 private:
     Device* m_device;
 };
@@ -18,6 +18,11 @@ QTEST_GUILESS_MAIN( ClearMountsJobTests )
 
 /* Not exactly public API */
 QStringList getPartitionsForDevice( const QString& deviceName );
+QList< QPair< QString, QString > > parseMountInfo( const QString& mountInfo );
+QStringList parseSwaps( const QString& swaps );
+QList< QStringList > teardownLevels( const QMap< QString, QStringList >& holders );
+QList< QPair< QString, QString > > unmountOrder( const QList< QPair< QString, QString > >& mounts,
+                                                 const QStringList& deviceNumbers );
 
 /* At one point, the partitions-list was read from /proc/partitions by
  * running awk and grep, as below. Check that the current implementation
@@ -66,3 +71,98 @@ ClearMountsJobTests::testFindPartitions()
 
     QCOMPARE( partitions, other_part );
 }
+
+void
+ClearMountsJobTests::testParseMountInfo()
+{
+    const QString mountInfo = QStringLiteral(
+        "22 1 8:2 / / rw,relatime shared:1 - ext4 /dev/sda2 rw\n"
+        "36 22 8:17 / /mnt/my\\040disk rw,noatime shared:2 - vfat /dev/sdb1 rw\n"
+        "37 36 254:0 / /mnt/my\\040disk/home rw shared:3 - btrfs /dev/mapper/luks-home rw,subvol=/\n"
+        "garbage\n" );
+    const auto mounts = parseMountInfo( mountInfo );
+    QCOMPARE( mounts.count(), 3 );
+    QCOMPARE( mounts[ 0 ].first, QStringLiteral( "8:2" ) );
+    QCOMPARE( mounts[ 0 ].second, QStringLiteral( "/" ) );
+    QCOMPARE( mounts[ 1 ].first, QStringLiteral( "8:17" ) );
+    QCOMPARE( mounts[ 1 ].second, QStringLiteral( "/mnt/my disk" ) );
+    QCOMPARE( mounts[ 2 ].first, QStringLiteral( "254:0" ) );
+    QCOMPARE( mounts[ 2 ].second, QStringLiteral( "/mnt/my disk/home" ) );
+
+    QVERIFY( parseMountInfo( QString() ).isEmpty() );
+}
+
+void
+ClearMountsJobTests::testParseSwaps()
+{
+    const QString swaps = QStringLiteral( "Filename\t\t\t\tType\t\tSize\t\tUsed\t\tPriority\n"
+                                          "/dev/sda3                               partition\t2097148\t\t0\t\t-2\n"
+                                          "/dev/dm-1                               partition\t4194300\t\t0\t\t-3\n"
+                                          "/swap\\040file                          file\t\t1048572\t\t0\t\t-4\n" );
+    QCOMPARE( parseSwaps( swaps ),
+              QStringList( {
+                  QStringLiteral( "/dev/sda3" ),
+                  QStringLiteral( "/dev/dm-1" ),
+                  QStringLiteral( "/swap file" ),
+              } ) );
+
+    // Just the header
+    QVERIFY( parseSwaps( QStringLiteral( "Filename\tType\tSize\tUsed\tPriority\n" ) ).isEmpty() );
+    QVERIFY( parseSwaps( QString() ).isEmpty() );
+}
+
+void
+ClearMountsJobTests::testUnmountOrder()
+{
+    // The root of the target is on an LV (254:1), /boot is on a partition
+    // (8:1) and mounted later, /mnt/proc is something else altogether;
+    // 8:2 is not being cleared at all.
+    const QString mountInfo = QStringLiteral( "22 1 8:2 / / rw shared:1 - ext4 /dev/sda2 rw\n"
+                                              "40 22 254:1 / /mnt rw shared:2 - ext4 /dev/mapper/vg-root rw\n"
+                                              "41 40 0:5 / /mnt/proc rw shared:3 - proc proc rw\n"
+                                              "42 40 8:1 / /mnt/boot rw shared:4 - vfat /dev/sdb1 rw\n"
+                                              "43 42 8:1 / /mnt/boot rw shared:5 - vfat /dev/sdb1 rw\n"
+                                              "44 22 8:3 / /srv rw shared:6 - ext4 /dev/sdb3 rw\n" );
+    const auto order = unmountOrder( parseMountInfo( mountInfo ), { "254:1", "8:1" } );
+    QCOMPARE( order.count(), 4 );
+    QCOMPARE( order[ 0 ].second, QStringLiteral( "/mnt/boot" ) );
+    QCOMPARE( order[ 1 ].second, QStringLiteral( "/mnt/boot" ) );
+    QCOMPARE( order[ 2 ].second, QStringLiteral( "/mnt/proc" ) );
+    QCOMPARE( order[ 2 ].first, QStringLiteral( "0:5" ) );
+    QCOMPARE( order[ 3 ].second, QStringLiteral( "/mnt" ) );
+
+    QVERIFY( unmountOrder( parseMountInfo( mountInfo ), {} ).isEmpty() );
+}
+
+void
+ClearMountsJobTests::testTeardownLevels()
+{
+    // sda1 holds a LUKS container (dm-0), which is a PV holding two LVs;
+    // sda2 and the disk itself are independent of that.
+    QMap< QString, QStringList > holders;
+    holders.insert( "sda", {} );
+    holders.insert( "sda1", { "dm-0" } );
+    holders.insert( "sda2", {} );
+    holders.insert( "dm-0", { "dm-1", "dm-2" } );
+    holders.insert( "dm-1", {} );
+    holders.insert( "dm-2", {} );
+
+    const auto levels = teardownLevels( holders );
+    QCOMPARE( levels.count(), 3 );
+    // QMap sorts keys, and the levels keep that order
+    QCOMPARE( levels[ 0 ], QStringList( { "dm-1", "dm-2", "sda", "sda2" } ) );
+    QCOMPARE( levels[ 1 ], QStringList( { "dm-0" } ) );
+    QCOMPARE( levels[ 2 ], QStringList( { "sda1" } ) );
+
+    QVERIFY( teardownLevels( {} ).isEmpty() );
+
+    // A cycle doesn't hang, it ends up at the end
+    QMap< QString, QStringList > cyclic;
+    cyclic.insert( "a", { "b" } );
+    cyclic.insert( "b", { "a" } );
+    cyclic.insert( "c", {} );
+    const auto cyclicLevels = teardownLevels( cyclic );
+    QCOMPARE( cyclicLevels.count(), 2 );
+    QCOMPARE( cyclicLevels[ 0 ], QStringList( { "c" } ) );
+    QCOMPARE( cyclicLevels[ 1 ], QStringList( { "a", "b" } ) );
+}
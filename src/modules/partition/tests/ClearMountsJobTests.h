@@ -20,6 +20,10 @@ public:
 
 private Q_SLOTS:
     void testFindPartitions();
+    void testParseMountInfo();
+    void testParseSwaps();
+    void testUnmountOrder();
+    void testTeardownLevels();
 };
 
 #endif
@@ -0,0 +1,102 @@
+/* === This file is part of Calamares - <https://calamares.io> ===
+ *
+ *   SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *   SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ *   Calamares is Free Software: see the License-Identifier above.
+ *
+ */
+
+#include "TestDevice.h"
+
+#include "core/PartitionLayout.h"
+
+#include "JobQueue.h"
+#include "partition/KPMManager.h"
+#include "utils/Logger.h"
+
+#include <QtTest/QtTest>
+
+#include <memory>
+
+using namespace CalamaresUtils::Units;
+
+class CreateLayoutsBenchmarks : public QObject
+{
+    Q_OBJECT
+public:
+    CreateLayoutsBenchmarks() {}
+    ~CreateLayoutsBenchmarks() override {}
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void benchCreatePartitions_data();
+    void benchCreatePartitions();
+
+private:
+    std::unique_ptr< Calamares::JobQueue > m_jobQueue;
+    std::unique_ptr< CalamaresUtils::Partition::KPMManager > m_kpmcore;
+};
+
+static constexpr const qint64 logicalSize = 512;
+
+void
+CreateLayoutsBenchmarks::initTestCase()
+{
+    Logger::setupLogLevel( Logger::LOGERROR );
+    m_jobQueue = std::make_unique< Calamares::JobQueue >( nullptr );
+    m_kpmcore = std::make_unique< CalamaresUtils::Partition::KPMManager >();
+}
+
+void
+CreateLayoutsBenchmarks::cleanupTestCase()
+{
+    m_kpmcore.reset();
+    m_jobQueue.reset();
+}
+
+void
+CreateLayoutsBenchmarks::benchCreatePartitions_data()
+{
+    QTest::addColumn< QStringList >( "sizes" );
+
+    QTest::newRow( "root" ) << QStringList { "100%" };
+    QTest::newRow( "efi+root+home" ) << QStringList { "300MiB", "40%", "100%" };
+    QStringList many;
+    for ( int i = 0; i < 32; ++i )
+    {
+        many << ( i % 2 ? QStringLiteral( "64MiB" ) : QStringLiteral( "2%" ) );
+    }
+    QTest::newRow( "many" ) << many;
+}
+
+void
+CreateLayoutsBenchmarks::benchCreatePartitions()
+{
+    QFETCH( QStringList, sizes );
+
+    PartitionLayout layout;
+    int count = 0;
+    for ( const auto& size : sizes )
+    {
+        QVERIFY( layout.addEntry( { FileSystem::Type::Ext4, QStringLiteral( "/mnt%1" ).arg( count++ ), size } ) );
+    }
+
+    TestDevice dev( QStringLiteral( "bench" ), logicalSize, 500_GiB / logicalSize );
+    PartitionRole role( PartitionRole::Role::Any );
+    QBENCHMARK
+    {
+        const auto partitions = layout.createPartitions(
+            static_cast< Device* >( &dev ), 0, dev.totalLogical(), QString(), nullptr, role );
+        QCOMPARE( partitions.count(), sizes.count() );
+        qDeleteAll( partitions );
+    }
+}
+
+QTEST_GUILESS_MAIN( CreateLayoutsBenchmarks )
+
+#include "utils/moc-warnings.h"
+
+#include "CreateLayoutsBenchmarks.moc"
@@ -15,15 +15,10 @@
 #include "partition/KPMManager.h"
 #include "utils/Logger.h"
 
-#include <memory>
-
 #include <QtTest/QtTest>
 
 using namespace CalamaresUtils::Units;
 
-class PartitionTable;
-class SmartStatus;
-
 QTEST_GUILESS_MAIN( CreateLayoutsTests )
 
 static CalamaresUtils::Partition::KPMManager* kpmcore = nullptr;
@@ -124,37 +119,3 @@ CreateLayoutsTests::testMixedSizePartition()
     QCOMPARE( partitions[ 1 ]->length(), ( ( 5_GiB - 5_MiB ) / 2 ) / LOGICAL_SIZE );
     QCOMPARE( partitions[ 2 ]->length(), ( ( 5_GiB - 5_MiB ) / 2 ) / LOGICAL_SIZE );
 }
-
-#ifdef WITH_KPMCORE4API
-// TODO: Get a clean way to instantiate a test Device from KPMCore
-class DevicePrivate
-{
-public:
-    QString m_Name;
-    QString m_DeviceNode;
-    qint64 m_LogicalSectorSize;
-    qint64 m_TotalLogical;
-    PartitionTable* m_PartitionTable;
-    QString m_IconName;
-    std::shared_ptr< SmartStatus > m_SmartStatus;
-    Device::Type m_Type;
-};
-
-TestDevice::TestDevice( const QString& name, const qint64 logicalSectorSize, const qint64 totalLogicalSectors )
-    : Device( std::make_shared< DevicePrivate >(),
-              name,
-              QString( "node" ),
-              logicalSectorSize,
-              totalLogicalSectors,
-              QString(),
-              Device::Type::Unknown_Device )
-{
-}
-#else
-TestDevice::TestDevice( const QString& name, const qint64 logicalSectorSize, const qint64 totalLogicalSectors )
-    : Device( name, QString( "node" ), logicalSectorSize, totalLogicalSectors, QString(), Device::Type::Unknown_Device )
-{
-}
-#endif
-
-TestDevice::~TestDevice() {}
@@ -10,7 +10,7 @@
 #ifndef CLEARMOUNTSJOBTESTS_H
 #define CLEARMOUNTSJOBTESTS_H
 
-#include "partition/KPMHelper.h"
+#include "TestDevice.h"
 
 #include <QObject>
 
@@ -29,11 +29,4 @@ private Q_SLOTS:
     void cleanup();
 };
 
-class TestDevice : public Device
-{
-public:
-    TestDevice( const QString& name, const qint64 logicalSectorSize, const qint64 totalLogicalSectors );
-    ~TestDevice() override;
-};
-
 #endif
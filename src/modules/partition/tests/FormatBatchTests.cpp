@@ -0,0 +1,306 @@
+/* === This file is part of Calamares - <https://calamares.io> ===
+ *
+ *   SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *   SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ *   Calamares is Free Software: see the License-Identifier above.
+ *
+ */
+
+#include "TestDevice.h"
+
+#include "core/KPMHelpers.h"
+
+#include "jobs/CreatePartitionJob.h"
+#include "jobs/CreatePartitionTableJob.h"
+#include "jobs/DeletePartitionJob.h"
+#include "jobs/FormatPartitionBatchJob.h"
+#include "jobs/FormatPartitionJob.h"
+#include "jobs/SetPartitionFlagsJob.h"
+
+#include "JobQueue.h"
+#include "partition/KPMManager.h"
+#include "utils/CalamaresUtilsSystem.h"
+#include "utils/Logger.h"
+#include "utils/Units.h"
+
+#include <kpmcore/core/partition.h>
+#include <kpmcore/core/partitiontable.h>
+#include <kpmcore/fs/filesystemfactory.h>
+
+#include <QObject>
+#include <QTemporaryDir>
+#include <QtTest/QtTest>
+
+#include <memory>
+
+using namespace CalamaresUtils::Units;
+
+#define LOGICAL_SIZE 512
+
+/// @brief A job that is not about any one disk, like filling global storage
+class BarrierJob : public Calamares::Job
+{
+    Q_OBJECT
+public:
+    QString prettyName() const override { return QStringLiteral( "Barrier" ); }
+    Calamares::JobResult exec() override { return Calamares::JobResult::ok(); }
+};
+
+class FormatBatchTests : public QObject
+{
+    Q_OBJECT
+
+public:
+    FormatBatchTests();
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testTwoDisks();
+    void testSameDiskOrder();
+    void testSplitCreate();
+    void testMkfsCommand();
+    void testFormatWithCommand();
+
+private:
+    /** @brief A new partition on @p device, the @p n th MiB of it
+     *
+     * The filesystem is ext4, unless @p type says otherwise; the
+     * partition path is made up from the device name, unless
+     * @p path is given.
+     */
+    Partition* makePartition( TestDevice& device,
+                              int n,
+                              FileSystem::Type type = FileSystem::Ext4,
+                              const QString& path = QString() );
+
+    std::unique_ptr< Calamares::JobQueue > m_queue;
+    std::unique_ptr< CalamaresUtils::Partition::KPMManager > m_kpmcore;
+};
+
+FormatBatchTests::FormatBatchTests() {}
+
+void
+FormatBatchTests::initTestCase()
+{
+    Logger::setupLogLevel( Logger::LOGDEBUG );
+    m_queue = std::make_unique< Calamares::JobQueue >( nullptr );
+    m_kpmcore = std::make_unique< CalamaresUtils::Partition::KPMManager >();
+    FileSystemFactory::init();
+}
+
+void
+FormatBatchTests::cleanupTestCase()
+{
+    m_kpmcore.reset();
+    m_queue.reset();
+}
+
+Partition*
+FormatBatchTests::makePartition( TestDevice& device, int n, FileSystem::Type type, const QString& path )
+{
+    if ( !device.partitionTable() )
+    {
+        device.setPartitionTable( new PartitionTable( PartitionTable::gpt, 2048, device.totalLogical() - 2048 ) );
+    }
+    const qint64 first = ( n + 1 ) * ( 1_MiB / LOGICAL_SIZE );
+    const qint64 last = first + ( 1_MiB / LOGICAL_SIZE ) - 1;
+    FileSystem* fs = FileSystemFactory::create( type, first, last, LOGICAL_SIZE );
+    auto* p = new Partition( device.partitionTable(),
+                             device,
+                             PartitionRole( PartitionRole::Primary ),
+                             fs,
+                             first,
+                             last,
+                             path.isEmpty() ? QString( "%1%2" ).arg( device.name() ).arg( n ) : path,
+                             KPM_PARTITION_FLAG( None ),
+                             QString(),
+                             false,
+                             KPM_PARTITION_FLAG( None ),
+                             KPM_PARTITION_STATE( None ) );
+    device.partitionTable()->append( p );
+    return p;
+}
+
+/// @brief The FormatPartitionJobs in the batch @p job, as partition names
+static QStringList
+batchPartitions( const Calamares::job_ptr& job )
+{
+    QStringList names;
+    auto* batch = dynamic_cast< FormatPartitionBatchJob* >( job.data() );
+    if ( batch )
+    {
+        for ( const auto& j : batch->jobs() )
+        {
+            names.append( dynamic_cast< FormatPartitionJob* >( j.data() )->partition()->partitionPath() );
+        }
+    }
+    return names;
+}
+
+void
+FormatBatchTests::testTwoDisks()
+{
+    TestDevice diskA( QStringLiteral( "sda" ), LOGICAL_SIZE, 64_MiB / LOGICAL_SIZE );
+    TestDevice diskB( QStringLiteral( "sdb" ), LOGICAL_SIZE, 64_MiB / LOGICAL_SIZE );
+    Partition* a1 = makePartition( diskA, 1 );
+    Partition* a2 = makePartition( diskA, 2 );
+    Partition* b1 = makePartition( diskB, 1 );
+    Partition* b2 = makePartition( diskB, 2 );
+    Partition* b9 = makePartition( diskB, 9 );
+
+    // The jobs as PartitionCoreModule lists them: one disk after the other
+    Calamares::job_ptr tableA( new CreatePartitionTableJob( &diskA, PartitionTable::gpt ) );
+    Calamares::job_ptr createA1( new CreatePartitionJob( &diskA, a1 ) );
+    Calamares::job_ptr formatA2( new FormatPartitionJob( &diskA, a2 ) );
+    Calamares::job_ptr deleteB9( new DeletePartitionJob( &diskB, b9 ) );
+    Calamares::job_ptr formatB1( new FormatPartitionJob( &diskB, b1 ) );
+    Calamares::job_ptr formatB2( new FormatPartitionJob( &diskB, b2 ) );
+    Calamares::job_ptr barrier( new BarrierJob );
+
+    const Calamares::JobList jobs { tableA, createA1, formatA2, deleteB9, formatB1, formatB2, barrier };
+    const auto batched = batchFormatJobs( jobs );
+
+    // The table changes on sdb move ahead of formatting on sda;
+    // all four formats (including the new partition) go in one
+    // batch, before the barrier.
+    QCOMPARE( batched.count(), 5 );
+    QCOMPARE( batched.at( 0 ), tableA );
+    auto* createOnly = dynamic_cast< CreatePartitionJob* >( batched.at( 1 ).data() );
+    QVERIFY( createOnly );
+    QCOMPARE( createOnly->partition(), a1 );
+    QVERIFY( createOnly->formatSeparately() );
+    QCOMPARE( batched.at( 2 ), deleteB9 );
+    QCOMPARE( batchPartitions( batched.at( 3 ) ), QStringList( { "sda1", "sda2", "sdb1", "sdb2" } ) );
+    QCOMPARE( batched.at( 4 ), barrier );
+    // The job that was passed in is unchanged
+    QVERIFY( !dynamic_cast< CreatePartitionJob* >( createA1.data() )->formatSeparately() );
+
+    // Nothing moves past a barrier
+    const Calamares::JobList split { formatA2, barrier, formatB1 };
+    QCOMPARE( batchFormatJobs( split ), split );
+}
+
+void
+FormatBatchTests::testSameDiskOrder()
+{
+    TestDevice diskA( QStringLiteral( "sda" ), LOGICAL_SIZE, 64_MiB / LOGICAL_SIZE );
+    TestDevice diskB( QStringLiteral( "sdb" ), LOGICAL_SIZE, 64_MiB / LOGICAL_SIZE );
+    Partition* a1 = makePartition( diskA, 1 );
+    Partition* a2 = makePartition( diskA, 2 );
+    Partition* b1 = makePartition( diskB, 1 );
+
+    // A table change on sda after formatting sda stays after it
+    Calamares::job_ptr formatA1( new FormatPartitionJob( &diskA, a1 ) );
+    Calamares::job_ptr flagsA1( new SetPartFlagsJob( &diskA, a1, KPM_PARTITION_FLAG( Boot ) ) );
+    Calamares::job_ptr formatA2( new FormatPartitionJob( &diskA, a2 ) );
+    Calamares::job_ptr formatB1( new FormatPartitionJob( &diskB, b1 ) );
+
+    const auto batched = batchFormatJobs( { formatA1, flagsA1, formatA2, formatB1 } );
+    QCOMPARE( batched.count(), 3 );
+    QCOMPARE( batched.at( 0 ), formatA1 );
+    QCOMPARE( batched.at( 1 ), flagsA1 );
+    QCOMPARE( batchPartitions( batched.at( 2 ) ), QStringList( { "sda2", "sdb1" } ) );
+
+    // The same partition twice is never in one batch
+    Calamares::job_ptr formatA1again( new FormatPartitionJob( &diskA, a1 ) );
+    const auto twice = batchFormatJobs( { formatA1, formatA1again } );
+    QCOMPARE( twice.count(), 2 );
+    QCOMPARE( twice.at( 0 ), formatA1 );
+    QCOMPARE( twice.at( 1 ), formatA1again );
+}
+
+void
+FormatBatchTests::testSplitCreate()
+{
+    TestDevice diskA( QStringLiteral( "sda" ), LOGICAL_SIZE, 64_MiB / LOGICAL_SIZE );
+    TestDevice diskB( QStringLiteral( "sdb" ), LOGICAL_SIZE, 64_MiB / LOGICAL_SIZE );
+    Partition* a1 = makePartition( diskA, 1 );
+    Partition* a2 = makePartition( diskA, 2, FileSystem::Ntfs );
+    Partition* b1 = makePartition( diskB, 1, FileSystem::LinuxSwap );
+
+    // New partitions are created first, and formatted separately
+    Calamares::job_ptr createA1( new CreatePartitionJob( &diskA, a1 ) );
+    Calamares::job_ptr flagsA1( new SetPartFlagsJob( &diskA, a1, KPM_PARTITION_FLAG( Boot ) ) );
+    Calamares::job_ptr createB1( new CreatePartitionJob( &diskB, b1 ) );
+    const auto batched = batchFormatJobs( { createA1, createB1, flagsA1 } );
+    QCOMPARE( batched.count(), 4 );
+    QVERIFY( dynamic_cast< CreatePartitionJob* >( batched.at( 0 ).data() )->formatSeparately() );
+    QVERIFY( dynamic_cast< CreatePartitionJob* >( batched.at( 1 ).data() )->formatSeparately() );
+    QCOMPARE( batchPartitions( batched.at( 2 ) ), QStringList( { "sda1", "sdb1" } ) );
+    // The flags wait for the filesystem, as with KPMcore
+    QCOMPARE( batched.at( 3 ), flagsA1 );
+
+    // Nothing to format alongside, so KPMcore's NewOperation does it all
+    const auto alone = batchFormatJobs( { createA1, flagsA1, createB1 } );
+    QCOMPARE( alone, Calamares::JobList( { createA1, flagsA1, createB1 } ) );
+
+    // Two disks, each a single partition
+    const auto pair = batchFormatJobs( { createA1, createB1 } );
+    QCOMPARE( pair.count(), 3 );
+    QCOMPARE( batchPartitions( pair.at( 2 ) ), QStringList( { "sda1", "sdb1" } ) );
+
+    // Without a mkfs command, KPMcore formats the new partition as before
+    Calamares::job_ptr createA2( new CreatePartitionJob( &diskA, a2 ) );
+    const auto kept = batchFormatJobs( { createA2 } );
+    QCOMPARE( kept.count(), 1 );
+    QCOMPARE( kept.at( 0 ), createA2 );
+}
+
+void
+FormatBatchTests::testMkfsCommand()
+{
+    TestDevice disk( QStringLiteral( "sda" ), LOGICAL_SIZE, 64_MiB / LOGICAL_SIZE );
+    Partition* ext4 = makePartition( disk, 1 );
+    Partition* swap = makePartition( disk, 2, FileSystem::LinuxSwap );
+    Partition* fat = makePartition( disk, 3, FileSystem::Fat32 );
+    Partition* ntfs = makePartition( disk, 4, FileSystem::Ntfs );
+    swap->fileSystem().setLabel( QStringLiteral( "my swap" ) );
+
+    QCOMPARE( FormatPartitionJob( &disk, ext4 ).mkfsCommand(), QStringList( { "mkfs.ext4", "-qF", "sda1" } ) );
+    QCOMPARE( FormatPartitionJob( &disk, swap ).mkfsCommand(), QStringList( { "mkswap", "-L", "my swap", "sda2" } ) );
+    QCOMPARE( FormatPartitionJob( &disk, fat ).mkfsCommand(), QStringList( { "mkfs.fat", "-F32", "-I", "sda3" } ) );
+    QVERIFY( FormatPartitionJob( &disk, ntfs ).mkfsCommand().isEmpty() );
+
+    // FAT labels are left to KPMcore
+    fat->fileSystem().setLabel( QStringLiteral( "EFI" ) );
+    QVERIFY( FormatPartitionJob( &disk, fat ).mkfsCommand().isEmpty() );
+}
+
+void
+FormatBatchTests::testFormatWithCommand()
+{
+    QTemporaryDir dir;
+    QVERIFY( dir.isValid() );
+
+    // Regular files stand in for the partitions, so this needs no root
+    TestDevice disk( QStringLiteral( "sda" ), LOGICAL_SIZE, 64_MiB / LOGICAL_SIZE );
+    const QString image = dir.filePath( QStringLiteral( "root.img" ) );
+    {
+        QFile f( image );
+        QVERIFY( f.open( QIODevice::WriteOnly ) );
+        QVERIFY( f.resize( qint64( 8_MiB ) ) );
+    }
+    Partition* p = makePartition( disk, 1, FileSystem::Ext4, image );
+    p->fileSystem().setLabel( QStringLiteral( "root" ) );
+
+    if ( CalamaresUtils::System::runCommand( { "mkfs.ext4", "-V" }, std::chrono::seconds( 5 ) ).getExitCode() != 0 )
+    {
+        QSKIP( "No mkfs.ext4 available" );
+    }
+    FormatPartitionJob job( &disk, p );
+    QVERIFY( job.formatWithCommand() );
+    const auto r
+        = CalamaresUtils::System::runCommand( { "blkid", "-p", "-o", "export", image }, std::chrono::seconds( 5 ) );
+    QCOMPARE( r.getExitCode(), 0 );
+    QVERIFY( r.getOutput().contains( QStringLiteral( "TYPE=ext4" ) ) );
+    QVERIFY( r.getOutput().contains( QStringLiteral( "LABEL=root" ) ) );
+}
+
+QTEST_GUILESS_MAIN( FormatBatchTests )
+
+#include "utils/moc-warnings.h"
+
+#include "FormatBatchTests.moc"
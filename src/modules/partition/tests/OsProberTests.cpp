@@ -0,0 +1,267 @@
+/* === This file is part of Calamares - <https://calamares.io> ===
+ *
+ *   SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *   SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ *   Calamares is Free Software: see the License-Identifier above.
+ *
+ */
+
+#include "core/OsProber.h"
+
+#include "utils/CalamaresUtilsSystem.h"
+#include "utils/Logger.h"
+
+#include <QObject>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QtTest/QtTest>
+
+#include <unistd.h>
+
+using CalamaresUtils::Partition::BlockDevice;
+
+class OsProberTests : public QObject
+{
+    Q_OBJECT
+
+public:
+    OsProberTests();
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void testBootSectors_data();
+    void testBootSectors();
+    void testFilesystem_data();
+    void testFilesystem();
+    void testFstab();
+
+    void testNtfsImage();
+    void testImages();
+
+private:
+    QString m_fixtures;
+    bool m_isRoot = false;
+};
+
+OsProberTests::OsProberTests()
+    : m_fixtures( QStringLiteral( BUILD_AS_TEST "/osprober" ) )
+    , m_isRoot( geteuid() == 0 )
+{
+}
+
+void
+OsProberTests::initTestCase()
+{
+    Logger::setupLogLevel( Logger::LOGDEBUG );
+    QVERIFY( QDir( m_fixtures ).exists() );
+}
+
+/// @brief Boot sectors for a volume with OEM ID @p oem and @p bootCode somewhere in the code
+static QByteArray
+bootSectors( const char* oem, const QByteArray& bootCode )
+{
+    QByteArray sectors( 16 * 512, '\0' );
+    sectors.replace( 0, 3, "\xeb\x52\x90" );
+    sectors.replace( 3, 8, oem );
+    sectors.replace( 0x180, bootCode.length(), bootCode );
+    sectors[ 510 ] = char( 0x55 );
+    sectors[ 511 ] = char( 0xaa );
+    return sectors;
+}
+
+void
+OsProberTests::testBootSectors_data()
+{
+    QTest::addColumn< QByteArray >( "sectors" );
+    QTest::addColumn< QString >( "name" );
+
+    // Vista and later have the messages in ASCII, and the name in UTF-16 later on
+    QTest::newRow( "bootmgr" ) << bootSectors( "NTFS    ", "BOOTMGR is compressed" )
+                               << QStringLiteral( "Windows (loader)" );
+    QTest::newRow( "bootmgr16" ) << bootSectors( "NTFS    ", QByteArray( "B\0O\0O\0T\0M\0G\0R\0", 14 ) )
+                                 << QStringLiteral( "Windows (loader)" );
+    QTest::newRow( "ntldr" ) << bootSectors( "NTFS    ", "NTLDR is missing" )
+                             << QStringLiteral( "Windows NT/2000/XP (loader)" );
+    QTest::newRow( "no-loader" ) << bootSectors( "NTFS    ", "Not a system disk" ) << QString();
+    QTest::newRow( "fat32" ) << bootSectors( "MSDOS5.0", "BOOTMGR is missing" ) << QString();
+    QTest::newRow( "short" ) << QByteArray( "\xeb\x52\x90NTF" ) << QString();
+}
+
+void
+OsProberTests::testBootSectors()
+{
+    QFETCH( QByteArray, sectors );
+    QFETCH( QString, name );
+
+    const auto entry = PartUtils::probeBootSectors( QStringLiteral( "/dev/sda1" ), sectors );
+    QCOMPARE( entry.prettyName, name );
+    if ( name.isEmpty() )
+    {
+        QVERIFY( entry.path.isEmpty() );
+    }
+    else
+    {
+        QCOMPARE( entry.path, QStringLiteral( "/dev/sda1" ) );
+        QCOMPARE( entry.line.join( ':' ), QStringLiteral( "/dev/sda1:%1:Windows:chain" ).arg( name ) );
+    }
+}
+
+void
+OsProberTests::testFilesystem_data()
+{
+    QTest::addColumn< QString >( "fixture" );
+    QTest::addColumn< QStringList >( "lines" );
+
+    QTest::newRow( "linux" ) << "linux"
+                             << QStringList { "/dev/sdb2:Fedora 34 (Workstation Edition):FedoraLinux:linux" };
+    // etc/os-release is an absolute symlink, which must not be followed
+    QTest::newRow( "usr-lib" ) << "linux-usrlib" << QStringList { "/dev/sdb2:Arch Linux:ArchLinux:linux" };
+    // Only known loaders, not the fallback BOOTX64.EFI
+    QTest::newRow( "esp" ) << "esp"
+                           << QStringList {
+                                  "/dev/sdb2@/EFI/Microsoft/Boot/bootmgfw.efi:Windows Boot Manager:Windows:efi"
+                              };
+    QTest::newRow( "macos" ) << "macos" << QStringList { "/dev/sdb2:Mac OS X 10.15.7:MacOSX:macosx" };
+    QTest::newRow( "data" ) << "data" << QStringList();
+}
+
+void
+OsProberTests::testFilesystem()
+{
+    QFETCH( QString, fixture );
+    QFETCH( QStringList, lines );
+
+    const auto entries = PartUtils::probeFilesystem( QStringLiteral( "/dev/sdb2" ), m_fixtures + '/' + fixture );
+    QStringList found;
+    for ( const auto& e : entries )
+    {
+        QCOMPARE( e.path, QStringLiteral( "/dev/sdb2" ) );
+        QVERIFY( !e.prettyName.isEmpty() );
+        found.append( e.line.join( ':' ) );
+    }
+    QCOMPARE( found, lines );
+}
+
+void
+OsProberTests::testFstab()
+{
+    const auto entries = PartUtils::probeFilesystem( QStringLiteral( "/dev/sdb2" ), m_fixtures + "/linux" );
+    QCOMPARE( entries.count(), 1 );
+
+    // Comments are dropped
+    const auto& fstab = entries.first().fstab;
+    QCOMPARE( fstab.count(), 4 );
+    QCOMPARE( fstab.at( 0 ).mountPoint, QStringLiteral( "/" ) );
+    QCOMPARE( fstab.at( 1 ).fsType, QStringLiteral( "vfat" ) );
+    QCOMPARE( fstab.at( 1 ).pass, 2 );
+    QCOMPARE( fstab.at( 2 ).mountPoint, QStringLiteral( "/home" ) );
+    QCOMPARE( fstab.at( 2 ).partitionNode, QStringLiteral( "UUID=1f0e2d3c-4b5a-6978-8a9b-0c1d2e3f4a5b" ) );
+    QCOMPARE( fstab.at( 3 ).fsType, QStringLiteral( "swap" ) );
+
+    // The fstab of another installation doesn't leak into this one
+    QVERIFY( PartUtils::probeFilesystem( QStringLiteral( "/dev/sdb2" ), m_fixtures + "/linux-usrlib" )
+                 .first()
+                 .fstab.isEmpty() );
+}
+
+void
+OsProberTests::testNtfsImage()
+{
+    // An image with a Windows boot sector, but no NTFS behind it: it
+    // can't be mounted, so the boot sectors decide.
+    QTemporaryDir dir;
+    QVERIFY( dir.isValid() );
+    QFile image( dir.filePath( "ntfs.img" ) );
+    QVERIFY( image.open( QIODevice::WriteOnly ) );
+    image.write( bootSectors( "NTFS    ", "BOOTMGR is compressed" ) );
+    image.write( QByteArray( 64 * 1024, '\0' ) );
+    image.close();
+
+    BlockDevice d;
+    d.name = QStringLiteral( "ntfs.img" );
+    d.path = image.fileName();
+    d.isPartition = true;
+    d.partitionNumber = 1;
+    d.fsType = QStringLiteral( "ntfs" );
+    d.uuid = QStringLiteral( "0123456789ABCDEF" );
+
+    const auto entries = PartUtils::probePartition( d );
+    QCOMPARE( entries.count(), 1 );
+    QCOMPARE( entries.first().prettyName, QStringLiteral( "Windows (loader)" ) );
+    QCOMPARE( entries.first().uuid, d.uuid );
+
+    // Not a partition, or a filesystem that can't hold an OS: not even looked at
+    d.isPartition = false;
+    QVERIFY( PartUtils::probePartition( d ).isEmpty() );
+    d.isPartition = true;
+    d.fsType = QStringLiteral( "swap" );
+    QVERIFY( PartUtils::probePartition( d ).isEmpty() );
+}
+
+void
+OsProberTests::testImages()
+{
+    if ( !m_isRoot )
+    {
+        QSKIP( "Mounting the images requires root" );
+    }
+    if ( QStandardPaths::findExecutable( "mkfs.ext4" ).isEmpty() )
+    {
+        QSKIP( "Creating the images requires mkfs.ext4" );
+    }
+
+    QTemporaryDir dir;
+    QVERIFY( dir.isValid() );
+
+    // Filesystem images with the fixtures as their contents
+    const QStringList fixtures { "linux", "esp", "data" };
+    CalamaresUtils::Partition::BlockDeviceList devices;
+    for ( const auto& fixture : fixtures )
+    {
+        const QString image = dir.filePath( fixture + ".img" );
+        auto r = CalamaresUtils::System::runCommand(
+            { "mkfs.ext4", "-q", "-F", "-d", m_fixtures + '/' + fixture, image, "4M" }, std::chrono::seconds( 30 ) );
+        QCOMPARE( r.getExitCode(), 0 );
+
+        BlockDevice d;
+        d.name = fixture;
+        d.path = image;
+        d.isPartition = true;
+        d.partitionNumber = devices.count() + 1;
+        d.fsType = QStringLiteral( "ext4" );
+        devices.append( d );
+    }
+    // Whole disks are not probed
+    BlockDevice disk = devices.first();
+    disk.isPartition = false;
+    devices.append( disk );
+    // A logical volume is
+    BlockDevice volume = disk;
+    volume.name = QStringLiteral( "dm-3" );
+    volume.path = dir.filePath( QStringLiteral( "volume.img" ) );
+    QVERIFY( QFile::copy( disk.path, volume.path ) );
+    devices.append( volume );
+
+    const auto entries = PartUtils::probePartitions( devices );
+    QCOMPARE( entries.count(), 3 );
+    QCOMPARE( entries.at( 0 ).path, devices.at( 0 ).path );
+    QCOMPARE( entries.at( 0 ).prettyName, QStringLiteral( "Fedora 34 (Workstation Edition)" ) );
+    QCOMPARE( entries.at( 0 ).fstab.count(), 4 );
+    QCOMPARE( entries.at( 1 ).path, devices.at( 1 ).path );
+    QCOMPARE( entries.at( 1 ).file, QStringLiteral( "/EFI/Microsoft/Boot/bootmgfw.efi" ) );
+    QCOMPARE( entries.at( 2 ).path, volume.path );
+    QCOMPARE( entries.at( 2 ).prettyName, entries.at( 0 ).prettyName );
+
+    // Nothing stays mounted
+    QFile mounts( "/proc/self/mounts" );
+    QVERIFY( mounts.open( QIODevice::ReadOnly ) );
+    QVERIFY( !mounts.readAll().contains( dir.path().toUtf8() ) );
+}
+
+QTEST_GUILESS_MAIN( OsProberTests )
+
+#include "utils/moc-warnings.h"
+
+#include "OsProberTests.moc"
@@ -0,0 +1,23 @@
+/* === This file is part of Calamares - <https://calamares.io> ===
+ *
+ *   SPDX-FileCopyrightText: 2020 Corentin Noël <corentin.noel@collabora.com>
+ *   SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ *   Calamares is Free Software: see the License-Identifier above.
+ *
+ */
+
+#ifndef PARTITION_TESTDEVICE_H
+#define PARTITION_TESTDEVICE_H
+
+#include "partition/KPMHelper.h"
+
+/// @brief A KPMcore device that exists only in memory, for tests
+class TestDevice : public Device
+{
+public:
+    TestDevice( const QString& name, const qint64 logicalSectorSize, const qint64 totalLogicalSectors );
+    ~TestDevice() override;
+};
+
+#endif
@@ -12,6 +12,8 @@
 #   Calamares is Free Software: see the License-Identifier above.
 #
 
+import subprocess
+
 import libcalamares
 
 
@@ -26,24 +28,62 @@ def pretty_name():
     return _("Configure systemd services")
 
 
-def systemctl(targets, command, suffix):
+def unit_entries(targets):
+    """
+    Normalizes the entries in @p targets (either a plain name, or a
+    dict with *name* and *mandatory*) to a list of (name, mandatory) pairs.
+    """
+    entries = []
+    for svc in targets:
+        if isinstance(svc, str):
+            entries.append((svc, False))
+        else:
+            entries.append((svc["name"], svc.get("mandatory", False)))
+    return entries
+
+
+def systemctl_batch(root_mount_point, entries, command, suffix):
+    """
+    Runs a single "systemctl --root <root> <command> <things..>" in the
+    host for all of the @p entries. This avoids one chroot and one
+    systemctl process for each unit.
+
+    Returns True if systemctl succeeded for all of the units.
+    """
+    units = ["{}{}".format(name, suffix) for name, _mandatory in entries]
+    try:
+        p = subprocess.run(["systemctl", "--root={!s}".format(root_mount_point), command] + units,
+                           stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+    except OSError as e:
+        libcalamares.utils.debug("Batched systemctl is not available: {!s}".format(e))
+        return False
+    if p.returncode != 0:
+        libcalamares.utils.debug("Batched systemctl {} returned {}: {!s}".format(command, p.returncode, p.stdout))
+    return p.returncode == 0
+
+
+def systemctl(targets, command, suffix, root_mount_point=None):
     """
     For each entry in @p targets, run "systemctl <command> <thing>",
     where <thing> is the entry's name plus the given @p suffix.
     (No dot is added between name and suffix; suffix may be empty)
 
+    If @p root_mount_point is given, all the entries are first tried
+    at once, with a single systemctl --root call. Only if that
+    fails is each entry done separately in the chroot, so that the
+    failing entries can be found (and reported if they are mandatory).
+
     Returns a failure message, or None if this was successful.
     Services that are not mandatory have their failures suppressed
     silently.
     """
-    for svc in targets:
-        if isinstance(svc, str):
-            name = svc
-            mandatory = False
-        else:
-            name = svc["name"]
-            mandatory = svc.get("mandatory", False)
+    entries = unit_entries(targets)
+    if not entries:
+        return None
+    if root_mount_point and systemctl_batch(root_mount_point, entries, command, suffix):
+        return None
 
+    for name, mandatory in entries:
         ec = libcalamares.utils.target_env_call(
             ['systemctl', command, "{}{}".format(name, suffix)]
             )
@@ -85,33 +125,38 @@ def run():
     Setup systemd services
     """
     cfg = libcalamares.job.configuration
+    root_mount_point = None
+    if cfg.get("batch", True):
+        root_mount_point = libcalamares.globalstorage.value("rootMountPoint")
 
     # note that the "systemctl enable" and "systemctl disable" commands used
     # here will work in a chroot; in fact, they are the only systemctl commands
     # that support that, see:
     # http://0pointer.de/blog/projects/changing-roots.html
+    # In batch mode, they are run from the host with --root, which
+    # does the same for a whole list of units at once.
 
-    r = systemctl(cfg.get("services", []), "enable", ".service")
+    r = systemctl(cfg.get("services", []), "enable", ".service", root_mount_point)
     if r is not None:
         return r
 
-    r = systemctl(cfg.get("targets", []), "enable", ".target")
+    r = systemctl(cfg.get("targets", []), "enable", ".target", root_mount_point)
     if r is not None:
         return r
 
-    r = systemctl(cfg.get("timers", []), "enable", ".timer")
+    r = systemctl(cfg.get("timers", []), "enable", ".timer", root_mount_point)
     if r is not None:
         return r
 
-    r = systemctl(cfg.get("disable", []), "disable", ".service")
+    r = systemctl(cfg.get("disable", []), "disable", ".service", root_mount_point)
     if r is not None:
         return r
 
-    r = systemctl(cfg.get("disable-targets", []), "disable", ".target")
+    r = systemctl(cfg.get("disable-targets", []), "disable", ".target", root_mount_point)
     if r is not None:
         return r
 
-    r = systemctl(cfg.get("mask", []), "mask", "")
+    r = systemctl(cfg.get("mask", []), "mask", "", root_mount_point)
     if r is not None:
         return r
 
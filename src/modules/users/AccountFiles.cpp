@@ -0,0 +1,485 @@
+/* === This file is part of Calamares - <https://calamares.io> ===
+ *
+ *   SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *   SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ *   Calamares is Free Software: see the License-Identifier above.
+ *
+ */
+
+#include "AccountFiles.h"
+
+#include "utils/CalamaresUtilsSystem.h"
+#include "utils/Entropy.h"
+#include "utils/Logger.h"
+#include "utils/String.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QSet>
+#include <QThread>
+
+#ifndef NO_CRYPT_H
+#include <crypt.h>
+#endif
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+bool
+AccountFiles::Database::load()
+{
+    if ( loaded )
+    {
+        return readable;
+    }
+
+    lines.clear();
+    changed = false;
+    loaded = true;
+    readable = false;
+
+    QFile f( path );
+    exists = f.exists();
+    if ( !exists )
+    {
+        readable = true;
+        return true;
+    }
+    if ( !f.open( QIODevice::ReadOnly ) )
+    {
+        cWarning() << "Can not read" << path;
+        return false;
+    }
+    lines = QString::fromUtf8( f.readAll() ).split( '\n' );
+    if ( !lines.isEmpty() && lines.last().isEmpty() )
+    {
+        // From the trailing newline
+        lines.removeLast();
+    }
+    readable = true;
+    return true;
+}
+
+bool
+AccountFiles::Database::write()
+{
+    if ( !changed )
+    {
+        return true;
+    }
+
+    QByteArray contents = lines.join( '\n' ).toUtf8();
+    if ( !lines.isEmpty() )
+    {
+        contents.append( '\n' );
+    }
+
+    const QByteArray target = QFile::encodeName( path );
+    const QByteArray temporary = target + '+';
+    const QByteArray backup = target + '-';
+
+    struct stat st;
+    const bool hadFile = ::stat( target.constData(), &st ) == 0;
+    const mode_t mode = hadFile ? ( st.st_mode & 07777 ) : 0644;
+
+    int fd = ::open( temporary.constData(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600 );
+    if ( fd < 0 )
+    {
+        cWarning() << "Can not create" << temporary;
+        return false;
+    }
+
+    // shadow and gshadow are not world-readable, and often owned by group shadow;
+    // the new file gets the owner before it gets any contents.
+    bool ok = !( hadFile && ::fchown( fd, st.st_uid, st.st_gid ) != 0 && ::geteuid() == 0 );
+    ok = ok && ::fchmod( fd, mode ) == 0;
+    const char* data = contents.constData();
+    qint64 remaining = contents.size();
+    while ( ok && remaining > 0 )
+    {
+        const auto written = ::write( fd, data, size_t( remaining ) );
+        if ( written < 0 )
+        {
+            ok = false;
+        }
+        else
+        {
+            data += written;
+            remaining -= written;
+        }
+    }
+    ok = ok && ::fsync( fd ) == 0;
+    ok = ( ::close( fd ) == 0 ) && ok;
+
+    if ( ok && hadFile )
+    {
+        ::unlink( backup.constData() );
+        if ( ::link( target.constData(), backup.constData() ) != 0 )
+        {
+            cWarning() << "Can not keep a backup of" << path;
+        }
+    }
+    ok = ok && ::rename( temporary.constData(), target.constData() ) == 0;
+    if ( !ok )
+    {
+        cWarning() << "Can not write" << path;
+        ::unlink( temporary.constData() );
+        return false;
+    }
+    changed = false;
+    return true;
+}
+
+int
+AccountFiles::Database::indexOf( const QString& name ) const
+{
+    const QString prefix = name + ':';
+    for ( int i = 0; i < lines.count(); ++i )
+    {
+        if ( lines.at( i ).startsWith( prefix ) )
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+AccountFiles::AccountFiles( const QString& root )
+    : m_root( root )
+{
+    m_group.path = m_root.absoluteFilePath( "etc/group" );
+    m_gshadow.path = m_root.absoluteFilePath( "etc/gshadow" );
+    m_passwd.path = m_root.absoluteFilePath( "etc/passwd" );
+    m_shadow.path = m_root.absoluteFilePath( "etc/shadow" );
+    m_loginDefs.path = m_root.absoluteFilePath( "etc/login.defs" );
+}
+
+AccountFiles::~AccountFiles()
+{
+    unlock();
+}
+
+bool
+AccountFiles::lock()
+{
+    if ( m_lockFd < 0 )
+    {
+        const QByteArray lockPath = QFile::encodeName( m_root.absoluteFilePath( "etc/.pwd.lock" ) );
+        m_lockFd = ::open( lockPath.constData(), O_WRONLY | O_CREAT | O_CLOEXEC, 0600 );
+        if ( m_lockFd < 0 )
+        {
+            cWarning() << "Can not open" << lockPath;
+            return false;
+        }
+
+        struct flock region = {};
+        region.l_type = F_WRLCK;
+        region.l_whence = SEEK_SET;
+        QElapsedTimer timer;
+        timer.start();
+        while ( ::fcntl( m_lockFd, F_SETLK, &region ) != 0 )
+        {
+            if ( timer.elapsed() > 15000 )
+            {
+                cWarning() << "Timed out waiting for" << lockPath;
+                unlock();
+                return false;
+            }
+            QThread::msleep( 100 );
+        }
+    }
+
+    // Anything read before is read again, now that nobody else can change it
+    for ( Database* d : { &m_group, &m_gshadow, &m_passwd, &m_shadow } )
+    {
+        d->loaded = false;
+    }
+    return true;
+}
+
+void
+AccountFiles::unlock()
+{
+    if ( m_lockFd >= 0 )
+    {
+        // Closing the file releases the lock
+        ::close( m_lockFd );
+        m_lockFd = -1;
+    }
+}
+
+QStringList
+AccountFiles::groupNames() const
+{
+    m_group.load();
+    QStringList names;
+    names.reserve( m_group.lines.count() );
+    for ( const auto& line : m_group.lines )
+    {
+        if ( line.startsWith( '#' ) )
+        {
+            continue;
+        }
+        const int colon = line.indexOf( ':' );
+        if ( colon >= 1 )
+        {
+            names.append( line.left( colon ) );
+        }
+    }
+    return names;
+}
+
+bool
+AccountFiles::hasGroup( const QString& name ) const
+{
+    m_group.load();
+    return m_group.indexOf( name ) >= 0;
+}
+
+int
+AccountFiles::loginDefsValue( const QString& key, int defaultValue ) const
+{
+    m_loginDefs.load();
+    for ( const auto& line : m_loginDefs.lines )
+    {
+        const QStringList parts = line.simplified().split( ' ', SplitSkipEmptyParts );
+        if ( parts.count() >= 2 && parts.at( 0 ) == key )
+        {
+            bool ok = false;
+            const int value = parts.at( 1 ).toInt( &ok );
+            return ok ? value : defaultValue;
+        }
+    }
+    return defaultValue;
+}
+
+int
+AccountFiles::addGroup( const QString& name, bool isSystem )
+{
+    if ( !m_group.load() || !m_group.exists || !m_gshadow.load() )
+    {
+        cWarning() << "No group file in" << m_root.absolutePath();
+        return -1;
+    }
+    if ( name.isEmpty() || name.contains( ':' ) || hasGroup( name ) )
+    {
+        return -1;
+    }
+
+    QSet< int > gids;
+    for ( const auto& line : m_group.lines )
+    {
+        bool ok = false;
+        const int gid = line.section( ':', 2, 2 ).toInt( &ok );
+        if ( ok && !line.startsWith( '#' ) )
+        {
+            gids.insert( gid );
+        }
+    }
+
+    const int gidMin = loginDefsValue( QStringLiteral( "GID_MIN" ), 1000 );
+    const int gidMax = loginDefsValue( QStringLiteral( "GID_MAX" ), 60000 );
+    int gid = -1;
+    if ( isSystem )
+    {
+        const int sysGidMin = loginDefsValue( QStringLiteral( "SYS_GID_MIN" ), 101 );
+        const int sysGidMax = loginDefsValue( QStringLiteral( "SYS_GID_MAX" ), gidMin - 1 );
+        for ( int candidate = sysGidMax; candidate >= sysGidMin; --candidate )
+        {
+            if ( !gids.contains( candidate ) )
+            {
+                gid = candidate;
+                break;
+            }
+        }
+    }
+    else
+    {
+        // The GID after the highest one in use, or else the lowest free one
+        int highest = gidMin - 1;
+        for ( int used : qAsConst( gids ) )
+        {
+            if ( gidMin <= used && used <= gidMax )
+            {
+                highest = qMax( highest, used );
+            }
+        }
+        for ( int candidate = highest < gidMax ? highest + 1 : gidMin; candidate <= gidMax; ++candidate )
+        {
+            if ( !gids.contains( candidate ) )
+            {
+                gid = candidate;
+                break;
+            }
+        }
+    }
+    if ( gid < 0 )
+    {
+        cWarning() << "No free GID for group" << name;
+        return -1;
+    }
+
+    m_group.lines.append( QStringLiteral( "%1:x:%2:" ).arg( name ).arg( gid ) );
+    m_group.changed = true;
+    if ( m_gshadow.exists )
+    {
+        m_gshadow.lines.append( QStringLiteral( "%1:!::" ).arg( name ) );
+        m_gshadow.changed = true;
+    }
+    return gid;
+}
+
+bool
+AccountFiles::addGroups( const QList< GroupDescription >& wantedGroups, QStringList& missingGroups )
+{
+    for ( const auto& group : wantedGroups )
+    {
+        if ( group.isValid() && !hasGroup( group.name() ) )
+        {
+            if ( group.mustAlreadyExist() )
+            {
+                // Should have been there already: don't create it
+                missingGroups.append( group.name() );
+            }
+            else if ( addGroup( group.name(), group.isSystemGroup() ) < 0 )
+            {
+                missingGroups.append( group.name() + QChar( '*' ) );
+            }
+        }
+    }
+    if ( !missingGroups.isEmpty() )
+    {
+        cWarning() << "Missing groups in target system (* for failure to add):" << Logger::DebugList( missingGroups );
+    }
+    return missingGroups.isEmpty();
+}
+
+bool
+AccountFiles::setPasswordHash( const QString& user, const QString& hash )
+{
+    m_shadow.load();
+    const int index = m_shadow.indexOf( user );
+    if ( index < 0 || hash.contains( ':' ) )
+    {
+        return false;
+    }
+    QStringList fields = m_shadow.lines.at( index ).split( ':' );
+    fields[ 1 ] = hash;
+    m_shadow.lines[ index ] = fields.join( ':' );
+    m_shadow.changed = true;
+    return true;
+}
+
+QString
+AccountFiles::passwordHash( const QString& user ) const
+{
+    m_shadow.load();
+    const int index = m_shadow.indexOf( user );
+    return index < 0 ? QString() : m_shadow.lines.at( index ).section( ':', 1, 1 );
+}
+
+QString
+AccountFiles::makeSalt( int length )
+{
+    Q_ASSERT( length >= 8 );
+    Q_ASSERT( length <= 128 );
+
+    QString salt_string;
+    CalamaresUtils::EntropySource source = CalamaresUtils::getPrintableEntropy( length, salt_string );
+    if ( salt_string.length() != length )
+    {
+        cWarning() << "getPrintableEntropy returned string of length" << salt_string.length() << "expected" << length;
+        salt_string.truncate( length );
+    }
+    if ( source != CalamaresUtils::EntropySource::URandom )
+    {
+        cWarning() << "Entropy data for salt is low-quality.";
+    }
+
+    salt_string.insert( 0, "$6$" );
+    salt_string.append( '$' );
+    return salt_string;
+}
+
+QString
+AccountFiles::hashPassword( const QString& user, const QString& password )
+{
+    if ( user == "root" && password.isEmpty() )  //special case for disabling root account
+    {
+        // What passwd -dl does: an empty password, locked
+        return QStringLiteral( "!" );
+    }
+    return QString::fromLatin1( crypt( password.toUtf8(), makeSalt( 16 ).toUtf8() ) );
+}
+
+Calamares::JobResult
+AccountFiles::setPasswords( const QString& rootMountPoint, const QList< QPair< QString, QString > >& passwords )
+{
+#ifdef __FreeBSD__
+    // The passwd database there needs pwd_mkdb, so leave it to pw(8)
+    Q_UNUSED( rootMountPoint )
+    for ( const auto& p : passwords )
+    {
+        int ec = CalamaresUtils::System::instance()->targetEnvCall(
+            { "pw", "usermod", "-n", p.first, "-H", "0" }, QString(), hashPassword( p.first, p.second ) );
+        if ( ec )
+        {
+            return Calamares::JobResult::error(
+                QCoreApplication::translate( "AccountFiles", "Cannot set password for user %1." ).arg( p.first ),
+                QCoreApplication::translate( "AccountFiles", "usermod terminated with error code %1." ).arg( ec ) );
+        }
+    }
+    return Calamares::JobResult::ok();
+#else
+    AccountFiles accounts( rootMountPoint );
+    if ( !accounts.lock() )
+    {
+        return Calamares::JobResult::error(
+            QCoreApplication::translate( "AccountFiles", "Cannot lock the password files." ),
+            QCoreApplication::translate( "AccountFiles", "rootMountPoint is %1" ).arg( rootMountPoint ) );
+    }
+
+    for ( const auto& p : passwords )
+    {
+        if ( !accounts.setPasswordHash( p.first, hashPassword( p.first, p.second ) ) )
+        {
+            return Calamares::JobResult::error(
+                QCoreApplication::translate( "AccountFiles", "Cannot set password for user %1." ).arg( p.first ),
+                QCoreApplication::translate( "AccountFiles", "There is no shadow entry for user %1." ).arg( p.first ) );
+        }
+    }
+    if ( !accounts.write() )
+    {
+        return Calamares::JobResult::error(
+            QCoreApplication::translate( "AccountFiles", "Cannot write the password files." ),
+            QCoreApplication::translate( "AccountFiles", "rootMountPoint is %1" ).arg( rootMountPoint ) );
+    }
+    return Calamares::JobResult::ok();
+#endif
+}
+
+bool
+AccountFiles::userIds( const QString& user, uint& uid, uint& gid ) const
+{
+    m_passwd.load();
+    const int index = m_passwd.indexOf( user );
+    if ( index < 0 )
+    {
+        return false;
+    }
+    const QStringList fields = m_passwd.lines.at( index ).split( ':' );
+    bool uidOk = false;
+    bool gidOk = false;
+    uid = fields.value( 2 ).toUInt( &uidOk );
+    gid = fields.value( 3 ).toUInt( &gidOk );
+    return uidOk && gidOk;
+}
+
+bool
+AccountFiles::write()
+{
+    // gshadow first, so that a group never exists without its shadow entry
+    return m_gshadow.write() && m_group.write() && m_shadow.write();
+}
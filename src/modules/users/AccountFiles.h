@@ -0,0 +1,150 @@
+/* === This file is part of Calamares - <https://calamares.io> ===
+ *
+ *   SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *   SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ *   Calamares is Free Software: see the License-Identifier above.
+ *
+ */
+
+/**@file Editing the account databases of the target system
+ *
+ * Creating groups with groupadd, adding memberships with usermod and
+ * setting passwords with usermod or passwd costs a chroot'ed process
+ * each, and every one of those re-reads (and re-writes) the same files.
+ * Here the files are read once, changed in memory, and written back.
+ */
+
+#ifndef USERS_ACCOUNTFILES_H
+#define USERS_ACCOUNTFILES_H
+
+#include "Config.h"
+
+#include "Job.h"
+
+#include <QDir>
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+
+/** @brief The group, gshadow, passwd and shadow files of a target system
+ *
+ * Each file is read when it is first needed: looking at groups reads
+ * only the group file (which is world-readable), adding groups the
+ * group and gshadow files, setting passwords the shadow file, and
+ * looking up users the passwd file.
+ *
+ * Use lock() before changing anything: it takes the same lock that
+ * lckpwdf(3) does (so shadow-utils inside the target system waits
+ * for us). Changes are made in memory until write(), which replaces
+ * each changed file atomically: the new contents are written to
+ * file+ (with the owner and mode of the old file), the old file is
+ * kept as file- and then file+ is renamed over it, as shadow-utils does.
+ *
+ * The lock is released by unlock() or when the object is destroyed.
+ */
+class AccountFiles
+{
+public:
+    /// @brief The account files in the system at @p root
+    explicit AccountFiles( const QString& root );
+    ~AccountFiles();
+
+    AccountFiles( const AccountFiles& ) = delete;
+    AccountFiles& operator=( const AccountFiles& ) = delete;
+
+    /** @brief Lock the account files
+     *
+     * Waits up to 15 seconds (like lckpwdf(3)) for the lock. Returns
+     * @c false if the lock can't be taken. Files that were read before
+     * locking are read again when next needed.
+     */
+    bool lock();
+    void unlock();
+
+    /// @brief The names of the groups in the group file
+    QStringList groupNames() const;
+    bool hasGroup( const QString& name ) const;
+
+    /** @brief Add a group with an unused GID
+     *
+     * System groups get the highest free GID in the SYS_GID_MIN .. SYS_GID_MAX
+     * range, other groups the next GID in GID_MIN .. GID_MAX (both ranges
+     * from the target's login.defs), the way groupadd picks them.
+     * Returns the GID, or -1 if there is no free GID (or the group exists,
+     * or the group file can't be read).
+     */
+    int addGroup( const QString& name, bool isSystem );
+
+    /** @brief Add all the @p wantedGroups that aren't there yet
+     *
+     * Valid groups that don't exist are added, unless they must
+     * already exist; those are listed by name in @p missingGroups.
+     * Returns @c false if any group could not be added (or is missing).
+     */
+    bool addGroups( const QList< GroupDescription >& wantedGroups, QStringList& missingGroups );
+
+    /** @brief Set the (hashed) password of @p user in the shadow file
+     *
+     * Returns @c false if there is no shadow entry for the user.
+     */
+    bool setPasswordHash( const QString& user, const QString& hash );
+    /// @brief The password hash of @p user in the shadow file (mostly for testing)
+    QString passwordHash( const QString& user ) const;
+
+    /// @brief A salt for crypt(3), method 6 (SHA512) with @p length random characters
+    static QString makeSalt( int length );
+    /** @brief The hashed @p password of @p user, as it goes into the shadow file
+     *
+     * An empty password for root disables the root account.
+     */
+    static QString hashPassword( const QString& user, const QString& password );
+    /** @brief Set all the (user name, password) @p passwords in one go
+     *
+     * The shadow file in @p rootMountPoint is locked, changed and written
+     * once, rather than running usermod or passwd in the target system
+     * for each user.
+     */
+    static Calamares::JobResult setPasswords( const QString& rootMountPoint,
+                                              const QList< QPair< QString, QString > >& passwords );
+
+    /** @brief Look up the UID and primary GID of @p user in the passwd file
+     *
+     * Returns @c false if the user doesn't exist.
+     */
+    bool userIds( const QString& user, uint& uid, uint& gid ) const;
+
+    /// @brief Write the changed files back; returns @c false on failure
+    bool write();
+
+private:
+    struct Database
+    {
+        QString path;
+        QStringList lines;
+        bool loaded = false;
+        bool readable = false;
+        bool exists = false;
+        bool changed = false;
+
+        /// @brief Read the file, unless it has been read already; @c false if it can't be read
+        bool load();
+        bool write();
+        /// @brief Index of the line for @p name, or -1
+        int indexOf( const QString& name ) const;
+    };
+
+    int loginDefsValue( const QString& key, int defaultValue ) const;
+
+    QDir m_root;
+    int m_lockFd = -1;
+    // Read on first use, also from const methods
+    mutable Database m_group;
+    mutable Database m_gshadow;
+    mutable Database m_passwd;
+    mutable Database m_shadow;
+    mutable Database m_loginDefs;
+};
+
+#endif
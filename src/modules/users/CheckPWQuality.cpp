@@ -26,13 +26,15 @@
 
 PasswordCheck::PasswordCheck()
     : m_weight( 0 )
+    , m_expensive( false )
     , m_message()
     , m_accept( []( const QString& ) { return true; } )
 {
 }
 
-PasswordCheck::PasswordCheck( MessageFunc m, AcceptFunc a, Weight weight )
+PasswordCheck::PasswordCheck( MessageFunc m, AcceptFunc a, Weight weight, bool expensive )
     : m_weight( weight )
+    , m_expensive( expensive )
     , m_message( m )
     , m_accept( a )
 {
@@ -96,6 +98,11 @@ mungeString( void* p )
  * Class that acts as a RAII placeholder for pwquality_settings_t pointers.
  * Gets a new pointer and ensures it is deleted only once; provides
  * convenience functions for setting options and checking passwords.
+ *
+ * A single holder is shared by the user- and root-password checks.
+ * It is not thread-safe: the checks are run one-at-a-time in the
+ * background (see Config), and a repeated check of the same password
+ * re-uses the previous result instead of consulting cracklib again.
  */
 class PWSettingsHolder
 {
@@ -110,7 +117,11 @@ public:
     ~PWSettingsHolder() { pwquality_free_settings( m_settings ); }
 
     /// Sets an option via the configuration string @p v, <key>=<value> style.
-    int set( const QString& v ) { return pwquality_set_option( m_settings, v.toUtf8().constData() ); }
+    int set( const QString& v )
+    {
+        m_hasChecked = false;
+        return pwquality_set_option( m_settings, v.toUtf8().constData() );
+    }
 
     /** @brief Checks the given password @p pwd against the current configuration
      *
@@ -120,6 +131,13 @@ public:
 
     int check( const QString& pwd )
     {
+        if ( m_hasChecked && pwd == m_lastPassword )
+        {
+            return m_rv;
+        }
+        m_hasChecked = true;
+        m_lastPassword = pwd;
+
         void* auxerror = nullptr;
         m_rv = pwquality_check( m_settings, pwd.toUtf8().constData(), nullptr, nullptr, &auxerror );
 
@@ -338,6 +356,8 @@ private:
     QString m_errorString;  ///< Textual error from last call to check()
     int m_errorCount = 0;  ///< Count (used in %n) error from last call to check()
     int m_rv = 0;  ///< Return value from libpwquality
+    QString m_lastPassword;  ///< Password passed to the last call to check()
+    bool m_hasChecked = false;  ///< Is m_lastPassword meaningful?
 
     pwquality_settings_t* m_settings = nullptr;
 };
@@ -392,7 +412,8 @@ DEFINE_CHECK_FUNC( libpwquality )
                                              }
                                              return r >= settings->arbitrary_minimum_strength;
                                          },
-                                         PasswordCheck::Weight( 100 ) ) );
+                                         PasswordCheck::Weight( 100 ),
+                                         true ) );
     }
 }
 #endif
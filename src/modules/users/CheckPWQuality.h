@@ -38,8 +38,13 @@ public:
      * @p message will be shown to the user.
      *
      * @p weight is used to order the checks (low-weight goes first).
+     *
+     * An @p expensive check is one that may take a noticeable amount
+     * of time (e.g. a dictionary lookup); those are run in the background
+     * rather than on every keystroke. Expensive checks must be safe to
+     * call from a thread other than the GUI thread.
      */
-    PasswordCheck( MessageFunc message, AcceptFunc filter, Weight weight = 1000 );
+    PasswordCheck( MessageFunc message, AcceptFunc filter, Weight weight = 1000, bool expensive = false );
     /** @brief Null check, always accepts, no message */
     PasswordCheck();
 
@@ -51,10 +56,12 @@ public:
     QString filter( const QString& s ) const { return m_accept( s ) ? QString() : m_message(); }
 
     Weight weight() const { return m_weight; }
+    bool isExpensive() const { return m_expensive; }
     bool operator<( const PasswordCheck& other ) const { return weight() < other.weight(); }
 
 private:
     Weight m_weight;
+    bool m_expensive;
     MessageFunc m_message;
     AcceptFunc m_accept;
 };
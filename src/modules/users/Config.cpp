@@ -12,7 +12,6 @@
 #include "CreateUserJob.h"
 #include "MiscJobs.h"
 #include "SetHostNameJob.h"
-#include "SetPasswordJob.h"
 
 #include "GlobalStorage.h"
 #include "JobQueue.h"
@@ -22,9 +21,11 @@
 
 #include <QCoreApplication>
 #include <QFile>
+#include <QFutureWatcher>
 #include <QMetaProperty>
 #include <QRegExp>
 #include <QTimer>
+#include <QtConcurrent/QtConcurrent>
 
 #ifdef HAVE_ICU
 #include <unicode/translit.h>
@@ -38,6 +39,8 @@ static const char TRANSLITERATOR_ID[] = "Russian-Latin/BGN;"
                                         "Latin-ASCII";
 #endif
 
+#include <algorithm>
+#include <iterator>
 #include <memory>
 
 static const QRegExp USERNAME_RX( "^[a-z_][a-z0-9_-]*[$]?$" );
@@ -47,6 +50,9 @@ static const QRegExp HOSTNAME_RX( "^[a-zA-Z0-9][-a-zA-Z0-9_]*$" );
 static constexpr const int HOSTNAME_MIN_LENGTH = 2;
 static constexpr const int HOSTNAME_MAX_LENGTH = 63;
 
+/// @brief Delay (ms) after the last keystroke before running expensive password checks
+static constexpr const int PASSWORD_CHECK_DELAY = 300;
+
 static void
 updateGSAutoLogin( bool doAutoLogin, const QString& login )
 {
@@ -105,6 +111,24 @@ Config::Config( QObject* parent )
     connect( this, &Config::rootPasswordStatusChanged, this, &Config::checkReady );
     connect( this, &Config::reuseUserPasswordForRootChanged, this, &Config::checkReady );
     connect( this, &Config::requireStrongPasswordsChanged, this, &Config::checkReady );
+
+    m_passwordCheckPool.setMaxThreadCount( 1 );
+    m_userPasswordCheck.timer.setSingleShot( true );
+    m_userPasswordCheck.timer.setInterval( PASSWORD_CHECK_DELAY );
+    connect( &m_userPasswordCheck.timer, &QTimer::timeout, this, [ this ]() {
+        runPasswordCheck( m_userPasswordCheck, [ this ]() {
+            const auto p = userPasswordStatus();
+            emit userPasswordStatusChanged( p.first, p.second );
+        } );
+    } );
+    m_rootPasswordCheck.timer.setSingleShot( true );
+    m_rootPasswordCheck.timer.setInterval( PASSWORD_CHECK_DELAY );
+    connect( &m_rootPasswordCheck.timer, &QTimer::timeout, this, [ this ]() {
+        runPasswordCheck( m_rootPasswordCheck, [ this ]() {
+            const auto p = rootPasswordStatus();
+            emit rootPasswordStatusChanged( p.first, p.second );
+        } );
+    } );
 }
 
 Config::~Config() {}
@@ -501,7 +525,8 @@ Config::setUserPassword( const QString& s )
     if ( s != m_userPassword )
     {
         m_userPassword = s;
-        const auto p = passwordStatus( m_userPassword, m_userPasswordSecondary );
+        schedulePasswordCheck( m_userPasswordCheck, s );
+        const auto p = passwordStatus( m_userPassword, m_userPasswordSecondary, m_userPasswordCheck );
         emit userPasswordStatusChanged( p.first, p.second );
         emit userPasswordChanged( s );
     }
@@ -513,7 +538,7 @@ Config::setUserPasswordSecondary( const QString& s )
     if ( s != m_userPasswordSecondary )
     {
         m_userPasswordSecondary = s;
-        const auto p = passwordStatus( m_userPassword, m_userPasswordSecondary );
+        const auto p = passwordStatus( m_userPassword, m_userPasswordSecondary, m_userPasswordCheck );
         emit userPasswordStatusChanged( p.first, p.second );
         emit userPasswordSecondaryChanged( s );
     }
@@ -525,9 +550,12 @@ Config::setUserPasswordSecondary( const QString& s )
  * the secondary fields -- checks them for validity and returns
  * a pair of <validity, message>.
  *
+ * Only the cheap checks are run here; the result of the expensive
+ * checks is taken from @p state. While those are still running,
+ * the password is not (yet) considered valid.
  */
 Config::PasswordStatus
-Config::passwordStatus( const QString& pw1, const QString& pw2 ) const
+Config::passwordStatus( const QString& pw1, const QString& pw2, const PasswordCheckState& state ) const
 {
     if ( pw1 != pw2 )
     {
@@ -537,6 +565,11 @@ Config::passwordStatus( const QString& pw1, const QString& pw2 ) const
     bool failureIsFatal = requireStrongPasswords();
     for ( const auto& pc : m_passwordChecks )
     {
+        if ( pc.isExpensive() )
+        {
+            continue;
+        }
+
         QString message = pc.filter( pw1 );
 
         if ( !message.isEmpty() )
@@ -545,14 +578,96 @@ Config::passwordStatus( const QString& pw1, const QString& pw2 ) const
         }
     }
 
+    if ( m_hasExpensivePasswordChecks )
+    {
+        if ( !state.isDone( pw1 ) )
+        {
+            return qMakePair( failureIsFatal ? PasswordValidity::Invalid : PasswordValidity::Weak,
+                              tr( "Checking password quality..." ) );
+        }
+        if ( !state.message.isEmpty() )
+        {
+            return qMakePair( failureIsFatal ? PasswordValidity::Invalid : PasswordValidity::Weak, state.message );
+        }
+    }
+
     return qMakePair( PasswordValidity::Valid, tr( "OK!" ) );
 }
 
+/** @brief Start (after a short delay) the expensive checks on @p password
+ *
+ * Any evaluation that is still queued or running for @p state is
+ * now stale, and its result will be ignored.
+ */
+void
+Config::schedulePasswordCheck( PasswordCheckState& state, const QString& password )
+{
+    if ( !m_hasExpensivePasswordChecks )
+    {
+        return;
+    }
+
+    ++( *state.generation );
+    state.password = password;
+    state.message.clear();
+    state.done = false;
+    state.timer.start();
+}
+
+/** @brief Run the expensive checks for @p state in the background
+ *
+ * When they are done (and the password has not changed in the meantime)
+ * the result is stored in @p state and @p notify is called, in the
+ * GUI thread, so that it can emit the relevant status-changed signal.
+ */
+void
+Config::runPasswordCheck( PasswordCheckState& state, const std::function< void() >& notify )
+{
+    PasswordCheckList checks;
+    std::copy_if( m_passwordChecks.cbegin(),
+                  m_passwordChecks.cend(),
+                  std::back_inserter( checks ),
+                  []( const PasswordCheck& pc ) { return pc.isExpensive(); } );
+
+    const QString password = state.password;
+    const int generation = *state.generation;
+    const auto latest = state.generation;
+
+    using Watcher = QFutureWatcher< QString >;
+    auto* watcher = new Watcher( this );
+    connect( watcher, &Watcher::finished, this, [ =, &state ]() {
+        watcher->deleteLater();
+        if ( *latest != generation )
+        {
+            return;
+        }
+        state.message = watcher->result();
+        state.done = true;
+        notify();
+    } );
+    watcher->setFuture( QtConcurrent::run( &m_passwordCheckPool, [ = ]() {
+        // Skip the work if the password changed while this was queued
+        if ( *latest != generation )
+        {
+            return QString();
+        }
+        for ( const auto& pc : checks )
+        {
+            QString message = pc.filter( password );
+            if ( !message.isEmpty() )
+            {
+                return message;
+            }
+        }
+        return QString();
+    } ) );
+}
+
 
 Config::PasswordStatus
 Config::userPasswordStatus() const
 {
-    return passwordStatus( m_userPassword, m_userPasswordSecondary );
+    return passwordStatus( m_userPassword, m_userPasswordSecondary, m_userPasswordCheck );
 }
 
 int
@@ -576,7 +691,8 @@ Config::setRootPassword( const QString& s )
     if ( writeRootPassword() && s != m_rootPassword )
     {
         m_rootPassword = s;
-        const auto p = passwordStatus( m_rootPassword, m_rootPasswordSecondary );
+        schedulePasswordCheck( m_rootPasswordCheck, s );
+        const auto p = passwordStatus( m_rootPassword, m_rootPasswordSecondary, m_rootPasswordCheck );
         emit rootPasswordStatusChanged( p.first, p.second );
         emit rootPasswordChanged( s );
     }
@@ -588,7 +704,7 @@ Config::setRootPasswordSecondary( const QString& s )
     if ( writeRootPassword() && s != m_rootPasswordSecondary )
     {
         m_rootPasswordSecondary = s;
-        const auto p = passwordStatus( m_rootPassword, m_rootPasswordSecondary );
+        const auto p = passwordStatus( m_rootPassword, m_rootPasswordSecondary, m_rootPasswordCheck );
         emit rootPasswordStatusChanged( p.first, p.second );
         emit rootPasswordSecondaryChanged( s );
     }
@@ -627,7 +743,7 @@ Config::rootPasswordStatus() const
 {
     if ( writeRootPassword() && !reuseUserPasswordForRoot() )
     {
-        return passwordStatus( m_rootPassword, m_rootPasswordSecondary );
+        return passwordStatus( m_rootPassword, m_rootPasswordSecondary, m_rootPasswordCheck );
     }
     else
     {
@@ -872,6 +988,11 @@ Config::setConfigurationMap( const QVariantMap& configurationMap )
         addPasswordCheck( i.key(), i.value(), m_passwordChecks );
     }
     std::sort( m_passwordChecks.begin(), m_passwordChecks.end() );
+    m_hasExpensivePasswordChecks = std::any_of( m_passwordChecks.cbegin(),
+                                                m_passwordChecks.cend(),
+                                                []( const PasswordCheck& pc ) { return pc.isExpensive(); } );
+    schedulePasswordCheck( m_userPasswordCheck, m_userPassword );
+    schedulePasswordCheck( m_rootPasswordCheck, m_rootPassword );
 
     updateGSAutoLogin( doAutoLogin(), loginName() );
     checkReady();
@@ -911,18 +1032,9 @@ Config::createJobs() const
         jobs.append( Calamares::job_ptr( j ) );
     }
 
-    j = new SetupGroupsJob( this );
-    jobs.append( Calamares::job_ptr( j ) );
-
     j = new CreateUserJob( this );
     jobs.append( Calamares::job_ptr( j ) );
 
-    j = new SetPasswordJob( loginName(), userPassword() );
-    jobs.append( Calamares::job_ptr( j ) );
-
-    j = new SetPasswordJob( "root", rootPassword() );
-    jobs.append( Calamares::job_ptr( j ) );
-
     j = new SetHostNameJob( hostName(), hostNameActions() );
     jobs.append( Calamares::job_ptr( j ) );
 
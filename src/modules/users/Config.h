@@ -18,8 +18,14 @@
 
 #include <QList>
 #include <QObject>
+#include <QThreadPool>
+#include <QTimer>
 #include <QVariantMap>
 
+#include <atomic>
+#include <functional>
+#include <memory>
+
 enum HostNameAction
 {
     None = 0x0,
@@ -307,7 +313,27 @@ signals:
     void readyChanged( bool ) const;
 
 private:
-    PasswordStatus passwordStatus( const QString&, const QString& ) const;
+    /** @brief State of the expensive password checks for one password
+     *
+     * Expensive checks (see PasswordCheck::isExpensive()) run on a worker
+     * thread, a short while after the password stops changing. Each
+     * change bumps the generation, so that stale evaluations are skipped
+     * or their results dropped.
+     */
+    struct PasswordCheckState
+    {
+        QString password;  ///< Password that is (or was last) being checked
+        QString message;  ///< Result of the expensive checks; empty if they pass
+        bool done = false;  ///< Is @c message the result for @c password ?
+        std::shared_ptr< std::atomic< int > > generation = std::make_shared< std::atomic< int > >( 0 );
+        QTimer timer;  ///< Debounces changes to the password
+
+        bool isDone( const QString& pw ) const { return done && pw == password; }
+    };
+
+    PasswordStatus passwordStatus( const QString&, const QString&, const PasswordCheckState& ) const;
+    void schedulePasswordCheck( PasswordCheckState& state, const QString& password );
+    void runPasswordCheck( PasswordCheckState& state, const std::function< void() >& notify );
     void checkReady();
 
     QList< GroupDescription > m_defaultGroups;
@@ -339,6 +365,11 @@ private:
 
     HostNameActions m_hostNameActions;
     PasswordCheckList m_passwordChecks;
+    bool m_hasExpensivePasswordChecks = false;
+
+    PasswordCheckState m_userPasswordCheck;
+    PasswordCheckState m_rootPasswordCheck;
+    QThreadPool m_passwordCheckPool;  ///< Single thread, so checks never run concurrently
 };
 
 #endif
@@ -7,6 +7,7 @@
 
 #include "CreateUserJob.h"
 
+#include "AccountFiles.h"
 #include "Config.h"
 
 #include "GlobalStorage.h"
@@ -17,10 +18,13 @@
 
 #include <QDateTime>
 #include <QDir>
+#include <QDirIterator>
 #include <QFile>
 #include <QFileInfo>
 #include <QTextStream>
 
+#include <unistd.h>
+
 
 CreateUserJob::CreateUserJob( const Config* config )
     : Calamares::Job()
@@ -49,8 +53,13 @@ CreateUserJob::prettyStatusMessage() const
     return m_status.isEmpty() ? tr( "Creating user %1" ).arg( m_config->loginName() ) : m_status;
 }
 
+/** @brief Create the user, already a member of @p groups
+ *
+ * The groups must exist; useradd's -G adds the memberships while it
+ * is writing the group file anyway, so there is no separate usermod.
+ */
 static Calamares::JobResult
-createUser( const QString& loginName, const QString& fullName, const QString& shell )
+createUser( const QString& loginName, const QString& fullName, const QString& shell, const QStringList& groups )
 {
     QStringList useraddCommand;
 #ifdef __FreeBSD__
@@ -62,6 +71,10 @@ createUser( const QString& loginName, const QString& fullName, const QString& sh
     {
         useraddCommand << "-s" << shell;
     }
+    if ( !groups.isEmpty() )
+    {
+        useraddCommand << "-G" << groups.join( ',' );
+    }
 #else
     useraddCommand << "useradd"
                    << "-m"
@@ -70,6 +83,10 @@ createUser( const QString& loginName, const QString& fullName, const QString& sh
     {
         useraddCommand << "-s" << shell;
     }
+    if ( !groups.isEmpty() )
+    {
+        useraddCommand << "-G" << groups.join( ',' );
+    }
     useraddCommand << "-c" << fullName;
     useraddCommand << loginName;
 #endif
@@ -83,28 +100,52 @@ createUser( const QString& loginName, const QString& fullName, const QString& sh
     return Calamares::JobResult::ok();
 }
 
-static Calamares::JobResult
-setUserGroups( const QString& loginName, const QStringList& groups )
+/** @brief Create the groups the user needs in the target system at @p root
+ *
+ * The group file is read once, and written once with all the new groups.
+ */
+STATICTEST Calamares::JobResult
+createGroups( const QString& root, const Config* config )
 {
-    QStringList setgroupsCommand;
-#ifdef __FreeBSD__
-    setgroupsCommand << "pw"
-                     << "usermod"
-                     << "-n" << loginName << "-G" << groups.join( ',' );
-#else
-    setgroupsCommand << "usermod"
-                     << "-aG" << groups.join( ',' ) << loginName;
-#endif
+    AccountFiles accounts( root );
+    if ( !accounts.lock() )
+    {
+        return Calamares::JobResult::error( CreateUserJob::tr( "Could not create groups in target system" ) );
+    }
 
-    auto commandResult = CalamaresUtils::System::instance()->targetEnvCommand( setgroupsCommand );
-    if ( commandResult.getExitCode() )
+    QStringList missingGroups;
+    if ( !accounts.addGroups( config->defaultGroups(), missingGroups ) )
+    {
+        return Calamares::JobResult::error(
+            CreateUserJob::tr( "Could not create groups in target system" ),
+            CreateUserJob::tr( "These groups are missing in the target system: %1" ).arg( missingGroups.join( ',' ) ) );
+    }
+    if ( config->doAutoLogin() && !config->autoLoginGroup().isEmpty() )
     {
-        cError() << "usermod failed" << commandResult.getExitCode();
-        return commandResult.explainProcess( setgroupsCommand, std::chrono::seconds( 10 ) /* bogus timeout */ );
+        (void)accounts.addGroups( { GroupDescription( config->autoLoginGroup() ) }, missingGroups );
+    }
+
+    if ( !accounts.write() )
+    {
+        return Calamares::JobResult::error( CreateUserJob::tr( "Could not create groups in target system" ) );
     }
     return Calamares::JobResult::ok();
 }
 
+/// @brief Give everything in @p path to @p uid and @p gid, without following symlinks
+static bool
+chownRecursive( const QString& path, uint uid, uint gid )
+{
+    bool ok = ::lchown( QFile::encodeName( path ).constData(), uid, gid ) == 0;
+    QDirIterator it( path, QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot,
+                     QDirIterator::Subdirectories );
+    while ( it.hasNext() )
+    {
+        ok = ( ::lchown( QFile::encodeName( it.next() ).constData(), uid, gid ) == 0 ) && ok;
+    }
+    return ok;
+}
+
 
 Calamares::JobResult
 CreateUserJob::exec()
@@ -118,6 +159,14 @@ CreateUserJob::exec()
         reuseHome = gs->value( "reuseHome" ).toBool();
     }
 
+    m_status = tr( "Preparing groups." );
+    emit progress( 0.1 );
+    auto groupsResult = createGroups( destDir.absolutePath(), m_config );
+    if ( !groupsResult )
+    {
+        return groupsResult;
+    }
+
     // If we're looking to reuse the contents of an existing /home.
     // This GS setting comes from the **partitioning** module.
     if ( reuseHome )
@@ -141,29 +190,41 @@ CreateUserJob::exec()
 
     m_status = tr( "Creating user %1" ).arg( m_config->loginName() );
     emit progress( 0.5 );
-    auto useraddResult = createUser( m_config->loginName(), m_config->fullName(), m_config->userShell() );
+    auto useraddResult = createUser(
+        m_config->loginName(), m_config->fullName(), m_config->userShell(), m_config->groupsForThisUser() );
     if ( !useraddResult )
     {
         return useraddResult;
     }
 
     m_status = tr( "Configuring user %1" ).arg( m_config->loginName() );
-    emit progress( 0.8 );
-    auto usergroupsResult = setUserGroups( m_config->loginName(), m_config->groupsForThisUser() );
-    if ( !usergroupsResult )
+    emit progress( 0.7 );
+    auto passwordResult = AccountFiles::setPasswords(
+        destDir.absolutePath(),
+        { qMakePair( m_config->loginName(), m_config->userPassword() ),
+          qMakePair( QStringLiteral( "root" ), m_config->rootPassword() ) } );
+    if ( !passwordResult )
     {
-        return usergroupsResult;
+        return passwordResult;
     }
 
     m_status = tr( "Setting file permissions" );
     emit progress( 0.9 );
-    QString userGroup = QString( "%1:%2" ).arg( m_config->loginName() ).arg( m_config->loginName() );
-    QString homeDir = QString( "/home/%1" ).arg( m_config->loginName() );
-    auto commandResult = CalamaresUtils::System::instance()->targetEnvCommand( { "chown", "-R", userGroup, homeDir } );
-    if ( commandResult.getExitCode() )
+    uint uid = 0;
+    uint gid = 0;
+    {
+        AccountFiles accounts( destDir.absolutePath() );
+        if ( !accounts.userIds( m_config->loginName(), uid, gid ) )
+        {
+            return Calamares::JobResult::error(
+                tr( "Cannot find user %1 in the target system." ).arg( m_config->loginName() ) );
+        }
+    }
+    QString homeDir = destDir.absoluteFilePath( QStringLiteral( "home/%1" ).arg( m_config->loginName() ) );
+    if ( !chownRecursive( homeDir, uid, gid ) )
     {
-        cError() << "chown failed" << commandResult.getExitCode();
-        return commandResult.explainProcess( "chown", std::chrono::seconds( 10 ) /* bogus timeout */ );
+        cError() << "chown failed for" << homeDir;
+        return Calamares::JobResult::error( tr( "Cannot set the owner of the home directory %1." ).arg( homeDir ) );
     }
 
     return Calamares::JobResult::ok();
@@ -34,17 +34,4 @@ public:
     Config::SudoStyle m_sudoStyle;
 };
 
-class SetupGroupsJob : public Calamares::Job
-{
-    Q_OBJECT
-
-public:
-    SetupGroupsJob( const Config* config );
-    QString prettyName() const override;
-    Calamares::JobResult exec() override;
-
-public:
-    const Config* m_config;
-};
-
 #endif
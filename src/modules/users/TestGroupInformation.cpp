@@ -7,6 +7,7 @@
  *
  */
 
+#include "AccountFiles.h"
 #include "Config.h"
 #include "CreateUserJob.h"
 #include "MiscJobs.h"
@@ -17,10 +18,16 @@
 #include "utils/Yaml.h"
 
 #include <QDir>
+#include <QTemporaryDir>
 #include <QtTest/QtTest>
 
+#ifndef NO_CRYPT_H
+#include <crypt.h>
+#endif
+#include <sys/stat.h>
+
 // Implementation details
-extern QStringList groupsInTargetSystem();  // CreateUserJob
+extern Calamares::JobResult createGroups( const QString& root, const Config* config );  // CreateUserJob
 
 class GroupTests : public QObject
 {
@@ -33,7 +40,10 @@ private Q_SLOTS:
     void initTestCase();
 
     void testReadGroup();
+    void testAddGroup();
     void testCreateGroup();
+    void testMissingGroup();
+    void testPasswords();
 
     void testSudoGroup();
     void testJobCreation();
@@ -41,6 +51,62 @@ private Q_SLOTS:
 
 GroupTests::GroupTests() {}
 
+/// @brief Write @p contents to @p path in the fake target system @p root
+static void
+writeFile( const QTemporaryDir& root, const QString& path, const QByteArray& contents, int mode = 0644 )
+{
+    QDir( root.path() ).mkpath( QFileInfo( root.filePath( path ) ).path() );
+    QFile f( root.filePath( path ) );
+    QVERIFY( f.open( QIODevice::WriteOnly ) );
+    f.write( contents );
+    f.close();
+    QCOMPARE( ::chmod( QFile::encodeName( f.fileName() ).constData(), mode_t( mode ) ), 0 );
+}
+
+static QByteArray
+readFile( const QTemporaryDir& root, const QString& path )
+{
+    QFile f( root.filePath( path ) );
+    return f.open( QIODevice::ReadOnly ) ? f.readAll() : QByteArray();
+}
+
+/// @brief A fake target system with a handful of groups and users
+static void
+fakeTarget( const QTemporaryDir& root )
+{
+    writeFile( root,
+               "etc/group",
+               "root:x:0:\n"
+               "# A comment\n"
+               "adm:x:4:\n"
+               "bar:x:998:\n"
+               "users:x:100:\n"
+               "goodj:x:1000:\n" );
+    writeFile( root,
+               "etc/gshadow",
+               "root:::\n"
+               "adm:::\n"
+               "bar:!::\n"
+               "users:!::\n"
+               "goodj:!::\n",
+               0640 );
+    writeFile( root,
+               "etc/passwd",
+               "root:x:0:0:root:/root:/bin/bash\n"
+               "goodj:x:1000:1000:Goodluck Jonathan:/home/goodj:/bin/bash\n" );
+    writeFile( root,
+               "etc/shadow",
+               "root:*:18900:0:99999:7:::\n"
+               "goodj:!:18900:0:99999:7:::\n",
+               0640 );
+    writeFile( root,
+               "etc/login.defs",
+               "# Group ids\n"
+               "GID_MIN\t\t\t 1000\n"
+               "GID_MAX\t\t\t60000\n"
+               "SYS_GID_MAX\t\t  999\n" );
+}
+
 void
 GroupTests::initTestCase()
 {
@@ -57,7 +123,9 @@ void
 GroupTests::testReadGroup()
 {
     // Get the groups in the host system
-    QStringList groups = groupsInTargetSystem();
+    // Only the group file is read, which needs no privileges
+    AccountFiles accounts( QStringLiteral( "/" ) );
+    QStringList groups = accounts.groupNames();
     QVERIFY( groups.count() > 2 );
 #ifdef __FreeBSD__
     QVERIFY( groups.contains( QStringLiteral( "wheel" ) ) );
@@ -75,6 +143,46 @@ GroupTests::testReadGroup()
     }
 }
 
+void
+GroupTests::testAddGroup()
+{
+    QTemporaryDir root;
+    QVERIFY( root.isValid() );
+    fakeTarget( root );
+
+    AccountFiles accounts( root.path() );
+    QVERIFY( accounts.lock() );
+    QCOMPARE( accounts.groupNames(), QStringList( { "root", "adm", "bar", "users", "goodj" } ) );
+
+    // System groups from the top of the system range down, skipping used ones
+    QCOMPARE( accounts.addGroup( "sys1", true ), 999 );
+    QCOMPARE( accounts.addGroup( "sys2", true ), 997 );
+    // User groups after the highest one in use
+    QCOMPARE( accounts.addGroup( "user1", false ), 1001 );
+    QCOMPARE( accounts.addGroup( "user2", false ), 1002 );
+    // Existing (or bogus) groups are not added
+    QCOMPARE( accounts.addGroup( "adm", true ), -1 );
+    QCOMPARE( accounts.addGroup( "sys1", false ), -1 );
+    QCOMPARE( accounts.addGroup( "a:b", false ), -1 );
+
+    // Nothing is written until asked to
+    QVERIFY( !readFile( root, "etc/group" ).contains( "sys1" ) );
+    QVERIFY( accounts.write() );
+    accounts.unlock();
+
+    const QByteArray group = readFile( root, "etc/group" );
+    QVERIFY( group.startsWith( "root:x:0:\n# A comment\n" ) );
+    QVERIFY( group.endsWith( "sys1:x:999:\nsys2:x:997:\nuser1:x:1001:\nuser2:x:1002:\n" ) );
+    QVERIFY( readFile( root, "etc/gshadow" ).endsWith( "sys1:!::\nsys2:!::\nuser1:!::\nuser2:!::\n" ) );
+    // The old files are kept, and the mode of gshadow is preserved
+    QVERIFY( !readFile( root, "etc/group-" ).contains( "sys1" ) );
+    QVERIFY( readFile( root, "etc/group-" ).contains( "goodj" ) );
+    QCOMPARE( QFileInfo( root.filePath( "etc/gshadow" ) ).permissions(),
+              QFileDevice::ReadOwner | QFileDevice::WriteOwner | QFileDevice::ReadUser | QFileDevice::WriteUser
+                  | QFileDevice::ReadGroup );
+    QVERIFY( !QFile::exists( root.filePath( "etc/group+" ) ) );
+}
+
 void
 GroupTests::testCreateGroup()
 {
@@ -94,10 +202,95 @@ GroupTests::testCreateGroup()
     QVERIFY( c.defaultGroups().contains( QStringLiteral( "adm" ) ) );
     QVERIFY( c.defaultGroups().contains( QStringLiteral( "bar" ) ) );
 
-    Calamares::JobQueue::instance()->globalStorage()->insert( "rootMountPoint", "/" );
+    QTemporaryDir root;
+    QVERIFY( root.isValid() );
+    fakeTarget( root );
+
+    // adm and bar are there, foo is a system group, foobar a regular one
+    QVERIFY( createGroups( root.path(), &c ) );
+    const QByteArray group = readFile( root, "etc/group" );
+    QVERIFY( group.endsWith( "goodj:x:1000:\nfoo:x:999:\nfoobar:x:1001:\n" ) );
+
+    // Second time around, nothing changes
+    QVERIFY( createGroups( root.path(), &c ) );
+    QCOMPARE( readFile( root, "etc/group" ), group );
+
+    // The autologin group comes along if needed
+    c.setAutoLoginGroup( QStringLiteral( "autologin" ) );
+    QVERIFY( createGroups( root.path(), &c ) );
+    QCOMPARE( readFile( root, "etc/group" ), group );
+    c.setAutoLogin( true );
+    QVERIFY( createGroups( root.path(), &c ) );
+    QVERIFY( readFile( root, "etc/group" ).endsWith( "foobar:x:1001:\nautologin:x:1002:\n" ) );
+
+    // Groups don't need the shadow file (a directory can't be read as one)
+    QVERIFY( QFile::remove( root.filePath( "etc/shadow" ) ) );
+    QVERIFY( QDir( root.path() ).mkpath( "etc/shadow" ) );
+    c.setAutoLoginGroup( QStringLiteral( "autologin2" ) );
+    QVERIFY( createGroups( root.path(), &c ) );
+    QVERIFY( readFile( root, "etc/group" ).endsWith( "autologin:x:1002:\nautologin2:x:1003:\n" ) );
+    AccountFiles accounts( root.path() );
+    QVERIFY( accounts.hasGroup( "autologin2" ) );
+    QVERIFY( accounts.passwordHash( "root" ).isEmpty() );
+    QVERIFY( !accounts.setPasswordHash( "root", "!" ) );
+}
+
+void
+GroupTests::testMissingGroup()
+{
+    QFile fi( QString( "%1/tests/5-issue-1523.conf" ).arg( BUILD_AS_TEST ) );
+    bool ok = false;
+    const auto map = CalamaresUtils::loadYaml( fi, &ok );
+    QVERIFY( ok );
+
+    Config c;
+    c.setConfigurationMap( map );
+
+    QTemporaryDir root;
+    QVERIFY( root.isValid() );
+    fakeTarget( root );
 
-    SetupGroupsJob j( &c );
-    QVERIFY( !j.exec() );  // running as regular user this should fail
+    // bar must already exist; if it doesn't, nothing is written at all
+    writeFile( root, "etc/group", "root:x:0:\nadm:x:4:\n" );
+    QVERIFY( !createGroups( root.path(), &c ) );
+    QCOMPARE( readFile( root, "etc/group" ), QByteArray( "root:x:0:\nadm:x:4:\n" ) );
+
+    // No target system at all
+    QTemporaryDir empty;
+    QVERIFY( !createGroups( empty.path(), &c ) );
+}
+
+void
+GroupTests::testPasswords()
+{
+    QTemporaryDir root;
+    QVERIFY( root.isValid() );
+    fakeTarget( root );
+
+    QVERIFY( AccountFiles::setPasswords( root.path(), { qMakePair( QString( "goodj" ), QString( "secret" ) ) } ) );
+    {
+        AccountFiles accounts( root.path() );
+        const QString hash = accounts.passwordHash( "goodj" );
+        QVERIFY( hash.startsWith( "$6$" ) );
+        QCOMPARE( QString::fromLatin1( crypt( "secret", hash.toLatin1() ) ), hash );
+        QCOMPARE( accounts.passwordHash( "root" ), QStringLiteral( "*" ) );
+    }
+    QVERIFY( readFile( root, "etc/shadow" ).endsWith( ":18900:0:99999:7:::\n" ) );
+
+    // Root with an empty password is disabled; unknown users fail
+    QVERIFY( AccountFiles::setPasswords( root.path(), { qMakePair( QString( "root" ), QString() ) } ) );
+    {
+        AccountFiles accounts( root.path() );
+        QCOMPARE( accounts.passwordHash( "root" ), QStringLiteral( "!" ) );
+
+        uint uid = 0;
+        uint gid = 0;
+        QVERIFY( accounts.userIds( "goodj", uid, gid ) );
+        QCOMPARE( uid, 1000u );
+        QCOMPARE( gid, 1000u );
+        QVERIFY( !accounts.userIds( "nobody", uid, gid ) );
+    }
+    QVERIFY( !AccountFiles::setPasswords( root.path(), { qMakePair( QString( "nobody" ), QString( "x" ) ) } ) );
 }
 
 void
@@ -145,16 +338,13 @@ GroupTests::testSudoGroup()
 /** @brief Are all the expected jobs (and no others) created?
  *
  * - A sudo job is created only when the sudoers group is set;
- * - Groups job
- * - User job
- * - Password job
- * - Root password job
+ * - User job (which also does the groups and passwords)
  * - Hostname job are always created.
  */
 void
 GroupTests::testJobCreation()
 {
-    const int expectedJobs = 5;
+    const int expectedJobs = 2;
     Config c;
     QVERIFY( !c.isReady() );
 
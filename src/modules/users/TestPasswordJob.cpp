@@ -7,7 +7,7 @@
  *
  */
 
-#include "SetPasswordJob.h"
+#include "AccountFiles.h"
 
 #include <QtTest/QtTest>
 
@@ -35,13 +35,13 @@ PasswordTests::initTestCase()
 void
 PasswordTests::testSalt()
 {
-    QString s = SetPasswordJob::make_salt( 8 );
+    QString s = AccountFiles::makeSalt( 8 );
     QCOMPARE( s.length(), 4 + 8 );  // 8 salt chars, plus $6$, plus trailing $
     QVERIFY( s.startsWith( "$6$" ) );
     QVERIFY( s.endsWith( '$' ) );
     qDebug() << "Obtained salt" << s;
 
-    s = SetPasswordJob::make_salt( 11 );
+    s = AccountFiles::makeSalt( 11 );
     QCOMPARE( s.length(), 4 + 11 );
     QVERIFY( s.startsWith( "$6$" ) );
     QVERIFY( s.endsWith( '$' ) );
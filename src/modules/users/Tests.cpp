@@ -44,6 +44,7 @@ private Q_SLOTS:
     void testHostActions();
     void testPasswordChecks();
     void testUserPassword();
+    void testExpensivePasswordChecks();
 
     void testAutoLogin_data();
     void testAutoLogin();
@@ -342,6 +343,57 @@ UserTests::testUserPassword()
     }
 }
 
+void
+UserTests::testExpensivePasswordChecks()
+{
+#ifdef CHECK_PWQUALITY
+    if ( !Calamares::JobQueue::instance() )
+    {
+        (void)new Calamares::JobQueue( nullptr );
+    }
+
+    Config c;
+
+    QVariantMap m;
+    QVariantMap pwreq;
+    pwreq.insert( "minLength", 2 );
+    pwreq.insert( "libpwquality", QStringList { "minlen=12" } );
+    m.insert( "passwordRequirements", pwreq );
+    c.setConfigurationMap( m );
+
+    QSignalSpy spy_pwStatusChanged( &c, &Config::userPasswordStatusChanged );
+
+    // Cheap checks give an answer right away
+    c.setUserPassword( "x" );
+    c.setUserPasswordSecondary( "x" );
+    QCOMPARE( c.userPasswordValidity(), int( Config::PasswordValidity::Invalid ) );
+    QCOMPARE( c.userPasswordMessage(), QStringLiteral( "Password is too short" ) );
+
+    // The libpwquality check is pending until the password stops changing
+    c.setUserPassword( "abcd" );
+    c.setUserPasswordSecondary( "abcd" );
+    c.setUserPassword( "abcde" );
+    c.setUserPasswordSecondary( "abcde" );
+    QCOMPARE( c.userPasswordValidity(), int( Config::PasswordValidity::Invalid ) );
+    QCOMPARE( c.userPasswordMessage(), QStringLiteral( "Checking password quality..." ) );
+
+    // Only the last password gets a result
+    spy_pwStatusChanged.clear();
+    QVERIFY( spy_pwStatusChanged.wait( 5000 ) );
+    QCOMPARE( c.userPasswordValidity(), int( Config::PasswordValidity::Invalid ) );
+    QVERIFY( c.userPasswordMessage() != QStringLiteral( "Checking password quality..." ) );
+    QTest::qWait( 500 );
+    QCOMPARE( spy_pwStatusChanged.count(), 1 );
+
+    c.setUserPassword( "Tr0ub4dor&3-horse" );
+    c.setUserPasswordSecondary( "Tr0ub4dor&3-horse" );
+    QVERIFY( spy_pwStatusChanged.wait( 5000 ) );
+    QCOMPARE( c.userPasswordValidity(), int( Config::PasswordValidity::Valid ) );
+#else
+    QSKIP( "libpwquality is not available." );
+#endif
+}
+
 void
 UserTests::testAutoLogin_data()
 {
@@ -34,6 +34,17 @@ Config::Config( QObject* parent )
     CALAMARES_RETRANSLATE_SLOT( &Config::retranslate );
     // But also when the requirements model changes, update the messages
     connect( requirementsModel(), &Calamares::RequirementsModel::progressMessageChanged, this, &Config::retranslate );
+    // Requirements that are checked again later update the model in-place
+    connect( m_requirementsChecker.get(),
+             &GeneralRequirements::requirementChanged,
+             this,
+             [ this ]( const Calamares::RequirementEntry& entry ) {
+                 if ( auto* model = requirementsModel() )
+                 {
+                     model->updateRequirement( entry );
+                     retranslate();
+                 }
+             } );
 }
 
 void
@@ -361,9 +372,7 @@ setGeoIP( Config* config, const QVariantMap& configurationMap )
     {
         using FWString = QFutureWatcher< QString >;
 
-        auto* handler = new CalamaresUtils::GeoIP::Handler( CalamaresUtils::getString( geoip, "style" ),
-                                                            CalamaresUtils::getString( geoip, "url" ),
-                                                            CalamaresUtils::getString( geoip, "selector" ) );
+        auto* handler = new CalamaresUtils::GeoIP::Handler( geoip );
         if ( handler->type() != CalamaresUtils::GeoIP::Handler::Type::None )
         {
             auto* future = new FWString();
@@ -8,6 +8,7 @@
  */
 
 #include "Config.h"
+#include "checker/GeneralRequirements.h"
 
 #include "Branding.h"
 #include "Settings.h"
@@ -16,8 +17,11 @@
 #include "utils/Logger.h"
 #include "utils/Yaml.h"
 
+#include <QSignalSpy>
 #include <QtTest/QtTest>
 
+#include <unistd.h>
+
 class WelcomeTests : public QObject
 {
     Q_OBJECT
@@ -33,6 +37,10 @@ private Q_SLOTS:
     void testUrls();
 
     void testBadConfigDoesNotResetUrls();
+
+    void testRequirementsCache();
+    void testRequirementsRecheck();
+    void testRequirementsPoll();
 };
 
 WelcomeTests::WelcomeTests() {}
@@ -53,6 +61,8 @@ WelcomeTests::initTestCase()
     {
         (void)new Calamares::Settings( true );
     }
+
+    qRegisterMetaType< Calamares::RequirementEntry >();
 }
 
 void
@@ -159,6 +169,109 @@ WelcomeTests::testBadConfigDoesNotResetUrls()
     QCOMPARE( nam.getCheckInternetUrls().count(), 1 );
 }
 
+/// @brief Requirements that are cheap to check, needing @p ram GiB of memory
+static QVariantMap
+requirementsConfig( double ram )
+{
+    return QVariantMap { { "check", QVariantList { "root", "ram" } },
+                         { "required", QVariantList {} },
+                         { "requiredRam", ram },
+                         { "internetCheckUrl", QVariantList { "http://example.com" } } };
+}
+
+void
+WelcomeTests::testRequirementsCache()
+{
+    GeneralRequirements r;
+    r.setConfigurationMap( requirementsConfig( 0.0 ) );
+
+    auto list = r.checkRequirements();
+    QCOMPARE( list.count(), 2 );
+    QCOMPARE( list.at( 0 ).name, QStringLiteral( "root" ) );
+    QCOMPARE( list.at( 0 ).satisfied, geteuid() == 0 );
+    QCOMPARE( list.at( 1 ).name, QStringLiteral( "ram" ) );
+    QVERIFY( list.at( 1 ).satisfied );
+    QCOMPARE( r.m_results.count(), 2 );
+
+    // The second time round, the cached result is used (even if it is wrong)
+    r.m_results.insert( QStringLiteral( "ram" ), false );
+    list = r.checkRequirements();
+    QVERIFY( !list.at( 1 ).satisfied );
+
+    // A new configuration invalidates the cache
+    r.setConfigurationMap( requirementsConfig( 1e6 ) );
+    QVERIFY( r.m_results.isEmpty() );
+    list = r.checkRequirements();
+    QVERIFY( !list.at( 1 ).satisfied );
+    r.setConfigurationMap( requirementsConfig( 0.0 ) );
+    list = r.checkRequirements();
+    QVERIFY( list.at( 1 ).satisfied );
+}
+
+void
+WelcomeTests::testRequirementsRecheck()
+{
+    GeneralRequirements r;
+    r.setConfigurationMap( requirementsConfig( 0.0 ) );
+    r.checkRequirements();
+    QCoreApplication::processEvents();  // Watching starts in the event loop
+    QVERIFY( r.m_watching );
+
+    QSignalSpy spy( &r, &GeneralRequirements::requirementChanged );
+    QVERIFY( spy.isValid() );
+
+    // Pretend that RAM was short; checking again finds that it isn't
+    r.m_results.insert( QStringLiteral( "ram" ), false );
+    r.scheduleRecheck( QStringLiteral( "ram" ) );
+    QVERIFY( spy.wait( 5000 ) );
+    QCOMPARE( spy.count(), 1 );
+    const auto entry = spy.at( 0 ).at( 0 ).value< Calamares::RequirementEntry >();
+    QCOMPARE( entry.name, QStringLiteral( "ram" ) );
+    QVERIFY( entry.satisfied );
+    QVERIFY( r.m_results.value( QStringLiteral( "ram" ) ) );
+
+    // Checking again, with the same result, is quiet
+    r.scheduleRecheck( QStringLiteral( "ram" ) );
+    QVERIFY( !spy.wait( 1500 ) );
+    QCOMPARE( spy.count(), 1 );
+
+    // A check that finishes after the configuration changed is dropped
+    r.m_results.insert( QStringLiteral( "ram" ), false );
+    r.m_pendingRechecks.insert( QStringLiteral( "ram" ) );
+    r.recheck();
+    r.setConfigurationMap( requirementsConfig( 0.0 ) );
+    QVERIFY( !spy.wait( 1500 ) );
+    QCOMPARE( spy.count(), 1 );
+    QVERIFY( !r.m_results.contains( QStringLiteral( "ram" ) ) );
+}
+
+void
+WelcomeTests::testRequirementsPoll()
+{
+    GeneralRequirements r;
+    r.setConfigurationMap( requirementsConfig( 0.0 ) );
+    r.setPollInterval( 100 );
+    QCOMPARE( r.pollInterval(), 100 );
+    r.checkRequirements();
+    QCoreApplication::processEvents();
+    QVERIFY( r.m_watching );
+
+    QSignalSpy spy( &r, &GeneralRequirements::requirementChanged );
+    QVERIFY( spy.isValid() );
+
+    // Nothing announces changes in RAM, so poll for them
+    r.m_results.insert( QStringLiteral( "ram" ), false );
+    r.startPolling( { QStringLiteral( "ram" ) } );
+    QVERIFY( spy.wait( 5000 ) );
+    const auto entry = spy.at( 0 ).at( 0 ).value< Calamares::RequirementEntry >();
+    QCOMPARE( entry.name, QStringLiteral( "ram" ) );
+    QVERIFY( entry.satisfied );
+
+    // Polling goes on, but nothing changes
+    QVERIFY( !spy.wait( 1500 ) );
+    QCOMPARE( spy.count(), 1 );
+}
+
 
 QTEST_GUILESS_MAIN( WelcomeTests )
 
@@ -86,6 +86,10 @@ WelcomePage::WelcomePage( Config* config, QWidget* parent )
              &Calamares::RequirementsModel::progressMessageChanged,
              m_checkingWidget,
              &CheckerContainer::requirementsProgress );
+    connect( Calamares::ModuleManager::instance()->requirementsModel(),
+             &Calamares::RequirementsModel::dataChanged,
+             m_checkingWidget,
+             &CheckerContainer::requirementsChanged );
 }
 
 void
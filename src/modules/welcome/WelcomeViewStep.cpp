@@ -15,6 +15,7 @@
 
 #include "Branding.h"
 #include "modulesystem/ModuleManager.h"
+#include "modulesystem/RequirementsModel.h"
 #include "utils/Logger.h"
 #include "utils/Variant.h"
 
@@ -29,6 +30,10 @@ WelcomeViewStep::WelcomeViewStep( QObject* parent )
              &Calamares::ModuleManager::requirementsComplete,
              this,
              &WelcomeViewStep::nextStatusChanged );
+    connect( Calamares::ModuleManager::instance()->requirementsModel(),
+             &Calamares::RequirementsModel::satisfiedMandatoryChanged,
+             this,
+             &WelcomeViewStep::nextStatusChanged );
     connect( m_conf, &Config::localeIndexChanged, m_widget, &WelcomePage::externallySelectedLanguage );
 }
 
@@ -85,6 +85,25 @@ CheckerContainer::requirementsProgress( const QString& message )
     }
 }
 
+void
+CheckerContainer::requirementsChanged()
+{
+    if ( !m_checkerWidget )
+    {
+        // Still waiting for the initial results
+        return;
+    }
+
+    layout()->removeWidget( m_checkerWidget );
+    m_checkerWidget->deleteLater();
+
+    m_checkerWidget = new ResultsListWidget( m_config, this );
+    m_checkerWidget->setObjectName( "requirementsChecker" );
+    layout()->addWidget( m_checkerWidget );
+
+    m_verdict = m_config->requirementsModel()->satisfiedMandatory();
+}
+
 bool
 CheckerContainer::verdict() const
 {
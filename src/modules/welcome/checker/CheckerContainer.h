@@ -43,6 +43,12 @@ public slots:
 
     void requirementsProgress( const QString& message );
 
+    /** @brief A requirement was checked again after completion
+     *
+     * Rebuilds the list view from the model, and updates the verdict.
+     */
+    void requirementsChanged();
+
 protected:
     WaitingWidget* m_waitingWidget;
     ResultsListWidget* m_checkerWidget;
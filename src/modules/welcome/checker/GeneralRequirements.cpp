@@ -13,11 +13,11 @@
 #include "GeneralRequirements.h"
 
 #include "CheckerContainer.h"
-#include "partman_devices.h"
 
 #include "Settings.h"
 #include "modulesystem/Requirement.h"
 #include "network/Manager.h"
+#include "partition/DeviceInventory.h"
 #include "utils/CalamaresUtilsGui.h"
 #include "utils/CalamaresUtilsSystem.h"
 #include "utils/Logger.h"
@@ -30,12 +30,18 @@
 #include "JobQueue.h"
 
 #include <QDBusConnection>
+#include <QDBusConnectionInterface>
 #include <QDBusInterface>
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QFutureWatcher>
 #include <QGuiApplication>
 #include <QScreen>
+#include <QTimer>
+#include <QtConcurrent/QtConcurrent>
+
+#include <algorithm>
 
 #include <unistd.h>  //geteuid
 
@@ -93,128 +99,367 @@ operator<<( QDebug& s, const MaybeChecked& c )
     return s;
 }
 
-Calamares::RequirementsList
-GeneralRequirements::checkRequirements()
+bool
+GeneralRequirements::evaluate( const QString& entry, qreal requiredStorageGiB, qreal requiredRamGiB )
 {
-    QSize availableSize = biggestSingleScreen();
-
-    MaybeChecked enoughStorage;
-    MaybeChecked enoughRam;
-    MaybeChecked hasPower;
-    MaybeChecked hasInternet;
-    MaybeChecked isRoot;
-    bool enoughScreen = availableSize.isValid() && ( availableSize.width() >= CalamaresUtils::windowMinimumWidth )
-        && ( availableSize.height() >= CalamaresUtils::windowMinimumHeight );
-
-    qint64 requiredStorageB = CalamaresUtils::GiBtoBytes( m_requiredStorageGiB );
-    if ( m_entriesToCheck.contains( "storage" ) )
+    if ( entry == "storage" )
     {
-        enoughStorage = checkEnoughStorage( requiredStorageB );
+        return checkEnoughStorage( CalamaresUtils::GiBtoBytes( requiredStorageGiB ) );
     }
-
-    qint64 requiredRamB = CalamaresUtils::GiBtoBytes( m_requiredRamGiB );
-    if ( m_entriesToCheck.contains( "ram" ) )
+    else if ( entry == "ram" )
     {
-        enoughRam = checkEnoughRam( requiredRamB );
+        return checkEnoughRam( CalamaresUtils::GiBtoBytes( requiredRamGiB ) );
     }
-
-    if ( m_entriesToCheck.contains( "power" ) )
+    else if ( entry == "power" )
+    {
+        return checkHasPower();
+    }
+    else if ( entry == "internet" )
+    {
+        return checkHasInternet();
+    }
+    else if ( entry == "root" )
+    {
+        return checkIsRoot();
+    }
+    else if ( entry == "screen" )
     {
-        hasPower = checkHasPower();
+        return checkEnoughScreen();
     }
+    return false;
+}
 
-    if ( m_entriesToCheck.contains( "internet" ) )
+bool
+GeneralRequirements::cachedResult( const QString& entry )
+{
     {
-        hasInternet = checkHasInternet();
+        QMutexLocker lock( &m_resultsMutex );
+        auto it = m_results.constFind( entry );
+        if ( it != m_results.constEnd() )
+        {
+            return it.value();
+        }
     }
+    const bool result = evaluate( entry, m_requiredStorageGiB, m_requiredRamGiB );
+    QMutexLocker lock( &m_resultsMutex );
+    m_results.insert( entry, result );
+    return result;
+}
 
-    if ( m_entriesToCheck.contains( "root" ) )
+Calamares::RequirementEntry
+GeneralRequirements::makeEntry( const QString& entry, bool satisfied ) const
+{
+    if ( entry == "storage" )
     {
-        isRoot = checkIsRoot();
+        return { entry,
+                 [ req = m_requiredStorageGiB ] { return tr( "has at least %1 GiB available drive space" ).arg( req ); },
+                 [ req = m_requiredStorageGiB ] {
+                     return tr( "There is not enough drive space. At least %1 GiB is required." ).arg( req );
+                 },
+                 satisfied,
+                 m_entriesToRequire.contains( entry ) };
     }
+    else if ( entry == "ram" )
+    {
+        return { entry,
+                 [ req = m_requiredRamGiB ] { return tr( "has at least %1 GiB working memory" ).arg( req ); },
+                 [ req = m_requiredRamGiB ] {
+                     return tr( "The system does not have enough working memory. At least %1 GiB is required." )
+                         .arg( req );
+                 },
+                 satisfied,
+                 m_entriesToRequire.contains( entry ) };
+    }
+    else if ( entry == "power" )
+    {
+        return { entry,
+                 [] { return tr( "is plugged in to a power source" ); },
+                 [] { return tr( "The system is not plugged in to a power source." ); },
+                 satisfied,
+                 m_entriesToRequire.contains( entry ) };
+    }
+    else if ( entry == "internet" )
+    {
+        return { entry,
+                 [] { return tr( "is connected to the Internet" ); },
+                 [] { return tr( "The system is not connected to the Internet." ); },
+                 satisfied,
+                 m_entriesToRequire.contains( entry ) };
+    }
+    else if ( entry == "root" )
+    {
+        return { entry,
+                 [] { return tr( "is running the installer as an administrator (root)" ); },
+                 [] {
+                     return Calamares::Settings::instance()->isSetupMode()
+                         ? tr( "The setup program is not running with administrator rights." )
+                         : tr( "The installer is not running with administrator rights." );
+                 },
+                 satisfied,
+                 m_entriesToRequire.contains( entry ) };
+    }
+    else if ( entry == "screen" )
+    {
+        return { entry,
+                 [] { return tr( "has a screen large enough to show the whole installer" ); },
+                 [] {
+                     return Calamares::Settings::instance()->isSetupMode()
+                         ? tr( "The screen is too small to display the setup program." )
+                         : tr( "The screen is too small to display the installer." );
+                 },
+                 satisfied,
+                 false };
+    }
+    return { entry, [] { return QString(); }, [] { return QString(); }, satisfied, false };
+}
 
-    using TNum = Logger::DebugRow< const char*, qint64 >;
-    using TR = Logger::DebugRow< const char*, MaybeChecked >;
-    // clang-format off
-    cDebug() << "GeneralRequirements output:"
-             << TNum( "storage", requiredStorageB )
-             << TR( "enoughStorage", enoughStorage )
-             << TNum( "RAM", requiredRamB )
-             << TR( "enoughRam", enoughRam )
-             << TR( "hasPower", hasPower )
-             << TR( "hasInternet", hasInternet )
-             << TR( "isRoot", isRoot );
-    // clang-format on
+Calamares::RequirementsList
+GeneralRequirements::checkRequirements()
+{
+    MaybeChecked enoughStorage;
+    MaybeChecked enoughRam;
+    MaybeChecked hasPower;
+    MaybeChecked hasInternet;
+    MaybeChecked isRoot;
+
+    static const QStringList knownEntries { "storage", "ram", "power", "internet", "root", "screen" };
     Calamares::RequirementsList checkEntries;
-    foreach ( const QString& entry, m_entriesToCheck )
+    for ( const QString& entry : qAsConst( m_entriesToCheck ) )
     {
+        if ( !knownEntries.contains( entry ) )
+        {
+            continue;
+        }
+        const bool satisfied = cachedResult( entry );
+        checkEntries.append( makeEntry( entry, satisfied ) );
+
         if ( entry == "storage" )
         {
-            checkEntries.append(
-                { entry,
-                  [req = m_requiredStorageGiB] { return tr( "has at least %1 GiB available drive space" ).arg( req ); },
-                  [req = m_requiredStorageGiB] {
-                      return tr( "There is not enough drive space. At least %1 GiB is required." ).arg( req );
-                  },
-                  enoughStorage,
-                  m_entriesToRequire.contains( entry ) } );
+            enoughStorage = satisfied;
         }
         else if ( entry == "ram" )
         {
-            checkEntries.append(
-                { entry,
-                  [req = m_requiredRamGiB] { return tr( "has at least %1 GiB working memory" ).arg( req ); },
-                  [req = m_requiredRamGiB] {
-                      return tr( "The system does not have enough working memory. At least %1 GiB is required." )
-                          .arg( req );
-                  },
-                  enoughRam,
-                  m_entriesToRequire.contains( entry ) } );
+            enoughRam = satisfied;
         }
         else if ( entry == "power" )
         {
-            checkEntries.append( { entry,
-                                   [] { return tr( "is plugged in to a power source" ); },
-                                   [] { return tr( "The system is not plugged in to a power source." ); },
-                                   hasPower,
-                                   m_entriesToRequire.contains( entry ) } );
+            hasPower = satisfied;
         }
         else if ( entry == "internet" )
         {
-            checkEntries.append( { entry,
-                                   [] { return tr( "is connected to the Internet" ); },
-                                   [] { return tr( "The system is not connected to the Internet." ); },
-                                   hasInternet,
-                                   m_entriesToRequire.contains( entry ) } );
+            hasInternet = satisfied;
         }
         else if ( entry == "root" )
         {
-            checkEntries.append( { entry,
-                                   [] { return tr( "is running the installer as an administrator (root)" ); },
-                                   [] {
-                                       return Calamares::Settings::instance()->isSetupMode()
-                                           ? tr( "The setup program is not running with administrator rights." )
-                                           : tr( "The installer is not running with administrator rights." );
-                                   },
-                                   isRoot,
-                                   m_entriesToRequire.contains( entry ) } );
-        }
-        else if ( entry == "screen" )
-        {
-            checkEntries.append( { entry,
-                                   [] { return tr( "has a screen large enough to show the whole installer" ); },
-                                   [] {
-                                       return Calamares::Settings::instance()->isSetupMode()
-                                           ? tr( "The screen is too small to display the setup program." )
-                                           : tr( "The screen is too small to display the installer." );
-                                   },
-                                   enoughScreen,
-                                   false } );
+            isRoot = satisfied;
         }
     }
+
+    using TNum = Logger::DebugRow< const char*, qint64 >;
+    using TR = Logger::DebugRow< const char*, MaybeChecked >;
+    // clang-format off
+    cDebug() << "GeneralRequirements output:"
+             << TNum( "storage", CalamaresUtils::GiBtoBytes( m_requiredStorageGiB ) )
+             << TR( "enoughStorage", enoughStorage )
+             << TNum( "RAM", CalamaresUtils::GiBtoBytes( m_requiredRamGiB ) )
+             << TR( "enoughRam", enoughRam )
+             << TR( "hasPower", hasPower )
+             << TR( "hasInternet", hasInternet )
+             << TR( "isRoot", isRoot );
+    // clang-format on
+
+    // This may be called from a worker thread
+    QMetaObject::invokeMethod( this, "startWatching", Qt::QueuedConnection );
     return checkEntries;
 }
 
+void
+GeneralRequirements::startWatching()
+{
+    if ( m_watching )
+    {
+        return;
+    }
+    m_watching = true;
+
+    m_recheckTimer = new QTimer( this );
+    m_recheckTimer->setSingleShot( true );
+    m_recheckTimer->setInterval( 500 );
+    connect( m_recheckTimer, &QTimer::timeout, this, &GeneralRequirements::recheck );
+
+    auto systemBus = QDBusConnection::systemBus();
+    auto isOnSystemBus = [ &systemBus ]( const QString& service ) {
+        return systemBus.isConnected() && systemBus.interface()
+            && systemBus.interface()->isServiceRegistered( service ).value();
+    };
+    // Without the service, nobody tells us about changes
+    QStringList unwatched;
+    if ( m_entriesToCheck.contains( "power" ) && !isOnSystemBus( QStringLiteral( "org.freedesktop.UPower" ) ) )
+    {
+        unwatched.append( QStringLiteral( "power" ) );
+    }
+    if ( m_entriesToCheck.contains( "internet" )
+         && !isOnSystemBus( QStringLiteral( "org.freedesktop.NetworkManager" ) ) )
+    {
+        unwatched.append( QStringLiteral( "internet" ) );
+    }
+    if ( !unwatched.isEmpty() )
+    {
+        startPolling( unwatched );
+    }
+
+    if ( m_entriesToCheck.contains( "power" ) )
+    {
+        const QString upowerService( "org.freedesktop.UPower" );
+        const QString upowerPath( "/org/freedesktop/UPower" );
+        // OnBattery changes, and batteries come and go
+        systemBus.connect( upowerService,
+                           upowerPath,
+                           "org.freedesktop.DBus.Properties",
+                           "PropertiesChanged",
+                           this,
+                           SLOT( powerChanged() ) );
+        systemBus.connect( upowerService, upowerPath, upowerService, "DeviceAdded", this, SLOT( powerChanged() ) );
+        systemBus.connect( upowerService, upowerPath, upowerService, "DeviceRemoved", this, SLOT( powerChanged() ) );
+    }
+    if ( m_entriesToCheck.contains( "internet" ) )
+    {
+        systemBus.connect( "org.freedesktop.NetworkManager",
+                           "/org/freedesktop/NetworkManager",
+                           "org.freedesktop.NetworkManager",
+                           "StateChanged",
+                           this,
+                           SLOT( networkChanged() ) );
+    }
+    if ( m_entriesToCheck.contains( "storage" ) )
+    {
+        // The inventory watches the device nodes that udev maintains
+        connect( CalamaresUtils::Partition::DeviceInventory::instance(),
+                 &CalamaresUtils::Partition::DeviceInventory::changed,
+                 this,
+                 &GeneralRequirements::devicesChanged );
+    }
+    if ( qGuiApp && m_entriesToCheck.contains( "screen" ) )
+    {
+        connect( qGuiApp, &QGuiApplication::screenAdded, this, &GeneralRequirements::screensChanged );
+        connect( qGuiApp, &QGuiApplication::screenRemoved, this, &GeneralRequirements::screensChanged );
+    }
+}
+
+void
+GeneralRequirements::startPolling( const QStringList& entries )
+{
+    cDebug() << "Requirements" << entries << "can not be watched, checking every" << m_pollInterval << "ms.";
+    m_polledEntries = entries;
+    if ( !m_pollTimer )
+    {
+        m_pollTimer = new QTimer( this );
+        connect( m_pollTimer, &QTimer::timeout, this, &GeneralRequirements::poll );
+    }
+    m_pollTimer->start( m_pollInterval );
+}
+
+void
+GeneralRequirements::setPollInterval( int milliseconds )
+{
+    m_pollInterval = milliseconds;
+    if ( m_pollTimer && m_pollTimer->isActive() )
+    {
+        m_pollTimer->start( m_pollInterval );
+    }
+}
+
+void
+GeneralRequirements::poll()
+{
+    for ( const auto& entry : qAsConst( m_polledEntries ) )
+    {
+        scheduleRecheck( entry );
+    }
+}
+
+void
+GeneralRequirements::powerChanged()
+{
+    scheduleRecheck( QStringLiteral( "power" ) );
+}
+
+void
+GeneralRequirements::devicesChanged()
+{
+    scheduleRecheck( QStringLiteral( "storage" ) );
+}
+
+void
+GeneralRequirements::networkChanged()
+{
+    scheduleRecheck( QStringLiteral( "internet" ) );
+}
+
+void
+GeneralRequirements::screensChanged()
+{
+    scheduleRecheck( QStringLiteral( "screen" ) );
+}
+
+void
+GeneralRequirements::scheduleRecheck( const QString& entry )
+{
+    m_pendingRechecks.insert( entry );
+    m_recheckTimer->start();
+}
+
+void
+GeneralRequirements::recheck()
+{
+    using Result = QPair< QString, bool >;
+    using Watcher = QFutureWatcher< Result >;
+
+    const auto entries = m_pendingRechecks;
+    m_pendingRechecks.clear();
+    int generation = 0;
+    {
+        QMutexLocker lock( &m_resultsMutex );
+        generation = m_generation;
+    }
+    for ( const auto& entry : entries )
+    {
+        cDebug() << "Requirement" << entry << "may have changed, checking again.";
+        // The watcher belongs to this object, so the result is never
+        // delivered after this object is gone; the check itself runs
+        // on copies and does not touch this object at all.
+        auto* watcher = new Watcher( this );
+        connect( watcher, &Watcher::finished, this, [ this, watcher, generation ]() {
+            const Result result = watcher->result();
+            const QString& name = result.first;
+            const bool satisfied = result.second;
+            watcher->deleteLater();
+
+            bool changed = false;
+            {
+                QMutexLocker lock( &m_resultsMutex );
+                if ( generation != m_generation )
+                {
+                    // Checked against a configuration that has since been replaced
+                    return;
+                }
+                changed = m_results.value( name, !satisfied ) != satisfied;
+                m_results.insert( name, satisfied );
+            }
+            if ( changed )
+            {
+                cDebug() << Logger::SubEntry << "Requirement" << name << "is now" << satisfied;
+                emit requirementChanged( makeEntry( name, satisfied ) );
+            }
+        } );
+        // Storage and internet checks may take a while
+        const qreal storage = m_requiredStorageGiB;
+        const qreal ram = m_requiredRamGiB;
+        watcher->setFuture( QtConcurrent::run(
+            [ entry, storage, ram ]() { return Result( entry, evaluate( entry, storage, ram ) ); } ) );
+    }
+}
+
 /** @brief Loads the check-internet URLs
  *
  * There may be zero or one or more URLs specified; returns
@@ -272,6 +517,12 @@ void
 GeneralRequirements::setConfigurationMap( const QVariantMap& configurationMap )
 {
     bool incompleteConfiguration = false;
+    {
+        // The results depend on the configuration
+        QMutexLocker lock( &m_resultsMutex );
+        m_results.clear();
+        ++m_generation;
+    }
 
     if ( configurationMap.contains( "check" ) && configurationMap.value( "check" ).type() == QVariant::List )
     {
@@ -295,17 +546,6 @@ GeneralRequirements::setConfigurationMap( const QVariantMap& configurationMap )
         incompleteConfiguration = true;
     }
 
-#ifdef WITHOUT_LIBPARTED
-    if ( m_entriesToCheck.contains( "storage" ) || m_entriesToRequire.contains( "storage" ) )
-    {
-        // Warn, but also drop the required bit because otherwise installation
-        // will be impossible (because the check always returns false).
-        cWarning() << "GeneralRequirements checks 'storage' but libparted is disabled.";
-        m_entriesToCheck.removeAll( "storage" );
-        m_entriesToRequire.removeAll( "storage" );
-    }
-#endif
-
     // Help out with consistency, but don't fix
     for ( const auto& r : m_entriesToRequire )
         if ( !m_entriesToCheck.contains( r ) )
@@ -366,13 +606,10 @@ GeneralRequirements::setConfigurationMap( const QVariantMap& configurationMap )
 bool
 GeneralRequirements::checkEnoughStorage( qint64 requiredSpace )
 {
-#ifdef WITHOUT_LIBPARTED
-    Q_UNUSED( requiredSpace )
-    cWarning() << "GeneralRequirements is configured without libparted.";
-    return false;
-#else
-    return check_big_enough( requiredSpace );
-#endif
+    const auto disks = CalamaresUtils::Partition::DeviceInventory::instance()->disks();
+    return std::any_of( disks.cbegin(), disks.cend(), [ requiredSpace ]( const auto& d ) {
+        return !d.readOnly && d.size >= requiredSpace;
+    } );
 }
 
 
@@ -460,3 +697,12 @@ GeneralRequirements::checkIsRoot()
 {
     return !geteuid();
 }
+
+
+bool
+GeneralRequirements::checkEnoughScreen()
+{
+    const QSize availableSize = biggestSingleScreen();
+    return availableSize.isValid() && ( availableSize.width() >= CalamaresUtils::windowMinimumWidth )
+        && ( availableSize.height() >= CalamaresUtils::windowMinimumHeight );
+}
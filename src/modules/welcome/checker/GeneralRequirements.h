@@ -11,11 +11,30 @@
 #ifndef GENERALREQUIREMENTS_H
 #define GENERALREQUIREMENTS_H
 
+#include <QHash>
+#include <QMutex>
 #include <QObject>
+#include <QSet>
 #include <QStringList>
 
 #include "modulesystem/Requirement.h"
 
+class QTimer;
+
+/** @brief The general requirements checked by the welcome module
+ *
+ * The result of each check is remembered, so that checking all the
+ * requirements again is cheap. After the first check, the inputs to
+ * the checks are watched: power supplies (through UPower), block
+ * devices (through the device nodes that udev creates), connectivity
+ * (through NetworkManager) and screens. When one of those changes,
+ * only the requirements that depend on it are checked again, and
+ * requirementChanged() is emitted if the result is different.
+ *
+ * Power and connectivity can only be watched if UPower and NetworkManager
+ * are on the system bus. Without them, those requirements are checked
+ * again every pollInterval() milliseconds instead.
+ */
 class GeneralRequirements : public QObject
 {
     Q_OBJECT
@@ -26,19 +45,67 @@ public:
 
     Calamares::RequirementsList checkRequirements();
 
+    /// @brief Interval for checking requirements that can't be watched
+    int pollInterval() const { return m_pollInterval; }
+    void setPollInterval( int milliseconds );
+
+signals:
+    /// @brief A requirement was checked again, and its result changed
+    void requirementChanged( const Calamares::RequirementEntry& entry );
+
+private Q_SLOTS:
+    /// @brief Starts watching the inputs of the checks (in the GUI thread)
+    void startWatching();
+    void powerChanged();
+    void devicesChanged();
+    void networkChanged();
+    void screensChanged();
+    /// @brief Checks the entries that were scheduled
+    void recheck();
+    /// @brief Schedules the entries that are polled rather than watched
+    void poll();
+
 private:
+    friend class WelcomeTests;
+
     QStringList m_entriesToCheck;
     QStringList m_entriesToRequire;
 
-    bool checkEnoughStorage( qint64 requiredSpace );
-    bool checkEnoughRam( qint64 requiredRam );
-    bool checkBatteryExists();
-    bool checkHasPower();
-    bool checkHasInternet();
-    bool checkIsRoot();
+    /** @brief Runs the check for @p entry, without looking at the cache
+     *
+     * This is static, and gets the required sizes passed in, so that it
+     * can run in a worker thread without touching the object.
+     */
+    static bool evaluate( const QString& entry, qreal requiredStorageGiB, qreal requiredRamGiB );
+    /// @brief The result for @p entry, from the cache if it has been checked before
+    bool cachedResult( const QString& entry );
+    Calamares::RequirementEntry makeEntry( const QString& entry, bool satisfied ) const;
+    /// @brief Check @p entry again, a little later (changes come in bursts)
+    void scheduleRecheck( const QString& entry );
+    /// @brief Check @p entries again every pollInterval() milliseconds
+    void startPolling( const QStringList& entries );
+
+    static bool checkEnoughStorage( qint64 requiredSpace );
+    static bool checkEnoughRam( qint64 requiredRam );
+    static bool checkBatteryExists();
+    static bool checkHasPower();
+    static bool checkHasInternet();
+    static bool checkIsRoot();
+    static bool checkEnoughScreen();
 
     qreal m_requiredStorageGiB;
     qreal m_requiredRamGiB;
+
+    QMutex m_resultsMutex;
+    QHash< QString, bool > m_results;  ///< Cached results, by entry name
+    QSet< QString > m_pendingRechecks;
+    QTimer* m_recheckTimer = nullptr;
+    QTimer* m_pollTimer = nullptr;
+    QStringList m_polledEntries;
+    int m_pollInterval = 30000;
+    /// @brief Bumped (under the mutex) when the configuration changes, to drop stale rechecks
+    int m_generation = 0;
+    bool m_watching = false;
 };
 
 #endif  // REQUIREMENTSCHECKER_H
@@ -19,6 +19,7 @@
 
 #include "Branding.h"
 #include "modulesystem/ModuleManager.h"
+#include "modulesystem/RequirementsModel.h"
 #include "utils/Yaml.h"
 
 CALAMARES_PLUGIN_FACTORY_DEFINITION( WelcomeQmlViewStepFactory, registerPlugin< WelcomeQmlViewStep >(); )
@@ -31,6 +32,10 @@ WelcomeQmlViewStep::WelcomeQmlViewStep( QObject* parent )
              &Calamares::ModuleManager::requirementsComplete,
              this,
              &WelcomeQmlViewStep::nextStatusChanged );
+    connect( m_config->requirementsModel(),
+             &Calamares::RequirementsModel::satisfiedMandatoryChanged,
+             this,
+             &WelcomeQmlViewStep::nextStatusChanged );
 }
 
 